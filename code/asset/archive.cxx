@@ -0,0 +1,320 @@
+namespace rt {
+namespace impl {
+struct Pack_Entry {
+  String path;
+  String name;
+  s64    size;
+  u64    hash;
+  s64    blob_offset;
+};
+
+struct Pack_State {
+  Pack_Entry *entries;
+  s64         entry_count;
+  s64         entry_capacity;
+};
+
+[[nodiscard]] u64
+archive_name_hash(String name) {
+  u64 const hash = string_hash(name);
+  return (hash != 0) ? hash : 1; // 0 is reserved for empty slots.
+}
+
+[[nodiscard]] s64
+align_forward(s64 offset, s64 alignment) {
+  return (offset + alignment - 1)/alignment*alignment;
+}
+
+void
+count_file_visitor(String, String, s64, void *user_data) {
+  Pack_State &state = *(Pack_State*)user_data;
+  state.entry_capacity++;
+}
+
+void
+collect_file_visitor(String path, String relative_path, s64 size, void *user_data) {
+  Pack_State &state = *(Pack_State*)user_data;
+
+  // @Note: the directory may have changed between the two passes.
+  if (state.entry_count == state.entry_capacity) {
+    errf("Directory contents changed while packing ('%.*s')",
+         (int)path.count, path.data);
+  }
+
+  state.entries[state.entry_count++] = {
+    .path = path,
+    .name = relative_path,
+    .size = size,
+    .hash = archive_name_hash(relative_path)
+  };
+}
+
+void
+write_zeros_or_panic(File_Writer &writer, s64 count) {
+  u8 static const ZEROS[ARCHIVE_BLOB_ALIGNMENT] = {};
+  dbg_check_(count >= 0 && count <= ARCHIVE_BLOB_ALIGNMENT);
+
+  os_file_writer_write_or_panic(writer, {.count = count, .bytes = (u8*)ZEROS});
+}
+} // namespace impl
+
+void
+asset_pack_directory_or_panic(char const *src_dir, char const *archive_path) {
+  check_(src_dir);
+  check_(archive_path);
+
+  f32 const start_time = os_get_app_uptime();
+
+  // Step 1. Collect the files
+
+  impl::Pack_State state = {};
+  os_visit_files_or_panic(src_dir, impl::count_file_visitor, &state);
+
+  if (state.entry_capacity > 0) {
+    state.entries = (impl::Pack_Entry*)alloc_temp(state.entry_capacity*sizeof(impl::Pack_Entry));
+  }
+  os_visit_files_or_panic(src_dir, impl::collect_file_visitor, &state);
+
+  if (state.entry_count > 0x7fffffff) {
+    errf("Too many files to pack in '%s' (%lld)", src_dir, state.entry_count);
+  }
+
+  // Step 2. Lay out the archive
+
+  u64 slot_count = 16;
+  while (slot_count < (u64)state.entry_count*2) {
+    slot_count *= 2;
+  }
+
+  s64 names_size = 0;
+  for (s64 i = 0; i < state.entry_count; i++) {
+    names_size += state.entries[i].name.count;
+  }
+
+  s64 const toc_offset   = sizeof(Archive_Header);
+  s64 const names_offset = toc_offset + (s64)(slot_count*sizeof(Archive_Toc_Slot));
+  s64 const blobs_offset = impl::align_forward(names_offset + names_size,
+                                               ARCHIVE_BLOB_ALIGNMENT);
+
+  s64 offset = blobs_offset;
+  for (s64 i = 0; i < state.entry_count; i++) {
+    state.entries[i].blob_offset = offset;
+    offset = impl::align_forward(offset + state.entries[i].size, ARCHIVE_BLOB_ALIGNMENT);
+  }
+  s64 const file_size = offset;
+
+  Archive_Toc_Slot *toc = (Archive_Toc_Slot*)alloc_temp(slot_count*sizeof(Archive_Toc_Slot));
+  ::memset(toc, 0, slot_count*sizeof(Archive_Toc_Slot));
+
+  u32 name_offset = 0;
+  for (s64 i = 0; i < state.entry_count; i++) {
+    impl::Pack_Entry const &entry = state.entries[i];
+
+    u64 slot = entry.hash & (slot_count - 1);
+    while (toc[slot].name_hash != 0) {
+      slot = (slot + 1) & (slot_count - 1);
+    }
+
+    toc[slot] = {
+      .name_hash   = entry.hash,
+      .blob_offset = (u64)entry.blob_offset,
+      .blob_size   = (u64)entry.size,
+      .name_offset = name_offset,
+      .name_length = (u32)entry.name.count
+    };
+
+    name_offset += (u32)entry.name.count;
+  }
+
+  Archive_Header const header = {
+    .magic        = ARCHIVE_MAGIC,
+    .version      = ARCHIVE_VERSION,
+    .entry_count  = (u32)state.entry_count,
+    .slot_count   = (u32)slot_count,
+    .toc_offset   = (u64)toc_offset,
+    .names_offset = (u64)names_offset,
+    .blobs_offset = (u64)blobs_offset,
+    .file_size    = (u64)file_size
+  };
+
+  // Step 3. Write it out
+
+  File_Writer writer = os_open_file_writer_or_panic(archive_path);
+
+  os_file_writer_write_or_panic(writer, {.count = sizeof(header), .bytes = (u8*)&header});
+  os_file_writer_write_or_panic(writer, {
+    .count = (s64)(slot_count*sizeof(Archive_Toc_Slot)),
+    .bytes = (u8*)toc
+  });
+
+  for (s64 i = 0; i < state.entry_count; i++) {
+    os_file_writer_write_or_panic(writer, {
+      .count = state.entries[i].name.count,
+      .bytes = (u8*)state.entries[i].name.data
+    });
+  }
+  impl::write_zeros_or_panic(writer, blobs_offset - (names_offset + names_size));
+
+  // @Note: the files are read asynchronously, up to ASSET_PACK_READ_AHEAD bytes ahead
+  //        of the one being written, so the disk is kept busy while blobs are written.
+  Async_Io_Request *reads = NULL;
+  if (state.entry_count > 0) {
+    reads = (Async_Io_Request*)alloc_temp(state.entry_count*sizeof(Async_Io_Request));
+  }
+
+  s64 next_read  = 0;
+  s64 read_ahead = 0; // Bytes read (or being read) but not written yet.
+  for (s64 i = 0; i < state.entry_count; i++) {
+    while (next_read < state.entry_count &&
+           os_get_async_io_in_flight_count() < ASYNC_IO_MAX_IN_FLIGHT &&
+           (next_read == i || read_ahead + state.entries[next_read].size <= ASSET_PACK_READ_AHEAD)) {
+      // @Note: the whole file is read into a new allocation, its size is checked below.
+      reads[next_read] = {
+        .op   = AsyncIoOp_Read,
+        .path = as_cstr(state.entries[next_read].path)
+      };
+      os_submit_async_io(reads[next_read]);
+      read_ahead += state.entries[next_read].size;
+      next_read++;
+    }
+
+    impl::Pack_Entry const &entry = state.entries[i];
+    Async_Io_Request       &read  = reads[i];
+    dbg_check_(writer.written + writer.buffered == entry.blob_offset);
+
+    while (read.status == AsyncIoStatus_Pending) {
+      (void)os_poll_async_io(true);
+    }
+
+    if (read.status != AsyncIoStatus_Done) {
+      errf("Failed to read '%.*s' while packing (error %u)",
+           (int)entry.path.count, entry.path.data, read.error);
+    }
+    if (read.buffer.count != entry.size || read.bytes_transferred != entry.size) {
+      errf("File '%.*s' changed while packing", (int)entry.path.count, entry.path.data);
+    }
+
+    os_file_writer_write_or_panic(writer, read.buffer);
+    if (read.buffer.bytes) {
+      free_perm(read.buffer.bytes);
+    }
+    read_ahead -= entry.size;
+
+    s64 const end = entry.blob_offset + entry.size;
+    impl::write_zeros_or_panic(writer, impl::align_forward(end, ARCHIVE_BLOB_ALIGNMENT) - end);
+  }
+
+  os_close_file_writer_or_panic(writer);
+
+  logf("Packed %lld files from '%s' into '%s' (%.2f MB) in %.3fs\n",
+       state.entry_count, src_dir, archive_path, (f64)file_size/RT_MEGABYTES(1),
+       os_get_app_uptime() - start_time);
+}
+
+[[nodiscard]] Asset_Archive
+asset_open_archive_or_panic(char const *path) {
+  Asset_Archive archive = {};
+  archive.file = os_map_file_or_panic(path);
+
+  Buffer const content = archive.file.content;
+  if (content.count < (s64)sizeof(Archive_Header)) {
+    errf("Asset archive '%s' is too small (%lld bytes)", path, content.count);
+  }
+
+  Archive_Header const &header = *(Archive_Header const*)content.bytes;
+  if (header.magic != ARCHIVE_MAGIC || header.version != ARCHIVE_VERSION) {
+    errf("'%s' is not an asset archive (or has a wrong version)", path);
+  }
+
+  // @Note: the sections are checked in file order, with subtractions only, so huge
+  //        offsets can't wrap around into a valid looking layout.
+  bool const is_layout_valid =
+    header.file_size == (u64)content.count &&
+    header.slot_count > 0 && (header.slot_count & (header.slot_count - 1)) == 0 &&
+    header.toc_offset   >= sizeof(Archive_Header) &&
+    header.toc_offset   <= header.names_offset &&
+    header.slot_count*(u64)sizeof(Archive_Toc_Slot) <= header.names_offset - header.toc_offset &&
+    header.names_offset <= header.blobs_offset &&
+    header.blobs_offset <= header.file_size;
+
+  if (!is_layout_valid) {
+    errf("Asset archive '%s' is corrupted", path);
+  }
+
+  archive.header = &header;
+  archive.toc    = (Archive_Toc_Slot const*)(content.bytes + header.toc_offset);
+  archive.names  = (char const*)(content.bytes + header.names_offset);
+
+  // @Note: asset_find trusts the entries, so a truncated or damaged archive has to be
+  //        caught here. A full table would also make a miss probe forever.
+  u64 const names_size = header.blobs_offset - header.names_offset;
+  u32       used_slots = 0;
+  for (u32 i = 0; i < header.slot_count; i++) {
+    Archive_Toc_Slot const &entry = archive.toc[i];
+    if (entry.name_hash == 0) {
+      continue;
+    }
+    used_slots++;
+
+    bool const is_entry_valid =
+      entry.blob_offset >= header.blobs_offset &&
+      entry.blob_offset <= header.file_size &&
+      entry.blob_size   <= header.file_size - entry.blob_offset &&
+      entry.name_offset <= names_size &&
+      entry.name_length <= names_size - entry.name_offset;
+
+    if (!is_entry_valid) {
+      errf("Asset archive '%s' is corrupted (entry in slot %u is out of bounds)", path, i);
+    }
+  }
+
+  if (used_slots != header.entry_count || used_slots == header.slot_count) {
+    errf("Asset archive '%s' is corrupted (%u entries in %u slots, expected %u)", path,
+         used_slots, header.slot_count, header.entry_count);
+  }
+
+  // @Note: the table of contents is touched on every lookup, so bring it in right away.
+  //        The blobs are paged in on demand.
+  os_prefetch_mapped_range(archive.file, 0, (s64)header.blobs_offset);
+
+  logf("Asset archive '%s' opened (%u assets)\n", path, header.entry_count);
+  return archive;
+}
+
+void
+asset_close_archive(Asset_Archive &archive) {
+  os_unmap_file(archive.file);
+  archive = {};
+}
+
+[[nodiscard]] Buffer
+asset_find(Asset_Archive const &archive, String name) {
+  check_(archive.header);
+
+  u64 const hash = impl::archive_name_hash(name);
+  u64 const mask = archive.header->slot_count - 1;
+
+  for (u64 slot = hash & mask;; slot = (slot + 1) & mask) {
+    Archive_Toc_Slot const &entry = archive.toc[slot];
+
+    if (entry.name_hash == 0) {
+      return {};
+    }
+
+    if (entry.name_hash   == hash &&
+        entry.name_length == (u64)name.count &&
+        mem_comp_(archive.names + entry.name_offset, name.data, name.count) == 0) {
+      return {
+        .count = (s64)entry.blob_size,
+        .bytes = archive.file.content.bytes + entry.blob_offset
+      };
+    }
+  }
+}
+
+[[nodiscard]] Buffer
+asset_find(Asset_Archive const &archive, char const *name) {
+  check_(name);
+  return asset_find(archive, String{.count = (s64)::strlen(name), .data = (char*)name});
+}
+} // namespace rt
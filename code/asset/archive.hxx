@@ -0,0 +1,69 @@
+/**
+ * Packed asset archive. All assets live in one file that is memory-mapped once at
+ * startup. Looking an asset up is a probe into a hashed table of contents and returns
+ * a pointer straight into the mapping -- pages are loaded by the OS on first access.
+ *
+ * Layout:
+ *   Archive_Header
+ *   Archive_Toc_Slot[slot_count]   -- open addressing, linear probing
+ *   names                          -- concatenated, not null-terminated
+ *   blobs                          -- each aligned to ARCHIVE_BLOB_ALIGNMENT
+ *
+ * Asset names are paths relative to the packed directory with '/' as the separator,
+ * e.g. "textures/bricks.png" for "%t/bricks.png".
+*/
+
+namespace rt {
+u32 constexpr static ARCHIVE_MAGIC          = 0x4b505452; // "RTPK"
+u32 constexpr static ARCHIVE_VERSION        = 1;
+s64 constexpr static ARCHIVE_BLOB_ALIGNMENT = 64;
+
+struct Archive_Header {
+  u32 magic;
+  u32 version;
+  u32 entry_count;
+  u32 slot_count;   // Power of two, at least twice the entry count.
+  u64 toc_offset;
+  u64 names_offset;
+  u64 blobs_offset;
+  u64 file_size;
+  u8  _unused[16];
+};
+static_assert(sizeof(Archive_Header) == 64);
+
+struct Archive_Toc_Slot {
+  u64 name_hash;    // string_hash of the name. 0 marks an empty slot.
+  u64 blob_offset;  // From the start of the archive.
+  u64 blob_size;
+  u32 name_offset;  // From names_offset.
+  u32 name_length;
+};
+static_assert(sizeof(Archive_Toc_Slot) == 32);
+
+struct Asset_Archive {
+  Mapped_File             file;
+  Archive_Header   const *header;
+  Archive_Toc_Slot const *toc;
+  char             const *names;
+};
+
+// Packs every file in `src_dir` (recursively) into a new archive at `archive_path`.
+// The files are read with async I/O, ahead of the one being written.
+void
+asset_pack_directory_or_panic(char const *src_dir, char const *archive_path);
+
+// Panics if the file isn't an archive, or if any entry points outside of it.
+[[nodiscard]] Asset_Archive
+asset_open_archive_or_panic(char const *path);
+
+void
+asset_close_archive(Asset_Archive &archive);
+
+// Returns an empty buffer if there's no such asset. The memory is read-only and valid
+// until the archive is closed.
+[[nodiscard]] Buffer
+asset_find(Asset_Archive const &archive, String name);
+
+[[nodiscard]] Buffer
+asset_find(Asset_Archive const &archive, char const *name);
+} // namespace rt
@@ -0,0 +1,2 @@
+#include "archive.cxx"
+#include "asset_check.cxx"
\ No newline at end of file
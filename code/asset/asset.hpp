@@ -0,0 +1,2 @@
+#include "archive.hxx"
+#include "asset_check.hxx"
\ No newline at end of file
@@ -0,0 +1,240 @@
+namespace rt {
+namespace impl {
+struct Asset_Check_State {
+  char const *group;
+  s32         count;
+  s32         failed;
+} static gAsset_Check;
+
+void
+asset_expect(bool ok, char const *expression, char const *file, s32 line) {
+  gAsset_Check.count++;
+  if (!ok) {
+    gAsset_Check.failed++;
+    logf("!!! [%s] check failed: %s\n!!! %s:%d\n", gAsset_Check.group, expression, file, line);
+  }
+}
+
+#define asset_expect_(x) impl::asset_expect((x), #x, __FILE__, (s32)__LINE__)
+
+// Random bytes in temp memory. Never NULL, even if empty.
+[[nodiscard]] Buffer
+random_buffer(Pcg32 &rng, s64 count) {
+  Buffer const buffer = {.count = count, .bytes = (u8*)alloc_temp(count + 1)};
+  for (s64 i = 0; i < count; i++) {
+    buffer.bytes[i] = (u8)next_u32(rng);
+  }
+  return buffer;
+}
+
+[[nodiscard]] bool
+equal(Buffer a, Buffer b) {
+  return a.count == b.count && (a.count == 0 || mem_comp_(a.bytes, b.bytes, a.count) == 0);
+}
+
+// Appends the chunks to a temp buffer big enough for them.
+struct Check_Sink {
+  Buffer buffer;
+  s64    size;
+};
+
+void
+check_sink(Buffer chunk, void *user_data) {
+  Check_Sink &sink = *(Check_Sink*)user_data;
+  dbg_check_(sink.size + chunk.count <= sink.buffer.count);
+
+  mem_copy_(sink.buffer.bytes + sink.size, chunk.bytes, chunk.count);
+  sink.size += chunk.count;
+}
+
+void
+check_compression(Pcg32 &rng) {
+  s64 constexpr static BIG = 2*COMPRESSION_BLOCK_SIZE + 123; // Three blocks, the last partial.
+
+  Buffer const empty          = random_buffer(rng, 0);
+  Buffer const one            = random_buffer(rng, 1);
+  Buffer const incompressible = random_buffer(rng, BIG);
+
+  Buffer const repetitive = {.count = BIG, .bytes = (u8*)alloc_temp(BIG)};
+  for (s64 i = 0; i < BIG; i++) {
+    repetitive.bytes[i] = (u8)"the quick brown fox jumps over the lazy dog "[i % 44];
+  }
+
+  // Runs of random bytes and zeros, so blocks mix literals and matches.
+  Buffer const mixed = random_buffer(rng, BIG);
+  for (s64 i = 0; i < BIG; i++) {
+    mixed.bytes[i] = ((i/1000) % 2 == 0) ? mixed.bytes[i] : 0;
+  }
+
+  Buffer const inputs[] = {empty, one, incompressible, repetitive, mixed};
+  for (Buffer const &raw : inputs) {
+    s64 const mark = get_temp_mem_mark();
+
+    // One block.
+    Buffer const block = {
+      .count = (raw.count < COMPRESSION_BLOCK_SIZE) ? raw.count : COMPRESSION_BLOCK_SIZE,
+      .bytes = raw.bytes
+    };
+    Buffer const packed   = {.count = compress_block_bound(block.count),
+                             .bytes = (u8*)alloc_temp(compress_block_bound(block.count) + 1)};
+    Buffer const unpacked = {.count = block.count, .bytes = (u8*)alloc_temp(block.count + 1)};
+
+    s64 const packed_size = compress_block(block, packed);
+    asset_expect_(packed_size > 0 || block.count == 0);
+    asset_expect_(decompress_block({.count = packed_size, .bytes = packed.bytes}, unpacked) == block.count);
+    asset_expect_(equal(unpacked, block));
+
+    // A whole stream, decoded sequentially and block by block.
+    Buffer const stream = {.count = compress_stream_bound(raw.count),
+                           .bytes = (u8*)alloc_temp(compress_stream_bound(raw.count))};
+    Buffer const packed_stream = {.count = compress_stream(raw, stream), .bytes = stream.bytes};
+    asset_expect_(packed_stream.count <= stream.count);
+
+    s64       raw_size    = -1;
+    s64 const block_count = compressed_stream_index(packed_stream, NULL, 0, raw_size);
+    asset_expect_(block_count == (raw.count + COMPRESSION_BLOCK_SIZE - 1)/COMPRESSION_BLOCK_SIZE);
+    asset_expect_(raw_size == raw.count);
+
+    Buffer const decoded = {.count = raw.count, .bytes = (u8*)alloc_temp(raw.count + 1)};
+    asset_expect_(decompress_stream(packed_stream, decoded) && equal(decoded, raw));
+
+    Compressed_Block blocks[4];
+    if (block_count >= 0 && block_count <= 4) {
+      (void)compressed_stream_index(packed_stream, blocks, 4, raw_size);
+      ::memset(decoded.bytes, 0, decoded.count);
+      bool ok = true;
+      for (s64 i = block_count - 1; i >= 0; i--) {
+        ok = ok && decompress_stream_block(blocks[i], decoded);
+      }
+      asset_expect_(ok && equal(decoded, raw));
+    }
+
+    // Streamed in uneven pieces, the result decodes the same.
+    Check_Sink sink = {.buffer = {.count = stream.count, .bytes = (u8*)alloc_temp(stream.count)}};
+    Compressor compressor = compressor_begin(check_sink, &sink);
+    for (s64 offset = 0; offset < raw.count;) {
+      s64 const piece = 1 + (s64)next_u32_below(rng, 100000);
+      s64 const count = (offset + piece < raw.count) ? piece : raw.count - offset;
+      compressor_write(compressor, {.count = count, .bytes = raw.bytes + offset});
+      offset += count;
+    }
+    compressor_end(compressor);
+    ::memset(decoded.bytes, 0, decoded.count);
+    asset_expect_(decompress_stream({.count = sink.size, .bytes = sink.buffer.bytes}, decoded) &&
+                  equal(decoded, raw));
+
+    // A cut stream is reported, not decoded past its end.
+    if (packed_stream.count > (s64)sizeof(Compressed_Stream_Header) + 8) {
+      Buffer const cut = {.count = packed_stream.count - 5, .bytes = packed_stream.bytes};
+      asset_expect_(compressed_stream_index(cut, NULL, 0, raw_size) < 0 ||
+                    !decompress_stream(cut, decoded));
+    }
+
+    pop_temp_mem_mark(get_temp_mem_mark() - mark);
+  }
+
+  // Incompressible data doesn't grow by more than the block headers.
+  s64 const stream_size = compress_stream(incompressible, {
+    .count = compress_stream_bound(incompressible.count),
+    .bytes = (u8*)alloc_temp(compress_stream_bound(incompressible.count))
+  });
+  asset_expect_(stream_size <= incompressible.count + 64);
+
+  // A destination below the bound is refused, not written past.
+  asset_expect_(compress_stream(incompressible, {
+    .count = compress_stream_bound(incompressible.count) - 1,
+    .bytes = (u8*)alloc_temp(compress_stream_bound(incompressible.count))
+  }) == 0);
+
+  // Through a file.
+  char const *const path = as_cstr(pathf("%l\\asset_check.rtlz"));
+  for (Buffer const &raw : inputs) {
+    os_write_compressed_file_or_panic(raw, path);
+    Buffer const read = os_read_compressed_file_or_panic(path);
+    asset_expect_(equal(read, raw));
+    if (read.bytes) {
+      free_perm(read.bytes);
+    }
+  }
+}
+
+void
+check_archive(Pcg32 &rng) {
+  // @Note: sizes around the blob alignment, an empty file and nested directories.
+  struct {
+    char const *name;
+    s64         size;
+  } const files[] = {
+    {"empty.bin",          0},
+    {"one.bin",            1},
+    {"aligned.bin",        ARCHIVE_BLOB_ALIGNMENT},
+    {"unaligned.bin",      ARCHIVE_BLOB_ALIGNMENT + 1},
+    {"textures/big.bin",   RT_KILOBYTES(300)},
+    {"models/a/deep.bin",  1000},
+  };
+  s32 constexpr static FILE_COUNT = sizeof(files)/sizeof(*files);
+
+  char const *const root = as_cstr(pathf("%l\\asset_check"));
+  os_create_directory_or_panic(root);
+  os_create_directory_or_panic(as_cstr(tprint("%s\\textures", root)));
+  os_create_directory_or_panic(as_cstr(tprint("%s\\models", root)));
+  os_create_directory_or_panic(as_cstr(tprint("%s\\models\\a", root)));
+
+  Buffer contents[FILE_COUNT];
+  for (s32 i = 0; i < FILE_COUNT; i++) {
+    contents[i] = random_buffer(rng, files[i].size);
+    os_write_entire_file_or_panic(contents[i], as_cstr(tprint("%s\\%s", root, files[i].name)));
+  }
+
+  char const *const archive_path = as_cstr(pathf("%l\\asset_check.rtpk"));
+  asset_pack_directory_or_panic(root, archive_path);
+
+  Asset_Archive archive = asset_open_archive_or_panic(archive_path);
+  asset_expect_(archive.header->entry_count == FILE_COUNT);
+
+  for (s32 i = 0; i < FILE_COUNT; i++) {
+    Buffer const asset = asset_find(archive, files[i].name);
+    asset_expect_(equal(asset, contents[i]));
+    asset_expect_(asset.count == 0 || (u64)asset.bytes % ARCHIVE_BLOB_ALIGNMENT == 0);
+  }
+
+  asset_expect_(asset_find(archive, "missing.bin").count == 0);
+  asset_expect_(asset_find(archive, "models").count == 0);
+  asset_expect_(asset_find(archive, "textures/BIG.bin").count == 0);
+
+  asset_close_archive(archive);
+}
+} // namespace impl
+
+[[nodiscard]] s32
+asset_run_checks() {
+  using Check_Fn = void(Pcg32 &rng);
+  struct {
+    char const *name;
+    Check_Fn   *fn;
+  } const groups[] = {
+    {"compression", impl::check_compression},
+    {"archive",     impl::check_archive},
+  };
+
+  impl::gAsset_Check = {};
+  Pcg32 rng = pcg32_seed(0xa55e7, 0);
+
+  for (auto const &group : groups) {
+    impl::gAsset_Check.group = group.name;
+
+    s32 const failed_before = impl::gAsset_Check.failed;
+    s32 const count_before  = impl::gAsset_Check.count;
+    s64 const mark          = get_temp_mem_mark();
+    group.fn(rng);
+    pop_temp_mem_mark(get_temp_mem_mark() - mark);
+
+    logf("Asset check: %-12s %5d checks, %d failed\n", group.name,
+         impl::gAsset_Check.count - count_before, impl::gAsset_Check.failed - failed_before);
+  }
+
+  logf("Asset check: %d of %d checks failed\n", impl::gAsset_Check.failed,
+       impl::gAsset_Check.count);
+  return impl::gAsset_Check.failed;
+}
+} // namespace rt
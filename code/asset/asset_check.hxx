@@ -0,0 +1,16 @@
+/**
+ * Self-check of the asset pipeline:
+ *
+ *    rt_internal.exe --asset-check
+ *
+ * Round-trips data through the compression (blocks, streams and compressed files),
+ * incompressible and empty inputs included. Then writes a directory of files with
+ * known contents into the logs directory, packs it into an archive, opens it and
+ * compares every asset with what was written.
+*/
+
+namespace rt {
+// Logs every failed check. Returns the number of failures.
+[[nodiscard]] s32
+asset_run_checks();
+} // namespace rt
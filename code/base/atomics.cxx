@@ -0,0 +1,39 @@
+namespace rt {
+[[nodiscard]] s64
+atomic_load(s64 volatile const &x) {
+  s64 const value = x;
+  _ReadWriteBarrier();
+  return value;
+}
+
+void
+atomic_store(s64 volatile &x, s64 value) {
+  _ReadWriteBarrier();
+  x = value;
+}
+
+s64
+atomic_exchange(s64 volatile &x, s64 value) {
+  return _InterlockedExchange64(&x, value);
+}
+
+[[nodiscard]] bool
+atomic_compare_exchange(s64 volatile &x, s64 expected, s64 desired) {
+  return _InterlockedCompareExchange64(&x, desired, expected) == expected;
+}
+
+s64
+atomic_add(s64 volatile &x, s64 value) {
+  return _InterlockedExchangeAdd64(&x, value) + value;
+}
+
+void
+atomic_fence() {
+  _mm_mfence();
+}
+
+void
+cpu_pause() {
+  _mm_pause();
+}
+} // namespace rt
@@ -0,0 +1,34 @@
+/**
+ * The handful of atomic operations the job system is built on, on top of the MSVC
+ * intrinsics. Loads have acquire and stores have release semantics -- on x64 that's
+ * what plain moves already do, so those only have to stop the compiler from
+ * reordering. The read-modify-write operations are full barriers.
+*/
+
+namespace rt {
+[[nodiscard]] s64
+atomic_load(s64 volatile const &x);
+
+void
+atomic_store(s64 volatile &x, s64 value);
+
+// Returns the previous value.
+s64
+atomic_exchange(s64 volatile &x, s64 value);
+
+// Stores `desired` if `x` holds `expected`. Returns true if it did.
+[[nodiscard]] bool
+atomic_compare_exchange(s64 volatile &x, s64 expected, s64 desired);
+
+// Returns the new value.
+s64
+atomic_add(s64 volatile &x, s64 value);
+
+// Orders every earlier load and store before every later one (including store->load).
+void
+atomic_fence();
+
+// Spin-wait hint.
+void
+cpu_pause();
+} // namespace rt
@@ -1,2 +1,5 @@
 #include "memory.cxx"
-#include "string.cxx"
\ No newline at end of file
+#include "string.cxx"
+#include "compression.cxx"
+#include "atomics.cxx"
+#include "jobs.cxx"
\ No newline at end of file
@@ -1,2 +1,5 @@
 #include "memory.hxx"
-#include "string.hxx"
\ No newline at end of file
+#include "string.hxx"
+#include "compression.hxx"
+#include "atomics.hxx"
+#include "jobs.hxx"
\ No newline at end of file
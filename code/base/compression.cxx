@@ -0,0 +1,535 @@
+namespace rt {
+namespace impl {
+s64 constexpr static LZ_MIN_MATCH     = 4;
+s64 constexpr static LZ_LAST_LITERALS = 5;  // The block always ends with literals...
+s64 constexpr static LZ_MF_LIMIT      = 12; // ...and the last match starts before this.
+s64 constexpr static LZ_MAX_OFFSET    = 65535;
+s32 constexpr static LZ_HASH_BITS     = 12;
+
+u32 constexpr static STORED_BLOCK_FLAG = 0x80000000;
+
+[[nodiscard]] u32
+read_u32(u8 const *p) {
+  u32 v;
+  mem_copy_(&v, p, sizeof(v));
+  return v;
+}
+
+[[nodiscard]] u32
+lz_hash(u32 sequence) {
+  return (sequence*2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+// Writes the 255-run of an extended length. Returns the new output pointer.
+[[nodiscard]] u8*
+write_length(u8 *op, s64 length) {
+  for (; length >= 255; length -= 255) {
+    *op++ = 255;
+  }
+  *op++ = (u8)length;
+  return op;
+}
+
+[[nodiscard]] u8*
+write_sequence(u8 *op, u8 const *literals, s64 literal_count, u16 offset, s64 match_length) {
+  u8 *token = op++;
+
+  // @Note: the last sequence has only literals (match_length == 0).
+  s64 const ml = (match_length > 0) ? match_length - LZ_MIN_MATCH : 0;
+  *token = (u8)(((literal_count < 15 ? literal_count : 15) << 4) | (ml < 15 ? ml : 15));
+
+  if (literal_count >= 15) {
+    op = write_length(op, literal_count - 15);
+  }
+
+  mem_copy_(op, literals, (u64)literal_count);
+  op += literal_count;
+
+  if (match_length == 0) {
+    return op;
+  }
+
+  op[0] = (u8)(offset & 0xff);
+  op[1] = (u8)(offset >> 8);
+  op += 2;
+
+  if (ml >= 15) {
+    op = write_length(op, ml - 15);
+  }
+
+  return op;
+}
+
+[[nodiscard]] s64
+sequence_bound(s64 literal_count, s64 match_length) {
+  return 1 + literal_count + literal_count/255 + 1 + 2 + match_length/255 + 1;
+}
+
+// @Note: returns false on malformed input.
+[[nodiscard]] bool
+read_length(u8 const *&ip, u8 const *iend, s64 &length) {
+  u8 b;
+  do {
+    if (ip >= iend) {
+      return false;
+    }
+    b = *ip++;
+    length += b;
+  } while (b == 255);
+
+  return true;
+}
+
+void
+write_u32(u8 *p, u32 v) {
+  mem_copy_(p, &v, sizeof(v));
+}
+} // namespace impl
+
+[[nodiscard]] s64
+compress_block_bound(s64 raw_size) {
+  return raw_size + raw_size/255 + 16;
+}
+
+[[nodiscard]] s64
+compress_block(Buffer src, Buffer dst) {
+  using namespace impl;
+  dbg_check_(src.count >= 0 && src.count <= COMPRESSION_BLOCK_SIZE);
+
+  u32 table[1 << LZ_HASH_BITS];
+  ::memset(table, 0, sizeof(table));
+
+  u8 const *const base   = src.bytes;
+  u8 const *const iend   = src.bytes + src.count;
+  u8 const       *ip     = src.bytes;
+  u8 const       *anchor = src.bytes;
+  u8             *op     = dst.bytes;
+  u8       *const oend   = dst.bytes + dst.count;
+
+  if (src.count > LZ_MF_LIMIT) {
+    u8 const *const match_limit  = iend - LZ_MF_LIMIT;
+    u8 const *const extend_limit = iend - LZ_LAST_LITERALS;
+    s64             misses       = 0;
+
+    while (ip < match_limit) {
+      u32 const sequence = read_u32(ip);
+      u32 const h        = lz_hash(sequence);
+      u8 const *match    = base + table[h];
+      table[h] = (u32)(ip - base);
+
+      bool const is_match = match < ip &&
+                            ip - match <= LZ_MAX_OFFSET &&
+                            read_u32(match) == sequence;
+
+      if (!is_match) {
+        // Skip faster over incompressible data.
+        ip += 1 + (misses++ >> 6);
+        continue;
+      }
+      misses = 0;
+
+      // Extend the match backwards over pending literals...
+      while (ip > anchor && match > base && ip[-1] == match[-1]) {
+        ip--;
+        match--;
+      }
+
+      // ...and forwards.
+      u8 const *mp = ip + LZ_MIN_MATCH;
+      u8 const *cp = match + LZ_MIN_MATCH;
+      while (mp < extend_limit && *mp == *cp) {
+        mp++;
+        cp++;
+      }
+
+      s64 const literal_count = ip - anchor;
+      s64 const match_length  = mp - ip;
+
+      if (oend - op < sequence_bound(literal_count, match_length)) {
+        return 0;
+      }
+
+      op = write_sequence(op, anchor, literal_count, (u16)(ip - match), match_length);
+
+      ip     = mp;
+      anchor = ip;
+
+      // @Note: remember a position inside the match too, it improves the ratio a lot.
+      if (ip - 2 > base && ip < match_limit) {
+        table[lz_hash(read_u32(ip - 2))] = (u32)(ip - 2 - base);
+      }
+    }
+  }
+
+  s64 const literal_count = iend - anchor;
+  if (oend - op < sequence_bound(literal_count, 0)) {
+    return 0;
+  }
+  op = write_sequence(op, anchor, literal_count, 0, 0);
+
+  return op - dst.bytes;
+}
+
+[[nodiscard]] s64
+decompress_block(Buffer src, Buffer dst) {
+  using namespace impl;
+
+  u8 const       *ip   = src.bytes;
+  u8 const *const iend = src.bytes + src.count;
+  u8             *op   = dst.bytes;
+  u8       *const oend = dst.bytes + dst.count;
+
+  while (ip < iend) {
+    u8 const token = *ip++;
+
+    s64 literal_count = token >> 4;
+    if (literal_count == 15 && !read_length(ip, iend, literal_count)) {
+      return -1;
+    }
+
+    if (literal_count > iend - ip || literal_count > oend - op) {
+      return -1;
+    }
+
+    // @Speed: short runs are copied with one fixed-size copy when there's slack.
+    if (literal_count <= 16 && iend - ip >= 16 && oend - op >= 16) {
+      mem_copy_(op, ip, 16);
+    } else {
+      mem_copy_(op, ip, (u64)literal_count);
+    }
+    op += literal_count;
+    ip += literal_count;
+
+    // The last sequence has no match.
+    if (ip == iend) {
+      break;
+    }
+
+    if (iend - ip < 2) {
+      return -1;
+    }
+    s64 const offset = (s64)ip[0] | ((s64)ip[1] << 8);
+    ip += 2;
+
+    s64 match_length = token & 15;
+    if (match_length == 15 && !read_length(ip, iend, match_length)) {
+      return -1;
+    }
+    match_length += LZ_MIN_MATCH;
+
+    if (offset == 0 || offset > op - dst.bytes || match_length > oend - op) {
+      return -1;
+    }
+
+    u8 const *match = op - offset;
+
+    if (offset >= 16 && oend - op >= match_length + 16) {
+      // Each 16-byte step reads only bytes written before it, even if the match 
+      // overlaps the output. May write up to 15 bytes past the match, which we checked
+      // we have room for.
+      u8 *const match_end = op + match_length;
+      while (op < match_end) {
+        mem_copy_(op, match, 16);
+        op    += 16;
+        match += 16;
+      }
+      op = match_end;
+    } else if (offset >= match_length) {
+      mem_copy_(op, match, (u64)match_length);
+      op += match_length;
+    } else if (offset >= 8 && oend - op >= match_length + 8) {
+      u8 *const match_end = op + match_length;
+      while (op < match_end) {
+        mem_copy_(op, match, 8);
+        op    += 8;
+        match += 8;
+      }
+      op = match_end;
+    } else {
+      // Short repeating pattern (e.g. a run of one byte).
+      for (s64 i = 0; i < match_length; i++) {
+        op[i] = match[i];
+      }
+      op += match_length;
+    }
+  }
+
+  return op - dst.bytes;
+}
+
+namespace impl {
+void
+emit_stream_block(Compressor &compressor, Buffer raw) {
+  s64 packed_count = compress_block(raw, {
+    .count = compressor.packed.count - 8,
+    .bytes = compressor.packed.bytes + 8
+  });
+
+  u32 packed_size = (u32)packed_count;
+
+  // Not worth it -- store the block as is.
+  if (packed_count == 0 || packed_count >= raw.count) {
+    mem_copy_(compressor.packed.bytes + 8, raw.bytes, (u64)raw.count);
+    packed_count = raw.count;
+    packed_size  = (u32)raw.count | STORED_BLOCK_FLAG;
+  }
+
+  write_u32(compressor.packed.bytes + 0, packed_size);
+  write_u32(compressor.packed.bytes + 4, (u32)raw.count);
+
+  Buffer const chunk = {.count = 8 + packed_count, .bytes = compressor.packed.bytes};
+  compressor.sink(chunk, compressor.user_data);
+
+  compressor.raw_size    += raw.count;
+  compressor.packed_size += chunk.count;
+}
+} // namespace impl
+
+[[nodiscard]] Compressor
+compressor_begin(Compression_Sink *sink, void *user_data) {
+  check_(sink);
+
+  s64 const packed_capacity = 8 + compress_block_bound(COMPRESSION_BLOCK_SIZE);
+
+  Compressor compressor = {
+    .sink        = sink,
+    .user_data   = user_data,
+    .staging     = {.count = COMPRESSION_BLOCK_SIZE, .bytes = (u8*)alloc_perm(COMPRESSION_BLOCK_SIZE)},
+    .staged      = 0,
+    .packed      = {.count = packed_capacity, .bytes = (u8*)alloc_perm(packed_capacity)},
+    .raw_size    = 0,
+    .packed_size = sizeof(Compressed_Stream_Header)
+  };
+
+  Compressed_Stream_Header const header = {
+    .magic      = COMPRESSION_MAGIC,
+    .block_size = (u32)COMPRESSION_BLOCK_SIZE
+  };
+  sink({.count = sizeof(header), .bytes = (u8*)&header}, user_data);
+
+  return compressor;
+}
+
+void
+compressor_write(Compressor &compressor, Buffer raw) {
+  check_(compressor.sink);
+
+  u8 const *src       = raw.bytes;
+  s64       remaining = raw.count;
+
+  while (remaining > 0) {
+    // Full blocks are compressed straight from the source, without staging.
+    if (compressor.staged == 0 && remaining >= COMPRESSION_BLOCK_SIZE) {
+      impl::emit_stream_block(compressor, {.count = COMPRESSION_BLOCK_SIZE, .bytes = (u8*)src});
+      src       += COMPRESSION_BLOCK_SIZE;
+      remaining -= COMPRESSION_BLOCK_SIZE;
+      continue;
+    }
+
+    s64 const space = COMPRESSION_BLOCK_SIZE - compressor.staged;
+    s64 const count = remaining < space ? remaining : space;
+
+    mem_copy_(compressor.staging.bytes + compressor.staged, src, (u64)count);
+    compressor.staged += count;
+    src               += count;
+    remaining         -= count;
+
+    if (compressor.staged == COMPRESSION_BLOCK_SIZE) {
+      impl::emit_stream_block(compressor, compressor.staging);
+      compressor.staged = 0;
+    }
+  }
+}
+
+void
+compressor_end(Compressor &compressor) {
+  check_(compressor.sink);
+
+  if (compressor.staged > 0) {
+    impl::emit_stream_block(compressor, {.count = compressor.staged, .bytes = compressor.staging.bytes});
+    compressor.staged = 0;
+  }
+
+  u8 end_marker[8] = {};
+  compressor.sink({.count = sizeof(end_marker), .bytes = end_marker}, compressor.user_data);
+  compressor.packed_size += sizeof(end_marker);
+
+  free_perm(compressor.staging.bytes);
+  free_perm(compressor.packed.bytes);
+  compressor.staging = {};
+  compressor.packed  = {};
+  compressor.sink    = NULL;
+}
+
+[[nodiscard]] s64
+compress_stream_bound(s64 raw_size) {
+  s64 const block_count = (raw_size + COMPRESSION_BLOCK_SIZE - 1)/COMPRESSION_BLOCK_SIZE;
+  return sizeof(Compressed_Stream_Header) + block_count*8 + raw_size + 8;
+}
+
+namespace impl {
+struct Buffer_Sink {
+  Buffer dst;
+  s64    written;
+  bool   overflowed; // Further chunks are dropped.
+};
+
+void
+buffer_sink(Buffer chunk, void *user_data) {
+  Buffer_Sink &sink = *(Buffer_Sink*)user_data;
+
+  if (sink.overflowed || chunk.count > sink.dst.count - sink.written) {
+    sink.overflowed = true;
+    return;
+  }
+
+  mem_copy_(sink.dst.bytes + sink.written, chunk.bytes, (u64)chunk.count);
+  sink.written += chunk.count;
+}
+} // namespace impl
+
+[[nodiscard]] s64
+compress_stream(Buffer raw, Buffer dst) {
+  if (dst.count < compress_stream_bound(raw.count)) {
+    return 0;
+  }
+
+  impl::Buffer_Sink sink = {.dst = dst, .written = 0, .overflowed = false};
+
+  Compressor compressor = compressor_begin(impl::buffer_sink, &sink);
+  compressor_write(compressor, raw);
+  compressor_end(compressor);
+
+  return sink.overflowed ? 0 : sink.written;
+}
+
+namespace impl {
+enum Stream_Read {
+  StreamRead_Block = 0,
+  StreamRead_End,
+  StreamRead_Corrupted
+};
+
+// Returns the offset of the first block, or -1 if the header is wrong.
+[[nodiscard]] s64
+read_stream_header(Buffer stream, u32 &block_size) {
+  Compressed_Stream_Header header;
+  if (stream.count < (s64)sizeof(header)) {
+    return -1;
+  }
+
+  mem_copy_(&header, stream.bytes, sizeof(header));
+  if (header.magic != COMPRESSION_MAGIC || header.block_size > COMPRESSION_BLOCK_SIZE) {
+    return -1;
+  }
+
+  block_size = header.block_size;
+  return sizeof(header);
+}
+
+// Reads the block at `offset` and moves `offset` past it. Fills everything but the
+// raw offset.
+[[nodiscard]] Stream_Read
+read_stream_block(Buffer stream, u32 block_size, s64 &offset, Compressed_Block &block) {
+  if (stream.count - offset < 8) {
+    return StreamRead_Corrupted;
+  }
+
+  u32 const packed_size = read_u32(stream.bytes + offset);
+  u32 const raw_size    = read_u32(stream.bytes + offset + 4);
+  offset += 8;
+
+  if (packed_size == 0 && raw_size == 0) {
+    return StreamRead_End;
+  }
+
+  bool const is_stored = (packed_size & STORED_BLOCK_FLAG) != 0;
+  s64  const packed    = packed_size & ~STORED_BLOCK_FLAG;
+
+  if (packed > stream.count - offset || raw_size > block_size ||
+      (is_stored && packed != raw_size)) {
+    return StreamRead_Corrupted;
+  }
+
+  block = {
+    .packed     = {.count = packed, .bytes = stream.bytes + offset},
+    .raw_offset = 0,
+    .raw_size   = raw_size,
+    .is_stored  = is_stored
+  };
+
+  offset += packed;
+  return StreamRead_Block;
+}
+} // namespace impl
+
+[[nodiscard]] s64
+compressed_stream_index(Buffer stream, Compressed_Block *blocks, s64 max_blocks,
+                        s64 &raw_size) {
+  raw_size = 0;
+
+  u32 block_size;
+  s64 offset = impl::read_stream_header(stream, block_size);
+  if (offset < 0) {
+    return -1;
+  }
+
+  for (s64 block_count = 0;; block_count++) {
+    Compressed_Block block;
+    switch (impl::read_stream_block(stream, block_size, offset, block)) {
+      case impl::StreamRead_End:       return block_count;
+      case impl::StreamRead_Corrupted: return -1;
+      case impl::StreamRead_Block:     break;
+    }
+
+    block.raw_offset = raw_size;
+    raw_size        += block.raw_size;
+
+    if (blocks && block_count < max_blocks) {
+      blocks[block_count] = block;
+    }
+  }
+}
+
+[[nodiscard]] bool
+decompress_stream_block(Compressed_Block const &block, Buffer raw) {
+  if (block.raw_offset + block.raw_size > raw.count) {
+    return false;
+  }
+
+  Buffer const dst = {.count = block.raw_size, .bytes = raw.bytes + block.raw_offset};
+
+  if (block.is_stored) {
+    mem_copy_(dst.bytes, block.packed.bytes, (u64)block.raw_size);
+    return true;
+  }
+
+  return decompress_block(block.packed, dst) == block.raw_size;
+}
+
+[[nodiscard]] bool
+decompress_stream(Buffer stream, Buffer raw) {
+  u32 block_size;
+  s64 offset = impl::read_stream_header(stream, block_size);
+  if (offset < 0) {
+    return false;
+  }
+
+  s64 raw_offset = 0;
+  for (;;) {
+    Compressed_Block block;
+    switch (impl::read_stream_block(stream, block_size, offset, block)) {
+      case impl::StreamRead_End:       return raw_offset == raw.count;
+      case impl::StreamRead_Corrupted: return false;
+      case impl::StreamRead_Block:     break;
+    }
+
+    block.raw_offset = raw_offset;
+    raw_offset      += block.raw_size;
+
+    if (!decompress_stream_block(block, raw)) {
+      return false;
+    }
+  }
+}
+} // namespace rt
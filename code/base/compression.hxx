@@ -0,0 +1,99 @@
+/**
+ * Fast LZ77 block compression. The block format is the LZ4 one (token, literals, 16-bit
+ * offset, match length), which trades ratio for decompression running at memory speed.
+ *
+ * Streams are split into blocks of up to COMPRESSION_BLOCK_SIZE raw bytes that don't
+ * reference each other, so they can be decoded in parallel:
+ *
+ *   Compressed_Stream_Header
+ *   { u32 packed_size (top bit: stored raw), u32 raw_size, payload } * N
+ *   { 0, 0 }  -- end marker
+*/
+
+namespace rt {
+s64 constexpr static COMPRESSION_BLOCK_SIZE = RT_KILOBYTES(256);
+u32 constexpr static COMPRESSION_MAGIC      = 0x5a4c5452; // "RTLZ"
+
+struct Compressed_Stream_Header {
+  u32 magic;
+  u32 block_size;
+};
+
+/**
+ * Blocks
+*/
+
+// Worst-case size of a compressed block.
+[[nodiscard]] s64
+compress_block_bound(s64 raw_size);
+
+// Returns the compressed size, or 0 if it doesn't fit into `dst`.
+[[nodiscard]] s64
+compress_block(Buffer src, Buffer dst);
+
+// Returns the decompressed size, or -1 if the input is corrupted or doesn't fit.
+[[nodiscard]] s64
+decompress_block(Buffer src, Buffer dst);
+
+/**
+ * Streams
+*/
+
+// Receives the compressed stream piece by piece (e.g. to write it to a file).
+using Compression_Sink = void(Buffer chunk, void *user_data);
+
+struct Compressor {
+  Compression_Sink *sink;
+  void             *user_data;
+
+  Buffer staging; // Raw data waiting to become a full block.
+  s64    staged;
+  Buffer packed;  // Scratch for the compressed block.
+
+  s64 raw_size;
+  s64 packed_size; // Including headers.
+};
+
+[[nodiscard]] Compressor
+compressor_begin(Compression_Sink *sink, void *user_data);
+
+void
+compressor_write(Compressor &compressor, Buffer raw);
+
+// Emits the last block and the end marker, and frees the scratch memory.
+void
+compressor_end(Compressor &compressor);
+
+// Worst-case size of a compressed stream.
+[[nodiscard]] s64
+compress_stream_bound(s64 raw_size);
+
+// Compresses `raw` into a stream in `dst`. Returns the stream size, or 0 if `dst` is
+// smaller than compress_stream_bound.
+[[nodiscard]] s64
+compress_stream(Buffer raw, Buffer dst);
+
+struct Compressed_Block {
+  Buffer packed;
+  s64    raw_offset;
+  s64    raw_size;
+  bool   is_stored; // Payload is the raw data.
+};
+
+// Walks the block headers. If `blocks` isn't NULL, fills up to `max_blocks` entries.
+// Returns the number of blocks, or -1 if the stream is corrupted. The decompressed
+// size is written to `raw_size`.
+[[nodiscard]] s64
+compressed_stream_index(Buffer stream, Compressed_Block *blocks, s64 max_blocks,
+                        s64 &raw_size);
+
+// Decodes one block into its place in `raw`. Blocks are independent, so this can be
+// called from many threads at once.
+[[nodiscard]] bool
+decompress_stream_block(Compressed_Block const &block, Buffer raw);
+
+// Sequential decode of a whole stream. `raw` must have the size reported by
+// compressed_stream_index. Returns false if the stream is corrupted.
+[[nodiscard]] bool
+decompress_stream(Buffer stream, Buffer raw);
+} // namespace rt
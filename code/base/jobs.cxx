@@ -0,0 +1,332 @@
+namespace rt {
+static_assert((JOBS_DEQUE_CAPACITY & (JOBS_DEQUE_CAPACITY - 1)) == 0);
+
+namespace impl {
+struct Queued_Job {
+  Job          job;
+  Job_Counter *counter;
+};
+
+// @Note: top and bottom live on separate cache lines. Thieves hammer the first one,
+//        the owner the second.
+struct Job_Deque {
+  alignas(64) s64 volatile top;    // Next job to steal.
+  alignas(64) s64 volatile bottom; // One past the owner's newest job.
+  alignas(64) Queued_Job   jobs[JOBS_DEQUE_CAPACITY];
+};
+} // namespace impl
+
+struct Jobs_State {
+  impl::Job_Deque *deques; // One per thread.
+  void            *deques_allocation;
+  s32              thread_count;
+
+  Thread    workers[JOBS_MAX_THREADS]; // [0] is unused, thread 0 is the caller of init_jobs.
+  Semaphore wake;
+
+  s64 volatile sleeping; // Workers waiting (or about to wait) on `wake`.
+  s64 volatile quit;
+} static gJobs;
+
+struct Job_Thread {
+  s32 index;
+  u32 rng; // Picks the first victim to steal from.
+} static thread_local gJob_Thread;
+
+namespace impl {
+// Owner only. Returns false if the deque is full.
+[[nodiscard]] bool
+push_job(Job_Deque &deque, Queued_Job const &job) {
+  s64 const bottom = atomic_load(deque.bottom);
+  s64 const top    = atomic_load(deque.top);
+  if (bottom - top >= JOBS_DEQUE_CAPACITY) {
+    return false;
+  }
+
+  deque.jobs[bottom & (JOBS_DEQUE_CAPACITY - 1)] = job;
+  atomic_store(deque.bottom, bottom + 1); // Publishes the job.
+  return true;
+}
+
+// Owner only.
+[[nodiscard]] bool
+pop_job(Job_Deque &deque, Queued_Job &job) {
+  s64 const bottom = atomic_load(deque.bottom) - 1;
+
+  // @Note: the exchange is a full barrier. The store to `bottom` has to be visible
+  //        before we read `top`, or we and a thief could both take the last job.
+  atomic_exchange(deque.bottom, bottom);
+  s64 const top = atomic_load(deque.top);
+
+  if (top > bottom) {
+    atomic_store(deque.bottom, bottom + 1); // Empty.
+    return false;
+  }
+
+  job = deque.jobs[bottom & (JOBS_DEQUE_CAPACITY - 1)];
+  if (top < bottom) {
+    return true;
+  }
+
+  // Last job: race the thieves for it.
+  bool const won = atomic_compare_exchange(deque.top, top, top + 1);
+  atomic_store(deque.bottom, bottom + 1);
+  return won;
+}
+
+// Any thread. Fails if the deque is empty or another thread got there first.
+[[nodiscard]] bool
+steal_job(Job_Deque &deque, Queued_Job &job) {
+  // @Note: x64 doesn't reorder loads with other loads, so the compiler barriers in
+  //        atomic_load are all the ordering we need between these two.
+  s64 const top    = atomic_load(deque.top);
+  s64 const bottom = atomic_load(deque.bottom);
+  if (top >= bottom) {
+    return false;
+  }
+
+  // @Note: the copy may be torn if the slot gets reused meanwhile, but then `top` has
+  //        moved and the exchange fails.
+  job = deque.jobs[top & (JOBS_DEQUE_CAPACITY - 1)];
+  return atomic_compare_exchange(deque.top, top, top + 1);
+}
+
+[[nodiscard]] bool
+find_job(Queued_Job &job) {
+  s32 const self = gJob_Thread.index;
+  if (pop_job(gJobs.deques[self], job)) {
+    return true;
+  }
+
+  s32 const count = gJobs.thread_count;
+  if (count <= 1) {
+    return false;
+  }
+
+  // @Note: xorshift32. Starting at a random victim keeps the thieves from all
+  //        lining up on the same deque.
+  u32 x = gJob_Thread.rng;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  gJob_Thread.rng = x;
+
+  s32 const first = (s32)(x % (u32)count);
+  for (s32 i = 0; i < count; i++) {
+    s32 const victim = (first + i) % count;
+    if (victim != self && steal_job(gJobs.deques[victim], job)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+run_job(Queued_Job const &job) {
+  job.job.fn(job.job.data);
+  atomic_add(job.counter->pending, -1);
+}
+
+void
+wake_workers(s64 job_count) {
+  // @Note: pairs with the worker announcing itself in `sleeping` before its last look
+  //        at the deques. One of us is guaranteed to see the other.
+  atomic_fence();
+
+  s64 const sleeping = atomic_load(gJobs.sleeping);
+  if (sleeping > 0) {
+    os_signal_semaphore(gJobs.wake, (s32)((job_count < sleeping) ? job_count : sleeping));
+  }
+}
+
+void
+worker_main(void *data) {
+  gJob_Thread.index = (s32)(s64)data;
+  gJob_Thread.rng   = 0x9E3779B9u*(u32)(gJob_Thread.index + 1);
+
+  if (!init_memory(JOBS_TEMP_MEM_SIZE)) {
+    errf("init_memory failed on job worker %d", gJob_Thread.index);
+  }
+
+  s32 idle_spins = 0;
+  while (!atomic_load(gJobs.quit)) {
+    Queued_Job job;
+    if (find_job(job)) {
+      run_job(job);
+      idle_spins = 0;
+      continue;
+    }
+
+    if (idle_spins < JOBS_SPIN_COUNT) {
+      idle_spins++;
+      cpu_pause();
+      continue;
+    }
+
+    atomic_add(gJobs.sleeping, 1);
+    bool const found = find_job(job);
+    if (!found) {
+      os_wait_semaphore(gJobs.wake);
+    }
+    atomic_add(gJobs.sleeping, -1);
+
+    if (found) {
+      run_job(job);
+    }
+    idle_spins = 0;
+  }
+
+  shutdown_memory();
+}
+
+struct Parallel_For_Batch {
+  Parallel_For_Fn *fn;
+  void            *data;
+  s64              begin;
+  s64              end;
+};
+
+void
+run_parallel_for_batch(void *data) {
+  Parallel_For_Batch const &batch = *(Parallel_For_Batch*)data;
+  batch.fn(batch.data, batch.begin, batch.end);
+}
+} // namespace impl
+
+void
+init_jobs(s32 thread_count) {
+  dbg_check_(!gJobs.deques);
+
+  if (thread_count <= 0) {
+    thread_count = os_get_cpu_info().logical_cores;
+  }
+  thread_count = (thread_count < 1) ? 1 : thread_count;
+  thread_count = (thread_count > JOBS_MAX_THREADS) ? JOBS_MAX_THREADS : thread_count;
+
+  // @Note: malloc only aligns to 16 bytes, the deques want whole cache lines.
+  s64 const deques_size = thread_count*sizeof(impl::Job_Deque) + alignof(impl::Job_Deque);
+  gJobs.deques_allocation = alloc_perm(deques_size);
+  gJobs.deques = (impl::Job_Deque*)(((u64)gJobs.deques_allocation + alignof(impl::Job_Deque) - 1) &
+                                    ~(u64)(alignof(impl::Job_Deque) - 1));
+  gJobs.thread_count = thread_count;
+  gJobs.wake         = os_create_semaphore_or_panic(0);
+
+  gJob_Thread = {.index = 0, .rng = 0x9E3779B9u};
+
+  for (s32 i = 1; i < thread_count; i++) {
+    char name[32];
+    ::snprintf(name, sizeof(name), "Job worker %d", i);
+    gJobs.workers[i] = os_create_thread_or_panic(impl::worker_main, (void*)(s64)i, name);
+  }
+
+  logf("Job system: %d threads\n", thread_count);
+}
+
+void
+shutdown_jobs() {
+  dbg_check_(gJob_Thread.index == 0);
+
+  atomic_store(gJobs.quit, 1);
+  if (gJobs.thread_count > 1) {
+    os_signal_semaphore(gJobs.wake, gJobs.thread_count - 1);
+  }
+  for (s32 i = 1; i < gJobs.thread_count; i++) {
+    os_join_thread(gJobs.workers[i]);
+  }
+
+  os_destroy_semaphore(gJobs.wake);
+  free_perm(gJobs.deques_allocation);
+
+  gJobs.deques            = NULL;
+  gJobs.deques_allocation = NULL;
+  gJobs.thread_count      = 0;
+  gJobs.sleeping          = 0;
+  gJobs.quit              = 0;
+}
+
+[[nodiscard]] s32
+jobs_thread_count() {
+  return gJobs.thread_count;
+}
+
+[[nodiscard]] s32
+jobs_thread_index() {
+  return gJob_Thread.index;
+}
+
+void
+submit_jobs(Job const *jobs, s64 count, Job_Counter &counter) {
+  dbg_check_(count >= 0);
+
+  atomic_add(counter.pending, count);
+
+  // @Note: without init_jobs (tools, checks) there are no deques, run everything here.
+  if (!gJobs.deques) {
+    for (s64 i = 0; i < count; i++) {
+      impl::run_job({.job = jobs[i], .counter = &counter});
+    }
+    return;
+  }
+
+  impl::Job_Deque &deque = gJobs.deques[gJob_Thread.index];
+  for (s64 i = 0; i < count; i++) {
+    impl::Queued_Job const job = {.job = jobs[i], .counter = &counter};
+    if (!impl::push_job(deque, job)) {
+      impl::run_job(job);
+    }
+  }
+
+  impl::wake_workers(count);
+}
+
+void
+wait_for_jobs(Job_Counter &counter) {
+  s32 idle_spins = 0;
+  while (atomic_load(counter.pending) > 0) {
+    impl::Queued_Job job;
+    if (impl::find_job(job)) {
+      impl::run_job(job);
+      idle_spins = 0;
+    } else if (idle_spins < JOBS_SPIN_COUNT) {
+      idle_spins++;
+      cpu_pause();
+    } else {
+      // @Note: the jobs we wait for run elsewhere. Don't steal their thread's time
+      //        slice if there are more threads than cores.
+      os_yield_thread();
+    }
+  }
+}
+
+void
+parallel_for(s64 count, s64 batch_size, Parallel_For_Fn *fn, void *data) {
+  dbg_check_(batch_size > 0);
+  if (count <= 0) {
+    return;
+  }
+
+  s64 const batch_count = (count + batch_size - 1)/batch_size;
+  if (batch_count == 1 || gJobs.thread_count <= 1) {
+    fn(data, 0, count);
+    return;
+  }
+
+  s64 const temp_size = batch_count*(sizeof(impl::Parallel_For_Batch) + sizeof(Job));
+  impl::Parallel_For_Batch *batches = (impl::Parallel_For_Batch*)alloc_temp(temp_size);
+  Job                      *jobs    = (Job*)(batches + batch_count);
+
+  for (s64 i = 0; i < batch_count; i++) {
+    s64 const begin = i*batch_size;
+    s64 const end   = (begin + batch_size < count) ? begin + batch_size : count;
+
+    batches[i] = {.fn = fn, .data = data, .begin = begin, .end = end};
+    jobs[i]    = {.fn = impl::run_parallel_for_batch, .data = &batches[i]};
+  }
+
+  Job_Counter counter = {};
+  submit_jobs(jobs, batch_count, counter);
+  wait_for_jobs(counter);
+
+  pop_temp_mem_mark(temp_size);
+}
+} // namespace rt
@@ -0,0 +1,64 @@
+/**
+ * Work-stealing job system. Every thread, the main one included, owns a Chase-Lev
+ * deque. The owner pushes and pops jobs at the bottom (LIFO, so what it just split off
+ * is still in its cache). Idle threads steal from the top of the other deques (FIFO,
+ * so they take the oldest -- usually the biggest -- pieces of work). Uneven jobs
+ * balance themselves without any static partitioning.
+ *
+ * Jobs may submit jobs and wait for them. Waiting doesn't block, the thread runs
+ * other jobs (its own first) until the counter drops to zero.
+ *
+ * Workers have their own temp memory (JOBS_TEMP_MEM_SIZE), so alloc_temp and tprint
+ * are safe in jobs. A job must pop what it allocates before it returns: while a thread
+ * waits, it runs other jobs on top of its temp memory.
+ *
+ *    Job_Counter counter = {};
+ *    submit_jobs(jobs, job_count, counter);
+ *    wait_for_jobs(counter);
+*/
+
+namespace rt {
+using Job_Fn = void(void *data);
+
+struct Job {
+  Job_Fn *fn;
+  void   *data;
+};
+
+// Number of submitted jobs that haven't finished yet.
+struct Job_Counter {
+  s64 volatile pending;
+};
+
+// Starts `thread_count - 1` workers; the calling thread becomes thread 0. Pass 0 to
+// use every logical core.
+void
+init_jobs(s32 thread_count = 0);
+
+// Call from thread 0 once no jobs are in flight.
+void
+shutdown_jobs();
+
+[[nodiscard]] s32
+jobs_thread_count();
+
+// 0 on the thread that called init_jobs, [1, jobs_thread_count()) on the workers.
+[[nodiscard]] s32
+jobs_thread_index();
+
+// Queues the jobs on the calling thread's deque. Jobs that don't fit are run right away,
+// and so are all of them if init_jobs wasn't called.
+void
+submit_jobs(Job const *jobs, s64 count, Job_Counter &counter);
+
+// Runs jobs until every job counted by `counter` is done.
+void
+wait_for_jobs(Job_Counter &counter);
+
+// Calls fn(data, begin, end) over [0, count) in ranges of up to `batch_size`, spread
+// over every thread. Returns when all of them are done.
+using Parallel_For_Fn = void(void *data, s64 begin, s64 end);
+
+void
+parallel_for(s64 count, s64 batch_size, Parallel_For_Fn *fn, void *data);
+} // namespace rt
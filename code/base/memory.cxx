@@ -2,24 +2,32 @@ namespace rt {
 struct Memory_State {
   Buffer temp_memory;
   s64 temp_mark;
-} static gMemory_State;
+} static thread_local gMemory_State;
 
 [[nodiscard]] bool
-init_memory() {
-  void *temp_memory_from_system = ::malloc(TEMP_MEM_SIZE);
+init_memory(s64 temp_size) {
+  dbg_check_(temp_size > 0);
+
+  void *temp_memory_from_system = ::malloc(temp_size);
   dbg_check_(temp_memory_from_system);
   if (!temp_memory_from_system) {
     return false;
   }
 
-  ::memset(temp_memory_from_system, 0, TEMP_MEM_SIZE);
+  ::memset(temp_memory_from_system, 0, temp_size);
 
-  gMemory_State.temp_memory.count = TEMP_MEM_SIZE;
+  gMemory_State.temp_memory.count = temp_size;
   gMemory_State.temp_memory.bytes = (u8*)temp_memory_from_system;
 
   return true;
 }
 
+void
+shutdown_memory() {
+  ::free(gMemory_State.temp_memory.bytes);
+  gMemory_State = {};
+}
+
 [[nodiscard]] void* 
 alloc_perm(s64 size) {
   dbg_check_(size > 0);
@@ -33,12 +41,17 @@ alloc_perm(s64 size) {
   return mem;
 }
 
+void
+free_perm(void *mem) {
+  ::free(mem);
+}
+
 [[nodiscard]] void* 
 alloc_temp(s64 size) {
   dbg_check_(size > 0);
-  dbg_check_(gMemory_State.temp_mark + size < TEMP_MEM_SIZE);
+  dbg_check_(gMemory_State.temp_mark + size < gMemory_State.temp_memory.count);
 
-  if (gMemory_State.temp_mark + size > TEMP_MEM_SIZE) {
+  if (gMemory_State.temp_mark + size > gMemory_State.temp_memory.count) {
     return alloc_perm(size);
   }
 
@@ -66,4 +79,45 @@ void
 clear_temp_mem() {
   ::memset(gMemory_State.temp_memory.bytes, 0, gMemory_State.temp_mark);
 }
+
+[[nodiscard]] Arena
+arena_create(s64 capacity) {
+  dbg_check_(capacity > 0);
+
+  // @Note: not alloc_perm, arenas may be large and don't need to be cleared.
+  void *mem = ::malloc(capacity);
+  if (!mem) {
+    errf("::malloc failed, size=%lld", capacity);
+  }
+
+  return {.base = (u8*)mem, .capacity = capacity, .used = 0};
+}
+
+void
+arena_destroy(Arena &arena) {
+  ::free(arena.base);
+  arena = {};
+}
+
+[[nodiscard]] void*
+arena_alloc(Arena &arena, s64 size, s64 alignment) {
+  dbg_check_(size >= 0);
+  dbg_check_(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+  // @Note: align the address, not the offset. The base is only 16-byte aligned.
+  u64 const address = ((u64)(arena.base + arena.used) + alignment - 1) & ~(u64)(alignment - 1);
+  s64 const offset  = (s64)(address - (u64)arena.base);
+  if (offset + size > arena.capacity) {
+    errf("Arena is full (capacity: %lld, used: %lld, requested: %lld)",
+         arena.capacity, arena.used, size);
+  }
+
+  arena.used = offset + size;
+  return arena.base + offset;
+}
+
+void
+arena_reset(Arena &arena) {
+  arena.used = 0;
+}
 } // namespace rt
\ No newline at end of file
@@ -7,8 +7,13 @@
 
 namespace rt {
 
+// Temp memory is per thread: every thread that allocates it calls init_memory first
+// (the job system does it for its workers) and shutdown_memory before it exits.
 [[nodiscard]] bool
-init_memory();
+init_memory(s64 temp_size = TEMP_MEM_SIZE);
+
+void
+shutdown_memory();
 
 [[nodiscard]] void* 
 alloc_perm(s64 size);
@@ -16,6 +21,10 @@ alloc_perm(s64 size);
 [[nodiscard]] void* 
 alloc_temp(s64 size);
 
+// Gives back memory from alloc_perm. Only for large, short-lived allocations.
+void
+free_perm(void *mem);
+
 [[nodiscard]] s64
 get_temp_mem_mark();
 
@@ -25,4 +34,27 @@ pop_temp_mem_mark(s64 size);
 
 void 
 clear_temp_mem();
+
+// Bump allocator for data that is freed all at once, like an acceleration structure
+// or the scratch memory of its build. The capacity is fixed when the arena is created
+// and running out of it is a fatal error.
+struct Arena {
+  u8 *base;
+  s64 capacity;
+  s64 used;
+};
+
+[[nodiscard]] Arena
+arena_create(s64 capacity);
+
+void
+arena_destroy(Arena &arena);
+
+// Not cleared. `alignment` must be a power of two.
+[[nodiscard]] void*
+arena_alloc(Arena &arena, s64 size, s64 alignment = 16);
+
+// Frees everything allocated from the arena, keeps its memory.
+void
+arena_reset(Arena &arena);
 } // namespace rt
\ No newline at end of file
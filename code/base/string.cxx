@@ -102,4 +102,16 @@ as_cstr(String string) {
 
   return buff;
 }
+
+[[nodiscard]] u64
+string_hash(String string) {
+  u64 hash = 0xcbf29ce484222325ull;
+
+  for (s64 i = 0; i < string.count; i++) {
+    hash ^= (u8)string.data[i];
+    hash *= 0x100000001b3ull;
+  }
+
+  return hash;
+}
 } // namespace rt
\ No newline at end of file
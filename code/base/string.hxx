@@ -28,4 +28,8 @@ tprint(char const *fmt, TArgs ...args);
 
 [[nodiscard]] char*
 as_cstr(String string);
+
+// 64-bit FNV-1a. Not cryptographic, but stable across runs, so it can be stored in files.
+[[nodiscard]] u64
+string_hash(String string);
 } // namespace rt
\ No newline at end of file
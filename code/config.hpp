@@ -10,4 +10,47 @@ bool constexpr static       VSYNC = true;
 
 s64 constexpr static TEMP_MEM_SIZE = RT_MEGABYTES(8);
 s64 constexpr static IM_TRIS_COUNT = 1024;
+
+s32 constexpr static ASYNC_IO_MAX_IN_FLIGHT = 256;
+s64 constexpr static ASSET_PACK_READ_AHEAD  = RT_MEGABYTES(64); // Bytes of files read ahead while packing.
+
+s64 constexpr static FILE_WRITER_BUFFER_SIZE      = RT_MEGABYTES(8);
+s64 constexpr static FILE_WRITER_DIRECT_ALIGNMENT = RT_KILOBYTES(4); // Sector size.
+
+s32 constexpr static FILE_WATCHER_MAX_SUBSCRIPTIONS = 64;
+f32 constexpr static FILE_WATCHER_DEBOUNCE          = 0.1f; // Seconds.
+
+s32 constexpr static JOBS_MAX_THREADS    = 128;
+s32 constexpr static JOBS_DEQUE_CAPACITY = 4096;             // Per thread, a power of two.
+s32 constexpr static JOBS_SPIN_COUNT     = 1024;             // Idle spins before sleeping.
+s64 constexpr static JOBS_TEMP_MEM_SIZE  = RT_MEGABYTES(2);  // Per worker thread.
+
+f32 constexpr static MATH_BENCHMARK_TIME = 0.05f; // Seconds per benchmark.
+
+s32 constexpr static RENDER_WIDTH          = 640;
+s32 constexpr static RENDER_HEIGHT         = 360;
+s32 constexpr static RENDER_SPP            = 16;
+s32 constexpr static RENDER_TILE_SIZE      = 16;    // Pixels. One job per tile.
+s32 constexpr static RENDER_MAX_DEPTH      = 8;
+s32 constexpr static RENDER_ROULETTE_DEPTH = 3;     // Bounces before Russian roulette.
+f32 constexpr static RENDER_RAY_EPSILON    = 1e-3f; // Keeps bounces off their own surface.
+
+f32 constexpr static RENDER_FRAME_BUDGET        = 0.014f; // Seconds of rendering per frame.
+s32 constexpr static RENDER_PROGRESSIVE_MAX_SPP = 4096;   // Converged, stop rendering.
+
+s32 constexpr static BVH_BIN_COUNT             = 16;      // Per axis. The splits are between the bins.
+s32 constexpr static BVH_MAX_LEAF_SIZE         = 8;       // Primitives. Bigger nodes are always split.
+s32 constexpr static BVH_MAX_DEPTH             = 64;      // Size of the traversal stack.
+f32 constexpr static BVH_TRAVERSAL_COST        = 0.125f;  // Of a node, relative to a primitive test.
+s32 constexpr static BVH_PARALLEL_SUBTREE_SIZE = 8192;    // Primitives. Smaller nodes are built by one thread.
+s32 constexpr static BVH_PARALLEL_BATCH_SIZE   = 32768;   // Primitives per job when binning big nodes.
+s32 constexpr static BVH_LBVH_MORTON30_MAX     = 1 << 20; // Primitives. More get 63-bit codes.
+s32 constexpr static BVH_TREELET_LEAVES        = 7;       // Optimal topology over 2^7 subsets.
+s32 constexpr static BVH_TREELET_MIN_SIZE      = 32;      // Primitives under a node to optimize its treelet.
+s32 constexpr static BVH_REFIT_TASK_DEPTH      = 6;       // Levels of the tree refit in parallel.
+f32 constexpr static BVH_REFIT_MAX_DEGRADATION = 1.5f;    // Of the SAH cost. Past it, rebuild.
+s32 constexpr static BVH_BENCHMARK_TRIS        = 1000000;
+s32 constexpr static BVH_BENCHMARK_RAYS        = 1000000;
+s32 constexpr static BVH_BENCHMARK_CHECK       = 256;     // Rays also traced brute force.
+s32 constexpr static BVH_BENCHMARK_FRAMES      = 16;      // Of moving geometry.
 } // namespace rt
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <cfloat>
 #include <cmath>
 #include <stdarg.h> // logf
+#include <intrin.h> // __cpuidex, _xgetbv, SIMD intrinsics
 
 #include "first.hpp"
 
@@ -11,6 +12,8 @@
 #include "base/base.hpp"
 #include "math/math.hpp"
 #include "os/os.hpp"
+#include "asset/asset.hpp"
+#include "render/render.hpp"
 #include "window/window.hpp"
 #include "gfx/gfx.hpp"
 #include "imgui/imgui.hpp"
@@ -18,6 +21,8 @@
 #include "base/base.cpp"
 #include "math/math.cpp"
 #include "os/os.cpp"
+#include "asset/asset.cpp"
+#include "render/render.cpp"
 #include "window/window.cpp"
 #include "gfx/gfx.cpp"
 #include "imgui/imgui.cpp"
@@ -43,7 +48,7 @@ errf(char const *fmt, TArgs ...args) {
 }
 
 int 
-main(void) {
+main(int argc, char **argv) {
   gLog_File = fopen(RT_LOG_FILE, "w");
 
   Vec2 vec2{1,1};
@@ -57,7 +62,82 @@ main(void) {
   }
 
   os_start_app_timer();
+  os_init_cpu_info();
+  init_math_kernels();
   os_init_filesystem();
+  os_init_async_io();
+  os_init_file_watcher();
+
+  // rt_internal.exe --pack [src_dir] [archive]
+  if (argc >= 2 && ::strcmp(argv[1], "--pack") == 0) {
+    char const *src_dir = (argc >= 3) ? argv[2] : as_cstr(pathf("%a"));
+    char const *archive = (argc >= 4) ? argv[3] : as_cstr(pathf("%d\\assets.rtpk"));
+
+    asset_pack_directory_or_panic(src_dir, archive);
+    fflush(gLog_File);
+    return 0;
+  }
+
+  // rt_internal.exe --math-check [--bench]
+  if (argc >= 2 && ::strcmp(argv[1], "--math-check") == 0) {
+    s32 const failed = math_run_checks();
+    if (argc >= 3 && ::strcmp(argv[2], "--bench") == 0) {
+      math_run_benchmarks();
+    }
+    fflush(gLog_File);
+    return (failed == 0) ? 0 : 1;
+  }
+
+  // rt_internal.exe --asset-check
+  if (argc >= 2 && ::strcmp(argv[1], "--asset-check") == 0) {
+    s32 const failed = asset_run_checks();
+    fflush(gLog_File);
+    return (failed == 0) ? 0 : 1;
+  }
+
+  // rt_internal.exe --bvh-bench [triangle_count] [thread_count]
+  if (argc >= 2 && ::strcmp(argv[1], "--bvh-bench") == 0) {
+    s32 const triangle_count = (argc >= 3) ? ::atoi(argv[2]) : BVH_BENCHMARK_TRIS;
+    if (triangle_count <= 0) {
+      errf("Invalid triangle count: '%s'", argv[2]);
+    }
+
+    init_jobs((argc >= 4) ? ::atoi(argv[3]) : 0);
+    s32 const failed = bvh_run_benchmark(triangle_count);
+    shutdown_jobs();
+    fflush(gLog_File);
+    return (failed == 0) ? 0 : 1;
+  }
+
+  // rt_internal.exe --render [output.bmp|output.pfm] [samples_per_pixel] [thread_count]
+  if (argc >= 2 && ::strcmp(argv[1], "--render") == 0) {
+    char const *output = (argc >= 3) ? argv[2] : as_cstr(pathf("%d\\render.bmp"));
+
+    Render_Settings const settings = {
+      .samples_per_pixel = (argc >= 4) ? ::atoi(argv[3]) : RENDER_SPP,
+      .max_depth         = RENDER_MAX_DEPTH,
+      .sampler           = SamplerType_Sobol,
+      .seed              = 1
+    };
+    if (settings.samples_per_pixel <= 0) {
+      errf("Invalid sample count: '%s'", argv[3]);
+    }
+
+    init_jobs((argc >= 5) ? ::atoi(argv[4]) : 0);
+    render_headless_or_panic(output, RENDER_WIDTH, RENDER_HEIGHT, settings);
+    shutdown_jobs();
+    fflush(gLog_File);
+    return 0;
+  }
+
+  init_jobs();
+
+  Asset_Archive assets      = {};
+  char const   *assets_path = as_cstr(pathf("%d\\assets.rtpk"));
+  if (os_file_exists(assets_path)) {
+    assets = asset_open_archive_or_panic(assets_path);
+  }
+
   window_create_or_panic();
   gfx_init_or_panic();
   dear_imgui_init();
@@ -75,18 +155,110 @@ main(void) {
 
   dbg_check_(false);
 
+  // Progressive ray tracing in the background of the window. The render step gets a
+  // fixed slice of every frame, so the UI stays responsive while the image converges.
+  Render_Settings const render_settings = {
+    .samples_per_pixel = 1,
+    .max_depth         = RENDER_MAX_DEPTH,
+    .sampler           = SamplerType_Sobol,
+    .seed              = 1
+  };
+
+  s32                scene_seed     = 1;
+  Scene              scene          = scene_create_demo((u32)scene_seed);
+  bool               animate        = false;
+  f32                scene_time     = 0;
+  Bvh_Update_Stats   bvh_stats      = {};
+  s32                bvh_rebuilds   = 0;
+  Orbit_Camera       orbit          = scene_demo_orbit();
+  f32                exposure       = 1;
+  f32                shown_exposure = 0;
+  Progressive_Render progressive    = progressive_create(RENDER_WIDTH, RENDER_HEIGHT,
+                                                         render_settings, RENDER_FRAME_BUDGET);
+  Gfx_Texture        render_texture = gfx_create_texture_or_panic(RENDER_WIDTH, RENDER_HEIGHT);
+  u32               *render_pixels  = (u32*)alloc_perm((s64)RENDER_WIDTH*RENDER_HEIGHT*sizeof(u32));
+
   while(!window_is_closed()) {
     win32_message_loop();
-
-    gfx_im_rect({.x = 650, .y = 400}, {.width = 50, .height = 100}, COLOR_RED);
-    gfx_im_rect({.x = 600, .y = 300}, {.width = 50, .height = 100}, COLOR_GREEN);
-    gfx_im_rect({.x = 700, .y = 300}, {.width = 50, .height = 100},   COLOR_BLUE);
+    os_poll_file_watcher();
 
     dear_imgui_update();
 
+    ImGuiIO &io = ImGui::GetIO();
+    if (!io.WantCaptureMouse) {
+      if (ImGui::IsMouseDragging(ImGuiMouseButton_Left)) {
+        orbit.yaw   += io.MouseDelta.x*0.005f;
+        orbit.pitch += io.MouseDelta.y*0.005f;
+      }
+      orbit.distance *= 1 - 0.1f*io.MouseWheel;
+    }
+    orbit.distance = (orbit.distance > 0.5f) ? orbit.distance : 0.5f;
+    orbit.pitch = (orbit.pitch >  1.5f) ?  1.5f : orbit.pitch;
+    orbit.pitch = (orbit.pitch < -1.5f) ? -1.5f : orbit.pitch;
+
+    if (animate) {
+      scene_time += io.DeltaTime;
+      scene_animate_demo(scene, scene_time, io.DeltaTime, &bvh_stats);
+      bvh_rebuilds += bvh_stats.rebuilt;
+      progressive_reset(progressive);
+    }
+
+    Camera       const camera = camera_from_orbit(orbit, (f32)RENDER_WIDTH/RENDER_HEIGHT);
+    Render_Stats const stats  = progressive_step(progressive, scene, camera);
+
+    // @Note: nothing to convert once the image has converged.
+    if (stats.samples > 0 || exposure != shown_exposure) {
+      framebuffer_resolve_rgba8(progressive.fb, render_pixels, exposure);
+      gfx_update_texture(render_texture, render_pixels);
+      shown_exposure = exposure;
+    }
+
+    Vec2 const win_size = window_get_size();
+    ImGui::GetBackgroundDrawList()->AddImage((ImTextureID)render_texture.view, {0, 0},
+                                             {win_size.width, win_size.height});
+
+    ImGui::Begin("Ray tracer");
+    ImGui::Text("%.1f spp, %lld tile samples per frame",
+                progressive_samples_per_pixel(progressive), progressive.tile_samples_per_step);
+    ImGui::Text("Render step: %.2f ms (budget: %.2f ms), %.2f Msamples/s",
+                stats.seconds*1000, RENDER_FRAME_BUDGET*1000,
+                (stats.seconds > 0) ? stats.samples/stats.seconds*1e-6 : 0);
+    ImGui::SliderAngle("Yaw", &orbit.yaw, -180, 180);
+    ImGui::SliderAngle("Pitch", &orbit.pitch, -85, 85);
+    ImGui::SliderFloat("Distance", &orbit.distance, 1, 50);
+    ImGui::SliderAngle("Field of view", &orbit.fov_y, 5, 120);
+    ImGui::SliderFloat("Aperture", &orbit.aperture, 0, 1);
+    ImGui::SliderFloat("Exposure", &exposure, 0.125f, 8, "%.3f", ImGuiSliderFlags_Logarithmic);
+    ImGui::Checkbox("Animate", &animate);
+    if (animate) {
+      ImGui::Text("BVH update: %.2f ms, SAH cost %.2f (%.2f when built), %d rebuilds",
+                  bvh_stats.seconds*1000, bvh_stats.sah_cost, bvh_stats.built_sah_cost, bvh_rebuilds);
+    }
+    if (ImGui::InputInt("Scene seed", &scene_seed)) {
+      scene_destroy(scene);
+      scene = scene_create_demo((u32)scene_seed);
+      progressive_reset(progressive);
+    }
+    if (ImGui::Button("Restart")) {
+      progressive_reset(progressive);
+    }
+    ImGui::End();
+
     gfx_render();
   }
+
+  free_perm(render_pixels);
+  gfx_destroy_texture(render_texture);
+  progressive_destroy(progressive);
+  scene_destroy(scene);
   
+  if (assets.header) {
+    asset_close_archive(assets);
+  }
+
+  os_shutdown_file_watcher();
+  shutdown_jobs();
+
   logf("Goodbye :)\n");
   fflush(gLog_File);
 
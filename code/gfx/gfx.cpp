@@ -91,4 +91,5 @@ gfx_render() {
 }
 } // namespace rt
 
-#include "im_pipeline.cxx"
\ No newline at end of file
+#include "im_pipeline.cxx"
+#include "texture.cxx"
\ No newline at end of file
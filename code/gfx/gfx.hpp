@@ -1,4 +1,5 @@
 #include "im_pipeline.hxx"
+#include "texture.hxx"
 
 namespace rt {
 u32 constexpr COLOR_RED   = 0xff0000ff;
@@ -17,6 +17,12 @@ struct XXC_Pipeline {
 void 
 gfx_im_load_compile_create_shaders_or_panic();
 
+[[nodiscard]] bool
+gfx_im_load_compile_create_shaders();
+
+void
+gfx_im_on_shaders_changed(String path, void *user_data);
+
 void
 gfx_im_create_vbo_or_panic();
 
@@ -32,6 +38,7 @@ gfx_im_init_or_panic() {
   gD3d.xxc_pipeline = (XXC_Pipeline*)alloc_perm(sizeof(XXC_Pipeline));
 
   gfx_im_load_compile_create_shaders_or_panic();
+  os_watch_file(as_cstr(pathf("%S/shaders.hlsl")), gfx_im_on_shaders_changed);
   gfx_im_create_vbo_or_panic();
   gfx_im_create_constants_buffer_or_panic();
   gfx_im_create_rasterizer_or_panic();
@@ -46,66 +53,80 @@ gfx_im_init_or_panic() {
   };
 }
 
-void 
-gfx_im_load_compile_create_shaders_or_panic() {
-  // Step 1. Load (and compile) shaders
+namespace impl {
+// Returns NULL (and logs the errors) if the shader doesn't compile.
+[[nodiscard]] ::IBlob*
+compile_im_shader(Buffer source, char const *source_name, 
+                  char const *entry_point, char const *target) {
+  ::UINT constexpr static SHADER_FLAGS = D3DCOMPILE_ENABLE_STRICTNESS | D3DCOMPILE_DEBUG;
 
-  ::IBlob *vs_blob = NULL, *ps_blob = NULL;
+  ::IBlob *blob     = NULL;
   ::IBlob *err_blob = NULL;
+
+  ::HRESULT const hr = ::D3DCompile(
+                           source.bytes, 
+                           source.count,
+                           source_name,
+                           NULL,
+                           D3D_COMPILE_STANDARD_FILE_INCLUDE,
+                           entry_point, 
+                           target, 
+                           SHADER_FLAGS, 
+                           0,
+                           &blob, 
+                           &err_blob
+                           );
+
+  if (FAILED(hr)) {
+    logf("[D3D] Failed to compile '%s' (%s): %s\n", entry_point, target,
+         err_blob ? (char const*)err_blob->GetBufferPointer() : "no error message");
+    d3d_safe_release_(blob);
+  }
+
+  d3d_safe_release_(err_blob);
+  return blob;
+}
+} // namespace impl
+
+[[nodiscard]] bool
+gfx_im_load_compile_create_shaders() {
+  // Step 1. Load (and compile) shaders
+
   ::HRESULT hr;
   
-  String shader_path = pathf("%S/shaders.hlsl");
-  Buffer raw_shader = os_read_entire_file_or_panic(as_cstr(shader_path));
+  // @Note: on hot reload the file may be gone again (or locked) by now, the old
+  //        shaders stay bound then.
+  String      shader_path = pathf("%S/shaders.hlsl");
+  Mapped_File shader_file;
+  if (!os_map_file(as_cstr(shader_path), shader_file)) {
+    return false;
+  }
+  Buffer raw_shader = shader_file.content;
 
-  ::UINT constexpr static SHADER_FLAGS = D3DCOMPILE_ENABLE_STRICTNESS | D3DCOMPILE_DEBUG;
+  ::IBlob *vs_blob = impl::compile_im_shader(raw_shader, as_cstr(shader_path), 
+                                             "vs_main", "vs_5_0");
+  ::IBlob *ps_blob = impl::compile_im_shader(raw_shader, as_cstr(shader_path), 
+                                             "ps_main", "ps_5_0");
 
-  hr = ::D3DCompile(
-          raw_shader.bytes, 
-          raw_shader.count,
-          NULL,
-          NULL,
-          D3D_COMPILE_STANDARD_FILE_INCLUDE,
-          "vs_main", 
-          "vs_5_0", 
-          SHADER_FLAGS, 
-          0,
-          &vs_blob, 
-          &err_blob
-          );
-
-  if (FAILED(hr) && err_blob) {
-    errf("Failed to compile the vertex shader: %s", 
-          (char const*)err_blob->GetBufferPointer());
-  }
-  d3d_check_hresult_(hr);
+  os_unmap_file(shader_file);
 
-  hr = ::D3DCompile(
-          raw_shader.bytes, 
-          raw_shader.count,
-          NULL,
-          NULL,
-          D3D_COMPILE_STANDARD_FILE_INCLUDE,
-          "ps_main", 
-          "ps_5_0", 
-          SHADER_FLAGS, 
-          0,
-          &ps_blob, 
-          &err_blob
-          );
-
-  if (FAILED(hr) && err_blob) {
-    errf("Failed to compile the pixel shader: %s", 
-          (char const*)err_blob->GetBufferPointer());
+  if (!vs_blob || !ps_blob) {
+    d3d_safe_release_(vs_blob);
+    d3d_safe_release_(ps_blob);
+    return false;
   }
-  d3d_check_hresult_(hr);
-
 
   // Step 2. Create shader objects
+
+  ::IVertexShader *vs     = NULL;
+  ::IPixelShader  *ps     = NULL;
+  ::IInputLayout  *layout = NULL;
+
   hr = gD3d.device->CreateVertexShader(
                       vs_blob->GetBufferPointer(),
                       vs_blob->GetBufferSize(), 
                       NULL,
-                      &gD3d.xxc_pipeline->vs
+                      &vs
                       );
   d3d_check_hresult_(hr);
 
@@ -113,7 +134,7 @@ gfx_im_load_compile_create_shaders_or_panic() {
                       ps_blob->GetBufferPointer(),
                       ps_blob->GetBufferSize(), 
                       NULL,
-                      &gD3d.xxc_pipeline->ps
+                      &ps
                       );
   d3d_check_hresult_(hr);
 
@@ -139,13 +160,47 @@ gfx_im_load_compile_create_shaders_or_panic() {
                       ARRAYSIZE(input_layout), 
                       vs_blob->GetBufferPointer(),
                       vs_blob->GetBufferSize(),
-                      &gD3d.xxc_pipeline->layout
+                      &layout
                       );
   d3d_check_hresult_(hr);
 
-  d3d_safe_release_(err_blob);
   d3d_safe_release_(vs_blob);
   d3d_safe_release_(ps_blob);
+
+  // Step 4. Swap in the new shaders (they are replaced on hot reload)
+
+  XXC_Pipeline &pipeline = *gD3d.xxc_pipeline;
+
+  d3d_safe_release_(pipeline.vs);
+  d3d_safe_release_(pipeline.ps);
+  d3d_safe_release_(pipeline.layout);
+
+  pipeline.vs     = vs;
+  pipeline.ps     = ps;
+  pipeline.layout = layout;
+
+  return true;
+}
+
+void 
+gfx_im_load_compile_create_shaders_or_panic() {
+  if (!gfx_im_load_compile_create_shaders()) {
+    errf("Failed to compile the immediate mode shaders (details in the log).");
+  }
+}
+
+void
+gfx_im_on_shaders_changed(String path, void*) {
+  // @Note: editors may replace the file by deleting and renaming it.
+  if (!os_file_exists(as_cstr(path))) {
+    return;
+  }
+
+  logf("Shader '%.*s' changed, reloading.\n", (int)path.count, path.data);
+
+  if (!gfx_im_load_compile_create_shaders()) {
+    logf("Shader reload failed, keeping the previous version.\n");
+  }
 }
 
 void
@@ -0,0 +1,60 @@
+namespace rt {
+[[nodiscard]] Gfx_Texture
+gfx_create_texture_or_panic(s32 width, s32 height) {
+  check_(width > 0 && height > 0);
+
+  ::D3D11_TEXTURE2D_DESC const texture_desc = {
+    .Width          = (::UINT)width,
+    .Height         = (::UINT)height,
+    .MipLevels      = 1,
+    .ArraySize      = 1,
+    .Format         = DXGI_FORMAT_R8G8B8A8_UNORM,
+    .SampleDesc     = {.Count = 1, .Quality = 0},
+    .Usage          = D3D11_USAGE_DYNAMIC,
+    .BindFlags      = D3D11_BIND_SHADER_RESOURCE,
+    .CPUAccessFlags = D3D11_CPU_ACCESS_WRITE
+  };
+
+  ::ITexture2D *texture = NULL;
+  ::HRESULT hr = gD3d.device->CreateTexture2D(&texture_desc, NULL, &texture);
+  d3d_check_hresult_(hr);
+
+  ::IShaderResourceView *view = NULL;
+  hr = gD3d.device->CreateShaderResourceView(texture, NULL, &view);
+  d3d_check_hresult_(hr);
+
+  return {
+    .texture = texture,
+    .view    = view,
+    .width   = width,
+    .height  = height
+  };
+}
+
+void
+gfx_destroy_texture(Gfx_Texture &texture) {
+  ::IShaderResourceView *view = (::IShaderResourceView*)texture.view;
+  ::ITexture2D          *tex  = (::ITexture2D*)texture.texture;
+
+  d3d_safe_release_(view);
+  d3d_safe_release_(tex);
+  texture = {};
+}
+
+void
+gfx_update_texture(Gfx_Texture &texture, u32 const *rgba) {
+  ::ID3D11Resource *resource = (::ITexture2D*)texture.texture;
+
+  ::D3D11_MAPPED_SUBRESOURCE mapped = {0};
+  ::HRESULT const hr = gD3d.device_context->Map(resource, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
+  d3d_check_hresult_(hr);
+
+  // @Note: the driver may pad the rows.
+  s64 const row_size = (s64)texture.width*sizeof(u32);
+  for (s32 y = 0; y < texture.height; y++) {
+    mem_copy_((u8*)mapped.pData + (s64)y*mapped.RowPitch, rgba + (s64)y*texture.width, row_size);
+  }
+
+  gD3d.device_context->Unmap(resource, 0);
+}
+} // namespace rt
@@ -0,0 +1,24 @@
+/**
+ * Textures written by the CPU every frame, like the ray tracer's image. Dear ImGui can
+ * draw them: `view` is the ImTextureID.
+*/
+
+namespace rt {
+struct Gfx_Texture {
+  void *texture; // ID3D11Texture2D
+  void *view;    // ID3D11ShaderResourceView
+  s32   width;
+  s32   height;
+};
+
+// R8G8B8A8, not sRGB: the pixels are stored and displayed as they are.
+[[nodiscard]] Gfx_Texture
+gfx_create_texture_or_panic(s32 width, s32 height);
+
+void
+gfx_destroy_texture(Gfx_Texture &texture);
+
+// `rgba` holds width*height pixels, top row first, R in the low byte.
+void
+gfx_update_texture(Gfx_Texture &texture, u32 const *rgba);
+} // namespace rt
@@ -0,0 +1,322 @@
+namespace rt {
+namespace impl {
+struct Batch_Transform {
+  Vec3_Soa src_p;
+  Vec3_Soa dst_p;
+  Vec3_Soa src_n; // .x is NULL if there are no normals.
+  Vec3_Soa dst_n;
+  s64      count;
+
+  f32 m[4][3]; // Point matrix without the w column.
+  f32 n[3][3]; // Inverse-transpose of the linear part.
+};
+
+using Batch_Transform_Fn = AABB(Batch_Transform const &job);
+
+[[nodiscard]] Batch_Transform
+make_batch_transform(Vec3_Soa src_p, Vec3_Soa dst_p, Vec3_Soa src_n, Vec3_Soa dst_n,
+                     s64 count, Mat4x4 const &m) {
+  dbg_check_(count >= 0);
+
+  Batch_Transform job = {
+    .src_p = src_p,
+    .dst_p = dst_p,
+    .src_n = src_n,
+    .dst_n = dst_n,
+    .count = count
+  };
+
+  for (int r = 0; r < 4; r++) {
+    for (int c = 0; c < 3; c++) {
+      job.m[r][c] = m.v[r][c];
+    }
+  }
+
+  if (src_n.x) {
+    Mat4x4 const inv = affine_inverse(m);
+    for (int r = 0; r < 3; r++) {
+      for (int c = 0; c < 3; c++) {
+        job.n[r][c] = inv.v[c][r];
+      }
+    }
+  }
+
+  return job;
+}
+
+// Handles [begin, job.count). Used by the scalar variant and for the SIMD tails.
+void
+batch_transform_range_scalar(Batch_Transform const &job, s64 begin, AABB &bounds) {
+  auto const &M = job.m;
+  auto const &N = job.n;
+
+  for (s64 i = begin; i < job.count; i++) {
+    f32 const x = job.src_p.x[i];
+    f32 const y = job.src_p.y[i];
+    f32 const z = job.src_p.z[i];
+
+    f32 const tx = x*M[0][0] + y*M[1][0] + z*M[2][0] + M[3][0];
+    f32 const ty = x*M[0][1] + y*M[1][1] + z*M[2][1] + M[3][1];
+    f32 const tz = x*M[0][2] + y*M[1][2] + z*M[2][2] + M[3][2];
+
+    job.dst_p.x[i] = tx;
+    job.dst_p.y[i] = ty;
+    job.dst_p.z[i] = tz;
+
+    bounds.min.x = (tx < bounds.min.x) ? tx : bounds.min.x;
+    bounds.min.y = (ty < bounds.min.y) ? ty : bounds.min.y;
+    bounds.min.z = (tz < bounds.min.z) ? tz : bounds.min.z;
+    bounds.max.x = (tx > bounds.max.x) ? tx : bounds.max.x;
+    bounds.max.y = (ty > bounds.max.y) ? ty : bounds.max.y;
+    bounds.max.z = (tz > bounds.max.z) ? tz : bounds.max.z;
+
+    if (!job.src_n.x) {
+      continue;
+    }
+
+    f32 const nx = job.src_n.x[i];
+    f32 const ny = job.src_n.y[i];
+    f32 const nz = job.src_n.z[i];
+
+    f32 const rx = nx*N[0][0] + ny*N[1][0] + nz*N[2][0];
+    f32 const ry = nx*N[0][1] + ny*N[1][1] + nz*N[2][1];
+    f32 const rz = nx*N[0][2] + ny*N[1][2] + nz*N[2][2];
+
+    f32 const inv_len = 1/std::sqrt(rx*rx + ry*ry + rz*rz);
+    job.dst_n.x[i] = rx*inv_len;
+    job.dst_n.y[i] = ry*inv_len;
+    job.dst_n.z[i] = rz*inv_len;
+  }
+}
+
+[[nodiscard]] AABB
+batch_transform_scalar(Batch_Transform const &job) {
+  AABB bounds = aabb_empty();
+  batch_transform_range_scalar(job, 0, bounds);
+  return bounds;
+}
+
+[[nodiscard]] f32
+hmin8(__m256 v) {
+  __m128 m = _mm_min_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  m = _mm_min_ps(m, _mm_movehl_ps(m, m));
+  m = _mm_min_ss(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 1, 1, 1)));
+  return _mm_cvtss_f32(m);
+}
+
+[[nodiscard]] f32
+hmax8(__m256 v) {
+  __m128 m = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+  m = _mm_max_ss(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 1, 1, 1)));
+  return _mm_cvtss_f32(m);
+}
+
+[[nodiscard]] AABB
+batch_transform_avx2(Batch_Transform const &job) {
+  auto const &M = job.m;
+  auto const &N = job.n;
+
+  __m256 const m00 = _mm256_set1_ps(M[0][0]), m01 = _mm256_set1_ps(M[0][1]), m02 = _mm256_set1_ps(M[0][2]);
+  __m256 const m10 = _mm256_set1_ps(M[1][0]), m11 = _mm256_set1_ps(M[1][1]), m12 = _mm256_set1_ps(M[1][2]);
+  __m256 const m20 = _mm256_set1_ps(M[2][0]), m21 = _mm256_set1_ps(M[2][1]), m22 = _mm256_set1_ps(M[2][2]);
+  __m256 const m30 = _mm256_set1_ps(M[3][0]), m31 = _mm256_set1_ps(M[3][1]), m32 = _mm256_set1_ps(M[3][2]);
+
+  __m256 const n00 = _mm256_set1_ps(N[0][0]), n01 = _mm256_set1_ps(N[0][1]), n02 = _mm256_set1_ps(N[0][2]);
+  __m256 const n10 = _mm256_set1_ps(N[1][0]), n11 = _mm256_set1_ps(N[1][1]), n12 = _mm256_set1_ps(N[1][2]);
+  __m256 const n20 = _mm256_set1_ps(N[2][0]), n21 = _mm256_set1_ps(N[2][1]), n22 = _mm256_set1_ps(N[2][2]);
+
+  __m256 min_x = _mm256_set1_ps( FLT_MAX), min_y = min_x, min_z = min_x;
+  __m256 max_x = _mm256_set1_ps(-FLT_MAX), max_y = max_x, max_z = max_x;
+
+  bool const has_normals = (job.src_n.x != NULL);
+
+  s64 i = 0;
+  for (; i + 8 <= job.count; i += 8) {
+    __m256 const x = _mm256_loadu_ps(job.src_p.x + i);
+    __m256 const y = _mm256_loadu_ps(job.src_p.y + i);
+    __m256 const z = _mm256_loadu_ps(job.src_p.z + i);
+
+    __m256 const tx = _mm256_fmadd_ps(x, m00, _mm256_fmadd_ps(y, m10, _mm256_fmadd_ps(z, m20, m30)));
+    __m256 const ty = _mm256_fmadd_ps(x, m01, _mm256_fmadd_ps(y, m11, _mm256_fmadd_ps(z, m21, m31)));
+    __m256 const tz = _mm256_fmadd_ps(x, m02, _mm256_fmadd_ps(y, m12, _mm256_fmadd_ps(z, m22, m32)));
+
+    _mm256_storeu_ps(job.dst_p.x + i, tx);
+    _mm256_storeu_ps(job.dst_p.y + i, ty);
+    _mm256_storeu_ps(job.dst_p.z + i, tz);
+
+    min_x = _mm256_min_ps(min_x, tx);
+    min_y = _mm256_min_ps(min_y, ty);
+    min_z = _mm256_min_ps(min_z, tz);
+    max_x = _mm256_max_ps(max_x, tx);
+    max_y = _mm256_max_ps(max_y, ty);
+    max_z = _mm256_max_ps(max_z, tz);
+
+    if (!has_normals) {
+      continue;
+    }
+
+    __m256 const nx = _mm256_loadu_ps(job.src_n.x + i);
+    __m256 const ny = _mm256_loadu_ps(job.src_n.y + i);
+    __m256 const nz = _mm256_loadu_ps(job.src_n.z + i);
+
+    __m256 const rx = _mm256_fmadd_ps(nx, n00, _mm256_fmadd_ps(ny, n10, _mm256_mul_ps(nz, n20)));
+    __m256 const ry = _mm256_fmadd_ps(nx, n01, _mm256_fmadd_ps(ny, n11, _mm256_mul_ps(nz, n21)));
+    __m256 const rz = _mm256_fmadd_ps(nx, n02, _mm256_fmadd_ps(ny, n12, _mm256_mul_ps(nz, n22)));
+
+    __m256 const len_sq  = _mm256_fmadd_ps(rx, rx, _mm256_fmadd_ps(ry, ry, _mm256_mul_ps(rz, rz)));
+    __m256 const inv_len = _mm256_div_ps(_mm256_set1_ps(1.f), _mm256_sqrt_ps(len_sq));
+
+    _mm256_storeu_ps(job.dst_n.x + i, _mm256_mul_ps(rx, inv_len));
+    _mm256_storeu_ps(job.dst_n.y + i, _mm256_mul_ps(ry, inv_len));
+    _mm256_storeu_ps(job.dst_n.z + i, _mm256_mul_ps(rz, inv_len));
+  }
+
+  AABB bounds = {
+    .min = {.x = hmin8(min_x), .y = hmin8(min_y), .z = hmin8(min_z)},
+    .max = {.x = hmax8(max_x), .y = hmax8(max_y), .z = hmax8(max_z)}
+  };
+
+  batch_transform_range_scalar(job, i, bounds);
+  return bounds;
+}
+
+[[nodiscard]] AABB
+batch_transform_avx512(Batch_Transform const &job) {
+  auto const &M = job.m;
+  auto const &N = job.n;
+
+  __m512 const m00 = _mm512_set1_ps(M[0][0]), m01 = _mm512_set1_ps(M[0][1]), m02 = _mm512_set1_ps(M[0][2]);
+  __m512 const m10 = _mm512_set1_ps(M[1][0]), m11 = _mm512_set1_ps(M[1][1]), m12 = _mm512_set1_ps(M[1][2]);
+  __m512 const m20 = _mm512_set1_ps(M[2][0]), m21 = _mm512_set1_ps(M[2][1]), m22 = _mm512_set1_ps(M[2][2]);
+  __m512 const m30 = _mm512_set1_ps(M[3][0]), m31 = _mm512_set1_ps(M[3][1]), m32 = _mm512_set1_ps(M[3][2]);
+
+  __m512 const n00 = _mm512_set1_ps(N[0][0]), n01 = _mm512_set1_ps(N[0][1]), n02 = _mm512_set1_ps(N[0][2]);
+  __m512 const n10 = _mm512_set1_ps(N[1][0]), n11 = _mm512_set1_ps(N[1][1]), n12 = _mm512_set1_ps(N[1][2]);
+  __m512 const n20 = _mm512_set1_ps(N[2][0]), n21 = _mm512_set1_ps(N[2][1]), n22 = _mm512_set1_ps(N[2][2]);
+
+  __m512 min_x = _mm512_set1_ps( FLT_MAX), min_y = min_x, min_z = min_x;
+  __m512 max_x = _mm512_set1_ps(-FLT_MAX), max_y = max_x, max_z = max_x;
+
+  bool const has_normals = (job.src_n.x != NULL);
+
+  // @Note: the tail is handled with masked loads and stores. Masked-off lanes load
+  //        zeros, so they must not take part in the bounds.
+  for (s64 i = 0; i < job.count; i += 16) {
+    s64       const left = job.count - i;
+    __mmask16 const mask = (left >= 16) ? (__mmask16)0xffff : (__mmask16)((1u << left) - 1);
+
+    __m512 const x = _mm512_maskz_loadu_ps(mask, job.src_p.x + i);
+    __m512 const y = _mm512_maskz_loadu_ps(mask, job.src_p.y + i);
+    __m512 const z = _mm512_maskz_loadu_ps(mask, job.src_p.z + i);
+
+    __m512 const tx = _mm512_fmadd_ps(x, m00, _mm512_fmadd_ps(y, m10, _mm512_fmadd_ps(z, m20, m30)));
+    __m512 const ty = _mm512_fmadd_ps(x, m01, _mm512_fmadd_ps(y, m11, _mm512_fmadd_ps(z, m21, m31)));
+    __m512 const tz = _mm512_fmadd_ps(x, m02, _mm512_fmadd_ps(y, m12, _mm512_fmadd_ps(z, m22, m32)));
+
+    _mm512_mask_storeu_ps(job.dst_p.x + i, mask, tx);
+    _mm512_mask_storeu_ps(job.dst_p.y + i, mask, ty);
+    _mm512_mask_storeu_ps(job.dst_p.z + i, mask, tz);
+
+    min_x = _mm512_mask_min_ps(min_x, mask, min_x, tx);
+    min_y = _mm512_mask_min_ps(min_y, mask, min_y, ty);
+    min_z = _mm512_mask_min_ps(min_z, mask, min_z, tz);
+    max_x = _mm512_mask_max_ps(max_x, mask, max_x, tx);
+    max_y = _mm512_mask_max_ps(max_y, mask, max_y, ty);
+    max_z = _mm512_mask_max_ps(max_z, mask, max_z, tz);
+
+    if (!has_normals) {
+      continue;
+    }
+
+    __m512 const nx = _mm512_maskz_loadu_ps(mask, job.src_n.x + i);
+    __m512 const ny = _mm512_maskz_loadu_ps(mask, job.src_n.y + i);
+    __m512 const nz = _mm512_maskz_loadu_ps(mask, job.src_n.z + i);
+
+    __m512 const rx = _mm512_fmadd_ps(nx, n00, _mm512_fmadd_ps(ny, n10, _mm512_mul_ps(nz, n20)));
+    __m512 const ry = _mm512_fmadd_ps(nx, n01, _mm512_fmadd_ps(ny, n11, _mm512_mul_ps(nz, n21)));
+    __m512 const rz = _mm512_fmadd_ps(nx, n02, _mm512_fmadd_ps(ny, n12, _mm512_mul_ps(nz, n22)));
+
+    __m512 const len_sq  = _mm512_fmadd_ps(rx, rx, _mm512_fmadd_ps(ry, ry, _mm512_mul_ps(rz, rz)));
+    __m512 const inv_len = _mm512_div_ps(_mm512_set1_ps(1.f), _mm512_sqrt_ps(len_sq));
+
+    _mm512_mask_storeu_ps(job.dst_n.x + i, mask, _mm512_mul_ps(rx, inv_len));
+    _mm512_mask_storeu_ps(job.dst_n.y + i, mask, _mm512_mul_ps(ry, inv_len));
+    _mm512_mask_storeu_ps(job.dst_n.z + i, mask, _mm512_mul_ps(rz, inv_len));
+  }
+
+  return {
+    .min = {
+      .x = _mm512_reduce_min_ps(min_x), 
+      .y = _mm512_reduce_min_ps(min_y), 
+      .z = _mm512_reduce_min_ps(min_z)
+    },
+    .max = {
+      .x = _mm512_reduce_max_ps(max_x), 
+      .y = _mm512_reduce_max_ps(max_y), 
+      .z = _mm512_reduce_max_ps(max_z)
+    }
+  };
+}
+} // namespace impl
+
+// Picked in init_math_kernels.
+struct Batch_Kernels {
+  impl::Batch_Transform_Fn *transform;
+} static gBatch_Kernels = {
+  .transform = impl::batch_transform_scalar
+};
+
+[[nodiscard]] AABB 
+transform_points_soa(Vec3_Soa src, Vec3_Soa dst, s64 count, Mat4x4 const &m) {
+  impl::Batch_Transform const job = impl::make_batch_transform(src, dst, {}, {}, count, m);
+  return gBatch_Kernels.transform(job);
+}
+
+[[nodiscard]] AABB 
+transform_points_aos(Vec3 const *src, Vec3 *dst, s64 count, Mat4x4 const &m) {
+  // @Note: small enough to stay in L1 between the passes.
+  s64 constexpr static STAGING_COUNT = 512;
+  f32 x[STAGING_COUNT];
+  f32 y[STAGING_COUNT];
+  f32 z[STAGING_COUNT];
+
+  Vec3_Soa const staging = {.x = x, .y = y, .z = z};
+  AABB           bounds  = aabb_empty();
+
+  for (s64 begin = 0; begin < count; begin += STAGING_COUNT) {
+    s64 const n = (count - begin < STAGING_COUNT) ? count - begin : STAGING_COUNT;
+
+    for (s64 i = 0; i < n; i++) {
+      x[i] = src[begin + i].x;
+      y[i] = src[begin + i].y;
+      z[i] = src[begin + i].z;
+    }
+
+    impl::Batch_Transform const job = impl::make_batch_transform(staging, staging, {}, {}, n, m);
+    AABB const chunk = gBatch_Kernels.transform(job);
+
+    for (s64 i = 0; i < n; i++) {
+      dst[begin + i] = {.x = x[i], .y = y[i], .z = z[i]};
+    }
+
+    bounds = aabb_union(bounds, chunk);
+  }
+
+  return bounds;
+}
+
+[[nodiscard]] AABB 
+transform_mesh_soa(Vec3_Soa src_positions, Vec3_Soa src_normals, 
+                   Vec3_Soa dst_positions, Vec3_Soa dst_normals, 
+                   s64 count, Mat4x4 const &m) {
+  check_(src_normals.x && dst_normals.x);
+
+  impl::Batch_Transform const job = impl::make_batch_transform(
+                                        src_positions, dst_positions,
+                                        src_normals,   dst_normals,
+                                        count, m
+                                        );
+  return gBatch_Kernels.transform(job);
+}
+} // namespace rt
@@ -0,0 +1,23 @@
+/**
+ * Batched kernels for large arrays (mesh vertices, instances). They work on SoA
+ * streams, 8 (AVX2) or 16 (AVX-512) elements per iteration, and fuse the work that
+ * would otherwise need another pass over the data, like computing the bounds.
+*/
+
+namespace rt {
+// Transforms points (w = 1) and returns the bounds of the results. `dst` may be the
+// same as `src`. Empty input gives aabb_empty().
+[[nodiscard]] AABB 
+transform_points_soa(Vec3_Soa src, Vec3_Soa dst, s64 count, Mat4x4 const &m);
+
+// AoS version. Goes through a small SoA staging buffer, so prefer the SoA one.
+[[nodiscard]] AABB 
+transform_points_aos(Vec3 const *src, Vec3 *dst, s64 count, Mat4x4 const &m);
+
+// Transforms positions by `m` and normals by its inverse-transpose (renormalized), in
+// a single pass. `m` must be affine. Returns the bounds of the positions.
+[[nodiscard]] AABB 
+transform_mesh_soa(Vec3_Soa src_positions, Vec3_Soa src_normals, 
+                   Vec3_Soa dst_positions, Vec3_Soa dst_normals, 
+                   s64 count, Mat4x4 const &m);
+} // namespace rt
@@ -0,0 +1,334 @@
+namespace rt {
+namespace impl {
+f32 constexpr static FM_PI        = 3.14159265358979f;
+f32 constexpr static FM_PI_2      = 1.57079632679490f;
+f32 constexpr static FM_PI_4      = 0.78539816339745f;
+f32 constexpr static FM_2_OVER_PI = 0.63661977236758f;
+f32 constexpr static FM_TAN_PI_8  = 0.41421356237310f;
+f32 constexpr static FM_SQRT2     = 1.41421356237310f;
+f32 constexpr static FM_LN2       = 0.69314718055995f;
+f32 constexpr static FM_LOG2E     = 1.44269504088896f;
+
+// pi/2 and ln(2) split so that q*HI is exact for the q we care about (Cody-Waite).
+f32 constexpr static FM_PI_2_A = 1.5703125f;
+f32 constexpr static FM_PI_2_B = 4.837512969970703125e-4f;
+f32 constexpr static FM_PI_2_C = 7.54978995489188216e-8f;
+f32 constexpr static FM_LN2_HI = 0.693359375f;
+f32 constexpr static FM_LN2_LO = -2.12194440e-4f;
+
+// Highest degree first.
+f32 constexpr static SIN_POLY[]  = {-1.9515295891e-4f, 8.3321608736e-3f, -1.6666654611e-1f};
+f32 constexpr static COS_POLY[]  = { 2.443315711809948e-5f, -1.388731625493765e-3f,
+                                     4.166664568298827e-2f};
+f32 constexpr static ATAN_POLY[] = { 8.05374449538e-2f, -1.38776856032e-1f,
+                                     1.99777106478e-1f, -3.33329491539e-1f};
+f32 constexpr static ASIN_POLY[] = { 4.2163199048e-2f, 2.4181311049e-2f, 4.5470025998e-2f,
+                                     7.4953002686e-2f, 1.6666752422e-1f};
+f32 constexpr static EXP_POLY[]  = { 1.9875691500e-4f, 1.3981999507e-3f, 8.3334519073e-3f,
+                                     4.1665795894e-2f, 1.6666665459e-1f, 5.0000001201e-1f};
+f32 constexpr static LOG_POLY[]  = { 7.0376836292e-2f, -1.1514610310e-1f, 1.1676998740e-1f,
+                                    -1.2420140846e-1f, 1.4249322787e-1f, -1.6668057665e-1f,
+                                     2.0000714765e-1f, -2.4999993993e-1f, 3.3333331174e-1f};
+
+/**
+ * Per-type building blocks. The algorithms below are templates over f32, F32x4 and
+ * F32x8; packet overloads of select/fmadd/etc. are found through ADL, the scalar
+ * ones are here.
+*/
+
+[[nodiscard]] f32 broadcast(f32,   f32 c) { return c; }
+[[nodiscard]] F32x4 broadcast(F32x4, f32 c) { return f32x4(c); }
+[[nodiscard]] F32x8 broadcast(F32x8, f32 c) { return f32x8(c); }
+
+[[nodiscard]] f32 select(bool mask, f32 a, f32 b) { return mask ? a : b; }
+[[nodiscard]] f32 fmadd(f32 a, f32 b, f32 c)      { return a*b + c; }
+[[nodiscard]] f32 abs(f32 x)                      { return std::abs(x); }
+[[nodiscard]] f32 sqrt(f32 x)                     { return std::sqrt(x); }
+[[nodiscard]] f32 min(f32 a, f32 b)               { return (a < b) ? a : b; }
+[[nodiscard]] f32 max(f32 a, f32 b)               { return (a > b) ? a : b; }
+
+// Round to nearest (even). Only valid for |x| < 2^31.
+[[nodiscard]] f32
+round_nearest(f32 x) {
+  return (f32)_mm_cvtss_si32(_mm_set_ss(x));
+}
+
+[[nodiscard]] F32x4
+round_nearest(F32x4 x) {
+  return {_mm_cvtepi32_ps(_mm_cvtps_epi32(x.m))};
+}
+
+[[nodiscard]] F32x8
+round_nearest(F32x8 x) {
+  return {_mm256_cvtepi32_ps(_mm256_cvtps_epi32(x.m))};
+}
+
+// 2^n for integral n in [-126, 127].
+[[nodiscard]] f32
+exp2_int(f32 n) {
+  u32 const bits = (u32)((s32)n + 127) << 23;
+  f32 result;
+  ::memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+[[nodiscard]] F32x4
+exp2_int(F32x4 n) {
+  __m128i const bits = _mm_slli_epi32(_mm_add_epi32(_mm_cvtps_epi32(n.m), _mm_set1_epi32(127)), 23);
+  return {_mm_castsi128_ps(bits)};
+}
+
+[[nodiscard]] F32x8
+exp2_int(F32x8 n) {
+  __m256i const bits = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n.m), _mm256_set1_epi32(127)), 23);
+  return {_mm256_castsi256_ps(bits)};
+}
+
+// x = m*2^e with m in [1, 2). Returns m. Only for positive, normal x.
+[[nodiscard]] f32
+split_exponent(f32 x, f32 &e) {
+  u32 bits;
+  ::memcpy(&bits, &x, sizeof(bits));
+
+  e = (f32)((s32)(bits >> 23) - 127);
+  bits = (bits & 0x007fffff) | 0x3f800000;
+
+  f32 m;
+  ::memcpy(&m, &bits, sizeof(m));
+  return m;
+}
+
+[[nodiscard]] F32x4
+split_exponent(F32x4 x, F32x4 &e) {
+  __m128i const bits     = _mm_castps_si128(x.m);
+  __m128i const exponent = _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127));
+  __m128i const mantissa = _mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)),
+                                        _mm_set1_epi32(0x3f800000));
+  e = {_mm_cvtepi32_ps(exponent)};
+  return {_mm_castsi128_ps(mantissa)};
+}
+
+[[nodiscard]] F32x8
+split_exponent(F32x8 x, F32x8 &e) {
+  __m256i const bits     = _mm256_castps_si256(x.m);
+  __m256i const exponent = _mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127));
+  __m256i const mantissa = _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)),
+                                           _mm256_set1_epi32(0x3f800000));
+  e = {_mm256_cvtepi32_ps(exponent)};
+  return {_mm256_castsi256_ps(mantissa)};
+}
+
+// ~12 bits.
+[[nodiscard]] f32   rsqrt_estimate(f32 x)   { return _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x))); }
+[[nodiscard]] F32x4 rsqrt_estimate(F32x4 x) { return {_mm_rsqrt_ps(x.m)}; }
+[[nodiscard]] F32x8 rsqrt_estimate(F32x8 x) { return {_mm256_rsqrt_ps(x.m)}; }
+
+template <typename T, s64 N>
+[[nodiscard]] T
+horner(T x, f32 const (&coeffs)[N]) {
+  T p = broadcast(x, coeffs[0]);
+  for (s64 i = 1; i < N; i++) {
+    p = fmadd(p, x, broadcast(x, coeffs[i]));
+  }
+  return p;
+}
+
+// Quadrant q of sin/cos: swap the two for odd q, negate sin for q = 2, 3 and cos for
+// q = 1, 2 (mod 4). Two's complement makes negative q work too.
+void
+quadrant_masks(f32 q, bool &swap, bool &flip_sin, bool &flip_cos) {
+  s32 const i = (s32)q;
+  swap     = (i & 1) != 0;
+  flip_sin = (i & 2) != 0;
+  flip_cos = ((i + 1) & 2) != 0;
+}
+
+void
+quadrant_masks(F32x4 q, Mask4 &swap, Mask4 &flip_sin, Mask4 &flip_cos) {
+  __m128i const i   = _mm_cvtps_epi32(q.m);
+  __m128i const one = _mm_set1_epi32(1);
+  __m128i const two = _mm_set1_epi32(2);
+  swap     = {_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(i, one), one))};
+  flip_sin = {_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(i, two), two))};
+  flip_cos = {_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(_mm_add_epi32(i, one), two), two))};
+}
+
+void
+quadrant_masks(F32x8 q, Mask8 &swap, Mask8 &flip_sin, Mask8 &flip_cos) {
+  __m256i const i   = _mm256_cvtps_epi32(q.m);
+  __m256i const one = _mm256_set1_epi32(1);
+  __m256i const two = _mm256_set1_epi32(2);
+  swap     = {_mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(i, one), one))};
+  flip_sin = {_mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(i, two), two))};
+  flip_cos = {_mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(_mm256_add_epi32(i, one), two), two))};
+}
+
+/**
+ * Algorithms
+*/
+
+template <typename T>
+void
+sincos_impl(T x, T &s, T &c) {
+  // x = q*pi/2 + r, |r| <= pi/4
+  T const q = round_nearest(x*FM_2_OVER_PI);
+  T r = x - q*FM_PI_2_A;
+  r = r - q*FM_PI_2_B;
+  r = r - q*FM_PI_2_C;
+
+  T const z     = r*r;
+  T const sin_r = fmadd(r*z, horner(z, SIN_POLY), r);
+  T const cos_r = fmadd(z*z, horner(z, COS_POLY), fmadd(z, broadcast(z, -0.5f), broadcast(z, 1.f)));
+
+  // Quadrants: sin = (s, c, -s, -c), cos = (c, -s, -c, s).
+  decltype(q < 0.f) swap, flip_sin, flip_cos;
+  quadrant_masks(q, swap, flip_sin, flip_cos);
+
+  s = select(swap, cos_r, sin_r);
+  c = select(swap, sin_r, cos_r);
+  s = select(flip_sin, -s, s);
+  c = select(flip_cos, -c, c);
+}
+
+template <typename T>
+[[nodiscard]] T
+atan2_impl(T y, T x) {
+  T const ax = abs(x);
+  T const ay = abs(y);
+  T const mx = max(ax, ay);
+  T const mn = min(ax, ay);
+
+  // atan(a) for a in [0, 1], reduced further to [-tan(pi/8), tan(pi/8)].
+  T const a    = select(mx == broadcast(x, 0.f), broadcast(x, 0.f), mn/mx);
+  auto const reduce = a > FM_TAN_PI_8;
+  T const t    = select(reduce, (a - 1.f)/(a + 1.f), a);
+  T const base = select(reduce, broadcast(x, FM_PI_4), broadcast(x, 0.f));
+
+  T const z = t*t;
+  T r = base + fmadd(t*z, horner(z, ATAN_POLY), t);
+
+  r = select(ay > ax, broadcast(x, FM_PI_2) - r, r);
+  r = select(x < 0.f, broadcast(x, FM_PI) - r, r);
+  r = select(y < 0.f, -r, r);
+  return r;
+}
+
+template <typename T>
+[[nodiscard]] T
+acos_impl(T x) {
+  T const a = abs(x);
+
+  // acos(a) = 2*asin(sqrt((1 - a)/2)) for a > 0.5, pi/2 - asin(a) otherwise.
+  auto const is_big = a > 0.5f;
+  T const z = select(is_big, (broadcast(x, 1.f) - a)*0.5f, a*a);
+  T const s = select(is_big, sqrt(z), a);
+
+  T const asin_s = fmadd(s*z, horner(z, ASIN_POLY), s);
+
+  T const small_result = broadcast(x, FM_PI_2) - select(x < 0.f, -asin_s, asin_s);
+  T const big_result   = select(x < 0.f, broadcast(x, FM_PI) - asin_s*2.f, asin_s*2.f);
+  return select(is_big, big_result, small_result);
+}
+
+// e^r for |r| <= ln(2)/2.
+template <typename T>
+[[nodiscard]] T
+exp_reduced(T r) {
+  T const z = r*r;
+  return fmadd(z, horner(r, EXP_POLY), r + 1.f);
+}
+
+template <typename T>
+[[nodiscard]] T
+exp2_impl(T x) {
+  x = min(max(x, broadcast(x, -126.f)), broadcast(x, 127.f));
+
+  T const n = round_nearest(x);
+  return exp_reduced((x - n)*FM_LN2)*exp2_int(n);
+}
+
+template <typename T>
+[[nodiscard]] T
+exp_impl(T x) {
+  x = min(max(x, broadcast(x, -87.3f)), broadcast(x, 88.3f));
+
+  T const n = round_nearest(x*FM_LOG2E);
+  T r = x - n*FM_LN2_HI;
+  r = r - n*FM_LN2_LO;
+  return exp_reduced(r)*exp2_int(n);
+}
+
+// x = m*2^e with m in [sqrt(2)/2, sqrt(2)). Returns ln(m).
+template <typename T>
+[[nodiscard]] T
+log_reduced(T x, T &e) {
+  T m = split_exponent(x, e);
+
+  auto const is_big = m > FM_SQRT2;
+  m = select(is_big, m*0.5f, m);
+  e = select(is_big, e + 1.f, e);
+
+  T const t = m - 1.f;
+  T const z = t*t;
+  return t + fmadd(t*z, horner(t, LOG_POLY), z*-0.5f);
+}
+
+template <typename T>
+[[nodiscard]] T
+log2_impl(T x) {
+  T e;
+  T const ln_m = log_reduced(x, e);
+  return fmadd(ln_m, broadcast(x, FM_LOG2E), e);
+}
+
+template <typename T>
+[[nodiscard]] T
+log_impl(T x) {
+  T e;
+  T const ln_m = log_reduced(x, e);
+  return fmadd(e, broadcast(x, FM_LN2_HI), fmadd(e, broadcast(x, FM_LN2_LO), ln_m));
+}
+
+// One Newton-Raphson step: y' = y*(1.5 - 0.5*x*y^2).
+template <typename T>
+[[nodiscard]] T
+rsqrt_impl(T x) {
+  T const y = rsqrt_estimate(x);
+  // @Note: x*0.5 would be denormal for the smallest inputs.
+  return y*(broadcast(x, 1.5f) - x*y*y*0.5f);
+}
+} // namespace impl
+
+[[nodiscard]] f32 fast_sin(f32 x)            { f32 s, c; impl::sincos_impl(x, s, c); return s; }
+[[nodiscard]] f32 fast_cos(f32 x)            { f32 s, c; impl::sincos_impl(x, s, c); return c; }
+void              fast_sincos(f32 x, f32 &s, f32 &c) { impl::sincos_impl(x, s, c); }
+[[nodiscard]] f32 fast_atan2(f32 y, f32 x)   { return impl::atan2_impl(y, x); }
+[[nodiscard]] f32 fast_acos(f32 x)           { return impl::acos_impl(x); }
+[[nodiscard]] f32 fast_exp2(f32 x)           { return impl::exp2_impl(x); }
+[[nodiscard]] f32 fast_exp(f32 x)            { return impl::exp_impl(x); }
+[[nodiscard]] f32 fast_log2(f32 x)           { return impl::log2_impl(x); }
+[[nodiscard]] f32 fast_log(f32 x)            { return impl::log_impl(x); }
+[[nodiscard]] f32 fast_rsqrt(f32 x)          { return impl::rsqrt_impl(x); }
+
+[[nodiscard]] F32x4 fast_sin(F32x4 x)            { F32x4 s, c; impl::sincos_impl(x, s, c); return s; }
+[[nodiscard]] F32x4 fast_cos(F32x4 x)            { F32x4 s, c; impl::sincos_impl(x, s, c); return c; }
+void                fast_sincos(F32x4 x, F32x4 &s, F32x4 &c) { impl::sincos_impl(x, s, c); }
+[[nodiscard]] F32x4 fast_atan2(F32x4 y, F32x4 x) { return impl::atan2_impl(y, x); }
+[[nodiscard]] F32x4 fast_acos(F32x4 x)           { return impl::acos_impl(x); }
+[[nodiscard]] F32x4 fast_exp2(F32x4 x)           { return impl::exp2_impl(x); }
+[[nodiscard]] F32x4 fast_exp(F32x4 x)            { return impl::exp_impl(x); }
+[[nodiscard]] F32x4 fast_log2(F32x4 x)           { return impl::log2_impl(x); }
+[[nodiscard]] F32x4 fast_log(F32x4 x)            { return impl::log_impl(x); }
+[[nodiscard]] F32x4 fast_rsqrt(F32x4 x)          { return impl::rsqrt_impl(x); }
+
+[[nodiscard]] F32x8 fast_sin(F32x8 x)            { F32x8 s, c; impl::sincos_impl(x, s, c); return s; }
+[[nodiscard]] F32x8 fast_cos(F32x8 x)            { F32x8 s, c; impl::sincos_impl(x, s, c); return c; }
+void                fast_sincos(F32x8 x, F32x8 &s, F32x8 &c) { impl::sincos_impl(x, s, c); }
+[[nodiscard]] F32x8 fast_atan2(F32x8 y, F32x8 x) { return impl::atan2_impl(y, x); }
+[[nodiscard]] F32x8 fast_acos(F32x8 x)           { return impl::acos_impl(x); }
+[[nodiscard]] F32x8 fast_exp2(F32x8 x)           { return impl::exp2_impl(x); }
+[[nodiscard]] F32x8 fast_exp(F32x8 x)            { return impl::exp_impl(x); }
+[[nodiscard]] F32x8 fast_log2(F32x8 x)           { return impl::log2_impl(x); }
+[[nodiscard]] F32x8 fast_log(F32x8 x)            { return impl::log_impl(x); }
+[[nodiscard]] F32x8 fast_rsqrt(F32x8 x)          { return impl::rsqrt_impl(x); }
+} // namespace rt
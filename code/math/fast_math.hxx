@@ -0,0 +1,58 @@
+/**
+ * Fast approximations of the transcendental functions, for shading and sampling code
+ * that calls them per sample. Each one comes in a scalar form and 4-/8-wide packet
+ * forms with the same name, so they can be used from templated packet kernels.
+ *
+ * Polynomials are minimax fits (mostly the Cephes single-precision coefficients) with
+ * a Cody-Waite range reduction. Max errors are in ULPs against the correctly rounded
+ * result, measured against a double-precision reference over every 7th float of the
+ * domain (2^26 random pairs for atan2):
+ *
+ *   fast_sin, fast_cos, fast_sincos  2 ULP      |x| <= pi
+ *                                    1e-7 abs   |x| <= 8192 (worse beyond)
+ *   fast_atan2                       4 ULP
+ *   fast_acos                        2 ULP      -1 <= x <= 1
+ *   fast_exp2                        2 ULP      -126 <= x <= 127 (clamped)
+ *   fast_exp                         2 ULP      -87.3 <= x <= 88.3 (clamped)
+ *   fast_log2                        2 ULP      positive, normal x
+ *   fast_log                         1 ULP      positive, normal x
+ *   fast_rsqrt                       4 ULP      positive, normal x
+ *
+ * @Note: none of them handle NaN, infinities or denormals. Signed zeros aren't
+ *        preserved (e.g. fast_atan2(-0, -1) is +pi).
+*/
+
+namespace rt {
+[[nodiscard]] f32 fast_sin(f32 x);
+[[nodiscard]] f32 fast_cos(f32 x);
+void              fast_sincos(f32 x, f32 &s, f32 &c);
+[[nodiscard]] f32 fast_atan2(f32 y, f32 x);
+[[nodiscard]] f32 fast_acos(f32 x);
+[[nodiscard]] f32 fast_exp2(f32 x);
+[[nodiscard]] f32 fast_exp(f32 x);
+[[nodiscard]] f32 fast_log2(f32 x);
+[[nodiscard]] f32 fast_log(f32 x);
+[[nodiscard]] f32 fast_rsqrt(f32 x);
+
+[[nodiscard]] F32x4 fast_sin(F32x4 x);
+[[nodiscard]] F32x4 fast_cos(F32x4 x);
+void                fast_sincos(F32x4 x, F32x4 &s, F32x4 &c);
+[[nodiscard]] F32x4 fast_atan2(F32x4 y, F32x4 x);
+[[nodiscard]] F32x4 fast_acos(F32x4 x);
+[[nodiscard]] F32x4 fast_exp2(F32x4 x);
+[[nodiscard]] F32x4 fast_exp(F32x4 x);
+[[nodiscard]] F32x4 fast_log2(F32x4 x);
+[[nodiscard]] F32x4 fast_log(F32x4 x);
+[[nodiscard]] F32x4 fast_rsqrt(F32x4 x);
+
+[[nodiscard]] F32x8 fast_sin(F32x8 x);
+[[nodiscard]] F32x8 fast_cos(F32x8 x);
+void                fast_sincos(F32x8 x, F32x8 &s, F32x8 &c);
+[[nodiscard]] F32x8 fast_atan2(F32x8 y, F32x8 x);
+[[nodiscard]] F32x8 fast_acos(F32x8 x);
+[[nodiscard]] F32x8 fast_exp2(F32x8 x);
+[[nodiscard]] F32x8 fast_exp(F32x8 x);
+[[nodiscard]] F32x8 fast_log2(F32x8 x);
+[[nodiscard]] F32x8 fast_log(F32x8 x);
+[[nodiscard]] F32x8 fast_rsqrt(F32x8 x);
+} // namespace rt
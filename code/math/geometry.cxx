@@ -0,0 +1,244 @@
+namespace rt {
+namespace impl {
+// 1 + 2*gamma(3), rounded up. gamma(n) = n*u/(1 - n*u) bounds the relative error of n
+// rounded operations (u = 2^-24), see PBRT 3.9.
+f32 constexpr static SLAB_EXIT_SCALE = 1.0000004f;
+
+[[nodiscard]] __m128
+load_vec3_m128(Vec3 v) {
+  return _mm_setr_ps(v.x, v.y, v.z, 0);
+}
+
+// mask ? a : b
+[[nodiscard]] __m128
+blend(__m128 mask, __m128 a, __m128 b) {
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// Over lanes 0..2.
+[[nodiscard]] f32
+hmax3(__m128 v) {
+  __m128 const m = _mm_max_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+  return _mm_cvtss_f32(_mm_max_ss(m, _mm_movehl_ps(v, v)));
+}
+
+[[nodiscard]] f32
+hmin3(__m128 v) {
+  __m128 const m = _mm_min_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+  return _mm_cvtss_f32(_mm_min_ss(m, _mm_movehl_ps(v, v)));
+}
+} // namespace impl
+
+[[nodiscard]] Ray
+make_ray(Vec3 origin, Vec3 dir) {
+  Vec3 const inv_dir = {.x = 1/dir.x, .y = 1/dir.y, .z = 1/dir.z};
+
+  // @Note: 1/-0 is -inf, so the sign of zero components is kept too.
+  return {
+    .origin  = origin,
+    .dir     = dir,
+    .inv_dir = inv_dir,
+    .sign    = {inv_dir.x < 0, inv_dir.y < 0, inv_dir.z < 0}
+  };
+}
+
+[[nodiscard]] Vec3
+ray_at(Ray const &ray, f32 t) {
+  return ray.origin + ray.dir*t;
+}
+
+[[nodiscard]] AABB
+aabb_empty() {
+  return {
+    .min = {.x =  FLT_MAX, .y =  FLT_MAX, .z =  FLT_MAX},
+    .max = {.x = -FLT_MAX, .y = -FLT_MAX, .z = -FLT_MAX}
+  };
+}
+
+[[nodiscard]] AABB
+aabb_union(AABB a, AABB b) {
+  return {
+    .min = {
+      .x = (a.min.x < b.min.x) ? a.min.x : b.min.x,
+      .y = (a.min.y < b.min.y) ? a.min.y : b.min.y,
+      .z = (a.min.z < b.min.z) ? a.min.z : b.min.z
+    },
+    .max = {
+      .x = (a.max.x > b.max.x) ? a.max.x : b.max.x,
+      .y = (a.max.y > b.max.y) ? a.max.y : b.max.y,
+      .z = (a.max.z > b.max.z) ? a.max.z : b.max.z
+    }
+  };
+}
+
+[[nodiscard]] AABB
+aabb_grow(AABB box, Vec3 p) {
+  return aabb_union(box, {.min = p, .max = p});
+}
+
+[[nodiscard]] bool
+is_empty(AABB const &box) {
+  return box.min.x > box.max.x || box.min.y > box.max.y || box.min.z > box.max.z;
+}
+
+[[nodiscard]] Vec3
+center(AABB const &box) {
+  return (box.min + box.max)*0.5f;
+}
+
+[[nodiscard]] Vec3
+extent(AABB const &box) {
+  return box.max - box.min;
+}
+
+[[nodiscard]] f32
+surface_area(AABB const &box) {
+  if (is_empty(box)) {
+    return 0;
+  }
+
+  Vec3 const e = extent(box);
+  return 2*(e.x*e.y + e.y*e.z + e.z*e.x);
+}
+
+[[nodiscard]] s32
+largest_axis(AABB const &box) {
+  Vec3 const e = extent(box);
+
+  if (e.x >= e.y && e.x >= e.z) {
+    return 0;
+  }
+  return (e.y >= e.z) ? 1 : 2;
+}
+
+[[nodiscard]] bool
+intersect(Ray const &ray, AABB const &box, f32 t_min, f32 t_max, f32 &t_entry) {
+  __m128 const origin  = impl::load_vec3_m128(ray.origin);
+  __m128 const inv_dir = impl::load_vec3_m128(ray.inv_dir);
+  __m128 const inv_far = _mm_mul_ps(inv_dir, _mm_set1_ps(impl::SLAB_EXIT_SCALE));
+  __m128 const t_lo    = _mm_sub_ps(impl::load_vec3_m128(box.min), origin);
+  __m128 const t_hi    = _mm_sub_ps(impl::load_vec3_m128(box.max), origin);
+
+  // The ray enters through the max plane on the negative axes (-0 included).
+  __m128 const negative = _mm_cmplt_ps(inv_dir, _mm_setzero_ps());
+  __m128 const t_near   = _mm_mul_ps(impl::blend(negative, t_hi, t_lo), inv_dir);
+  __m128 const t_far    = _mm_mul_ps(impl::blend(negative, t_lo, t_hi), inv_far);
+
+  // @Note: max/min return the second argument for NaN lanes, so they become t_min/t_max.
+  f32 const entry = impl::hmax3(_mm_max_ps(t_near, _mm_set1_ps(t_min)));
+  f32 const leave = impl::hmin3(_mm_min_ps(t_far,  _mm_set1_ps(t_max)));
+
+  t_entry = entry;
+  return entry <= leave;
+}
+
+/**
+ * Wide
+*/
+
+[[nodiscard]] AABBx4
+load_aabbx4(AABB const *boxes, s32 count) {
+  dbg_check_(count >= 0 && count <= 4);
+
+  alignas(16) f32 lanes[6][4];
+  for (s32 i = 0; i < 4; i++) {
+    AABB const box = (i < count) ? boxes[i] : aabb_empty();
+    lanes[0][i] = box.min.x; lanes[1][i] = box.min.y; lanes[2][i] = box.min.z;
+    lanes[3][i] = box.max.x; lanes[4][i] = box.max.y; lanes[5][i] = box.max.z;
+  }
+
+  return {
+    .min = {load_f32x4(lanes[0]), load_f32x4(lanes[1]), load_f32x4(lanes[2])},
+    .max = {load_f32x4(lanes[3]), load_f32x4(lanes[4]), load_f32x4(lanes[5])}
+  };
+}
+
+[[nodiscard]] AABB
+lane(AABBx4 const &boxes, s32 i) {
+  return {.min = lane(boxes.min, i), .max = lane(boxes.max, i)};
+}
+
+[[nodiscard]] Mask4
+intersect(Ray const &ray, AABBx4 const &boxes, f32 t_min, f32 t_max, F32x4 &t_entry) {
+  Mask4 const negative_x = f32x4(ray.inv_dir.x) < 0.f;
+  Mask4 const negative_y = f32x4(ray.inv_dir.y) < 0.f;
+  Mask4 const negative_z = f32x4(ray.inv_dir.z) < 0.f;
+  F32x4 const near_x = select(negative_x, boxes.max.x, boxes.min.x);
+  F32x4 const near_y = select(negative_y, boxes.max.y, boxes.min.y);
+  F32x4 const near_z = select(negative_z, boxes.max.z, boxes.min.z);
+  F32x4 const far_x  = select(negative_x, boxes.min.x, boxes.max.x);
+  F32x4 const far_y  = select(negative_y, boxes.min.y, boxes.max.y);
+  F32x4 const far_z  = select(negative_z, boxes.min.z, boxes.max.z);
+
+  Vec3x4 const origin  = vec3x4(ray.origin);
+  Vec3x4 const inv_dir = vec3x4(ray.inv_dir);
+  Vec3x4 const inv_far = vec3x4(ray.inv_dir*impl::SLAB_EXIT_SCALE);
+
+  F32x4 entry = f32x4(t_min);
+  entry = max((near_x - origin.x)*inv_dir.x, entry);
+  entry = max((near_y - origin.y)*inv_dir.y, entry);
+  entry = max((near_z - origin.z)*inv_dir.z, entry);
+
+  F32x4 leave = f32x4(t_max);
+  leave = min((far_x - origin.x)*inv_far.x, leave);
+  leave = min((far_y - origin.y)*inv_far.y, leave);
+  leave = min((far_z - origin.z)*inv_far.z, leave);
+
+  t_entry = entry;
+  return entry <= leave;
+}
+
+[[nodiscard]] AABBx8
+load_aabbx8(AABB const *boxes, s32 count) {
+  dbg_check_(count >= 0 && count <= 8);
+
+  alignas(32) f32 lanes[6][8];
+  for (s32 i = 0; i < 8; i++) {
+    AABB const box = (i < count) ? boxes[i] : aabb_empty();
+    lanes[0][i] = box.min.x; lanes[1][i] = box.min.y; lanes[2][i] = box.min.z;
+    lanes[3][i] = box.max.x; lanes[4][i] = box.max.y; lanes[5][i] = box.max.z;
+  }
+
+  return {
+    .min = {load_f32x8(lanes[0]), load_f32x8(lanes[1]), load_f32x8(lanes[2])},
+    .max = {load_f32x8(lanes[3]), load_f32x8(lanes[4]), load_f32x8(lanes[5])}
+  };
+}
+
+[[nodiscard]] AABB
+lane(AABBx8 const &boxes, s32 i) {
+  return {.min = lane(boxes.min, i), .max = lane(boxes.max, i)};
+}
+
+[[nodiscard]] Mask8
+intersect(Ray const &ray, AABBx8 const &boxes, f32 t_min, f32 t_max, F32x8 &t_entry) {
+  Mask8 const negative_x = f32x8(ray.inv_dir.x) < 0.f;
+  Mask8 const negative_y = f32x8(ray.inv_dir.y) < 0.f;
+  Mask8 const negative_z = f32x8(ray.inv_dir.z) < 0.f;
+  F32x8 const near_x = select(negative_x, boxes.max.x, boxes.min.x);
+  F32x8 const near_y = select(negative_y, boxes.max.y, boxes.min.y);
+  F32x8 const near_z = select(negative_z, boxes.max.z, boxes.min.z);
+  F32x8 const far_x  = select(negative_x, boxes.min.x, boxes.max.x);
+  F32x8 const far_y  = select(negative_y, boxes.min.y, boxes.max.y);
+  F32x8 const far_z  = select(negative_z, boxes.min.z, boxes.max.z);
+
+  Vec3x8 const origin  = vec3x8(ray.origin);
+  Vec3x8 const inv_dir = vec3x8(ray.inv_dir);
+  Vec3x8 const inv_far = vec3x8(ray.inv_dir*impl::SLAB_EXIT_SCALE);
+
+  // @Note: no fmsub(near, inv_dir, origin*inv_dir) here -- origin*inv_dir is 0*inf = NaN
+  //        for an origin on a zero coordinate, which would drop an axis that must be tested.
+  F32x8 entry = f32x8(t_min);
+  entry = max((near_x - origin.x)*inv_dir.x, entry);
+  entry = max((near_y - origin.y)*inv_dir.y, entry);
+  entry = max((near_z - origin.z)*inv_dir.z, entry);
+
+  F32x8 leave = f32x8(t_max);
+  leave = min((far_x - origin.x)*inv_far.x, leave);
+  leave = min((far_y - origin.y)*inv_far.y, leave);
+  leave = min((far_z - origin.z)*inv_far.z, leave);
+
+  t_entry = entry;
+  return entry <= leave;
+}
+} // namespace rt
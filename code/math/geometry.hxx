@@ -0,0 +1,68 @@
+/**
+ * Rays and axis-aligned boxes.
+ *
+ * The slab test is the robust one from "Robust BVH Ray Traversal" (Ize 2013). A zero
+ * direction component gives an infinite reciprocal, and when the origin lies exactly on
+ * that slab's plane the distance is 0*inf = NaN. min/max are ordered so a NaN distance
+ * drops its axis from the test instead of turning the result into a miss. The exit
+ * distance is scaled by 1 + 2*gamma(3), so rounding never makes a ray miss a box it
+ * grazes (a BVH would lose the triangles on the box's faces otherwise).
+ *
+ * The wide variants test one ray against 4 (SSE2) or 8 (AVX2) boxes stored as SoA,
+ * which is the layout of a BVH4/BVH8 node. Same rules as in packet.hxx: call the 8-wide
+ * ones only from AVX2 kernels.
+*/
+
+namespace rt {
+struct Ray {
+  Vec3 origin;
+  Vec3 dir;     // Doesn't have to be normalized; t is measured in units of |dir|.
+  Vec3 inv_dir; // +-inf for zero components.
+  u32  sign[3]; // 1 if inv_dir is negative (the max plane is entered first). Orders BVH children.
+};
+
+[[nodiscard]] Ray  make_ray(Vec3 origin, Vec3 dir);
+[[nodiscard]] Vec3 ray_at(Ray const &ray, f32 t);
+
+struct AABB {
+  Vec3 min;
+  Vec3 max;
+};
+
+// min = FLT_MAX, max = -FLT_MAX. The identity of aabb_union, and never hit by a ray.
+[[nodiscard]] AABB aabb_empty();
+[[nodiscard]] AABB aabb_union(AABB a, AABB b);
+[[nodiscard]] AABB aabb_grow(AABB box, Vec3 p);
+
+[[nodiscard]] bool is_empty(AABB const &box);
+[[nodiscard]] Vec3 center(AABB const &box);
+[[nodiscard]] Vec3 extent(AABB const &box); // max - min
+[[nodiscard]] f32  surface_area(AABB const &box); // 0 for empty boxes.
+[[nodiscard]] s32  largest_axis(AABB const &box);
+
+// Hit if the ray overlaps the box somewhere in [t_min, t_max]. `t_entry` is where it
+// enters the box, clipped to t_min (so it's t_min if the origin is inside).
+[[nodiscard]] bool intersect(Ray const &ray, AABB const &box, f32 t_min, f32 t_max, f32 &t_entry);
+
+/**
+ * Wide
+*/
+
+struct AABBx4 {
+  Vec3x4 min, max;
+};
+
+struct AABBx8 {
+  Vec3x8 min, max;
+};
+
+// Lanes past `count` are set to aabb_empty().
+[[nodiscard]] AABBx4 load_aabbx4(AABB const *boxes, s32 count);
+[[nodiscard]] AABBx8 load_aabbx8(AABB const *boxes, s32 count);
+[[nodiscard]] AABB   lane(AABBx4 const &boxes, s32 i);
+[[nodiscard]] AABB   lane(AABBx8 const &boxes, s32 i);
+
+// Lane i is set if the ray hits box i. `t_entry` as in the scalar version.
+[[nodiscard]] Mask4 intersect(Ray const &ray, AABBx4 const &boxes, f32 t_min, f32 t_max, F32x4 &t_entry);
+[[nodiscard]] Mask8 intersect(Ray const &ray, AABBx8 const &boxes, f32 t_min, f32 t_max, F32x8 &t_entry);
+} // namespace rt
@@ -10,6 +10,18 @@ namespace rt {
 }
 
 [[nodiscard]] Vec4 transformed_point(Vec4 const &p, Mat4x4 const &m) {
+	__m128 r;
+	r = _mm_mul_ps(_mm_set1_ps(p.x), _mm_load_ps(m.v[0]));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(p.y), _mm_load_ps(m.v[1])));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(p.z), _mm_load_ps(m.v[2])));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(p.w), _mm_load_ps(m.v[3])));
+
+	Vec4 result;
+	result.m128 = r;
+	return result;
+}
+
+[[nodiscard]] Vec4 transformed_point_scalar(Vec4 const &p, Mat4x4 const &m) {
 	auto const &M = m.v;
 	return {
     .x = p.x*M[0][0] + p.y*M[1][0] + p.z*M[2][0] + p.w*M[3][0],
@@ -24,6 +36,14 @@ namespace rt {
 	return V4.xy;
 }
 
+[[nodiscard]] Vec3 transformed_point(Vec3 const &p, Mat4x4 const &m) {
+	return transformed_point(Vec4{.x = p.x, .y = p.y, .z = p.z, .w = 1.f}, m).xyz;
+}
+
+[[nodiscard]] Vec3 transformed_direction(Vec3 const &d, Mat4x4 const &m) {
+	return transformed_point(Vec4{.x = d.x, .y = d.y, .z = d.z, .w = 0.f}, m).xyz;
+}
+
 Vec4& transform_point(Vec4 &p, Mat4x4 const &m) {
 	Vec4 Copy = p;
 	p = transformed_point(p, m);
@@ -36,7 +56,61 @@ Vec2& transform_point(Vec2 &p, Mat4x4 const &m) {
 	return p;
 }
 
+namespace impl {
+using Combine_Fn = Mat4x4(Mat4x4 const &a, Mat4x4 const &b);
+
+// Row r of a*b is row r of `a` transformed by `b`.
+[[nodiscard]] Mat4x4 combine_sse(Mat4x4 const &a, Mat4x4 const &b) {
+	__m128 const b0 = _mm_load_ps(b.v[0]);
+	__m128 const b1 = _mm_load_ps(b.v[1]);
+	__m128 const b2 = _mm_load_ps(b.v[2]);
+	__m128 const b3 = _mm_load_ps(b.v[3]);
+
+	Mat4x4 result;
+	for (int r = 0; r < 4; r++) {
+		__m128 row;
+		row = _mm_mul_ps(_mm_set1_ps(a.v[r][0]), b0);
+		row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a.v[r][1]), b1));
+		row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a.v[r][2]), b2));
+		row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a.v[r][3]), b3));
+		_mm_store_ps(result.v[r], row);
+	}
+
+	return result;
+}
+
+[[nodiscard]] Mat4x4 combine_fma(Mat4x4 const &a, Mat4x4 const &b) {
+	__m128 const b0 = _mm_load_ps(b.v[0]);
+	__m128 const b1 = _mm_load_ps(b.v[1]);
+	__m128 const b2 = _mm_load_ps(b.v[2]);
+	__m128 const b3 = _mm_load_ps(b.v[3]);
+
+	Mat4x4 result;
+	for (int r = 0; r < 4; r++) {
+		__m128 row;
+		row = _mm_mul_ps(_mm_set1_ps(a.v[r][0]), b0);
+		row = _mm_fmadd_ps(_mm_set1_ps(a.v[r][1]), b1, row);
+		row = _mm_fmadd_ps(_mm_set1_ps(a.v[r][2]), b2, row);
+		row = _mm_fmadd_ps(_mm_set1_ps(a.v[r][3]), b3, row);
+		_mm_store_ps(result.v[r], row);
+	}
+
+	return result;
+}
+} // namespace impl
+
+// Picked in init_math_kernels.
+struct Mat_Kernels {
+	impl::Combine_Fn *combine;
+} static gMat_Kernels = {
+	.combine = impl::combine_sse
+};
+
 [[nodiscard]] Mat4x4 combine(Mat4x4 const &a, Mat4x4 const &b) {
+	return gMat_Kernels.combine(a, b);
+}
+
+[[nodiscard]] Mat4x4 combine_scalar(Mat4x4 const &a, Mat4x4 const &b) {
 	Mat4x4 Result{};
 	auto &R = Result.v;
 	auto const &A = a.v;
@@ -66,6 +140,141 @@ Vec2& transform_point(Vec2 &p, Mat4x4 const &m) {
 }
 
 
+// Cofactor expansion through 2x2 sub-determinants of the top and bottom halves.
+[[nodiscard]] Mat4x4 inverse(Mat4x4 const &m) {
+	auto const &M = m.v;
+
+	f32 const s0 = M[0][0]*M[1][1] - M[1][0]*M[0][1];
+	f32 const s1 = M[0][0]*M[1][2] - M[1][0]*M[0][2];
+	f32 const s2 = M[0][0]*M[1][3] - M[1][0]*M[0][3];
+	f32 const s3 = M[0][1]*M[1][2] - M[1][1]*M[0][2];
+	f32 const s4 = M[0][1]*M[1][3] - M[1][1]*M[0][3];
+	f32 const s5 = M[0][2]*M[1][3] - M[1][2]*M[0][3];
+
+	f32 const c5 = M[2][2]*M[3][3] - M[3][2]*M[2][3];
+	f32 const c4 = M[2][1]*M[3][3] - M[3][1]*M[2][3];
+	f32 const c3 = M[2][1]*M[3][2] - M[3][1]*M[2][2];
+	f32 const c2 = M[2][0]*M[3][3] - M[3][0]*M[2][3];
+	f32 const c1 = M[2][0]*M[3][2] - M[3][0]*M[2][2];
+	f32 const c0 = M[2][0]*M[3][1] - M[3][0]*M[2][1];
+
+	f32 const det = s0*c5 - s1*c4 + s2*c3 + s3*c2 - s4*c1 + s5*c0;
+	dbg_check_(!f32_compare(det, 0));
+
+	f32 const D = 1/det;
+
+	Mat4x4 Result;
+	auto &R = Result.v;
+
+	R[0][0] = ( M[1][1]*c5 - M[1][2]*c4 + M[1][3]*c3)*D;
+	R[0][1] = (-M[0][1]*c5 + M[0][2]*c4 - M[0][3]*c3)*D;
+	R[0][2] = ( M[3][1]*s5 - M[3][2]*s4 + M[3][3]*s3)*D;
+	R[0][3] = (-M[2][1]*s5 + M[2][2]*s4 - M[2][3]*s3)*D;
+
+	R[1][0] = (-M[1][0]*c5 + M[1][2]*c2 - M[1][3]*c1)*D;
+	R[1][1] = ( M[0][0]*c5 - M[0][2]*c2 + M[0][3]*c1)*D;
+	R[1][2] = (-M[3][0]*s5 + M[3][2]*s2 - M[3][3]*s1)*D;
+	R[1][3] = ( M[2][0]*s5 - M[2][2]*s2 + M[2][3]*s1)*D;
+
+	R[2][0] = ( M[1][0]*c4 - M[1][1]*c2 + M[1][3]*c0)*D;
+	R[2][1] = (-M[0][0]*c4 + M[0][1]*c2 - M[0][3]*c0)*D;
+	R[2][2] = ( M[3][0]*s4 - M[3][1]*s2 + M[3][3]*s0)*D;
+	R[2][3] = (-M[2][0]*s4 + M[2][1]*s2 - M[2][3]*s0)*D;
+
+	R[3][0] = (-M[1][0]*c3 + M[1][1]*c1 - M[1][2]*c0)*D;
+	R[3][1] = ( M[0][0]*c3 - M[0][1]*c1 + M[0][2]*c0)*D;
+	R[3][2] = (-M[3][0]*s3 + M[3][1]*s1 - M[3][2]*s0)*D;
+	R[3][3] = ( M[2][0]*s3 - M[2][1]*s1 + M[2][2]*s0)*D;
+
+	return Result;
+}
+
+// p' = p*A + t  =>  p = (p' - t)*A^-1. For A with rows a, b, c, the columns of A^-1
+// are (b x c, c x a, a x b)/det.
+[[nodiscard]] Mat4x4 affine_inverse(Mat4x4 const &m) {
+	dbg_check_(m.v[0][3] == 0 && m.v[1][3] == 0 && m.v[2][3] == 0 && m.v[3][3] == 1);
+
+	Vec3a a, b, c;
+	a.m128 = _mm_load_ps(m.v[0]);
+	b.m128 = _mm_load_ps(m.v[1]);
+	c.m128 = _mm_load_ps(m.v[2]);
+
+	Vec3a const bc = cross(b, c);
+	Vec3a const ca = cross(c, a);
+	Vec3a const ab = cross(a, b);
+
+	f32 const det = dot(a, bc);
+	dbg_check_(!f32_compare(det, 0));
+
+	__m128 const D = _mm_set1_ps(1/det);
+	__m128 r0 = _mm_mul_ps(bc.m128, D);
+	__m128 r1 = _mm_mul_ps(ca.m128, D);
+	__m128 r2 = _mm_mul_ps(ab.m128, D);
+	__m128 r3 = _mm_setzero_ps();
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+	// -t*A^-1
+	__m128 t;
+	t = _mm_mul_ps(_mm_set1_ps(m.v[3][0]), r0);
+	t = _mm_add_ps(t, _mm_mul_ps(_mm_set1_ps(m.v[3][1]), r1));
+	t = _mm_add_ps(t, _mm_mul_ps(_mm_set1_ps(m.v[3][2]), r2));
+	t = _mm_sub_ps(_mm_set_ps(1, 0, 0, 0), t);
+
+	Mat4x4 Result;
+	_mm_store_ps(Result.v[0], r0);
+	_mm_store_ps(Result.v[1], r1);
+	_mm_store_ps(Result.v[2], r2);
+	_mm_store_ps(Result.v[3], t);
+	return Result;
+}
+
+// The rotation part is orthonormal, so its inverse is the transpose.
+[[nodiscard]] Mat4x4 rigid_inverse(Mat4x4 const &m) {
+	__m128 r0 = _mm_load_ps(m.v[0]);
+	__m128 r1 = _mm_load_ps(m.v[1]);
+	__m128 r2 = _mm_load_ps(m.v[2]);
+	__m128 r3 = _mm_setzero_ps();
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+	__m128 t;
+	t = _mm_mul_ps(_mm_set1_ps(m.v[3][0]), r0);
+	t = _mm_add_ps(t, _mm_mul_ps(_mm_set1_ps(m.v[3][1]), r1));
+	t = _mm_add_ps(t, _mm_mul_ps(_mm_set1_ps(m.v[3][2]), r2));
+	t = _mm_sub_ps(_mm_set_ps(1, 0, 0, 0), t);
+
+	Mat4x4 Result;
+	_mm_store_ps(Result.v[0], r0);
+	_mm_store_ps(Result.v[1], r1);
+	_mm_store_ps(Result.v[2], r2);
+	_mm_store_ps(Result.v[3], t);
+	return Result;
+}
+
+
+[[nodiscard]] Mat4x4 rot_x(f32 angle) {
+	f32 const S = std::sin(angle);
+	f32 const C = std::cos(angle);
+
+	return {{
+    {1,  0, 0, 0},
+    {0,  C, S, 0},
+    {0, -S, C, 0},
+    {0,  0, 0, 1}
+  }};
+}
+
+[[nodiscard]] Mat4x4 rot_y(f32 angle) {
+	f32 const S = std::sin(angle);
+	f32 const C = std::cos(angle);
+
+	return {{
+    {C, 0, -S, 0},
+    {0, 1,  0, 0},
+    {S, 0,  C, 0},
+    {0, 0,  0, 1}
+  }};
+}
+
 [[nodiscard]] Mat4x4 rot_z(f32 angle) {
 	f32 const S = std::sin(angle);
 	f32 const C = std::cos(angle);
@@ -79,6 +288,26 @@ Vec2& transform_point(Vec2 &p, Mat4x4 const &m) {
 }
 
 
+// Rodrigues' formula, transposed for row vectors.
+[[nodiscard]] Mat4x4 rot_axis(Vec3 axis, f32 angle) {
+	dbg_check_(std::abs(len_sq(axis) - 1) < 1e-3f);
+
+	f32 const S = std::sin(angle);
+	f32 const C = std::cos(angle);
+	f32 const T = 1 - C;
+	f32 const x = axis.x;
+	f32 const y = axis.y;
+	f32 const z = axis.z;
+
+	return {{
+    {C + x*x*T,   x*y*T + z*S, x*z*T - y*S, 0},
+    {x*y*T - z*S, C + y*y*T,   y*z*T + x*S, 0},
+    {x*z*T + y*S, y*z*T - x*S, C + z*z*T,   0},
+    {0,           0,           0,           1}
+  }};
+}
+
+
 [[nodiscard]] Mat4x4 scale2(Vec2 factor) {
 	f32 const x = factor.x;
 	f32 const y = factor.y;
@@ -90,6 +319,18 @@ Vec2& transform_point(Vec2 &p, Mat4x4 const &m) {
   }};
 }
 
+[[nodiscard]] Mat4x4 scale3(Vec3 factor) {
+	f32 const x = factor.x;
+	f32 const y = factor.y;
+	f32 const z = factor.z;
+  return {{
+    {x, 0, 0, 0},
+    {0, y, 0, 0},
+    {0, 0, z, 0},
+    {0, 0, 0, 1}
+  }};
+}
+
 [[nodiscard]] Mat4x4 translate2(Vec2 o) {
 	f32 const x = o.x;
 	f32 const y = o.y;
@@ -101,6 +342,18 @@ Vec2& transform_point(Vec2 &p, Mat4x4 const &m) {
   }};
 }
 
+[[nodiscard]] Mat4x4 translate3(Vec3 o) {
+	f32 const x = o.x;
+	f32 const y = o.y;
+	f32 const z = o.z;
+  return {{
+    {1, 0, 0, 0},
+    {0, 1, 0, 0},
+    {0, 0, 1, 0},
+    {x, y, z, 1}
+  }};
+}
+
 // top, left, bottom, right
 // height, 0, 0, width
 // top = height
@@ -127,4 +380,40 @@ Vec2& transform_point(Vec2 &p, Mat4x4 const &m) {
 
   return Result;
 }
+
+// The view space basis is (right, up, back), so the camera looks down -Z.
+[[nodiscard]] Mat4x4 look_at(Vec3 eye, Vec3 target, Vec3 up) {
+	Vec3 const back  = normalized(eye - target);
+	Vec3 const right = normalized(cross(up, back));
+	Vec3 const up_   = cross(back, right);
+
+  return {{
+    {right.x,           up_.x,           back.x,           0},
+    {right.y,           up_.y,           back.y,           0},
+    {right.z,           up_.z,           back.z,           0},
+    {-dot(right, eye), -dot(up_, eye),  -dot(back, eye),   1}
+  }};
+}
+
+// Right-handed, depth mapped to [0, 1] (near to far).
+[[nodiscard]] Mat4x4 perspective_proj(f32 fov_y, f32 aspect, f32 near_z, f32 far_z) {
+	dbg_check_(fov_y > 0);
+	dbg_check_(aspect > 0);
+	dbg_check_(near_z > 0 && far_z > near_z);
+
+	f32 const Y = 1/std::tan(fov_y*0.5f);
+	f32 const X = Y/aspect;
+	f32 const Z = far_z/(near_z - far_z);
+
+  Mat4x4 Result{};
+  auto& R = Result.v;
+
+  R[0][0] = X;
+  R[1][1] = Y;
+  R[2][2] = Z;
+  R[2][3] = -1;
+  R[3][2] = near_z*Z;
+
+  return Result;
+}
 } // namespace rt
\ No newline at end of file
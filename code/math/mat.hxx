@@ -1,5 +1,13 @@
+/**
+ * Row-major 4x4 matrices for row vectors (p' = p*M, translation in the last row).
+ * Rows are 16-byte aligned, so they map 1:1 onto SSE registers.
+ *
+ * 3D space is right-handed and the camera looks down -Z. Projections map the depth
+ * to [0, 1], like D3D does.
+*/
+
 namespace rt {
-struct Mat4x4 {
+struct alignas(16) Mat4x4 {
 	f32 v[4][4];
 };
 
@@ -11,14 +19,46 @@ struct Mat4x4 {
 Vec4& transform_point(Vec4 &p, Mat4x4 const &m);
 Vec2& transform_point(Vec2 &p, Mat4x4 const &m);
 
+// w = 1 and w = 0, without the projective divide.
+[[nodiscard]] Vec3 transformed_point(Vec3 const &p, Mat4x4 const &m);
+[[nodiscard]] Vec3 transformed_direction(Vec3 const &d, Mat4x4 const &m);
+
+// a*b, i.e. first transform by `a`, then by `b`. Uses FMA when the CPU has it.
 [[nodiscard]] Mat4x4 combine(Mat4x4 const &a, Mat4x4 const &b);
 
+// Plain f32 versions of the SIMD paths, for verification.
+[[nodiscard]] Vec4   transformed_point_scalar(Vec4 const &p, Mat4x4 const &m);
+[[nodiscard]] Mat4x4 combine_scalar(Mat4x4 const &a, Mat4x4 const &b);
+
 [[nodiscard]] Mat4x4 transpose(Mat4x4 m);
 
+// General inverse. The matrix must not be singular.
+[[nodiscard]] Mat4x4 inverse(Mat4x4 const &m);
+
+// Inverse of a matrix whose last column is (0, 0, 0, 1) -- any mix of rotation, scale,
+// shear and translation. Much cheaper than the general inverse.
+[[nodiscard]] Mat4x4 affine_inverse(Mat4x4 const &m);
+
+// Inverse of rotation + translation only (no scale). Cheapest of them all.
+[[nodiscard]] Mat4x4 rigid_inverse(Mat4x4 const &m);
+
+// Angles are in radians, counter-clockwise when looking down the axis.
+[[nodiscard]] Mat4x4 rot_x(f32 angle);
+[[nodiscard]] Mat4x4 rot_y(f32 angle);
 [[nodiscard]] Mat4x4 rot_z(f32 angle);
+[[nodiscard]] Mat4x4 rot_axis(Vec3 axis, f32 angle); // `axis` must be normalized.
+
 [[nodiscard]] Mat4x4 scale2(Vec2 factor);
+[[nodiscard]] Mat4x4 scale3(Vec3 factor);
 
 [[nodiscard]] Mat4x4 translate2(Vec2 o);
+[[nodiscard]] Mat4x4 translate3(Vec3 o);
 
 [[nodiscard]] Mat4x4 ortho_proj(f32 width, f32 height);
+
+// World-to-view matrix. Its rigid_inverse is the camera-to-world matrix.
+[[nodiscard]] Mat4x4 look_at(Vec3 eye, Vec3 target, Vec3 up);
+
+// `fov_y` is in radians.
+[[nodiscard]] Mat4x4 perspective_proj(f32 fov_y, f32 aspect, f32 near_z, f32 far_z);
 } // namespace rt
\ No newline at end of file
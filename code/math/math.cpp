@@ -1,2 +1,24 @@
 #include "vec.cxx"
-#include "mat.cxx"
\ No newline at end of file
+#include "mat.cxx"
+#include "quat.cxx"
+#include "packet.cxx"
+#include "geometry.cxx"
+#include "batch.cxx"
+#include "fast_math.cxx"
+#include "random.cxx"
+#include "sampling_tables.cxx"
+#include "sampling.cxx"
+#include "math_check.cxx"
+
+namespace rt {
+void
+init_math_kernels() {
+  gMat_Kernels.combine = os_pick_kernel<impl::Combine_Fn>({{
+    impl::combine_sse, NULL, impl::combine_fma, NULL
+  }});
+
+  gBatch_Kernels.transform = os_pick_kernel<impl::Batch_Transform_Fn>({{
+    impl::batch_transform_scalar, NULL, impl::batch_transform_avx2, impl::batch_transform_avx512
+  }});
+}
+} // namespace rt
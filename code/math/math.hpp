@@ -4,8 +4,23 @@
 
 #include "vec.hxx"
 #include "mat.hxx"
+#include "quat.hxx"
+#include "packet.hxx"
+#include "geometry.hxx"
+#include "batch.hxx"
+#include "fast_math.hxx"
+#include "random.hxx"
+#include "sampling.hxx"
+#include "math_check.hxx"
 
 namespace rt {
+f32 constexpr static PI = 3.14159265358979f;
+
+// Picks the SIMD variants of the math kernels for the current ISA level. Call it after
+// os_init_cpu_info (and again after os_limit_isa_level). Until then SSE2 is used.
+void
+init_math_kernels();
+
 [[nodiscard]] bool
 f32_compare(f32 a, f32 b) {
   return (std::abs(a - b) < FLT_EPSILON);
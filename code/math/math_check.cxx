@@ -0,0 +1,1185 @@
+namespace rt {
+namespace impl {
+struct Math_Check_State {
+  char const *group;
+  s32         count;
+  s32         failed;
+} static gMath_Check;
+
+f32 volatile static gMath_Bench_Sink;
+
+void
+math_expect(bool ok, char const *expression, char const *file, s32 line) {
+  gMath_Check.count++;
+  if (!ok) {
+    gMath_Check.failed++;
+    logf("!!! [%s] check failed: %s\n!!! %s:%d\n", gMath_Check.group, expression, file, line);
+  }
+}
+
+#define math_expect_(x) impl::math_expect((x), #x, __FILE__, (s32)__LINE__)
+
+// |a - b| <= eps, relative for |ref| > 1.
+[[nodiscard]] bool
+near(f64 a, f64 ref, f64 eps) {
+  f64 const scale = (std::abs(ref) > 1) ? std::abs(ref) : 1;
+  return std::abs(a - ref) <= eps*scale;
+}
+
+[[nodiscard]] bool
+near(Vec3 a, Vec3 b, f64 eps) {
+  return near(a.x, b.x, eps) && near(a.y, b.y, eps) && near(a.z, b.z, eps);
+}
+
+[[nodiscard]] bool
+near(Mat4x4 const &a, Mat4x4 const &b, f64 eps) {
+  for (s32 r = 0; r < 4; r++) {
+    for (s32 c = 0; c < 4; c++) {
+      if (!near(a.v[r][c], b.v[r][c], eps)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// q and -q are the same rotation.
+[[nodiscard]] bool
+near_rotation(Quat a, Quat b, f64 eps) {
+  return std::abs(std::abs(dot(a, b)) - 1) <= eps;
+}
+
+// Error of `value` in units in the last place of the correctly rounded `ref`.
+[[nodiscard]] f64
+ulp_error(f32 value, f64 ref) {
+  f32 const rounded = (f32)ref;
+  if (value == rounded) {
+    return 0;
+  }
+  if (value != value) {
+    return FLT_MAX;
+  }
+
+  s32 exponent;
+  std::frexp((rounded == 0) ? (f64)FLT_MIN : (f64)rounded, &exponent);
+  exponent = (exponent - 24 > -149) ? exponent - 24 : -149;
+  return std::abs((f64)value - ref)/std::ldexp(1.0, exponent);
+}
+
+[[nodiscard]] f32
+random_f32(Pcg32 &rng, f32 lo, f32 hi) {
+  return lo + (hi - lo)*next_f32(rng);
+}
+
+[[nodiscard]] Vec3
+random_vec3(Pcg32 &rng, f32 lo, f32 hi) {
+  return {.x = random_f32(rng, lo, hi), .y = random_f32(rng, lo, hi), .z = random_f32(rng, lo, hi)};
+}
+
+[[nodiscard]] Vec3
+random_unit_vec3(Pcg32 &rng) {
+  for (;;) {
+    Vec3 const v = random_vec3(rng, -1, 1);
+    f32  const l = len_sq(v);
+    if (l > 0.01f && l <= 1) {
+      return v*(1/std::sqrt(l));
+    }
+  }
+}
+
+// Rotation, non-uniform scale and translation.
+[[nodiscard]] Mat4x4
+random_affine(Pcg32 &rng) {
+  Mat4x4 const s = scale3(random_vec3(rng, 0.5f, 2));
+  Mat4x4 const r = rot_axis(random_unit_vec3(rng), random_f32(rng, -3, 3));
+  Mat4x4 const t = translate3(random_vec3(rng, -10, 10));
+  return combine(combine(s, r), t);
+}
+
+[[nodiscard]] Mat4x4
+random_rigid(Pcg32 &rng) {
+  return combine(rot_axis(random_unit_vec3(rng), random_f32(rng, -3, 3)),
+                 translate3(random_vec3(rng, -10, 10)));
+}
+
+// Runs `fn` once per ISA level the CPU supports, with the math kernels picked for it.
+template <typename TFn>
+void
+for_each_isa_level(TFn fn) {
+  Isa_Level const detected = os_get_cpu_info().isa_level;
+
+  for (s32 level = IsaLevel_Scalar; level <= detected; level++) {
+    os_limit_isa_level((Isa_Level)level);
+    init_math_kernels();
+    fn((Isa_Level)level);
+  }
+
+  os_limit_isa_level(detected);
+  init_math_kernels();
+}
+
+/**
+ * Vectors
+*/
+
+template <typename TVec, s32 N>
+[[nodiscard]] TVec
+random_vec(Pcg32 &rng, f32 lo, f32 hi) {
+  TVec v = {};
+  for (s32 i = 0; i < N; i++) {
+    v.v[i] = random_f32(rng, lo, hi);
+  }
+  return v;
+}
+
+template <typename TVec, s32 N>
+void
+check_vec_type(Pcg32 &rng) {
+  // Vec3a keeps its padding lane at zero.
+  bool constexpr IS_PADDED = (sizeof(TVec)/sizeof(f32) > N);
+
+  for (s32 it = 0; it < 256; it++) {
+    TVec const a = random_vec<TVec, N>(rng, -100, 100);
+    TVec const b = random_vec<TVec, N>(rng, 1, 100);
+
+    TVec const sum    = a + b;
+    TVec const diff   = a - b;
+    TVec const prod   = a*b;
+    TVec const quot   = a/b;
+    TVec const scaled = a*3.f;
+
+    f64 dot_ref = 0, len_sq_ref = 0, dist_sq_ref = 0, magnitude = 0;
+    for (s32 i = 0; i < N; i++) {
+      math_expect_(sum.v[i]    == a.v[i] + b.v[i]);
+      math_expect_(diff.v[i]   == a.v[i] - b.v[i]);
+      math_expect_(prod.v[i]   == a.v[i]*b.v[i]);
+      math_expect_(scaled.v[i] == a.v[i]*3.f);
+      math_expect_(near(quot.v[i], (f64)a.v[i]/b.v[i], 1e-6));
+
+      dot_ref     += (f64)a.v[i]*b.v[i];
+      magnitude   += std::abs((f64)a.v[i]*b.v[i]);
+      len_sq_ref  += (f64)a.v[i]*a.v[i];
+      dist_sq_ref += ((f64)a.v[i] - b.v[i])*((f64)a.v[i] - b.v[i]);
+    }
+
+    if constexpr (IS_PADDED) {
+      math_expect_(sum.v[3] == 0 && diff.v[3] == 0 && prod.v[3] == 0 && scaled.v[3] == 0);
+    }
+
+    TVec compound = a;
+    compound += b;
+    math_expect_(compound == sum);
+    compound = a;
+    compound *= b;
+    math_expect_(compound == prod);
+    compound /= b;
+    math_expect_(near(compound.v[0], a.v[0], 1e-6));
+
+    math_expect_(std::abs(dot(a, b) - dot_ref) <= 1e-6*magnitude + 1e-6);
+    math_expect_(near(len_sq(a),     len_sq_ref,             1e-6));
+    math_expect_(near(len(a),        std::sqrt(len_sq_ref),  1e-6));
+    math_expect_(near(dist_sq(a, b), dist_sq_ref,            1e-5));
+    math_expect_(near(dist(a, b),    std::sqrt(dist_sq_ref), 1e-6));
+
+    TVec const n = normalized(a);
+    math_expect_(near(len(n), 1, 1e-6));
+    math_expect_(near(dot(n, a), std::sqrt(len_sq_ref), 1e-5));
+    if constexpr (IS_PADDED) {
+      math_expect_(n.v[3] == 0);
+    }
+  }
+
+  // Edge cases: the whole range of lengths we accept (not below FLT_EPSILON, see
+  // normalize) must give unit vectors, and axes must stay on their axis.
+  f32 const scales[] = {1e-6f, 1e-3f, 1.f, 1e3f, 1e6f, 1e18f, -1e-6f, -1.f, -1e18f};
+
+  for (s32 axis = 0; axis < N; axis++) {
+    for (f32 const scale : scales) {
+      TVec v = {};
+      v.v[axis] = scale;
+
+      TVec const n = normalized(v);
+      for (s32 i = 0; i < N; i++) {
+        math_expect_(near(n.v[i], (i == axis) ? ((scale > 0) ? 1 : -1) : 0, 1e-7));
+      }
+    }
+  }
+
+  for (f32 const scale : scales) {
+    TVec v = random_vec<TVec, N>(rng, 0.5f, 1);
+    v *= scale;
+
+    TVec n = v;
+    normalize(n);
+    math_expect_(near(len(n), 1, 1e-6));
+
+    TVec const twice = normalized(n);
+    for (s32 i = 0; i < N; i++) {
+      math_expect_(near(twice.v[i], n.v[i], 1e-6));
+    }
+  }
+}
+
+void
+check_vectors(Pcg32 &rng) {
+  check_vec_type<Vec2,  2>(rng);
+  check_vec_type<Vec3,  3>(rng);
+  check_vec_type<Vec4,  4>(rng);
+  check_vec_type<Vec3a, 3>(rng);
+
+  for (s32 it = 0; it < 256; it++) {
+    Vec4 const a = random_vec<Vec4, 4>(rng, -10, 10);
+    Vec4 const b = random_vec<Vec4, 4>(rng, -10, 10);
+    math_expect_(near(dot(a, b), dot_scalar(a, b), 1e-5));
+    math_expect_(near(normalized(a).x, normalized_scalar(a).x, 1e-6));
+
+    Vec3 const c = random_vec3(rng, -10, 10);
+    Vec3 const d = random_vec3(rng, -10, 10);
+    Vec3 const ref = {
+      .x = (f32)((f64)c.y*d.z - (f64)c.z*d.y),
+      .y = (f32)((f64)c.z*d.x - (f64)c.x*d.z),
+      .z = (f32)((f64)c.x*d.y - (f64)c.y*d.x)
+    };
+    math_expect_(near(cross(c, d), ref, 1e-5));
+    math_expect_(near(cross(to_vec3a(c), to_vec3a(d)).xyz, ref, 1e-5));
+    math_expect_(near(dot(cross(c, d), c), 0, 1e-3));
+  }
+
+  Vec3 const x = {.x = 1}, y = {.y = 1}, z = {.z = 1};
+  math_expect_(cross(x, y) == z);
+  math_expect_(cross(y, z) == x);
+  math_expect_(cross(z, x) == y);
+}
+
+/**
+ * Matrices
+*/
+
+[[nodiscard]] Vec3
+project(Vec3 p, Mat4x4 const &m) {
+  Vec4 const h = transformed_point(Vec4{.x = p.x, .y = p.y, .z = p.z, .w = 1}, m);
+  return {.x = h.x/h.w, .y = h.y/h.w, .z = h.z/h.w};
+}
+
+void
+check_matrices(Pcg32 &rng) {
+  Mat4x4 const I = identity();
+
+  for (s32 it = 0; it < 256; it++) {
+    Mat4x4 a, b;
+    for (s32 r = 0; r < 4; r++) {
+      for (s32 c = 0; c < 4; c++) {
+        a.v[r][c] = random_f32(rng, -4, 4);
+        b.v[r][c] = random_f32(rng, -4, 4);
+      }
+    }
+
+    Mat4x4 const t = transpose(a);
+    for (s32 r = 0; r < 4; r++) {
+      for (s32 c = 0; c < 4; c++) {
+        math_expect_(t.v[r][c] == a.v[c][r]);
+      }
+    }
+    math_expect_(near(transpose(t), a, 0));
+
+    math_expect_(near(combine(a, I), a, 0));
+    math_expect_(near(combine(I, a), a, 0));
+
+    Vec4 const p = random_vec<Vec4, 4>(rng, -10, 10);
+    Vec4 const q = transformed_point(p, a);
+    Vec4 const q_ref = transformed_point_scalar(p, a);
+    math_expect_(near(q.x, q_ref.x, 1e-5) && near(q.y, q_ref.y, 1e-5) &&
+                 near(q.z, q_ref.z, 1e-5) && near(q.w, q_ref.w, 1e-5));
+
+    // Applying a, then b, is the same as applying combine(a, b).
+    Vec4 const ab  = transformed_point(p, combine(a, b));
+    Vec4 const a_b = transformed_point_scalar(transformed_point_scalar(p, a), b);
+    math_expect_(near(ab.x, a_b.x, 1e-4) && near(ab.w, a_b.w, 1e-4));
+
+    Mat4x4 const m = random_affine(rng);
+    math_expect_(near(combine(m, inverse(m)), I, 1e-4));
+  }
+
+  for_each_isa_level([&](Isa_Level) {
+    for (s32 it = 0; it < 64; it++) {
+      Mat4x4 a = random_affine(rng);
+      Mat4x4 b = random_affine(rng);
+      a.v[0][3] = random_f32(rng, -1, 1); // Not affine, so all lanes matter.
+      math_expect_(near(combine(a, b), combine_scalar(a, b), 1e-5));
+    }
+  });
+
+  for (s32 it = 0; it < 256; it++) {
+    Mat4x4 const affine = random_affine(rng);
+    Mat4x4 const rigid  = random_rigid(rng);
+    math_expect_(near(affine_inverse(affine), inverse(affine), 1e-4));
+    math_expect_(near(rigid_inverse(rigid),   inverse(rigid),  1e-4));
+    math_expect_(near(combine(affine, affine_inverse(affine)), I, 1e-4));
+
+    Vec3 const p = random_vec3(rng, -10, 10);
+    Vec4 const h = transformed_point_scalar(Vec4{.x = p.x, .y = p.y, .z = p.z, .w = 1}, affine);
+    Vec4 const d = transformed_point_scalar(Vec4{.x = p.x, .y = p.y, .z = p.z, .w = 0}, affine);
+    math_expect_(near(transformed_point(p, affine),     h.xyz, 1e-5));
+    math_expect_(near(transformed_direction(p, affine), d.xyz, 1e-5));
+
+    Vec3 const axis  = random_unit_vec3(rng);
+    f32  const angle = random_f32(rng, -3, 3);
+    Mat4x4 const r   = rot_axis(axis, angle);
+    math_expect_(near(transformed_direction(axis, r), axis, 1e-5));
+    math_expect_(near(combine(r, rot_axis(axis, -angle)), I, 1e-5));
+  }
+
+  // Counter-clockwise when looking down the axis.
+  f32 const quarter = 1.57079632679f;
+  Vec3 const x = {.x = 1}, y = {.y = 1}, z = {.z = 1};
+  math_expect_(near(transformed_direction(y, rot_x(quarter)), z, 1e-6));
+  math_expect_(near(transformed_direction(z, rot_y(quarter)), x, 1e-6));
+  math_expect_(near(transformed_direction(x, rot_z(quarter)), y, 1e-6));
+  math_expect_(near(rot_x(0.7f), rot_axis(x, 0.7f), 1e-6));
+  math_expect_(near(rot_y(0.7f), rot_axis(y, 0.7f), 1e-6));
+  math_expect_(near(rot_z(0.7f), rot_axis(z, 0.7f), 1e-6));
+
+  math_expect_(near(transformed_point(Vec3{.x = 1, .y = 2, .z = 3},
+                                      combine(scale3({.x = 2, .y = 2, .z = 2}),
+                                              translate3({.x = 1}))),
+                    Vec3{.x = 3, .y = 4, .z = 6}, 0));
+
+  // Screen space (origin in the corner) to clip space.
+  Mat4x4 const ortho = ortho_proj(800, 600);
+  Vec2 const corner_min = transformed_point(Vec2{.x = 0,   .y = 0},   ortho);
+  Vec2 const corner_max = transformed_point(Vec2{.x = 800, .y = 600}, ortho);
+  Vec2 const center     = transformed_point(Vec2{.x = 400, .y = 300}, ortho);
+  math_expect_(corner_min.x == -1 && corner_min.y == -1);
+  math_expect_(near(corner_max.x, 1, 1e-6) && near(corner_max.y, 1, 1e-6));
+  math_expect_(center.x == 0 && center.y == 0);
+  math_expect_(near(transformed_point(Vec2{.x = 200, .y = 450},
+                                      combine(translate2({.x = 10, .y = 20}), ortho)).x,
+                    (210.0/800)*2 - 1, 1e-6));
+
+  // Depth goes from 0 at the near plane to 1 at the far plane, camera looks down -Z.
+  Mat4x4 const proj = perspective_proj(1.2f, 16.f/9, 0.1f, 100);
+  math_expect_(near(project({.z = -0.1f}, proj).z, 0, 1e-5));
+  math_expect_(near(project({.z = -100},  proj).z, 1, 1e-5));
+  math_expect_(near(project({.x = 0, .y = std::tan(0.6f), .z = -1}, proj).y, 1, 1e-5));
+
+  Vec3 const eye    = {.x = 1, .y = 2, .z = 3};
+  Vec3 const target = {.x = 4, .y = 2, .z = -1};
+  Mat4x4 const view = look_at(eye, target, y);
+  math_expect_(near(transformed_point(eye,    view), Vec3{}, 1e-5));
+  math_expect_(near(transformed_point(target, view), Vec3{.z = -5}, 1e-5));
+  math_expect_(near(transformed_point(Vec3{}, rigid_inverse(view)), eye, 1e-5));
+}
+
+/**
+ * Quaternions
+*/
+
+void
+check_quats(Pcg32 &rng) {
+  for (s32 it = 0; it < 256; it++) {
+    Vec3 const axis_a  = random_unit_vec3(rng);
+    Vec3 const axis_b  = random_unit_vec3(rng);
+    f32  const angle_a = random_f32(rng, -3, 3);
+    f32  const angle_b = random_f32(rng, -3, 3);
+
+    Quat const a = quat_from_axis_angle(axis_a, angle_a);
+    Quat const b = quat_from_axis_angle(axis_b, angle_b);
+    Mat4x4 const ma = rot_axis(axis_a, angle_a);
+    Mat4x4 const mb = rot_axis(axis_b, angle_b);
+
+    math_expect_(near(to_mat4x4(a), ma, 1e-5));
+    math_expect_(near(to_mat4x4(combine(a, b)), combine(ma, mb), 1e-5));
+    math_expect_(near_rotation(quat_from_mat4x4(ma), a, 1e-5));
+
+    Vec3 const v = random_vec3(rng, -10, 10);
+    math_expect_(near(rotated(v, a), transformed_direction(v, ma), 1e-5));
+    math_expect_(near_rotation(combine(a, conjugate(a)), quat_identity(), 1e-6));
+
+    math_expect_(near_rotation(slerp(a, b, 0), a, 1e-6));
+    math_expect_(near_rotation(slerp(a, b, 1), b, 1e-5));
+    math_expect_(near(len_sq(nlerp(a, b, 0.3f).xyz) + nlerp(a, b, 0.3f).w*nlerp(a, b, 0.3f).w,
+                      1, 1e-5));
+
+    // Constant angular velocity: halfway is equally far from both ends.
+    Quat const mid = slerp(a, b, 0.5f);
+    math_expect_(near(std::abs(dot(mid, a)), std::abs(dot(mid, b)), 1e-4));
+    math_expect_(near(dot(slerp(a, b, 0.3f), slerp(a, b, 0.3f)), 1, 1e-5));
+  }
+}
+
+/**
+ * Batches
+*/
+
+void
+check_batches(Pcg32 &rng) {
+  s64 constexpr MAX_COUNT = 1000;
+  f32 static src[6][MAX_COUNT];
+  f32 static dst[6][MAX_COUNT];
+
+  Vec3_Soa const src_p = {src[0], src[1], src[2]};
+  Vec3_Soa const src_n = {src[3], src[4], src[5]};
+  Vec3_Soa const dst_p = {dst[0], dst[1], dst[2]};
+  Vec3_Soa const dst_n = {dst[3], dst[4], dst[5]};
+
+  for (s64 i = 0; i < MAX_COUNT; i++) {
+    Vec3 const p = random_vec3(rng, -10, 10);
+    Vec3 const n = random_unit_vec3(rng);
+    src_p.x[i] = p.x; src_p.y[i] = p.y; src_p.z[i] = p.z;
+    src_n.x[i] = n.x; src_n.y[i] = n.y; src_n.z[i] = n.z;
+  }
+
+  Mat4x4 const m             = random_affine(rng);
+  Mat4x4 const normal_matrix = transpose(affine_inverse(m));
+
+  for_each_isa_level([&](Isa_Level) {
+    // Every tail length of the 8- and 16-wide loops, and a long run.
+    s64 const counts[] = {0, 1, 7, 8, 9, 15, 16, 17, 31, 33, MAX_COUNT};
+    for (s64 count : counts) {
+      AABB const bounds = transform_mesh_soa(src_p, src_n, dst_p, dst_n, count, m);
+
+      AABB ref_bounds = aabb_empty();
+
+      bool positions_ok = true, normals_ok = true;
+      for (s64 i = 0; i < count; i++) {
+        Vec3 const p = transformed_point(Vec3{.x = src_p.x[i], .y = src_p.y[i], .z = src_p.z[i]}, m);
+        Vec3 const n = normalized(transformed_direction(
+                         Vec3{.x = src_n.x[i], .y = src_n.y[i], .z = src_n.z[i]}, normal_matrix));
+
+        positions_ok &= near(Vec3{.x = dst_p.x[i], .y = dst_p.y[i], .z = dst_p.z[i]}, p, 1e-5);
+        normals_ok   &= near(Vec3{.x = dst_n.x[i], .y = dst_n.y[i], .z = dst_n.z[i]}, n, 1e-5);
+        ref_bounds = aabb_grow(ref_bounds, p);
+      }
+
+      math_expect_(positions_ok);
+      math_expect_(normals_ok);
+      math_expect_(near(bounds.min, ref_bounds.min, 1e-5) && near(bounds.max, ref_bounds.max, 1e-5));
+
+      AABB const points_bounds = transform_points_soa(src_p, dst_p, count, m);
+      math_expect_(near(points_bounds.min, ref_bounds.min, 1e-5));
+    }
+
+    Vec3 aos_src[64], aos_dst[64];
+    for (s32 i = 0; i < 64; i++) {
+      aos_src[i] = {.x = src_p.x[i], .y = src_p.y[i], .z = src_p.z[i]};
+    }
+    (void)transform_points_aos(aos_src, aos_dst, 64, m);
+
+    bool aos_ok = true;
+    for (s32 i = 0; i < 64; i++) {
+      aos_ok &= near(aos_dst[i], transformed_point(aos_src[i], m), 1e-5);
+    }
+    math_expect_(aos_ok);
+  });
+}
+
+/**
+ * Packets
+*/
+
+template <typename TF32, typename TVec3, typename TMask, s32 N>
+void
+check_packet_type(Pcg32 &rng, TF32 (*load)(f32 const*), TVec3 (*load3)(Vec3_Soa, s64)) {
+  for (s32 it = 0; it < 256; it++) {
+    f32 a[N], b[N], c[N], out[N];
+    f32 ax[N], ay[N], az[N], bx[N], by[N], bz[N];
+    for (s32 i = 0; i < N; i++) {
+      a[i]  = random_f32(rng, -10, 10);
+      b[i]  = random_f32(rng, 0.5f, 10);
+      c[i]  = random_f32(rng, -10, 10);
+      ax[i] = random_f32(rng, -1, 1); ay[i] = random_f32(rng, -1, 1); az[i] = random_f32(rng, -1, 1);
+      bx[i] = random_f32(rng, -1, 1); by[i] = random_f32(rng, -1, 1); bz[i] = random_f32(rng, -1, 1);
+    }
+    // Ties for the compares.
+    b[0] = a[0] = 1;
+
+    TF32  const pa = load(a), pb = load(b), pc = load(c);
+    TVec3 const va = load3({ax, ay, az}, 0), vb = load3({bx, by, bz}, 0);
+
+    TF32  const results[] = {pa + pb, pa - pb, pa*pb, pa/pb, pa + 2.f, -pa, min(pa, pb),
+                             max(pa, pb), abs(pa), sqrt(pb), fmadd(pa, pb, pc),
+                             select(pa < pb, pa, pc), select(pa >= pb, pa, pc), dot(va, vb),
+                             len(va)};
+    s32 constexpr RESULT_COUNT = sizeof(results)/sizeof(*results);
+
+    for (s32 r = 0; r < RESULT_COUNT; r++) {
+      store(out, results[r]);
+
+      bool ok = true;
+      for (s32 i = 0; i < N; i++) {
+        Vec3 const sa = {.x = ax[i], .y = ay[i], .z = az[i]};
+        Vec3 const sb = {.x = bx[i], .y = by[i], .z = bz[i]};
+        f32  const refs[RESULT_COUNT] = {
+          a[i] + b[i], a[i] - b[i], a[i]*b[i], a[i]/b[i], a[i] + 2.f, -a[i],
+          (a[i] < b[i]) ? a[i] : b[i], (a[i] > b[i]) ? a[i] : b[i], std::abs(a[i]),
+          std::sqrt(b[i]), a[i]*b[i] + c[i], (a[i] < b[i]) ? a[i] : c[i],
+          (a[i] >= b[i]) ? a[i] : c[i], dot(sa, sb), len(sa)
+        };
+        ok &= near(out[i], refs[r], 1e-6);
+      }
+
+      if (!ok) {
+        logf("!!! [%s] %d-wide packet op #%d differs from scalar\n", gMath_Check.group, N, r);
+      }
+      math_expect_(ok);
+    }
+
+    TVec3 const cr = cross(va, vb);
+    TVec3 const nv = normalized(va);
+    for (s32 i = 0; i < N; i++) {
+      Vec3 const sa = {.x = ax[i], .y = ay[i], .z = az[i]};
+      Vec3 const sb = {.x = bx[i], .y = by[i], .z = bz[i]};
+      math_expect_(near(lane(cr, i), cross(sa, sb), 1e-6));
+      math_expect_(near(lane(nv, i), normalized(sa), 1e-6));
+    }
+
+    f64 sum = 0;
+    for (s32 i = 0; i < N; i++) {
+      sum += a[i];
+    }
+    math_expect_(near(reduce_add(pa), sum, 1e-5));
+
+    TMask const lt = pa < pb;
+    u32 bits = 0;
+    for (s32 i = 0; i < N; i++) {
+      bits |= (u32)(a[i] < b[i]) << i;
+    }
+    math_expect_(to_bits(lt) == bits);
+    math_expect_(any(lt) == (bits != 0));
+    math_expect_(all(lt) == (bits == (1u << N) - 1));
+    math_expect_(to_bits(~lt) == (~bits & ((1u << N) - 1)));
+  }
+}
+
+void
+check_packets(Pcg32 &rng) {
+  check_packet_type<F32x4, Vec3x4, Mask4, 4>(rng, load_f32x4, load_vec3x4);
+
+  if (os_get_cpu_info().isa_level >= IsaLevel_AVX2) {
+    check_packet_type<F32x8, Vec3x8, Mask8, 8>(rng, load_f32x8, load_vec3x8);
+  }
+}
+
+/**
+ * Fast math
+*/
+
+struct Fast_Math_Case {
+  char const *name;
+  f32 (*fn)(f32);
+  F32x4 (*fn4)(F32x4);
+  F32x8 (*fn8)(F32x8);
+  f64 (*ref)(f64);
+  f32 lo, hi;
+  f64 max_ulp; // As documented in fast_math.hxx.
+};
+
+void
+check_fast_math() {
+  Fast_Math_Case const cases[] = {
+    {"fast_sin",   fast_sin,   fast_sin,   fast_sin,   [](f64 x) { return std::sin(x); },   -3.14159f, 3.14159f, 2},
+    {"fast_cos",   fast_cos,   fast_cos,   fast_cos,   [](f64 x) { return std::cos(x); },   -3.14159f, 3.14159f, 2},
+    {"fast_acos",  fast_acos,  fast_acos,  fast_acos,  [](f64 x) { return std::acos(x); },  -1, 1,        2},
+    {"fast_exp2",  fast_exp2,  fast_exp2,  fast_exp2,  [](f64 x) { return std::exp2(x); },  -126, 127,    2},
+    {"fast_exp",   fast_exp,   fast_exp,   fast_exp,   [](f64 x) { return std::exp(x); },   -87.3f, 88.3f, 2},
+    {"fast_log2",  fast_log2,  fast_log2,  fast_log2,  [](f64 x) { return std::log2(x); },  1e-30f, 1e30f, 2},
+    {"fast_log",   fast_log,   fast_log,   fast_log,   [](f64 x) { return std::log(x); },   1e-30f, 1e30f, 1},
+    {"fast_rsqrt", fast_rsqrt, fast_rsqrt, fast_rsqrt, [](f64 x) { return 1/std::sqrt(x); }, 1e-30f, 1e30f, 4},
+  };
+
+  bool const has_avx2 = os_get_cpu_info().isa_level >= IsaLevel_AVX2;
+  s32  constexpr STEPS = 1 << 16;
+
+  for (Fast_Math_Case const &c : cases) {
+    // Log-spaced for the positive-only functions, so every exponent is covered.
+    bool const is_log_spaced = (c.lo > 0);
+    f64  max_error = 0;
+
+    for (s32 i = 0; i < STEPS; i += 8) {
+      f32 x[8], out4[8], out8[8];
+      for (s32 j = 0; j < 8; j++) {
+        f64 const t = (f64)(i + j)/(STEPS - 1);
+        x[j] = is_log_spaced ? (f32)(c.lo*std::pow((f64)c.hi/c.lo, t)) : (f32)(c.lo + (c.hi - c.lo)*t);
+      }
+
+      store(out4,     c.fn4(load_f32x4(x)));
+      store(out4 + 4, c.fn4(load_f32x4(x + 4)));
+      if (has_avx2) {
+        store(out8, c.fn8(load_f32x8(x)));
+      }
+
+      for (s32 j = 0; j < 8; j++) {
+        f64 const ref   = c.ref(x[j]);
+        f64       error = ulp_error(c.fn(x[j]), ref);
+        f64 const e4    = ulp_error(out4[j], ref);
+        error = (e4 > error) ? e4 : error;
+        if (has_avx2) {
+          f64 const e8 = ulp_error(out8[j], ref);
+          error = (e8 > error) ? e8 : error;
+        }
+        max_error = (error > max_error) ? error : max_error;
+      }
+    }
+
+    if (max_error > c.max_ulp) {
+      logf("!!! [%s] %s: %.2f ULP, documented %.0f\n", gMath_Check.group, c.name, max_error, c.max_ulp);
+    }
+    math_expect_(max_error <= c.max_ulp);
+  }
+
+  // sin and cos away from [-pi, pi], in absolute error.
+  f64 max_abs_error = 0;
+  for (s32 i = 0; i < STEPS; i += 8) {
+    f32 x[8], sin4[8], cos4[8], sin8[8], cos8[8];
+    for (s32 j = 0; j < 8; j++) {
+      x[j] = (f32)(-8192 + 16384*((f64)(i + j)/(STEPS - 1)));
+    }
+
+    for (s32 half = 0; half < 8; half += 4) {
+      F32x4 s4, c4;
+      fast_sincos(load_f32x4(x + half), s4, c4);
+      store(sin4 + half, s4);
+      store(cos4 + half, c4);
+    }
+    if (has_avx2) {
+      F32x8 s8, c8;
+      fast_sincos(load_f32x8(x), s8, c8);
+      store(sin8, s8);
+      store(cos8, c8);
+    }
+
+    for (s32 j = 0; j < 8; j++) {
+      f64 const ref_sin = std::sin((f64)x[j]);
+      f64 const ref_cos = std::cos((f64)x[j]);
+
+      f64 const errors[6] = {
+        std::abs(fast_sin(x[j]) - ref_sin), std::abs(fast_cos(x[j]) - ref_cos),
+        std::abs(sin4[j] - ref_sin),        std::abs(cos4[j] - ref_cos),
+        has_avx2 ? std::abs(sin8[j] - ref_sin) : 0, has_avx2 ? std::abs(cos8[j] - ref_cos) : 0
+      };
+      for (f64 error : errors) {
+        max_abs_error = (error > max_abs_error) ? error : max_abs_error;
+      }
+    }
+  }
+  if (max_abs_error > 1e-7) {
+    logf("!!! [%s] fast_sin/fast_cos: %.3g absolute over |x| <= 8192, documented 1e-7\n",
+         gMath_Check.group, max_abs_error);
+  }
+  math_expect_(max_abs_error <= 1e-7);
+
+  // atan2 on a polar grid, all quadrants.
+  f64 max_error = 0;
+  for (s32 i = 0; i < 4096; i++) {
+    f64 const angle  = -3.14159 + 6.28318*(i/4095.0);
+    f32 const radius = (f32)std::pow(10.0, (i%13) - 6);
+    f32 const y = (f32)(radius*std::sin(angle));
+    f32 const x = (f32)(radius*std::cos(angle));
+
+    f64 const error = ulp_error(fast_atan2(y, x), std::atan2((f64)y, (f64)x));
+    max_error = (error > max_error) ? error : max_error;
+  }
+  math_expect_(max_error <= 4);
+
+  f32 s, c;
+  fast_sincos(0.5f, s, c);
+  math_expect_(s == fast_sin(0.5f) && c == fast_cos(0.5f));
+}
+
+/**
+ * Random numbers and sample sequences
+*/
+
+void
+check_random() {
+  // Reference output of pcg32-global-demo (seed 42, stream 54).
+  Pcg32 pcg = pcg32_seed(42, 54);
+  u32 const pcg_ref[] = {0xa15c02b7, 0x7b47f409, 0xba1d3330, 0x83d2f293, 0xbfa4784b, 0xcbed606e};
+  for (u32 expected : pcg_ref) {
+    math_expect_(next_u32(pcg) == expected);
+  }
+
+  Pcg32 stepped  = pcg32_seed(7, 3);
+  Pcg32 advanced = stepped;
+  for (s32 i = 0; i < 1000; i++) {
+    (void)next_u32(stepped);
+  }
+  pcg32_advance(advanced, 1000);
+  math_expect_(stepped.state == advanced.state);
+
+  // Random123 known-answer vectors.
+  Philox_Block const k0 = philox4x32({0, 0, 0, 0}, 0);
+  Philox_Block const k1 = philox4x32({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+                                     0x299f31d0a4093822);
+  math_expect_(k0.v[0] == 0x6627e8d5 && k0.v[1] == 0xe169c58d &&
+               k0.v[2] == 0xbc57ac4c && k0.v[3] == 0x9b00dbd8);
+  math_expect_(k1.v[0] == 0xd16cfe09 && k1.v[1] == 0x94fdcceb &&
+               k1.v[2] == 0x5001e420 && k1.v[3] == 0x24126ea1);
+
+  math_expect_(u32_to_unit_f32(0xffffffff) < 1);
+
+  if (os_get_cpu_info().isa_level < IsaLevel_AVX2) {
+    return;
+  }
+
+  // 8-wide lanes match the scalar generators.
+  U32x8 const streams = u32x8_iota(100);
+  Pcg32x8 pcg8 = pcg32x8_seed(42, streams);
+  Pcg32   pcg1[8];
+  for (s32 i = 0; i < 8; i++) {
+    pcg1[i] = pcg32_seed(42, 100 + i);
+  }
+
+  bool lanes_ok = true;
+  for (s32 it = 0; it < 64; it++) {
+    U32x8 const v = next_u32(pcg8);
+    for (s32 i = 0; i < 8; i++) {
+      lanes_ok &= (lane(v, i) == next_u32(pcg1[i]));
+    }
+
+    U32x8 const pixels = u32x8_iota(it*8);
+    Philox_Block_x8 const block = philox_sample(pixels, u32x8(it), 3, 0x1234);
+    U32x8 const hashed = random_hash_u32(pixels, u32x8(it), 5, 77);
+    for (s32 i = 0; i < 8; i++) {
+      Philox_Block const ref = philox_sample(it*8 + i, it, 3, 0x1234);
+      lanes_ok &= (lane(block.v[0], i) == ref.v[0] && lane(block.v[3], i) == ref.v[3]);
+      lanes_ok &= (lane(hashed, i) == random_hash_u32(it*8 + i, it, 5, 77));
+    }
+  }
+  math_expect_(lanes_ok);
+}
+
+void
+check_sampling() {
+  // Each 1D projection of 2^k Sobol points is stratified, with or without scrambling.
+  for (u32 dimension = 0; dimension < 40; dimension++) {
+    s32 strata[64] = {};
+    for (u32 i = 0; i < 64; i++) {
+      f32 const unscrambled = (dimension < SOBOL_DIMENSIONS) ? sobol(i, dimension) : 0.5f;
+      f32 const scrambled   = sobol_owen(i, dimension, 1234);
+      math_expect_(unscrambled >= 0 && unscrambled < 1);
+      strata[(s32)(scrambled*64)]++;
+    }
+
+    bool stratified = true;
+    for (s32 s : strata) {
+      stratified &= (s == 1);
+    }
+    math_expect_(stratified);
+  }
+
+  // The first two dimensions form a (0, 2)-sequence: one point per 16x16 cell.
+  s32 cells[16][16] = {};
+  for (u32 i = 0; i < 256; i++) {
+    cells[(s32)(sobol_owen(i, 0, 99)*16)][(s32)(sobol_owen(i, 1, 99)*16)]++;
+  }
+  bool one_per_cell = true;
+  for (s32 r = 0; r < 16; r++) {
+    for (s32 c = 0; c < 16; c++) {
+      one_per_cell &= (cells[r][c] == 1);
+    }
+  }
+  math_expect_(one_per_cell);
+
+  math_expect_(radical_inverse(1, 2) == 0.5f);
+  math_expect_(near(halton(5, 1), 2.0/3 + 1.0/9, 1e-7));
+
+  // The blue-noise ranks are a permutation.
+  static bool seen[BLUE_NOISE_SIZE*BLUE_NOISE_SIZE];
+  ::memset(seen, 0, sizeof(seen));
+  for (u32 y = 0; y < BLUE_NOISE_SIZE; y++) {
+    for (u32 x = 0; x < BLUE_NOISE_SIZE; x++) {
+      seen[(s32)(blue_noise(x, y)*BLUE_NOISE_SIZE*BLUE_NOISE_SIZE)] = true;
+    }
+  }
+  bool is_permutation = true;
+  for (bool s : seen) {
+    is_permutation &= s;
+  }
+  math_expect_(is_permutation);
+
+  for (s32 type = 0; type < SamplerType_Count; type++) {
+    Sampler sampler = sampler_init((Sampler_Type)type, 7);
+
+    bool in_range = true;
+    for (u32 i = 0; i < 256; i++) {
+      sampler_start(sampler, i%17, i/17, i);
+      f32  const u  = sampler_next_1d(sampler);
+      Vec2 const uv = sampler_next_2d(sampler);
+      in_range &= (u >= 0 && u < 1 && uv.x >= 0 && uv.x < 1 && uv.y >= 0 && uv.y < 1);
+      in_range &= (sampler.dimension == 4 && uv.x == sampler_get(sampler, 2));
+    }
+    math_expect_(in_range);
+  }
+}
+
+/**
+ * Geometry
+*/
+
+// Slab test in f64 with the axis-parallel case handled explicitly. Returns the
+// [entry, exit] interval, empty if the ray misses.
+void
+reference_slabs(Ray const &ray, AABB const &box, f64 t_min, f64 t_max, f64 &entry, f64 &leave) {
+  entry = t_min;
+  leave = t_max;
+  for (s32 axis = 0; axis < 3; axis++) {
+    f64 const o = ray.origin.v[axis], d = ray.dir.v[axis];
+    f64 const lo = box.min.v[axis], hi = box.max.v[axis];
+
+    if (d == 0) {
+      if (o < lo || o > hi) {
+        leave = -FLT_MAX;
+      }
+      continue;
+    }
+
+    f64 const t0 = (lo - o)/d, t1 = (hi - o)/d;
+    f64 const t_near = (t0 < t1) ? t0 : t1, t_far = (t0 < t1) ? t1 : t0;
+    entry = (t_near > entry) ? t_near : entry;
+    leave = (t_far  < leave) ? t_far  : leave;
+  }
+}
+
+[[nodiscard]] Ray
+random_ray(Pcg32 &rng, AABB const &box) {
+  Vec3 origin = random_vec3(rng, -4, 4);
+  Vec3 dir    = random_vec3(rng, -1, 1);
+
+  // Half of them aimed at the box, so there are enough hits.
+  if (next_u32(rng) & 1) {
+    Vec3 const t = random_vec3(rng, 0, 1);
+    dir = box.min + (box.max - box.min)*t - origin;
+  }
+
+  // Axis-parallel rays, also starting exactly on the box's planes (0*inf in the test).
+  for (s32 axis = 0; axis < 3; axis++) {
+    u32 const r = next_u32_below(rng, 8);
+    if (r < 2) {
+      dir.v[axis] = (r == 0) ? 0.f : -0.f;
+    }
+    if (next_u32_below(rng, 8) == 0) {
+      origin.v[axis] = (next_u32(rng) & 1) ? box.max.v[axis] : box.min.v[axis];
+    }
+  }
+  return make_ray(origin, dir);
+}
+
+[[nodiscard]] AABB
+random_aabb(Pcg32 &rng) {
+  return aabb_grow(aabb_grow(aabb_empty(), random_vec3(rng, -2, 2)), random_vec3(rng, -2, 2));
+}
+
+void
+check_geometry(Pcg32 &rng) {
+  AABB const unit = {.min = {.x = 0, .y = 0, .z = 0}, .max = {.x = 1, .y = 1, .z = 1}};
+  AABB const slab = {.min = {.x = 0, .y = 0, .z = 0}, .max = {.x = 4, .y = 2, .z = 1}};
+
+  math_expect_(is_empty(aabb_empty()) && surface_area(aabb_empty()) == 0);
+  math_expect_(!is_empty(unit) && surface_area(unit) == 6 && surface_area(slab) == 28);
+  Vec3 const slab_center = {.x = 2, .y = 1, .z = 0.5f};
+  math_expect_(center(slab) == slab_center && largest_axis(slab) == 0);
+  math_expect_(aabb_union(aabb_empty(), unit).min == unit.min && aabb_union(unit, aabb_empty()).max == unit.max);
+  AABB const grown = aabb_grow(unit, {.x = -1, .y = 0.5f, .z = 3});
+  math_expect_(grown.min.x == -1 && grown.max.z == 3 && grown.min.y == 0 && grown.max.y == 1);
+
+  // Edge cases of the slab test.
+  struct {
+    Vec3 origin, dir;
+    bool hit;
+  } const cases[] = {
+    {{.x = -1, .y = 0.5f, .z = 0.5f}, {.x =  1, .y = 0, .z =  0}, true},
+    {{.x =  2, .y = 0.5f, .z = 0.5f}, {.x = -1, .y = 0, .z = -0.f}, true},
+    {{.x =  2, .y = 0.5f, .z = 0.5f}, {.x =  1, .y = 0, .z =  0}, false},
+    {{.x = -1, .y = 0,    .z = 0.5f}, {.x =  1, .y = 0, .z =  0}, true},  // On the min face.
+    {{.x = -1, .y = 1,    .z = 1},    {.x =  1, .y = 0, .z =  0}, true},  // Along the max edge.
+    {{.x = -1, .y = 1.5f, .z = 0.5f}, {.x =  1, .y = 0, .z =  0}, false},
+    {{.x =  0, .y = 0,    .z = 0},    {.x =  0, .y = 0, .z =  1}, true},  // Origin on a corner.
+    {{.x =  0, .y = -1,   .z = 0.5f}, {.x =  1, .y = 1, .z =  0}, true},  // Through an edge.
+    {{.x =  0, .y = -1.001f, .z = 0.5f}, {.x = 1, .y = 1, .z = 0}, false},
+  };
+
+  for (auto const &c : cases) {
+    Ray const ray = make_ray(c.origin, c.dir);
+    f32 t_entry;
+    math_expect_(intersect(ray, unit, 0, FLT_MAX, t_entry) == c.hit);
+    math_expect_(!intersect(ray, aabb_empty(), -FLT_MAX, FLT_MAX, t_entry));
+  }
+
+  // @Note: origin*inv_dir would be 0*inf here, which must not drop the x axis.
+  AABB const shifted = {.min = {.x = 1, .y = -1, .z = -1}, .max = {.x = 2, .y = 1, .z = 1}};
+  f32 t_entry;
+  math_expect_(!intersect(make_ray({}, {.x = 0, .y = 0, .z = 1}), shifted, -FLT_MAX, FLT_MAX, t_entry));
+  math_expect_(intersect(make_ray({.x = -2, .y = 0.5f, .z = 0.5f}, {.x = 1, .y = 0, .z = 0}), unit, 0, 10, t_entry) && t_entry == 2);
+  math_expect_(intersect(make_ray({.x = 0.5f, .y = 0.5f, .z = 0.5f}, {.x = 1, .y = 0, .z = 0}), unit, 0, 10, t_entry) && t_entry == 0);
+  math_expect_(!intersect(make_ray({.x = -2, .y = 0.5f, .z = 0.5f}, {.x = 1, .y = 0, .z = 0}), unit, 0, 1.5f, t_entry));
+
+  // Random rays against the f64 reference, away from the grazing cases.
+  bool agrees = true;
+  for (s32 it = 0; it < 20000; it++) {
+    AABB const box = random_aabb(rng);
+    Ray  const ray = random_ray(rng, box);
+    f32  const t_max = (next_u32(rng) & 1) ? FLT_MAX : random_f32(rng, 0, 8);
+
+    f64 entry, leave;
+    reference_slabs(ray, box, 0, t_max, entry, leave);
+
+    f32 t;
+    bool const hit = intersect(ray, box, 0, t_max, t);
+    if (leave - entry > 1e-4) {
+      agrees &= hit && near(t, entry, 1e-4);
+    } else if (leave - entry < -1e-4) {
+      agrees &= !hit;
+    }
+  }
+  math_expect_(agrees);
+
+  // Grazing hits are never lost: rays aimed exactly at the box's corners.
+  bool corners_hit = true;
+  for (s32 it = 0; it < 4096; it++) {
+    AABB const box    = random_aabb(rng);
+    Vec3 const corner = {
+      .x = (it & 1) ? box.max.x : box.min.x,
+      .y = (it & 2) ? box.max.y : box.min.y,
+      .z = (it & 4) ? box.max.z : box.min.z
+    };
+    Vec3 const origin = random_vec3(rng, -8, 8);
+
+    f32 t;
+    corners_hit &= intersect(make_ray(origin, corner - origin), box, 0, FLT_MAX, t);
+  }
+  math_expect_(corners_hit);
+
+  // Wide variants match the scalar one lane by lane (partially filled nodes too).
+  bool lanes_ok = true;
+  bool const has_avx2 = os_get_cpu_info().isa_level >= IsaLevel_AVX2;
+  for (s32 it = 0; it < 2048; it++) {
+    AABB boxes[8];
+    for (AABB &box : boxes) {
+      box = random_aabb(rng);
+    }
+    Ray const ray   = random_ray(rng, boxes[0]);
+    s32 const count = 1 + (s32)next_u32_below(rng, 8);
+
+    AABBx4 const boxes4 = load_aabbx4(boxes, (count < 4) ? count : 4);
+    F32x4 t4;
+    u32 const bits4 = to_bits(intersect(ray, boxes4, 0, 100, t4));
+
+    for (s32 i = 0; i < 4; i++) {
+      f32 t;
+      bool const hit = (i < count) && intersect(ray, boxes[i], 0, 100, t);
+      lanes_ok &= (((bits4 >> i) & 1) == (u32)hit) && (!hit || lane(t4, i) == t);
+      lanes_ok &= (i >= count) || (lane(boxes4, i).max == boxes[i].max);
+    }
+
+    if (has_avx2) {
+      AABBx8 const boxes8 = load_aabbx8(boxes, count);
+      F32x8 t8;
+      u32 const bits8 = to_bits(intersect(ray, boxes8, 0, 100, t8));
+
+      for (s32 i = 0; i < 8; i++) {
+        f32 t;
+        bool const hit = (i < count) && intersect(ray, boxes[i], 0, 100, t);
+        lanes_ok &= (((bits8 >> i) & 1) == (u32)hit) && (!hit || lane(t8, i) == t);
+      }
+    }
+  }
+  math_expect_(lanes_ok);
+}
+
+/**
+ * Benchmarks
+*/
+
+// Calls `fn(i)` for MATH_BENCHMARK_TIME and logs the time per operation.
+template <typename TFn>
+void
+bench(char const *name, s32 ops_per_call, TFn fn) {
+  f32 sink = 0;
+  for (s32 i = 0; i < 256; i++) {
+    sink += fn(i);
+  }
+
+  s64 calls   = 0;
+  f64 elapsed = 0;
+  f64 const start = os_get_app_uptime_precise();
+  do {
+    for (s32 i = 0; i < 1024; i++) {
+      sink += fn(i);
+    }
+    calls  += 1024;
+    elapsed = os_get_app_uptime_precise() - start;
+  } while (elapsed < MATH_BENCHMARK_TIME);
+
+  gMath_Bench_Sink = sink;
+  logf("  %-36s %8.2f ns/op\n", name, elapsed*1e9/((f64)calls*ops_per_call));
+}
+} // namespace impl
+
+[[nodiscard]] s32
+math_run_checks() {
+  using Check_Fn = void(Pcg32 &rng);
+  struct {
+    char const *name;
+    Check_Fn   *fn;
+  } const groups[] = {
+    {"vectors",    impl::check_vectors},
+    {"matrices",   impl::check_matrices},
+    {"quats",      impl::check_quats},
+    {"batches",    impl::check_batches},
+    {"packets",    impl::check_packets},
+    {"fast math",  [](Pcg32&) { impl::check_fast_math(); }},
+    {"random",     [](Pcg32&) { impl::check_random(); }},
+    {"sampling",   [](Pcg32&) { impl::check_sampling(); }},
+    {"geometry",   impl::check_geometry},
+  };
+
+  impl::gMath_Check = {};
+  Pcg32 rng = pcg32_seed(0x5eed, 0);
+
+  for (auto const &group : groups) {
+    impl::gMath_Check.group = group.name;
+
+    s32 const failed_before = impl::gMath_Check.failed;
+    s32 const count_before  = impl::gMath_Check.count;
+    group.fn(rng);
+
+    logf("Math check: %-10s %5d checks, %d failed\n", group.name,
+         impl::gMath_Check.count - count_before, impl::gMath_Check.failed - failed_before);
+  }
+
+  logf("Math check: %d of %d checks failed\n", impl::gMath_Check.failed, impl::gMath_Check.count);
+  return impl::gMath_Check.failed;
+}
+
+void
+math_run_benchmarks() {
+  using namespace impl;
+
+  Pcg32 rng = pcg32_seed(0xbe4c, 0);
+
+  // Varied inputs, so nothing gets hoisted out of the loops.
+  s32 constexpr INPUT_COUNT = 256;
+  s32 constexpr INPUT_MASK  = INPUT_COUNT - 1;
+  Vec3   static vec3s[INPUT_COUNT];
+  Vec4   static vec4s[INPUT_COUNT];
+  f32    static scalars[INPUT_COUNT + 8];
+  Mat4x4 static mats[INPUT_COUNT];
+  Quat   static quats[INPUT_COUNT];
+
+  for (s32 i = 0; i < INPUT_COUNT; i++) {
+    vec3s[i] = random_vec3(rng, -10, 10);
+    vec4s[i] = random_vec<Vec4, 4>(rng, -10, 10);
+    mats[i]  = random_affine(rng);
+    quats[i] = quat_from_axis_angle(random_unit_vec3(rng), random_f32(rng, -3, 3));
+  }
+  for (s32 i = 0; i < INPUT_COUNT + 8; i++) {
+    scalars[i] = random_f32(rng, 0.01f, 3);
+  }
+
+  logf("Math benchmarks (%.0f ms each):\n", MATH_BENCHMARK_TIME*1000);
+
+  bench("dot(Vec3)", 1, [&](s32 i) { return dot(vec3s[i & INPUT_MASK], vec3s[(i + 1) & INPUT_MASK]); });
+  bench("dot(Vec4)", 1, [&](s32 i) { return dot(vec4s[i & INPUT_MASK], vec4s[(i + 1) & INPUT_MASK]); });
+  bench("cross(Vec3)", 1, [&](s32 i) { return cross(vec3s[i & INPUT_MASK], vec3s[(i + 1) & INPUT_MASK]).x; });
+  bench("normalized(Vec3)", 1, [&](s32 i) { return normalized(vec3s[i & INPUT_MASK]).x; });
+  bench("normalized(Vec4)", 1, [&](s32 i) { return normalized(vec4s[i & INPUT_MASK]).x; });
+  bench("transformed_point(Vec4)", 1, [&](s32 i) {
+    return transformed_point(vec4s[i & INPUT_MASK], mats[(i + 1) & INPUT_MASK]).x;
+  });
+  bench("transpose", 1, [&](s32 i) { return transpose(mats[i & INPUT_MASK]).v[0][1]; });
+  bench("inverse", 1, [&](s32 i) { return inverse(mats[i & INPUT_MASK]).v[0][0]; });
+  bench("affine_inverse", 1, [&](s32 i) { return affine_inverse(mats[i & INPUT_MASK]).v[0][0]; });
+  bench("rigid_inverse", 1, [&](s32 i) { return rigid_inverse(mats[i & INPUT_MASK]).v[0][0]; });
+  bench("combine(Quat)", 1, [&](s32 i) { return combine(quats[i & INPUT_MASK], quats[(i + 1) & INPUT_MASK]).w; });
+  bench("slerp", 1, [&](s32 i) { return slerp(quats[i & INPUT_MASK], quats[(i + 1) & INPUT_MASK], 0.3f).w; });
+
+  s64 constexpr POINT_COUNT = 4096;
+  f32 static points[6][POINT_COUNT];
+  Vec3_Soa const src = {points[0], points[1], points[2]};
+  Vec3_Soa const dst = {points[3], points[4], points[5]};
+  for (s64 i = 0; i < POINT_COUNT; i++) {
+    src.x[i] = random_f32(rng, -10, 10);
+    src.y[i] = random_f32(rng, -10, 10);
+    src.z[i] = random_f32(rng, -10, 10);
+  }
+
+  for_each_isa_level([&](Isa_Level level) {
+    char const *isa = os_isa_level_name(level);
+    bench(as_cstr(tprint("combine (%s)", isa)), 1, [&](s32 i) {
+      return combine(mats[i & INPUT_MASK], mats[(i + 1) & INPUT_MASK]).v[0][0];
+    });
+    bench(as_cstr(tprint("transform_points_soa (%s, per point)", isa)), POINT_COUNT, [&](s32 i) {
+      return transform_points_soa(src, dst, POINT_COUNT, mats[i & INPUT_MASK]).min.x;
+    });
+  });
+
+  bench("std::sin", 1, [&](s32 i) { return std::sin(scalars[i & INPUT_MASK]); });
+  bench("fast_sin", 1, [&](s32 i) { return fast_sin(scalars[i & INPUT_MASK]); });
+  bench("fast_sin (F32x4, per lane)", 4, [&](s32 i) { return lane(fast_sin(load_f32x4(scalars + (i & INPUT_MASK))), 0); });
+  bench("std::exp", 1, [&](s32 i) { return std::exp(scalars[i & INPUT_MASK]); });
+  bench("fast_exp", 1, [&](s32 i) { return fast_exp(scalars[i & INPUT_MASK]); });
+  bench("std::log", 1, [&](s32 i) { return std::log(scalars[i & INPUT_MASK]); });
+  bench("fast_log", 1, [&](s32 i) { return fast_log(scalars[i & INPUT_MASK]); });
+  bench("std::atan2", 1, [&](s32 i) { return std::atan2(scalars[i & INPUT_MASK], scalars[(i + 1) & INPUT_MASK]); });
+  bench("fast_atan2", 1, [&](s32 i) { return fast_atan2(scalars[i & INPUT_MASK], scalars[(i + 1) & INPUT_MASK]); });
+  bench("1/std::sqrt", 1, [&](s32 i) { return 1/std::sqrt(scalars[i & INPUT_MASK]); });
+  bench("fast_rsqrt", 1, [&](s32 i) { return fast_rsqrt(scalars[i & INPUT_MASK]); });
+
+  Pcg32 pcg = pcg32_seed(1, 2);
+  bench("next_f32(Pcg32)", 1, [&](s32) { return next_f32(pcg); });
+  bench("philox4x32 (per number)", 4, [&](s32 i) { return (f32)philox_sample(i, 0, 0, 1).v[0]; });
+  bench("random_hash_f32", 1, [&](s32 i) { return random_hash_f32(i, 1, 2, 3); });
+  bench("sobol_owen", 1, [&](s32 i) { return sobol_owen(i, 3, 1234); });
+
+  AABB static boxes[INPUT_COUNT + 8];
+  Ray  static rays[INPUT_COUNT];
+  for (s32 i = 0; i < INPUT_COUNT + 8; i++) {
+    boxes[i] = random_aabb(rng);
+  }
+  for (s32 i = 0; i < INPUT_COUNT; i++) {
+    rays[i] = make_ray(random_vec3(rng, -4, 4), random_unit_vec3(rng));
+  }
+  AABBx4 static boxes4[INPUT_COUNT];
+  for (s32 i = 0; i < INPUT_COUNT; i++) {
+    boxes4[i] = load_aabbx4(boxes + i, 4);
+  }
+
+  bench("intersect(Ray, AABB)", 1, [&](s32 i) {
+    f32 t;
+    return intersect(rays[i & INPUT_MASK], boxes[(i*7) & INPUT_MASK], 0, FLT_MAX, t) ? t : 0;
+  });
+  bench("intersect(Ray, AABBx4, per box)", 4, [&](s32 i) {
+    F32x4 t;
+    return (f32)to_bits(intersect(rays[i & INPUT_MASK], boxes4[(i*7) & INPUT_MASK], 0, FLT_MAX, t));
+  });
+
+  if (os_get_cpu_info().isa_level >= IsaLevel_AVX2) {
+    bench("fast_sin (F32x8, per lane)", 8, [&](s32 i) { return lane(fast_sin(load_f32x8(scalars + (i & INPUT_MASK))), 0); });
+    Pcg32x8 pcg8 = pcg32x8_seed(1, u32x8_iota(0));
+    bench("next_f32(Pcg32x8, per lane)", 8, [&](s32) { return lane(next_f32(pcg8), 0); });
+    bench("random_hash_f32 (U32x8, per lane)", 8, [&](s32 i) {
+      return lane(random_hash_f32(u32x8_iota(i*8), u32x8(1), 2, 3), 0);
+    });
+
+    AABBx8 static boxes8[INPUT_COUNT];
+    for (s32 i = 0; i < INPUT_COUNT; i++) {
+      boxes8[i] = load_aabbx8(boxes + i, 8);
+    }
+    bench("intersect(Ray, AABBx8, per box)", 8, [&](s32 i) {
+      F32x8 t;
+      return (f32)to_bits(intersect(rays[i & INPUT_MASK], boxes8[(i*7) & INPUT_MASK], 0, FLT_MAX, t));
+    });
+  }
+
+  for (s32 type = 0; type < SamplerType_Count; type++) {
+    Sampler sampler = sampler_init((Sampler_Type)type, 7);
+    bench(as_cstr(tprint("sampler_next_2d (%s)", sampler_type_name((Sampler_Type)type))), 1, [&](s32 i) {
+      sampler_start(sampler, i & 63, i >> 6, i);
+      return sampler_next_2d(sampler).x;
+    });
+  }
+}
+
+#undef math_expect_
+} // namespace rt
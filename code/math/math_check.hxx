@@ -0,0 +1,19 @@
+/**
+ * Self-check and micro-benchmarks of the math module:
+ *
+ *    rt_internal.exe --math-check [--bench]
+ *
+ * Every function is compared against a plain reference (scalar code, f64 or known
+ * answers), the SIMD kernels at every ISA level the CPU supports. The benchmarks log
+ * the time per call, so SIMD and approximation work can be judged on both accuracy
+ * and speed.
+*/
+
+namespace rt {
+// Logs every failed check. Returns the number of failures.
+[[nodiscard]] s32
+math_run_checks();
+
+void
+math_run_benchmarks();
+} // namespace rt
@@ -0,0 +1,807 @@
+namespace rt {
+/**
+ * 4 lanes
+*/
+
+[[nodiscard]] F32x4
+f32x4(f32 x) {
+  return {_mm_set1_ps(x)};
+}
+
+[[nodiscard]] Vec3x4
+vec3x4(Vec3 v) {
+  return {f32x4(v.x), f32x4(v.y), f32x4(v.z)};
+}
+
+[[nodiscard]] F32x4
+load_f32x4(f32 const *src) {
+  return {_mm_loadu_ps(src)};
+}
+
+[[nodiscard]] F32x4
+load_u8_f32x4(u8 const *src) {
+  s32 bytes;
+  mem_copy_(&bytes, src, sizeof(bytes));
+
+  __m128i const zero  = _mm_setzero_si128();
+  __m128i const words = _mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero);
+  return {_mm_cvtepi32_ps(_mm_unpacklo_epi16(words, zero))};
+}
+
+[[nodiscard]] Vec3x4
+load_vec3x4(Vec3_Soa src, s64 offset) {
+  return {
+    load_f32x4(src.x + offset), 
+    load_f32x4(src.y + offset), 
+    load_f32x4(src.z + offset)
+  };
+}
+
+void
+store(f32 *dst, F32x4 v) {
+  _mm_storeu_ps(dst, v.m);
+}
+
+void
+store(Vec3_Soa dst, s64 offset, Vec3x4 v) {
+  store(dst.x + offset, v.x);
+  store(dst.y + offset, v.y);
+  store(dst.z + offset, v.z);
+}
+
+[[nodiscard]] f32
+lane(F32x4 v, s32 i) {
+  dbg_check_(i >= 0 && i < 4);
+
+  alignas(16) f32 lanes[4];
+  _mm_store_ps(lanes, v.m);
+  return lanes[i];
+}
+
+[[nodiscard]] Vec3
+lane(Vec3x4 v, s32 i) {
+  return {.x = lane(v.x, i), .y = lane(v.y, i), .z = lane(v.z, i)};
+}
+
+[[nodiscard]] F32x4
+operator+(F32x4 a, F32x4 b) {
+  return {_mm_add_ps(a.m, b.m)};
+}
+
+[[nodiscard]] F32x4
+operator-(F32x4 a, F32x4 b) {
+  return {_mm_sub_ps(a.m, b.m)};
+}
+
+[[nodiscard]] F32x4
+operator*(F32x4 a, F32x4 b) {
+  return {_mm_mul_ps(a.m, b.m)};
+}
+
+[[nodiscard]] F32x4
+operator/(F32x4 a, F32x4 b) {
+  return {_mm_div_ps(a.m, b.m)};
+}
+
+[[nodiscard]] F32x4
+operator+(F32x4 a, f32 x) {
+  return a + f32x4(x);
+}
+
+[[nodiscard]] F32x4
+operator-(F32x4 a, f32 x) {
+  return a - f32x4(x);
+}
+
+[[nodiscard]] F32x4
+operator/(F32x4 a, f32 x) {
+  return a/f32x4(x);
+}
+
+[[nodiscard]] F32x4
+operator*(F32x4 a, f32 x) {
+  return {_mm_mul_ps(a.m, _mm_set1_ps(x))};
+}
+
+[[nodiscard]] F32x4
+operator-(F32x4 a) {
+  return {_mm_xor_ps(a.m, _mm_set1_ps(-0.f))};
+}
+
+F32x4&
+operator+=(F32x4 &a, F32x4 b) {
+  a = a + b;
+  return a;
+}
+
+F32x4&
+operator-=(F32x4 &a, F32x4 b) {
+  a = a - b;
+  return a;
+}
+
+F32x4&
+operator*=(F32x4 &a, F32x4 b) {
+  a = a * b;
+  return a;
+}
+
+F32x4&
+operator/=(F32x4 &a, F32x4 b) {
+  a = a / b;
+  return a;
+}
+
+[[nodiscard]] Mask4
+operator<(F32x4 a, F32x4 b) {
+  return {_mm_cmplt_ps(a.m, b.m)};
+}
+
+[[nodiscard]] Mask4
+operator<=(F32x4 a, F32x4 b) {
+  return {_mm_cmple_ps(a.m, b.m)};
+}
+
+[[nodiscard]] Mask4
+operator>(F32x4 a, F32x4 b) {
+  return {_mm_cmpgt_ps(a.m, b.m)};
+}
+
+[[nodiscard]] Mask4
+operator>=(F32x4 a, F32x4 b) {
+  return {_mm_cmpge_ps(a.m, b.m)};
+}
+
+[[nodiscard]] Mask4
+operator==(F32x4 a, F32x4 b) {
+  return {_mm_cmpeq_ps(a.m, b.m)};
+}
+
+[[nodiscard]] Mask4
+operator!=(F32x4 a, F32x4 b) {
+  return {_mm_cmpneq_ps(a.m, b.m)};
+}
+
+[[nodiscard]] Mask4
+operator<(F32x4 a, f32 x) {
+  return a < f32x4(x);
+}
+
+[[nodiscard]] Mask4
+operator<=(F32x4 a, f32 x) {
+  return a <= f32x4(x);
+}
+
+[[nodiscard]] Mask4
+operator>(F32x4 a, f32 x) {
+  return a > f32x4(x);
+}
+
+[[nodiscard]] Mask4
+operator>=(F32x4 a, f32 x) {
+  return a >= f32x4(x);
+}
+
+[[nodiscard]] Mask4
+operator&(Mask4 a, Mask4 b) {
+  return {_mm_and_ps(a.m, b.m)};
+}
+
+[[nodiscard]] Mask4
+operator|(Mask4 a, Mask4 b) {
+  return {_mm_or_ps(a.m, b.m)};
+}
+
+[[nodiscard]] Mask4
+operator^(Mask4 a, Mask4 b) {
+  return {_mm_xor_ps(a.m, b.m)};
+}
+
+[[nodiscard]] Mask4
+operator~(Mask4 a) {
+  return {_mm_xor_ps(a.m, _mm_castsi128_ps(_mm_set1_epi32(-1)))};
+}
+
+[[nodiscard]] Mask4
+and_not(Mask4 a, Mask4 b) {
+  return {_mm_andnot_ps(b.m, a.m)};
+}
+
+[[nodiscard]] u32
+to_bits(Mask4 m) {
+  return (u32)_mm_movemask_ps(m.m);
+}
+
+[[nodiscard]] bool
+any(Mask4 m) {
+  return to_bits(m) != 0;
+}
+
+[[nodiscard]] bool
+all(Mask4 m) {
+  return to_bits(m) == 0xf;
+}
+
+[[nodiscard]] bool
+none(Mask4 m) {
+  return to_bits(m) == 0;
+}
+
+[[nodiscard]] F32x4
+select(Mask4 mask, F32x4 a, F32x4 b) {
+  return {_mm_or_ps(_mm_and_ps(mask.m, a.m), _mm_andnot_ps(mask.m, b.m))};
+}
+
+[[nodiscard]] Vec3x4
+select(Mask4 mask, Vec3x4 a, Vec3x4 b) {
+  return {select(mask, a.x, b.x), select(mask, a.y, b.y), select(mask, a.z, b.z)};
+}
+
+[[nodiscard]] F32x4
+min(F32x4 a, F32x4 b) {
+  return {_mm_min_ps(a.m, b.m)};
+}
+
+[[nodiscard]] F32x4
+max(F32x4 a, F32x4 b) {
+  return {_mm_max_ps(a.m, b.m)};
+}
+
+[[nodiscard]] F32x4
+abs(F32x4 a) {
+  return {_mm_and_ps(a.m, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)))};
+}
+
+[[nodiscard]] F32x4
+sqrt(F32x4 a) {
+  return {_mm_sqrt_ps(a.m)};
+}
+
+[[nodiscard]] F32x4
+fmadd(F32x4 a, F32x4 b, F32x4 c) {
+  return {_mm_add_ps(_mm_mul_ps(a.m, b.m), c.m)};
+}
+
+[[nodiscard]] F32x4
+fmsub(F32x4 a, F32x4 b, F32x4 c) {
+  return {_mm_sub_ps(_mm_mul_ps(a.m, b.m), c.m)};
+}
+
+[[nodiscard]] f32
+reduce_add(F32x4 v) {
+  __m128 m = v.m;
+  m = _mm_add_ps(m, _mm_movehl_ps(m, m));
+  m = _mm_add_ss(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 1, 1, 1)));
+  return _mm_cvtss_f32(m);
+}
+
+[[nodiscard]] f32
+reduce_min(F32x4 v) {
+  __m128 m = v.m;
+  m = _mm_min_ps(m, _mm_movehl_ps(m, m));
+  m = _mm_min_ss(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 1, 1, 1)));
+  return _mm_cvtss_f32(m);
+}
+
+[[nodiscard]] f32
+reduce_max(F32x4 v) {
+  __m128 m = v.m;
+  m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+  m = _mm_max_ss(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 1, 1, 1)));
+  return _mm_cvtss_f32(m);
+}
+
+[[nodiscard]] Vec3x4
+operator+(Vec3x4 a, Vec3x4 b) {
+  return {a.x + b.x, a.y + b.y, a.z + b.z};
+}
+
+[[nodiscard]] Vec3x4
+operator-(Vec3x4 a, Vec3x4 b) {
+  return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+[[nodiscard]] Vec3x4
+operator*(Vec3x4 a, Vec3x4 b) {
+  return {a.x * b.x, a.y * b.y, a.z * b.z};
+}
+
+[[nodiscard]] Vec3x4
+operator/(Vec3x4 a, Vec3x4 b) {
+  return {a.x / b.x, a.y / b.y, a.z / b.z};
+}
+
+[[nodiscard]] Vec3x4
+operator*(Vec3x4 v, F32x4 x) {
+  return {v.x*x, v.y*x, v.z*x};
+}
+
+[[nodiscard]] Vec3x4
+operator*(Vec3x4 v, f32 x) {
+  return v*f32x4(x);
+}
+
+[[nodiscard]] Vec3x4
+operator+(Vec3x4 a, Vec3 b) {
+  return a + vec3x4(b);
+}
+
+[[nodiscard]] Vec3x4
+operator-(Vec3x4 a, Vec3 b) {
+  return a - vec3x4(b);
+}
+
+[[nodiscard]] Vec3x4
+operator-(Vec3x4 v) {
+  return {-v.x, -v.y, -v.z};
+}
+
+Vec3x4&
+operator+=(Vec3x4 &a, Vec3x4 b) {
+  a = a + b;
+  return a;
+}
+
+Vec3x4&
+operator-=(Vec3x4 &a, Vec3x4 b) {
+  a = a - b;
+  return a;
+}
+
+Vec3x4&
+operator*=(Vec3x4 &a, Vec3x4 b) {
+  a = a*b;
+  return a;
+}
+
+Vec3x4&
+operator*=(Vec3x4 &a, F32x4 x) {
+  a = a*x;
+  return a;
+}
+
+[[nodiscard]] F32x4
+dot(Vec3x4 a, Vec3x4 b) {
+  return fmadd(a.x, b.x, fmadd(a.y, b.y, a.z*b.z));
+}
+
+[[nodiscard]] Vec3x4
+cross(Vec3x4 a, Vec3x4 b) {
+  return {
+    fmsub(a.y, b.z, a.z*b.y),
+    fmsub(a.z, b.x, a.x*b.z),
+    fmsub(a.x, b.y, a.y*b.x)
+  };
+}
+
+[[nodiscard]] F32x4
+len_sq(Vec3x4 v) {
+  return dot(v, v);
+}
+
+[[nodiscard]] F32x4
+len(Vec3x4 v) {
+  return sqrt(dot(v, v));
+}
+
+[[nodiscard]] Vec3x4
+normalized(Vec3x4 v) {
+  return v*(f32x4(1.f)/len(v));
+}
+
+[[nodiscard]] Vec3x4
+min(Vec3x4 a, Vec3x4 b) {
+  return {min(a.x, b.x), min(a.y, b.y), min(a.z, b.z)};
+}
+
+[[nodiscard]] Vec3x4
+max(Vec3x4 a, Vec3x4 b) {
+  return {max(a.x, b.x), max(a.y, b.y), max(a.z, b.z)};
+}
+
+[[nodiscard]] Vec3x4
+fmadd(Vec3x4 a, F32x4 b, Vec3x4 c) {
+  return {fmadd(a.x, b, c.x), fmadd(a.y, b, c.y), fmadd(a.z, b, c.z)};
+}
+
+/**
+ * 8 lanes
+*/
+
+[[nodiscard]] F32x8
+f32x8(f32 x) {
+  return {_mm256_set1_ps(x)};
+}
+
+[[nodiscard]] Vec3x8
+vec3x8(Vec3 v) {
+  return {f32x8(v.x), f32x8(v.y), f32x8(v.z)};
+}
+
+[[nodiscard]] F32x8
+load_f32x8(f32 const *src) {
+  return {_mm256_loadu_ps(src)};
+}
+
+[[nodiscard]] F32x8
+load_u8_f32x8(u8 const *src) {
+  __m128i const bytes = _mm_loadl_epi64((__m128i const*)src);
+  return {_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes))};
+}
+
+[[nodiscard]] Vec3x8
+load_vec3x8(Vec3_Soa src, s64 offset) {
+  return {
+    load_f32x8(src.x + offset), 
+    load_f32x8(src.y + offset), 
+    load_f32x8(src.z + offset)
+  };
+}
+
+void
+store(f32 *dst, F32x8 v) {
+  _mm256_storeu_ps(dst, v.m);
+}
+
+void
+store(Vec3_Soa dst, s64 offset, Vec3x8 v) {
+  store(dst.x + offset, v.x);
+  store(dst.y + offset, v.y);
+  store(dst.z + offset, v.z);
+}
+
+[[nodiscard]] f32
+lane(F32x8 v, s32 i) {
+  dbg_check_(i >= 0 && i < 8);
+
+  alignas(32) f32 lanes[8];
+  _mm256_store_ps(lanes, v.m);
+  return lanes[i];
+}
+
+[[nodiscard]] Vec3
+lane(Vec3x8 v, s32 i) {
+  return {.x = lane(v.x, i), .y = lane(v.y, i), .z = lane(v.z, i)};
+}
+
+[[nodiscard]] F32x8
+operator+(F32x8 a, F32x8 b) {
+  return {_mm256_add_ps(a.m, b.m)};
+}
+
+[[nodiscard]] F32x8
+operator-(F32x8 a, F32x8 b) {
+  return {_mm256_sub_ps(a.m, b.m)};
+}
+
+[[nodiscard]] F32x8
+operator*(F32x8 a, F32x8 b) {
+  return {_mm256_mul_ps(a.m, b.m)};
+}
+
+[[nodiscard]] F32x8
+operator/(F32x8 a, F32x8 b) {
+  return {_mm256_div_ps(a.m, b.m)};
+}
+
+[[nodiscard]] F32x8
+operator+(F32x8 a, f32 x) {
+  return a + f32x8(x);
+}
+
+[[nodiscard]] F32x8
+operator-(F32x8 a, f32 x) {
+  return a - f32x8(x);
+}
+
+[[nodiscard]] F32x8
+operator/(F32x8 a, f32 x) {
+  return a/f32x8(x);
+}
+
+[[nodiscard]] F32x8
+operator*(F32x8 a, f32 x) {
+  return {_mm256_mul_ps(a.m, _mm256_set1_ps(x))};
+}
+
+[[nodiscard]] F32x8
+operator-(F32x8 a) {
+  return {_mm256_xor_ps(a.m, _mm256_set1_ps(-0.f))};
+}
+
+F32x8&
+operator+=(F32x8 &a, F32x8 b) {
+  a = a + b;
+  return a;
+}
+
+F32x8&
+operator-=(F32x8 &a, F32x8 b) {
+  a = a - b;
+  return a;
+}
+
+F32x8&
+operator*=(F32x8 &a, F32x8 b) {
+  a = a * b;
+  return a;
+}
+
+F32x8&
+operator/=(F32x8 &a, F32x8 b) {
+  a = a / b;
+  return a;
+}
+
+[[nodiscard]] Mask8
+operator<(F32x8 a, F32x8 b) {
+  return {_mm256_cmp_ps(a.m, b.m, _CMP_LT_OQ)};
+}
+
+[[nodiscard]] Mask8
+operator<=(F32x8 a, F32x8 b) {
+  return {_mm256_cmp_ps(a.m, b.m, _CMP_LE_OQ)};
+}
+
+[[nodiscard]] Mask8
+operator>(F32x8 a, F32x8 b) {
+  return {_mm256_cmp_ps(a.m, b.m, _CMP_GT_OQ)};
+}
+
+[[nodiscard]] Mask8
+operator>=(F32x8 a, F32x8 b) {
+  return {_mm256_cmp_ps(a.m, b.m, _CMP_GE_OQ)};
+}
+
+[[nodiscard]] Mask8
+operator==(F32x8 a, F32x8 b) {
+  return {_mm256_cmp_ps(a.m, b.m, _CMP_EQ_OQ)};
+}
+
+[[nodiscard]] Mask8
+operator!=(F32x8 a, F32x8 b) {
+  return {_mm256_cmp_ps(a.m, b.m, _CMP_NEQ_UQ)};
+}
+
+[[nodiscard]] Mask8
+operator<(F32x8 a, f32 x) {
+  return a < f32x8(x);
+}
+
+[[nodiscard]] Mask8
+operator<=(F32x8 a, f32 x) {
+  return a <= f32x8(x);
+}
+
+[[nodiscard]] Mask8
+operator>(F32x8 a, f32 x) {
+  return a > f32x8(x);
+}
+
+[[nodiscard]] Mask8
+operator>=(F32x8 a, f32 x) {
+  return a >= f32x8(x);
+}
+
+[[nodiscard]] Mask8
+operator&(Mask8 a, Mask8 b) {
+  return {_mm256_and_ps(a.m, b.m)};
+}
+
+[[nodiscard]] Mask8
+operator|(Mask8 a, Mask8 b) {
+  return {_mm256_or_ps(a.m, b.m)};
+}
+
+[[nodiscard]] Mask8
+operator^(Mask8 a, Mask8 b) {
+  return {_mm256_xor_ps(a.m, b.m)};
+}
+
+[[nodiscard]] Mask8
+operator~(Mask8 a) {
+  return {_mm256_xor_ps(a.m, _mm256_castsi256_ps(_mm256_set1_epi32(-1)))};
+}
+
+[[nodiscard]] Mask8
+and_not(Mask8 a, Mask8 b) {
+  return {_mm256_andnot_ps(b.m, a.m)};
+}
+
+[[nodiscard]] u32
+to_bits(Mask8 m) {
+  return (u32)_mm256_movemask_ps(m.m);
+}
+
+[[nodiscard]] bool
+any(Mask8 m) {
+  return to_bits(m) != 0;
+}
+
+[[nodiscard]] bool
+all(Mask8 m) {
+  return to_bits(m) == 0xff;
+}
+
+[[nodiscard]] bool
+none(Mask8 m) {
+  return to_bits(m) == 0;
+}
+
+[[nodiscard]] F32x8
+select(Mask8 mask, F32x8 a, F32x8 b) {
+  return {_mm256_blendv_ps(b.m, a.m, mask.m)};
+}
+
+[[nodiscard]] Vec3x8
+select(Mask8 mask, Vec3x8 a, Vec3x8 b) {
+  return {select(mask, a.x, b.x), select(mask, a.y, b.y), select(mask, a.z, b.z)};
+}
+
+[[nodiscard]] F32x8
+min(F32x8 a, F32x8 b) {
+  return {_mm256_min_ps(a.m, b.m)};
+}
+
+[[nodiscard]] F32x8
+max(F32x8 a, F32x8 b) {
+  return {_mm256_max_ps(a.m, b.m)};
+}
+
+[[nodiscard]] F32x8
+abs(F32x8 a) {
+  return {_mm256_and_ps(a.m, _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff)))};
+}
+
+[[nodiscard]] F32x8
+sqrt(F32x8 a) {
+  return {_mm256_sqrt_ps(a.m)};
+}
+
+[[nodiscard]] F32x8
+fmadd(F32x8 a, F32x8 b, F32x8 c) {
+  return {_mm256_fmadd_ps(a.m, b.m, c.m)};
+}
+
+[[nodiscard]] F32x8
+fmsub(F32x8 a, F32x8 b, F32x8 c) {
+  return {_mm256_fmsub_ps(a.m, b.m, c.m)};
+}
+
+[[nodiscard]] f32
+reduce_add(F32x8 v) {
+  __m128 m = _mm_add_ps(_mm256_castps256_ps128(v.m), _mm256_extractf128_ps(v.m, 1));
+  m = _mm_add_ps(m, _mm_movehl_ps(m, m));
+  m = _mm_add_ss(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 1, 1, 1)));
+  return _mm_cvtss_f32(m);
+}
+
+[[nodiscard]] f32
+reduce_min(F32x8 v) {
+  __m128 m = _mm_min_ps(_mm256_castps256_ps128(v.m), _mm256_extractf128_ps(v.m, 1));
+  m = _mm_min_ps(m, _mm_movehl_ps(m, m));
+  m = _mm_min_ss(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 1, 1, 1)));
+  return _mm_cvtss_f32(m);
+}
+
+[[nodiscard]] f32
+reduce_max(F32x8 v) {
+  __m128 m = _mm_max_ps(_mm256_castps256_ps128(v.m), _mm256_extractf128_ps(v.m, 1));
+  m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+  m = _mm_max_ss(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 1, 1, 1)));
+  return _mm_cvtss_f32(m);
+}
+
+[[nodiscard]] Vec3x8
+operator+(Vec3x8 a, Vec3x8 b) {
+  return {a.x + b.x, a.y + b.y, a.z + b.z};
+}
+
+[[nodiscard]] Vec3x8
+operator-(Vec3x8 a, Vec3x8 b) {
+  return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+[[nodiscard]] Vec3x8
+operator*(Vec3x8 a, Vec3x8 b) {
+  return {a.x * b.x, a.y * b.y, a.z * b.z};
+}
+
+[[nodiscard]] Vec3x8
+operator/(Vec3x8 a, Vec3x8 b) {
+  return {a.x / b.x, a.y / b.y, a.z / b.z};
+}
+
+[[nodiscard]] Vec3x8
+operator*(Vec3x8 v, F32x8 x) {
+  return {v.x*x, v.y*x, v.z*x};
+}
+
+[[nodiscard]] Vec3x8
+operator*(Vec3x8 v, f32 x) {
+  return v*f32x8(x);
+}
+
+[[nodiscard]] Vec3x8
+operator+(Vec3x8 a, Vec3 b) {
+  return a + vec3x8(b);
+}
+
+[[nodiscard]] Vec3x8
+operator-(Vec3x8 a, Vec3 b) {
+  return a - vec3x8(b);
+}
+
+[[nodiscard]] Vec3x8
+operator-(Vec3x8 v) {
+  return {-v.x, -v.y, -v.z};
+}
+
+Vec3x8&
+operator+=(Vec3x8 &a, Vec3x8 b) {
+  a = a + b;
+  return a;
+}
+
+Vec3x8&
+operator-=(Vec3x8 &a, Vec3x8 b) {
+  a = a - b;
+  return a;
+}
+
+Vec3x8&
+operator*=(Vec3x8 &a, Vec3x8 b) {
+  a = a*b;
+  return a;
+}
+
+Vec3x8&
+operator*=(Vec3x8 &a, F32x8 x) {
+  a = a*x;
+  return a;
+}
+
+[[nodiscard]] F32x8
+dot(Vec3x8 a, Vec3x8 b) {
+  return fmadd(a.x, b.x, fmadd(a.y, b.y, a.z*b.z));
+}
+
+[[nodiscard]] Vec3x8
+cross(Vec3x8 a, Vec3x8 b) {
+  return {
+    fmsub(a.y, b.z, a.z*b.y),
+    fmsub(a.z, b.x, a.x*b.z),
+    fmsub(a.x, b.y, a.y*b.x)
+  };
+}
+
+[[nodiscard]] F32x8
+len_sq(Vec3x8 v) {
+  return dot(v, v);
+}
+
+[[nodiscard]] F32x8
+len(Vec3x8 v) {
+  return sqrt(dot(v, v));
+}
+
+[[nodiscard]] Vec3x8
+normalized(Vec3x8 v) {
+  return v*(f32x8(1.f)/len(v));
+}
+
+[[nodiscard]] Vec3x8
+min(Vec3x8 a, Vec3x8 b) {
+  return {min(a.x, b.x), min(a.y, b.y), min(a.z, b.z)};
+}
+
+[[nodiscard]] Vec3x8
+max(Vec3x8 a, Vec3x8 b) {
+  return {max(a.x, b.x), max(a.y, b.y), max(a.z, b.z)};
+}
+
+[[nodiscard]] Vec3x8
+fmadd(Vec3x8 a, F32x8 b, Vec3x8 c) {
+  return {fmadd(a.x, b, c.x), fmadd(a.y, b, c.y), fmadd(a.z, b, c.z)};
+}
+} // namespace rt
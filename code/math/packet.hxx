@@ -0,0 +1,216 @@
+/**
+ * Packet math: N lanes of f32/Vec3 processed at once, for tracing ray packets and
+ * shading batches of hits. The API mirrors vec.hxx, so a kernel can be written once as
+ * a template over the packet types and instantiated 4-wide (SSE2) and 8-wide (AVX2):
+ *
+ *    template <typename TF32, typename TVec3, typename TMask>
+ *    TMask hit_sphere(TVec3 o, TVec3 d, Vec3 center, f32 radius, TF32 &t) {...}
+ *
+ * Put both instantiations into Kernel_Variants (4-wide under IsaLevel_Scalar, 8-wide
+ * under IsaLevel_AVX2) to pick the right one at runtime.
+ *
+ * Masks are all-ones/all-zeros per lane, like the SIMD compare results. min/max
+ * return the second argument if either one is NaN.
+*/
+
+namespace rt {
+/**
+ * 4 lanes (SSE2)
+*/
+
+struct F32x4 {
+  __m128 m;
+};
+
+struct Mask4 {
+  __m128 m;
+};
+
+struct Vec3x4 {
+  F32x4 x, y, z;
+};
+
+[[nodiscard]] F32x4  f32x4(f32 x); // Broadcast.
+[[nodiscard]] Vec3x4 vec3x4(Vec3 v);
+[[nodiscard]] F32x4  load_f32x4(f32 const *src);  // Unaligned.
+[[nodiscard]] F32x4  load_u8_f32x4(u8 const *src); // 4 bytes, converted to floats.
+[[nodiscard]] Vec3x4 load_vec3x4(Vec3_Soa src, s64 offset);
+void store(f32 *dst, F32x4 v);
+void store(Vec3_Soa dst, s64 offset, Vec3x4 v);
+[[nodiscard]] f32  lane(F32x4 v, s32 i);
+[[nodiscard]] Vec3 lane(Vec3x4 v, s32 i);
+
+[[nodiscard]] F32x4 operator+(F32x4 a, F32x4 b);
+[[nodiscard]] F32x4 operator-(F32x4 a, F32x4 b);
+[[nodiscard]] F32x4 operator*(F32x4 a, F32x4 b);
+[[nodiscard]] F32x4 operator/(F32x4 a, F32x4 b);
+[[nodiscard]] F32x4 operator+(F32x4 a, f32 x);
+[[nodiscard]] F32x4 operator-(F32x4 a, f32 x);
+[[nodiscard]] F32x4 operator*(F32x4 a, f32 x);
+[[nodiscard]] F32x4 operator/(F32x4 a, f32 x);
+[[nodiscard]] F32x4 operator-(F32x4 a);
+F32x4& operator+=(F32x4 &a, F32x4 b);
+F32x4& operator-=(F32x4 &a, F32x4 b);
+F32x4& operator*=(F32x4 &a, F32x4 b);
+F32x4& operator/=(F32x4 &a, F32x4 b);
+
+[[nodiscard]] Mask4 operator< (F32x4 a, F32x4 b);
+[[nodiscard]] Mask4 operator<=(F32x4 a, F32x4 b);
+[[nodiscard]] Mask4 operator> (F32x4 a, F32x4 b);
+[[nodiscard]] Mask4 operator>=(F32x4 a, F32x4 b);
+[[nodiscard]] Mask4 operator==(F32x4 a, F32x4 b);
+[[nodiscard]] Mask4 operator!=(F32x4 a, F32x4 b);
+[[nodiscard]] Mask4 operator< (F32x4 a, f32 x);
+[[nodiscard]] Mask4 operator<=(F32x4 a, f32 x);
+[[nodiscard]] Mask4 operator> (F32x4 a, f32 x);
+[[nodiscard]] Mask4 operator>=(F32x4 a, f32 x);
+
+[[nodiscard]] Mask4 operator&(Mask4 a, Mask4 b);
+[[nodiscard]] Mask4 operator|(Mask4 a, Mask4 b);
+[[nodiscard]] Mask4 operator^(Mask4 a, Mask4 b);
+[[nodiscard]] Mask4 operator~(Mask4 a);
+[[nodiscard]] Mask4 and_not(Mask4 a, Mask4 b); // a & ~b
+
+[[nodiscard]] u32  to_bits(Mask4 m); // Lane i -> bit i.
+[[nodiscard]] bool any(Mask4 m);
+[[nodiscard]] bool all(Mask4 m);
+[[nodiscard]] bool none(Mask4 m);
+
+// mask ? a : b, per lane.
+[[nodiscard]] F32x4  select(Mask4 mask, F32x4 a, F32x4 b);
+[[nodiscard]] Vec3x4 select(Mask4 mask, Vec3x4 a, Vec3x4 b);
+
+[[nodiscard]] F32x4 min(F32x4 a, F32x4 b);
+[[nodiscard]] F32x4 max(F32x4 a, F32x4 b);
+[[nodiscard]] F32x4 abs(F32x4 a);
+[[nodiscard]] F32x4 sqrt(F32x4 a);
+[[nodiscard]] F32x4 fmadd(F32x4 a, F32x4 b, F32x4 c); // a*b + c
+[[nodiscard]] F32x4 fmsub(F32x4 a, F32x4 b, F32x4 c); // a*b - c
+
+[[nodiscard]] f32 reduce_add(F32x4 v);
+[[nodiscard]] f32 reduce_min(F32x4 v);
+[[nodiscard]] f32 reduce_max(F32x4 v);
+
+[[nodiscard]] Vec3x4 operator+(Vec3x4 a, Vec3x4 b);
+[[nodiscard]] Vec3x4 operator-(Vec3x4 a, Vec3x4 b);
+[[nodiscard]] Vec3x4 operator*(Vec3x4 a, Vec3x4 b);
+[[nodiscard]] Vec3x4 operator/(Vec3x4 a, Vec3x4 b);
+[[nodiscard]] Vec3x4 operator*(Vec3x4 v, F32x4 x);
+[[nodiscard]] Vec3x4 operator*(Vec3x4 v, f32 x);
+[[nodiscard]] Vec3x4 operator+(Vec3x4 a, Vec3 b);
+[[nodiscard]] Vec3x4 operator-(Vec3x4 a, Vec3 b);
+[[nodiscard]] Vec3x4 operator-(Vec3x4 v);
+Vec3x4& operator+=(Vec3x4 &a, Vec3x4 b);
+Vec3x4& operator-=(Vec3x4 &a, Vec3x4 b);
+Vec3x4& operator*=(Vec3x4 &a, Vec3x4 b);
+Vec3x4& operator*=(Vec3x4 &a, F32x4 x);
+
+[[nodiscard]] F32x4  dot(Vec3x4 a, Vec3x4 b);
+[[nodiscard]] Vec3x4 cross(Vec3x4 a, Vec3x4 b);
+[[nodiscard]] F32x4  len_sq(Vec3x4 v);
+[[nodiscard]] F32x4  len(Vec3x4 v);
+[[nodiscard]] Vec3x4 normalized(Vec3x4 v);
+[[nodiscard]] Vec3x4 min(Vec3x4 a, Vec3x4 b);
+[[nodiscard]] Vec3x4 max(Vec3x4 a, Vec3x4 b);
+[[nodiscard]] Vec3x4 fmadd(Vec3x4 a, F32x4 b, Vec3x4 c); // a*b + c
+
+/**
+ * 8 lanes (AVX2, FMA)
+*/
+
+struct F32x8 {
+  __m256 m;
+};
+
+struct Mask8 {
+  __m256 m;
+};
+
+struct Vec3x8 {
+  F32x8 x, y, z;
+};
+
+[[nodiscard]] F32x8  f32x8(f32 x); // Broadcast.
+[[nodiscard]] Vec3x8 vec3x8(Vec3 v);
+[[nodiscard]] F32x8  load_f32x8(f32 const *src);  // Unaligned.
+[[nodiscard]] F32x8  load_u8_f32x8(u8 const *src); // 8 bytes, converted to floats.
+[[nodiscard]] Vec3x8 load_vec3x8(Vec3_Soa src, s64 offset);
+void store(f32 *dst, F32x8 v);
+void store(Vec3_Soa dst, s64 offset, Vec3x8 v);
+[[nodiscard]] f32  lane(F32x8 v, s32 i);
+[[nodiscard]] Vec3 lane(Vec3x8 v, s32 i);
+
+[[nodiscard]] F32x8 operator+(F32x8 a, F32x8 b);
+[[nodiscard]] F32x8 operator-(F32x8 a, F32x8 b);
+[[nodiscard]] F32x8 operator*(F32x8 a, F32x8 b);
+[[nodiscard]] F32x8 operator/(F32x8 a, F32x8 b);
+[[nodiscard]] F32x8 operator+(F32x8 a, f32 x);
+[[nodiscard]] F32x8 operator-(F32x8 a, f32 x);
+[[nodiscard]] F32x8 operator*(F32x8 a, f32 x);
+[[nodiscard]] F32x8 operator/(F32x8 a, f32 x);
+[[nodiscard]] F32x8 operator-(F32x8 a);
+F32x8& operator+=(F32x8 &a, F32x8 b);
+F32x8& operator-=(F32x8 &a, F32x8 b);
+F32x8& operator*=(F32x8 &a, F32x8 b);
+F32x8& operator/=(F32x8 &a, F32x8 b);
+
+[[nodiscard]] Mask8 operator< (F32x8 a, F32x8 b);
+[[nodiscard]] Mask8 operator<=(F32x8 a, F32x8 b);
+[[nodiscard]] Mask8 operator> (F32x8 a, F32x8 b);
+[[nodiscard]] Mask8 operator>=(F32x8 a, F32x8 b);
+[[nodiscard]] Mask8 operator==(F32x8 a, F32x8 b);
+[[nodiscard]] Mask8 operator!=(F32x8 a, F32x8 b);
+[[nodiscard]] Mask8 operator< (F32x8 a, f32 x);
+[[nodiscard]] Mask8 operator<=(F32x8 a, f32 x);
+[[nodiscard]] Mask8 operator> (F32x8 a, f32 x);
+[[nodiscard]] Mask8 operator>=(F32x8 a, f32 x);
+
+[[nodiscard]] Mask8 operator&(Mask8 a, Mask8 b);
+[[nodiscard]] Mask8 operator|(Mask8 a, Mask8 b);
+[[nodiscard]] Mask8 operator^(Mask8 a, Mask8 b);
+[[nodiscard]] Mask8 operator~(Mask8 a);
+[[nodiscard]] Mask8 and_not(Mask8 a, Mask8 b); // a & ~b
+
+[[nodiscard]] u32  to_bits(Mask8 m); // Lane i -> bit i.
+[[nodiscard]] bool any(Mask8 m);
+[[nodiscard]] bool all(Mask8 m);
+[[nodiscard]] bool none(Mask8 m);
+
+// mask ? a : b, per lane.
+[[nodiscard]] F32x8  select(Mask8 mask, F32x8 a, F32x8 b);
+[[nodiscard]] Vec3x8 select(Mask8 mask, Vec3x8 a, Vec3x8 b);
+
+[[nodiscard]] F32x8 min(F32x8 a, F32x8 b);
+[[nodiscard]] F32x8 max(F32x8 a, F32x8 b);
+[[nodiscard]] F32x8 abs(F32x8 a);
+[[nodiscard]] F32x8 sqrt(F32x8 a);
+[[nodiscard]] F32x8 fmadd(F32x8 a, F32x8 b, F32x8 c); // a*b + c
+[[nodiscard]] F32x8 fmsub(F32x8 a, F32x8 b, F32x8 c); // a*b - c
+
+[[nodiscard]] f32 reduce_add(F32x8 v);
+[[nodiscard]] f32 reduce_min(F32x8 v);
+[[nodiscard]] f32 reduce_max(F32x8 v);
+
+[[nodiscard]] Vec3x8 operator+(Vec3x8 a, Vec3x8 b);
+[[nodiscard]] Vec3x8 operator-(Vec3x8 a, Vec3x8 b);
+[[nodiscard]] Vec3x8 operator*(Vec3x8 a, Vec3x8 b);
+[[nodiscard]] Vec3x8 operator/(Vec3x8 a, Vec3x8 b);
+[[nodiscard]] Vec3x8 operator*(Vec3x8 v, F32x8 x);
+[[nodiscard]] Vec3x8 operator*(Vec3x8 v, f32 x);
+[[nodiscard]] Vec3x8 operator+(Vec3x8 a, Vec3 b);
+[[nodiscard]] Vec3x8 operator-(Vec3x8 a, Vec3 b);
+[[nodiscard]] Vec3x8 operator-(Vec3x8 v);
+Vec3x8& operator+=(Vec3x8 &a, Vec3x8 b);
+Vec3x8& operator-=(Vec3x8 &a, Vec3x8 b);
+Vec3x8& operator*=(Vec3x8 &a, Vec3x8 b);
+Vec3x8& operator*=(Vec3x8 &a, F32x8 x);
+
+[[nodiscard]] F32x8  dot(Vec3x8 a, Vec3x8 b);
+[[nodiscard]] Vec3x8 cross(Vec3x8 a, Vec3x8 b);
+[[nodiscard]] F32x8  len_sq(Vec3x8 v);
+[[nodiscard]] F32x8  len(Vec3x8 v);
+[[nodiscard]] Vec3x8 normalized(Vec3x8 v);
+[[nodiscard]] Vec3x8 min(Vec3x8 a, Vec3x8 b);
+[[nodiscard]] Vec3x8 max(Vec3x8 a, Vec3x8 b);
+[[nodiscard]] Vec3x8 fmadd(Vec3x8 a, F32x8 b, Vec3x8 c); // a*b + c
+} // namespace rt
@@ -0,0 +1,139 @@
+namespace rt {
+[[nodiscard]] Quat quat_identity() {
+	return {};
+}
+
+[[nodiscard]] Quat quat_from_axis_angle(Vec3 axis, f32 angle) {
+	dbg_check_(std::abs(len_sq(axis) - 1) < 1e-3f);
+
+	f32 const S = std::sin(angle*0.5f);
+	f32 const C = std::cos(angle*0.5f);
+
+	return {.x = axis.x*S, .y = axis.y*S, .z = axis.z*S, .w = C};
+}
+
+// Shepperd's method: pick the largest of w, x, y, z to divide by, so we never divide
+// by something close to 0. Indices are transposed, because we use row vectors.
+[[nodiscard]] Quat quat_from_mat4x4(Mat4x4 const &m) {
+	auto const &M = m.v;
+	f32 const trace = M[0][0] + M[1][1] + M[2][2];
+
+	Quat q;
+	if (trace > 0) {
+		f32 const S = 0.5f/std::sqrt(trace + 1);
+		q.w = 0.25f/S;
+		q.x = (M[1][2] - M[2][1])*S;
+		q.y = (M[2][0] - M[0][2])*S;
+		q.z = (M[0][1] - M[1][0])*S;
+	} else if (M[0][0] > M[1][1] && M[0][0] > M[2][2]) {
+		f32 const S = 2*std::sqrt(1 + M[0][0] - M[1][1] - M[2][2]);
+		q.w = (M[1][2] - M[2][1])/S;
+		q.x = 0.25f*S;
+		q.y = (M[1][0] + M[0][1])/S;
+		q.z = (M[2][0] + M[0][2])/S;
+	} else if (M[1][1] > M[2][2]) {
+		f32 const S = 2*std::sqrt(1 + M[1][1] - M[0][0] - M[2][2]);
+		q.w = (M[2][0] - M[0][2])/S;
+		q.x = (M[1][0] + M[0][1])/S;
+		q.y = 0.25f*S;
+		q.z = (M[2][1] + M[1][2])/S;
+	} else {
+		f32 const S = 2*std::sqrt(1 + M[2][2] - M[0][0] - M[1][1]);
+		q.w = (M[0][1] - M[1][0])/S;
+		q.x = (M[2][0] + M[0][2])/S;
+		q.y = (M[2][1] + M[1][2])/S;
+		q.z = 0.25f*S;
+	}
+
+	return normalized(q);
+}
+
+[[nodiscard]] Mat4x4 to_mat4x4(Quat q) {
+	f32 const x = q.x, y = q.y, z = q.z, w = q.w;
+
+	f32 const xx = x*x, yy = y*y, zz = z*z;
+	f32 const xy = x*y, xz = x*z, yz = y*z;
+	f32 const wx = w*x, wy = w*y, wz = w*z;
+
+	return {{
+    {1 - 2*(yy + zz), 2*(xy + wz),     2*(xz - wy),     0},
+    {2*(xy - wz),     1 - 2*(xx + zz), 2*(yz + wx),     0},
+    {2*(xz + wy),     2*(yz - wx),     1 - 2*(xx + yy), 0},
+    {0,               0,               0,               1}
+  }};
+}
+
+[[nodiscard]] f32 dot(Quat a, Quat b) {
+	Vec4 va, vb;
+	va.m128 = a.m128;
+	vb.m128 = b.m128;
+	return dot(va, vb);
+}
+
+[[nodiscard]] Quat normalized(Quat q) {
+	Vec4 v;
+	v.m128 = q.m128;
+	q.m128 = normalized(v).m128;
+	return q;
+}
+
+[[nodiscard]] Quat conjugate(Quat q) {
+	return {.x = -q.x, .y = -q.y, .z = -q.z, .w = q.w};
+}
+
+// Hamilton product b*a.
+[[nodiscard]] Quat combine(Quat a, Quat b) {
+	return {
+		.x = b.w*a.x + b.x*a.w + b.y*a.z - b.z*a.y,
+		.y = b.w*a.y - b.x*a.z + b.y*a.w + b.z*a.x,
+		.z = b.w*a.z + b.x*a.y - b.y*a.x + b.z*a.w,
+		.w = b.w*a.w - b.x*a.x - b.y*a.y - b.z*a.z
+	};
+}
+
+// v + w*t + u x t, where t = 2*(u x v).
+[[nodiscard]] Vec3 rotated(Vec3 v, Quat q) {
+	Vec3 const t = cross(q.xyz, v)*2;
+	return v + t*q.w + cross(q.xyz, t);
+}
+
+[[nodiscard]] Quat nlerp(Quat a, Quat b, f32 t) {
+	// @Note: q and -q are the same rotation -- take the shorter way.
+	f32 const sign = (dot(a, b) < 0) ? -1.f : 1.f;
+
+	__m128 const wa = _mm_set1_ps(1 - t);
+	__m128 const wb = _mm_set1_ps(t*sign);
+
+	Quat q;
+	q.m128 = _mm_add_ps(_mm_mul_ps(a.m128, wa), _mm_mul_ps(b.m128, wb));
+	return normalized(q);
+}
+
+[[nodiscard]] Quat slerp(Quat a, Quat b, f32 t) {
+	f32 cos_theta = dot(a, b);
+	if (cos_theta < 0) {
+		cos_theta = -cos_theta;
+		b.m128    = _mm_sub_ps(_mm_setzero_ps(), b.m128);
+	}
+
+	// @Note: sin(theta) gets too small to divide by.
+	if (cos_theta > 0.9995f) {
+		return nlerp(a, b, t);
+	}
+
+	// @Note: 2 ULP is below the rounding of the blend itself, so the fast versions
+	//        don't cost accuracy, and the three sines are one packet call.
+	f32 const theta = fast_acos(cos_theta);
+
+	alignas(16) f32 sines[4];
+	store(sines, fast_sin(F32x4{_mm_set_ps(0, t*theta, (1 - t)*theta, theta)}));
+	f32 const inv_sin = 1/sines[0];
+
+	__m128 const wa = _mm_set1_ps(sines[1]*inv_sin);
+	__m128 const wb = _mm_set1_ps(sines[2]*inv_sin);
+
+	Quat q;
+	q.m128 = _mm_add_ps(_mm_mul_ps(a.m128, wa), _mm_mul_ps(b.m128, wb));
+	return q;
+}
+} // namespace rt
@@ -0,0 +1,45 @@
+/**
+ * Unit quaternions for rotations. Like matrices, they are composed in the order of
+ * application: combine(a, b) rotates by `a` first, then by `b`.
+*/
+
+namespace rt {
+union Quat {
+  struct {
+    f32 x, y, z, w;
+  };
+
+  struct {
+    Vec3 xyz; f32 _unused0;
+  };
+
+  __m128 m128;
+  f32    v[4] = {0, 0, 0, 1};
+};
+
+[[nodiscard]] Quat quat_identity();
+
+// `axis` must be normalized. The angle is in radians.
+[[nodiscard]] Quat quat_from_axis_angle(Vec3 axis, f32 angle);
+
+// Only the rotation part of `m` is used. It must not contain scale.
+[[nodiscard]] Quat quat_from_mat4x4(Mat4x4 const &m);
+
+[[nodiscard]] Mat4x4 to_mat4x4(Quat q);
+
+[[nodiscard]] f32  dot(Quat a, Quat b);
+[[nodiscard]] Quat normalized(Quat q);
+[[nodiscard]] Quat conjugate(Quat q); // The inverse, for unit quaternions.
+
+[[nodiscard]] Quat combine(Quat a, Quat b);
+
+[[nodiscard]] Vec3 rotated(Vec3 v, Quat q);
+
+// Normalized linear interpolation along the shorter arc. Cheap, but the angular
+// speed isn't constant.
+[[nodiscard]] Quat nlerp(Quat a, Quat b, f32 t);
+
+// Constant angular speed along the shorter arc. Falls back to nlerp for nearly
+// parallel quaternions.
+[[nodiscard]] Quat slerp(Quat a, Quat b, f32 t);
+} // namespace rt
@@ -0,0 +1,326 @@
+namespace rt {
+namespace impl {
+u64 constexpr static PCG32_MULT = 6364136223846793005ull;
+
+u32 constexpr static PHILOX_M0 = 0xd2511f53;
+u32 constexpr static PHILOX_M1 = 0xcd9e8d57;
+u32 constexpr static PHILOX_W0 = 0x9e3779b9;
+u32 constexpr static PHILOX_W1 = 0xbb67ae85;
+s32 constexpr static PHILOX_ROUNDS = 10;
+
+[[nodiscard]] u32
+rotate_right(u32 x, u32 r) {
+  return (x >> r) | (x << ((32 - r) & 31));
+}
+
+[[nodiscard]] u32
+hash_seed(u32 dimension, u32 seed) {
+  return hash_u32(seed ^ hash_u32(dimension));
+}
+} // namespace impl
+
+[[nodiscard]] f32
+u32_to_unit_f32(u32 x) {
+  return (f32)(x >> 8)*(1.f/(1 << 24));
+}
+
+/**
+ * PCG32
+*/
+
+[[nodiscard]] Pcg32
+pcg32_seed(u64 seed, u64 stream) {
+  Pcg32 rng = {.state = 0, .inc = (stream << 1) | 1};
+  (void)next_u32(rng);
+  rng.state += seed;
+  (void)next_u32(rng);
+  return rng;
+}
+
+[[nodiscard]] u32
+next_u32(Pcg32 &rng) {
+  u64 const old = rng.state;
+  rng.state = old*impl::PCG32_MULT + rng.inc;
+
+  u32 const xorshifted = (u32)(((old >> 18) ^ old) >> 27);
+  u32 const rotation   = (u32)(old >> 59);
+  return impl::rotate_right(xorshifted, rotation);
+}
+
+[[nodiscard]] f32
+next_f32(Pcg32 &rng) {
+  return u32_to_unit_f32(next_u32(rng));
+}
+
+// Lemire's multiply-and-reject.
+[[nodiscard]] u32
+next_u32_below(Pcg32 &rng, u32 bound) {
+  dbg_check_(bound > 0);
+
+  u64 product = (u64)next_u32(rng)*bound;
+  if ((u32)product < bound) {
+    u32 const threshold = (0u - bound) % bound;
+    while ((u32)product < threshold) {
+      product = (u64)next_u32(rng)*bound;
+    }
+  }
+  return (u32)(product >> 32);
+}
+
+// Brown, "Random Number Generation with Arbitrary Strides".
+void
+pcg32_advance(Pcg32 &rng, u64 delta) {
+  u64 mult     = impl::PCG32_MULT;
+  u64 plus     = rng.inc;
+  u64 acc_mult = 1;
+  u64 acc_plus = 0;
+
+  while (delta > 0) {
+    if (delta & 1) {
+      acc_mult *= mult;
+      acc_plus  = acc_plus*mult + plus;
+    }
+    plus  = (mult + 1)*plus;
+    mult *= mult;
+    delta >>= 1;
+  }
+
+  rng.state = acc_mult*rng.state + acc_plus;
+}
+
+/**
+ * Philox4x32-10
+*/
+
+[[nodiscard]] Philox_Block
+philox4x32(Philox_Block counter, u64 key) {
+  u32 k0 = (u32)key;
+  u32 k1 = (u32)(key >> 32);
+  u32 *c = counter.v;
+
+  for (s32 round = 0; round < impl::PHILOX_ROUNDS; round++) {
+    u64 const p0 = (u64)impl::PHILOX_M0*c[0];
+    u64 const p1 = (u64)impl::PHILOX_M1*c[2];
+
+    u32 const next[4] = {
+      (u32)(p1 >> 32) ^ c[1] ^ k0,
+      (u32)p1,
+      (u32)(p0 >> 32) ^ c[3] ^ k1,
+      (u32)p0
+    };
+    ::memcpy(c, next, sizeof(next));
+
+    k0 += impl::PHILOX_W0;
+    k1 += impl::PHILOX_W1;
+  }
+
+  return counter;
+}
+
+[[nodiscard]] Philox_Block
+philox_sample(u32 pixel, u32 sample, u32 dimension_block, u64 seed) {
+  return philox4x32({pixel, sample, dimension_block, 0}, seed);
+}
+
+/**
+ * Hash-based
+*/
+
+// Chris Wellons' lowbias32.
+[[nodiscard]] u32
+hash_u32(u32 x) {
+  x ^= x >> 16;
+  x *= 0x7feb352d;
+  x ^= x >> 15;
+  x *= 0x846ca68b;
+  x ^= x >> 16;
+  return x;
+}
+
+[[nodiscard]] u32
+random_hash_u32(u32 pixel, u32 sample, u32 dimension, u32 seed) {
+  u32 const base = impl::hash_seed(dimension, seed);
+  return hash_u32(hash_u32(base ^ pixel) ^ sample);
+}
+
+[[nodiscard]] f32
+random_hash_f32(u32 pixel, u32 sample, u32 dimension, u32 seed) {
+  return u32_to_unit_f32(random_hash_u32(pixel, sample, dimension, seed));
+}
+
+/**
+ * 8 lanes
+*/
+
+namespace impl {
+// Low 64 bits of a*b per 64-bit lane.
+[[nodiscard]] __m256i
+mul_u64(__m256i a, u64 b) {
+  __m256i const b_lo = _mm256_set1_epi64x((s64)(b & 0xffffffff));
+  __m256i const b_hi = _mm256_set1_epi64x((s64)(b >> 32));
+
+  __m256i const lo_lo = _mm256_mul_epu32(a, b_lo);
+  __m256i const hi_lo = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b_lo);
+  __m256i const lo_hi = _mm256_mul_epu32(a, b_hi);
+  return _mm256_add_epi64(lo_lo, _mm256_slli_epi64(_mm256_add_epi64(hi_lo, lo_hi), 32));
+}
+
+// PCG output of 4 64-bit states, in the low halves of the lanes.
+[[nodiscard]] __m256i
+pcg32_output(__m256i old) {
+  __m256i const xorshifted = _mm256_and_si256(
+    _mm256_srli_epi64(_mm256_xor_si256(_mm256_srli_epi64(old, 18), old), 27),
+    _mm256_set1_epi64x(0xffffffff));
+  __m256i const rotation = _mm256_srli_epi64(old, 59);
+
+  __m256i const right = _mm256_srlv_epi64(xorshifted, rotation);
+  __m256i const left  = _mm256_sllv_epi64(xorshifted, _mm256_sub_epi64(_mm256_set1_epi64x(32), rotation));
+  return _mm256_and_si256(_mm256_or_si256(right, left), _mm256_set1_epi64x(0xffffffff));
+}
+
+// Low halves of the 64-bit lanes of `a` and `b` as 8 32-bit lanes.
+[[nodiscard]] __m256i
+pack_low_halves(__m256i a, __m256i b) {
+  __m256i const a_packed = _mm256_permute4x64_epi64(_mm256_shuffle_epi32(a, _MM_SHUFFLE(2, 0, 2, 0)),
+                                                    _MM_SHUFFLE(3, 1, 2, 0));
+  __m256i const b_packed = _mm256_permute4x64_epi64(_mm256_shuffle_epi32(b, _MM_SHUFFLE(2, 0, 2, 0)),
+                                                    _MM_SHUFFLE(3, 1, 2, 0));
+  return _mm256_permute2x128_si256(a_packed, b_packed, 0x20);
+}
+
+void
+pcg32x8_step(Pcg32x8 &rng, __m256i output[2]) {
+  for (s32 i = 0; i < 2; i++) {
+    __m256i const old = rng.state[i];
+    rng.state[i] = _mm256_add_epi64(mul_u64(old, PCG32_MULT), rng.inc[i]);
+    output[i] = pcg32_output(old);
+  }
+}
+
+// 32x32->64 multiply of every lane: low and high halves as separate vectors.
+void
+mul_hi_lo(__m256i a, u32 b, __m256i &hi, __m256i &lo) {
+  __m256i const vb   = _mm256_set1_epi32((s32)b);
+  __m256i const even = _mm256_mul_epu32(a, vb);
+  __m256i const odd  = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), vb);
+
+  lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xaa);
+  hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xaa);
+}
+} // namespace impl
+
+[[nodiscard]] U32x8
+u32x8(u32 x) {
+  return {_mm256_set1_epi32((s32)x)};
+}
+
+[[nodiscard]] U32x8
+u32x8_iota(u32 first) {
+  return {_mm256_add_epi32(_mm256_set1_epi32((s32)first), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7))};
+}
+
+[[nodiscard]] U32x8
+load_u32x8(u32 const *src) {
+  return {_mm256_loadu_si256((__m256i const*)src)};
+}
+
+void
+store(u32 *dst, U32x8 v) {
+  _mm256_storeu_si256((__m256i*)dst, v.m);
+}
+
+[[nodiscard]] u32
+lane(U32x8 v, s32 i) {
+  dbg_check_(i >= 0 && i < 8);
+  alignas(32) u32 lanes[8];
+  _mm256_store_si256((__m256i*)lanes, v.m);
+  return lanes[i];
+}
+
+[[nodiscard]] F32x8
+u32_to_unit_f32(U32x8 x) {
+  __m256 const value = _mm256_cvtepi32_ps(_mm256_srli_epi32(x.m, 8));
+  return {_mm256_mul_ps(value, _mm256_set1_ps(1.f/(1 << 24)))};
+}
+
+[[nodiscard]] Pcg32x8
+pcg32x8_seed(u64 seed, U32x8 streams) {
+  Pcg32x8 rng = {};
+
+  __m256i const one        = _mm256_set1_epi64x(1);
+  __m256i const streams_lo = _mm256_cvtepu32_epi64(_mm256_castsi256_si128(streams.m));
+  __m256i const streams_hi = _mm256_cvtepu32_epi64(_mm256_extracti128_si256(streams.m, 1));
+  rng.inc[0] = _mm256_or_si256(_mm256_slli_epi64(streams_lo, 1), one);
+  rng.inc[1] = _mm256_or_si256(_mm256_slli_epi64(streams_hi, 1), one);
+
+  __m256i unused[2];
+  impl::pcg32x8_step(rng, unused);
+  rng.state[0] = _mm256_add_epi64(rng.state[0], _mm256_set1_epi64x((s64)seed));
+  rng.state[1] = _mm256_add_epi64(rng.state[1], _mm256_set1_epi64x((s64)seed));
+  impl::pcg32x8_step(rng, unused);
+  return rng;
+}
+
+[[nodiscard]] U32x8
+next_u32(Pcg32x8 &rng) {
+  __m256i output[2];
+  impl::pcg32x8_step(rng, output);
+  return {impl::pack_low_halves(output[0], output[1])};
+}
+
+[[nodiscard]] F32x8
+next_f32(Pcg32x8 &rng) {
+  return u32_to_unit_f32(next_u32(rng));
+}
+
+[[nodiscard]] Philox_Block_x8
+philox4x32(Philox_Block_x8 counter, u64 key) {
+  u32 k0 = (u32)key;
+  u32 k1 = (u32)(key >> 32);
+  __m256i c[4] = {counter.v[0].m, counter.v[1].m, counter.v[2].m, counter.v[3].m};
+
+  for (s32 round = 0; round < impl::PHILOX_ROUNDS; round++) {
+    __m256i hi0, lo0, hi1, lo1;
+    impl::mul_hi_lo(c[0], impl::PHILOX_M0, hi0, lo0);
+    impl::mul_hi_lo(c[2], impl::PHILOX_M1, hi1, lo1);
+
+    c[0] = _mm256_xor_si256(_mm256_xor_si256(hi1, c[1]), _mm256_set1_epi32((s32)k0));
+    c[1] = lo1;
+    c[2] = _mm256_xor_si256(_mm256_xor_si256(hi0, c[3]), _mm256_set1_epi32((s32)k1));
+    c[3] = lo0;
+
+    k0 += impl::PHILOX_W0;
+    k1 += impl::PHILOX_W1;
+  }
+
+  return {{{c[0]}, {c[1]}, {c[2]}, {c[3]}}};
+}
+
+[[nodiscard]] Philox_Block_x8
+philox_sample(U32x8 pixel, U32x8 sample, u32 dimension_block, u64 seed) {
+  return philox4x32({{pixel, sample, u32x8(dimension_block), u32x8(0)}}, seed);
+}
+
+[[nodiscard]] U32x8
+hash_u32(U32x8 x) {
+  __m256i v = x.m;
+  v = _mm256_xor_si256(v, _mm256_srli_epi32(v, 16));
+  v = _mm256_mullo_epi32(v, _mm256_set1_epi32(0x7feb352d));
+  v = _mm256_xor_si256(v, _mm256_srli_epi32(v, 15));
+  v = _mm256_mullo_epi32(v, _mm256_set1_epi32((s32)0x846ca68b));
+  v = _mm256_xor_si256(v, _mm256_srli_epi32(v, 16));
+  return {v};
+}
+
+[[nodiscard]] U32x8
+random_hash_u32(U32x8 pixel, U32x8 sample, u32 dimension, u32 seed) {
+  __m256i const base   = _mm256_set1_epi32((s32)impl::hash_seed(dimension, seed));
+  U32x8   const hashed = hash_u32({_mm256_xor_si256(base, pixel.m)});
+  return hash_u32({_mm256_xor_si256(hashed.m, sample.m)});
+}
+
+[[nodiscard]] F32x8
+random_hash_f32(U32x8 pixel, U32x8 sample, u32 dimension, u32 seed) {
+  return u32_to_unit_f32(random_hash_u32(pixel, sample, dimension, seed));
+}
+} // namespace rt
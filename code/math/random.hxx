@@ -0,0 +1,98 @@
+/**
+ * Random numbers for sampling. Nothing here has shared state, so every thread (or
+ * pixel) gets its own generator, and renders are reproducible no matter how the work
+ * was split between threads.
+ *
+ *  - Pcg32 (PCG-XSH-RR 64/32) is a tiny sequential generator. Seed one per pixel or
+ *    path with the pixel index as the stream.
+ *  - Philox4x32-10 is counter-based: the output is a pure function of the counter and
+ *    the key, so a number can be addressed directly, e.g. by {pixel, sample, dimension}.
+ *  - random_hash_* is a cheaper counter-based generator built on an integer hash. It's
+ *    fine for sampling, but use Philox where statistical quality matters more.
+ *
+ * The 8-wide variants (AVX2) run 8 independent generators at once; lane i produces the
+ * same numbers as the scalar version with lane i's seed/counter.
+ *
+ * Floats are in [0, 1) and have 24 random bits.
+*/
+
+namespace rt {
+// Top 24 bits of `x` mapped to [0, 1).
+[[nodiscard]] f32 u32_to_unit_f32(u32 x);
+
+/**
+ * PCG32
+*/
+
+struct Pcg32 {
+  u64 state;
+  u64 inc; // Stream selector, always odd.
+};
+
+// Generators with different streams produce different sequences for the same seed.
+[[nodiscard]] Pcg32 pcg32_seed(u64 seed, u64 stream);
+[[nodiscard]] u32   next_u32(Pcg32 &rng);
+[[nodiscard]] f32   next_f32(Pcg32 &rng);
+[[nodiscard]] u32   next_u32_below(Pcg32 &rng, u32 bound); // [0, bound), unbiased.
+
+// Jumps `delta` steps ahead in O(log delta).
+void pcg32_advance(Pcg32 &rng, u64 delta);
+
+/**
+ * Philox4x32-10
+*/
+
+struct Philox_Block {
+  u32 v[4];
+};
+
+[[nodiscard]] Philox_Block philox4x32(Philox_Block counter, u64 key);
+
+// Four numbers for the given sample. Dimensions are consumed 4 at a time: pass
+// dimension/4 and use v[dimension%4].
+[[nodiscard]] Philox_Block philox_sample(u32 pixel, u32 sample, u32 dimension_block, u64 seed);
+
+/**
+ * Hash-based
+*/
+
+[[nodiscard]] u32 hash_u32(u32 x);
+[[nodiscard]] u32 random_hash_u32(u32 pixel, u32 sample, u32 dimension, u32 seed);
+[[nodiscard]] f32 random_hash_f32(u32 pixel, u32 sample, u32 dimension, u32 seed);
+
+/**
+ * 8 lanes (AVX2)
+*/
+
+struct U32x8 {
+  __m256i m;
+};
+
+[[nodiscard]] U32x8 u32x8(u32 x); // Broadcast.
+[[nodiscard]] U32x8 u32x8_iota(u32 first); // {first, first + 1, ..., first + 7}
+[[nodiscard]] U32x8 load_u32x8(u32 const *src); // Unaligned.
+void store(u32 *dst, U32x8 v);
+[[nodiscard]] u32   lane(U32x8 v, s32 i);
+[[nodiscard]] F32x8 u32_to_unit_f32(U32x8 x);
+
+struct Pcg32x8 {
+  __m256i state[2]; // Lanes 0-3 and 4-7, 64 bits each.
+  __m256i inc[2];
+};
+
+[[nodiscard]] Pcg32x8 pcg32x8_seed(u64 seed, U32x8 streams);
+[[nodiscard]] U32x8   next_u32(Pcg32x8 &rng);
+[[nodiscard]] F32x8   next_f32(Pcg32x8 &rng);
+
+struct Philox_Block_x8 {
+  U32x8 v[4];
+};
+
+[[nodiscard]] Philox_Block_x8 philox4x32(Philox_Block_x8 counter, u64 key);
+[[nodiscard]] Philox_Block_x8 philox_sample(U32x8 pixel, U32x8 sample, u32 dimension_block,
+                                            u64 seed);
+
+[[nodiscard]] U32x8 hash_u32(U32x8 x);
+[[nodiscard]] U32x8 random_hash_u32(U32x8 pixel, U32x8 sample, u32 dimension, u32 seed);
+[[nodiscard]] F32x8 random_hash_f32(U32x8 pixel, U32x8 sample, u32 dimension, u32 seed);
+} // namespace rt
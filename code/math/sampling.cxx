@@ -0,0 +1,252 @@
+namespace rt {
+namespace impl {
+u32 constexpr static SOBOL_GROUP_DIMENSIONS = 4;
+
+// Generators of the R2 sequence: 1/plastic number and 1/plastic number^2.
+f64 constexpr static R2_ALPHA_X = 0.7548776662466927;
+f64 constexpr static R2_ALPHA_Y = 0.5698402909980532;
+
+[[nodiscard]] u32
+reverse_bits(u32 x) {
+  x = ((x >> 1) & 0x55555555) | ((x & 0x55555555) << 1);
+  x = ((x >> 2) & 0x33333333) | ((x & 0x33333333) << 2);
+  x = ((x >> 4) & 0x0f0f0f0f) | ((x & 0x0f0f0f0f) << 4);
+  x = ((x >> 8) & 0x00ff00ff) | ((x & 0x00ff00ff) << 8);
+  return (x >> 16) | (x << 16);
+}
+
+// Laine-Karras style hash: every bit only depends on the bits below it. Constants
+// from Burley 2020.
+[[nodiscard]] u32
+laine_karras_permutation(u32 x, u32 seed) {
+  x ^= x*0x3d20adea;
+  x += seed;
+  x *= (seed >> 16) | 1;
+  x ^= x*0x05526c56;
+  x ^= x*0x53a22864;
+  return x;
+}
+
+[[nodiscard]] u32
+hash_combine(u32 seed, u32 value) {
+  return hash_u32(seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2)));
+}
+
+// In [0, 1) for non-negative x.
+[[nodiscard]] f32
+fract(f32 x) {
+  return x - (f32)(s32)x;
+}
+} // namespace impl
+
+/**
+ * Sequences
+*/
+
+[[nodiscard]] u32
+sobol_u32(u32 index, u32 dimension) {
+  dbg_check_(dimension < SOBOL_DIMENSIONS);
+
+  // @Note: branchless, the bits of a shuffled index are random.
+  u32 const *directions = impl::SOBOL_DIRECTIONS[dimension];
+  u32 result = 0;
+  for (; index != 0; index >>= 1, directions++) {
+    result ^= *directions & (0u - (index & 1));
+  }
+  return result;
+}
+
+[[nodiscard]] f32
+sobol(u32 index, u32 dimension) {
+  return u32_to_unit_f32(sobol_u32(index, dimension));
+}
+
+[[nodiscard]] u32
+owen_scramble(u32 x, u32 seed) {
+  return impl::reverse_bits(impl::laine_karras_permutation(impl::reverse_bits(x), seed));
+}
+
+[[nodiscard]] f32
+sobol_owen(u32 index, u32 dimension, u32 seed) {
+  u32 const group      = dimension/impl::SOBOL_GROUP_DIMENSIONS;
+  u32 const group_seed = impl::hash_combine(seed, group);
+
+  // @Note: shuffling the index (itself an Owen scramble) keeps the groups from being
+  //        correlated with each other.
+  u32 const shuffled = owen_scramble(index, group_seed);
+  u32 const d        = dimension%impl::SOBOL_GROUP_DIMENSIONS;
+  u32 const value    = owen_scramble(sobol_u32(shuffled, d), impl::hash_combine(group_seed, d));
+  return u32_to_unit_f32(value);
+}
+
+[[nodiscard]] f32
+radical_inverse(u32 index, u32 base) {
+  dbg_check_(base >= 2);
+
+  f64 const inv_base  = 1.0/base;
+  f64       inv_power = 1.0;
+  u64       reversed  = 0;
+  for (; index != 0; index /= base) {
+    reversed  = reversed*base + index%base;
+    inv_power *= inv_base;
+  }
+
+  f32 const result = (f32)((f64)reversed*inv_power);
+  return (result < ONE_MINUS_EPSILON) ? result : ONE_MINUS_EPSILON;
+}
+
+[[nodiscard]] f32
+halton(u32 index, u32 dimension) {
+  dbg_check_(dimension < HALTON_DIMENSIONS);
+  return radical_inverse(index, impl::HALTON_PRIMES[dimension]);
+}
+
+[[nodiscard]] f32
+blue_noise(u32 x, u32 y) {
+  u32 const mask = BLUE_NOISE_SIZE - 1;
+  u32 const rank = impl::BLUE_NOISE_RANKS[(y & mask)*BLUE_NOISE_SIZE + (x & mask)];
+  return ((f32)rank + 0.5f)/(f32)(BLUE_NOISE_SIZE*BLUE_NOISE_SIZE);
+}
+
+[[nodiscard]] Vec2
+r2(u32 index, Vec2 offset) {
+  // @Note: wrap the index product in 0.32 fixed point, f32 would lose the fraction.
+  u32 const x = (u32)(impl::R2_ALPHA_X*4294967296.0)*index;
+  u32 const y = (u32)(impl::R2_ALPHA_Y*4294967296.0)*index;
+  return {
+    .x = impl::fract(u32_to_unit_f32(x) + offset.x),
+    .y = impl::fract(u32_to_unit_f32(y) + offset.y)
+  };
+}
+
+/**
+ * Sampler
+*/
+
+[[nodiscard]] Sampler
+sampler_init(Sampler_Type type, u32 seed) {
+  check_(type >= 0 && type < SamplerType_Count);
+  return {.type = type, .seed = seed};
+}
+
+void
+sampler_start(Sampler &sampler, u32 pixel_x, u32 pixel_y, u32 sample_index) {
+  sampler.pixel_x      = pixel_x;
+  sampler.pixel_y      = pixel_y;
+  sampler.pixel_seed   = impl::hash_combine(impl::hash_combine(sampler.seed, pixel_x), pixel_y);
+  sampler.sample_index = sample_index;
+  sampler.dimension    = 0;
+}
+
+[[nodiscard]] f32
+sampler_get(Sampler const &sampler, u32 dimension) {
+  u32 const sample = sampler.sample_index;
+
+  switch (sampler.type) {
+    case SamplerType_Random: {
+      return random_hash_f32(sampler.pixel_seed, sample, dimension, sampler.seed);
+    }
+
+    case SamplerType_Sobol: {
+      return sobol_owen(sample, dimension, sampler.pixel_seed);
+    }
+
+    case SamplerType_Halton: {
+      // Per-pixel Cranley-Patterson rotation. Past the last prime the dimensions repeat
+      // with a different rotation, which is correlated but better than nothing.
+      f32 const value  = halton(sample, dimension%HALTON_DIMENSIONS);
+      f32 const offset = u32_to_unit_f32(impl::hash_combine(sampler.pixel_seed, dimension));
+      return impl::fract(value + offset);
+    }
+
+    case SamplerType_Blue_Noise: {
+      // Every dimension looks at the tile from a different offset, so they don't share
+      // the same pattern. Over the samples, each pair of dimensions walks the R2
+      // lattice: stepping both with the same constant would put the points on a line.
+      u32 const tile_offset = impl::hash_combine(sampler.seed, dimension);
+      f32 const mask        = blue_noise(sampler.pixel_x + (tile_offset & 0xffff),
+                                         sampler.pixel_y + (tile_offset >> 16));
+      f64 const alpha       = (dimension & 1) ? impl::R2_ALPHA_Y : impl::R2_ALPHA_X;
+      u32 const step        = (u32)(alpha*4294967296.0)*sample;
+      return impl::fract(mask + u32_to_unit_f32(step));
+    }
+
+    default: {
+      errf("Unknown sampler type (%d)", (int)sampler.type);
+      return 0;
+    }
+  }
+}
+
+[[nodiscard]] f32
+sampler_next_1d(Sampler &sampler) {
+  return sampler_get(sampler, sampler.dimension++);
+}
+
+[[nodiscard]] Vec2
+sampler_next_2d(Sampler &sampler) {
+  sampler.dimension += sampler.dimension & 1;
+
+  Vec2 const result = {
+    .x = sampler_get(sampler, sampler.dimension),
+    .y = sampler_get(sampler, sampler.dimension + 1)
+  };
+  sampler.dimension += 2;
+  return result;
+}
+
+[[nodiscard]] char const*
+sampler_type_name(Sampler_Type type) {
+  switch (type) {
+    case SamplerType_Random:     return "Random";
+    case SamplerType_Sobol:      return "Sobol";
+    case SamplerType_Halton:     return "Halton";
+    case SamplerType_Blue_Noise: return "Blue noise";
+    default:                     return "Unknown";
+  }
+}
+
+/**
+ * Warps
+*/
+
+[[nodiscard]] Vec2
+sample_unit_disk(Vec2 u) {
+  f32 const x = 2*u.x - 1;
+  f32 const y = 2*u.y - 1;
+  if (x == 0 && y == 0) {
+    return {};
+  }
+
+  f32 r, theta;
+  if (std::abs(x) > std::abs(y)) {
+    r     = x;
+    theta = (PI/4)*(y/x);
+  } else {
+    r     = y;
+    theta = PI/2 - (PI/4)*(x/y);
+  }
+
+  f32 s, c;
+  fast_sincos(theta, s, c);
+  return {.x = r*c, .y = r*s};
+}
+
+[[nodiscard]] Vec3
+sample_cosine_hemisphere(Vec2 u) {
+  Vec2 const d = sample_unit_disk(u);
+  f32 const z_sq = 1 - d.x*d.x - d.y*d.y;
+  return {.x = d.x, .y = d.y, .z = std::sqrt((z_sq > 0) ? z_sq : 0)};
+}
+
+[[nodiscard]] Vec3
+sample_uniform_sphere(Vec2 u) {
+  f32 const z    = 1 - 2*u.x;
+  f32 const r_sq = 1 - z*z;
+  f32 const r    = std::sqrt((r_sq > 0) ? r_sq : 0);
+
+  f32 s, c;
+  fast_sincos(2*PI*u.y - PI, s, c);
+  return {.x = r*c, .y = r*s, .z = z};
+}
+} // namespace rt
@@ -0,0 +1,106 @@
+/**
+ * Low-discrepancy and blue-noise sample sequences. They cover the sample domain more
+ * evenly than random numbers, so an image converges with fewer samples per pixel.
+ *
+ *  - Sobol: first SOBOL_DIMENSIONS dimensions of the Joe-Kuo sequence, with Owen
+ *    scrambling and index shuffling (Burley 2020, "Practical Hash-based Owen
+ *    Scrambling"). Best default.
+ *  - Halton: radical inverses in the first HALTON_DIMENSIONS prime bases.
+ *  - Blue noise: a tiled 64x64 void-and-cluster mask, advanced per sample along the
+ *    R2 rank-1 lattice. Errors of neighboring pixels are anti-correlated, so low
+ *    sample counts look like fine grain instead of blotches.
+ *
+ * Sampler gives the samples of one pixel, dimension after dimension. The value of a
+ * (pixel, sample, dimension) triple doesn't depend on anything else, so pixels can be
+ * rendered in any order, on any thread.
+*/
+
+namespace rt {
+u32 constexpr static SOBOL_DIMENSIONS  = 16;
+u32 constexpr static HALTON_DIMENSIONS = 32;
+u32 constexpr static BLUE_NOISE_SIZE   = 64;
+
+// Largest f32 below 1.
+f32 constexpr static ONE_MINUS_EPSILON = 0.99999994f;
+
+/**
+ * Sequences
+*/
+
+// Point `index` of the unscrambled Sobol sequence, as a 0.32 fixed-point fraction.
+[[nodiscard]] u32 sobol_u32(u32 index, u32 dimension);
+[[nodiscard]] f32 sobol(u32 index, u32 dimension);
+
+// Random permutation of the binary digits that keeps the sequence's stratification.
+[[nodiscard]] u32 owen_scramble(u32 x, u32 seed);
+
+// Dimensions are padded in groups of 4: each group is a shuffled and scrambled copy of
+// the first 4 Sobol dimensions, decorrelated by the seed.
+[[nodiscard]] f32 sobol_owen(u32 index, u32 dimension, u32 seed);
+
+[[nodiscard]] f32 radical_inverse(u32 index, u32 base);
+[[nodiscard]] f32 halton(u32 index, u32 dimension);
+
+// Tiled, so any coordinates work. In [0, 1).
+[[nodiscard]] f32 blue_noise(u32 x, u32 y);
+
+// 2D rank-1 lattice (Roberts' R2 sequence), with a toroidal shift.
+[[nodiscard]] Vec2 r2(u32 index, Vec2 offset = {});
+
+/**
+ * Sampler
+*/
+
+enum Sampler_Type {
+  SamplerType_Random = 0,
+  SamplerType_Sobol,
+  SamplerType_Halton,
+  SamplerType_Blue_Noise,
+
+  SamplerType_Count
+};
+
+struct Sampler {
+  Sampler_Type type;
+  u32          seed;
+
+  u32 pixel_x;
+  u32 pixel_y;
+  u32 pixel_seed;
+
+  u32 sample_index;
+  u32 dimension; // Next one to hand out.
+};
+
+[[nodiscard]] Sampler
+sampler_init(Sampler_Type type, u32 seed);
+
+void
+sampler_start(Sampler &sampler, u32 pixel_x, u32 pixel_y, u32 sample_index);
+
+// Random access to any dimension of the current sample.
+[[nodiscard]] f32
+sampler_get(Sampler const &sampler, u32 dimension);
+
+[[nodiscard]] f32
+sampler_next_1d(Sampler &sampler);
+
+// Starts at an even dimension, so the pair comes from a well-distributed 2D projection.
+[[nodiscard]] Vec2
+sampler_next_2d(Sampler &sampler);
+
+[[nodiscard]] char const*
+sampler_type_name(Sampler_Type type);
+
+/**
+ * Warps of [0, 1)^2 samples. They keep the stratification of the input points.
+*/
+
+// Concentric mapping (Shirley-Chiu 1997).
+[[nodiscard]] Vec2 sample_unit_disk(Vec2 u);
+
+// Around +Z, with pdf = cos(theta)/PI.
+[[nodiscard]] Vec3 sample_cosine_hemisphere(Vec2 u);
+
+[[nodiscard]] Vec3 sample_uniform_sphere(Vec2 u);
+} // namespace rt
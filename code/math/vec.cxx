@@ -1,8 +1,31 @@
+namespace rt {
+namespace impl {
+// Sum of all 4 lanes, broadcast to every lane.
+[[nodiscard]] __m128
+hsum4_splat(__m128 v) {
+	v = _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+	v = _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+	return v;
+}
+
+// Sum of the x, y, z lanes, broadcast to every lane.
+[[nodiscard]] __m128
+hsum3_splat(__m128 v) {
+	__m128 const XYZ_MASK = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+	return hsum4_splat(_mm_and_ps(v, XYZ_MASK));
+}
+} // namespace impl
+
+[[nodiscard]] Vec3a to_vec3a(Vec3 v) {
+	Vec3a result;
+	result.m128 = _mm_set_ps(0, v.z, v.y, v.x);
+	return result;
+}
+
 /**
  * Functions
 */
 
-namespace rt {
 [[nodiscard]] f32 dist_sq(Vec2 a, Vec2 b) {
 	b = b - a;
 	return dot(b, b);
@@ -18,6 +41,11 @@ namespace rt {
 	return dot(b, b);
 }
 
+[[nodiscard]] f32 dist_sq(Vec3a a, Vec3a b) {
+	b = b - a;
+	return dot(b, b);
+}
+
 
 [[nodiscard]] f32 dist(Vec2 a, Vec2 b) {
 	return std::sqrt(dist_sq(a, b));
@@ -31,6 +59,10 @@ namespace rt {
 	return std::sqrt(dist_sq(a, b));
 }
 
+[[nodiscard]] f32 dist(Vec3a a, Vec3a b) {
+	return std::sqrt(dist_sq(a, b));
+}
+
 
 [[nodiscard]] f32 len_sq(Vec2 v) {
 	return dot(v, v);
@@ -44,6 +76,10 @@ namespace rt {
 	return dot(v, v);
 }
 
+[[nodiscard]] f32 len_sq(Vec3a v) {
+	return dot(v, v);
+}
+
 
 [[nodiscard]] f32 len(Vec2 v) {
 	return std::sqrt(len_sq(v));
@@ -57,6 +93,10 @@ namespace rt {
 	return std::sqrt(len_sq(v));
 }
 
+[[nodiscard]] f32 len(Vec3a v) {
+	return std::sqrt(len_sq(v));
+}
+
 
 Vec2& normalize(Vec2 &v) {
 	dbg_check_(!f32_compare(0, len(v)));
@@ -69,8 +109,19 @@ Vec3& normalize(Vec3 &v) {
 }
 
 Vec4& normalize(Vec4 &v) {
-	dbg_check_(!f32_compare(0, len(v)));
-	return (v *= 1/len(v));
+	__m128 const length = _mm_sqrt_ps(impl::hsum4_splat(_mm_mul_ps(v.m128, v.m128)));
+	dbg_check_(!f32_compare(0, _mm_cvtss_f32(length)));
+
+	v.m128 = _mm_div_ps(v.m128, length);
+	return v;
+}
+
+Vec3a& normalize(Vec3a &v) {
+	__m128 const length = _mm_sqrt_ps(impl::hsum3_splat(_mm_mul_ps(v.m128, v.m128)));
+	dbg_check_(!f32_compare(0, _mm_cvtss_f32(length)));
+
+	v.m128 = _mm_div_ps(v.m128, length);
+	return v;
 }
 
 [[nodiscard]] Vec2 normalized(Vec2 v) {
@@ -85,6 +136,10 @@ Vec4& normalize(Vec4 &v) {
 	return normalize(v);
 }
 
+[[nodiscard]] Vec3a normalized(Vec3a v) {
+	return normalize(v);
+}
+
 
 [[nodiscard]] f32 dot(Vec2 a, Vec2 b) {
 	a *= b;
@@ -97,8 +152,47 @@ Vec4& normalize(Vec4 &v) {
 }
 
 [[nodiscard]] f32 dot(Vec4 a, Vec4 b) {
-	a *= b;
-	return (a.x + a.y + a.z + a.w);
+	return _mm_cvtss_f32(impl::hsum4_splat(_mm_mul_ps(a.m128, b.m128)));
+}
+
+[[nodiscard]] f32 dot(Vec3a a, Vec3a b) {
+	return _mm_cvtss_f32(impl::hsum3_splat(_mm_mul_ps(a.m128, b.m128)));
+}
+
+
+[[nodiscard]] Vec3 cross(Vec3 a, Vec3 b) {
+	return {
+		.x = a.y*b.z - a.z*b.y,
+		.y = a.z*b.x - a.x*b.z,
+		.z = a.x*b.y - a.y*b.x
+	};
+}
+
+[[nodiscard]] Vec3a cross(Vec3a a, Vec3a b) {
+	// a.yzx*b.zxy - a.zxy*b.yzx, with one shuffle less.
+	__m128 const a_yzx = _mm_shuffle_ps(a.m128, a.m128, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 const b_yzx = _mm_shuffle_ps(b.m128, b.m128, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 const c     = _mm_sub_ps(_mm_mul_ps(a.m128, b_yzx), _mm_mul_ps(a_yzx, b.m128));
+
+	Vec3a result;
+	result.m128 = _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+	return result;
+}
+
+
+[[nodiscard]] f32 dot_scalar(Vec4 a, Vec4 b) {
+	return (a.x*b.x + a.y*b.y + a.z*b.z + a.w*b.w);
+}
+
+[[nodiscard]] f32 dot_scalar(Vec3a a, Vec3a b) {
+	return (a.x*b.x + a.y*b.y + a.z*b.z);
+}
+
+[[nodiscard]] Vec4 normalized_scalar(Vec4 v) {
+	f32 const length = std::sqrt(dot_scalar(v, v));
+	dbg_check_(!f32_compare(0, length));
+
+	return {.x = v.x/length, .y = v.y/length, .z = v.z/length, .w = v.w/length};
 }
 
 /**
@@ -242,26 +336,17 @@ Vec3& operator*=(Vec3 &a, f32 x) {
 }
 
 [[nodiscard]] Vec4 operator+(Vec4 a, Vec4 b) {
-	a.x += b.x;
-	a.y += b.y;
-	a.z += b.z;
-	a.w += b.w;
+	a.m128 = _mm_add_ps(a.m128, b.m128);
 	return a;
 }
 
 [[nodiscard]] Vec4 operator-(Vec4 a, Vec4 b) {
-	a.x -= b.x;
-	a.y -= b.y;
-	a.z -= b.z;
-	a.w -= b.w;
+	a.m128 = _mm_sub_ps(a.m128, b.m128);
 	return a;
 }
 
 [[nodiscard]] Vec4 operator*(Vec4 a, Vec4 b) {
-	a.x *= b.x;
-	a.y *= b.y;
-	a.z *= b.z;
-	a.w *= b.w;
+	a.m128 = _mm_mul_ps(a.m128, b.m128);
 	return a;
 }
 
@@ -270,18 +355,12 @@ Vec3& operator*=(Vec3 &a, f32 x) {
 	dbg_check_(!f32_compare(b.y, 0));
 	dbg_check_(!f32_compare(b.z, 0));
 	dbg_check_(!f32_compare(b.w, 0));
-	a.x /= b.x;
-	a.y /= b.y;
-	a.z /= b.z;
-	a.w /= b.w;
+	a.m128 = _mm_div_ps(a.m128, b.m128);
 	return a;
 }
 
 [[nodiscard]] Vec4 operator*(Vec4 v, f32 x) {
-	v.x *= x;
-	v.y *= x;
-	v.z *= x;
-	v.w *= x;
+	v.m128 = _mm_mul_ps(v.m128, _mm_set1_ps(x));
 	return v;
 }
 
@@ -309,4 +388,67 @@ Vec4& operator*=(Vec4 &a, f32 x) {
 	a = a*x;
 	return a;
 }
+
+
+
+// @Note: the padding lane is excluded from the comparison.
+[[nodiscard]] bool operator==(Vec3a a, Vec3a b) {
+	return (_mm_movemask_ps(_mm_cmpeq_ps(a.m128, b.m128)) & 0x7) == 0x7;
+}
+
+[[nodiscard]] Vec3a operator+(Vec3a a, Vec3a b) {
+	a.m128 = _mm_add_ps(a.m128, b.m128);
+	return a;
+}
+
+[[nodiscard]] Vec3a operator-(Vec3a a, Vec3a b) {
+	a.m128 = _mm_sub_ps(a.m128, b.m128);
+	return a;
+}
+
+[[nodiscard]] Vec3a operator*(Vec3a a, Vec3a b) {
+	a.m128 = _mm_mul_ps(a.m128, b.m128);
+	return a;
+}
+
+[[nodiscard]] Vec3a operator/(Vec3a a, Vec3a b) {
+	dbg_check_(!f32_compare(b.x, 0));
+	dbg_check_(!f32_compare(b.y, 0));
+	dbg_check_(!f32_compare(b.z, 0));
+
+	// @Note: keep the padding lane at 0 instead of producing 0/0.
+	__m128 const XYZ_MASK = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+	a.m128 = _mm_and_ps(_mm_div_ps(a.m128, b.m128), XYZ_MASK);
+	return a;
+}
+
+[[nodiscard]] Vec3a operator*(Vec3a v, f32 x) {
+	v.m128 = _mm_mul_ps(v.m128, _mm_set1_ps(x));
+	return v;
+}
+
+Vec3a& operator+=(Vec3a &a, Vec3a b) {
+	a = a + b;
+	return a;
+}
+
+Vec3a& operator-=(Vec3a &a, Vec3a b) {
+	a = a - b;
+	return a;
+}
+
+Vec3a& operator*=(Vec3a &a, Vec3a b) {
+	a = a*b;
+	return a;
+}
+
+Vec3a& operator/=(Vec3a &a, Vec3a b) {
+	a = a/b;
+	return a;
+}
+
+Vec3a& operator*=(Vec3a &a, f32 x) {
+	a = a*x;
+	return a;
+}
 } // namespace rt
\ No newline at end of file
@@ -1,5 +1,10 @@
 /**
  * Vector types expressed as unions for better expression.
+ *
+ * Vec4 and Vec3a are backed by SSE registers (SSE2 is always there on x64). Vec3a is
+ * a Vec3 padded to 16 bytes, so it can be loaded and stored as a whole -- use it in
+ * hot loops. The padding lane is ignored by every function (and is kept at 0 by most
+ * of them).
 */
 
 namespace rt {
@@ -44,7 +49,36 @@ union Vec4 {
     Vec2 xy; Vec2 _unused2;
   };
 
-  f32 v[4] = {};
+  __m128 m128;
+  f32    v[4] = {};
+};
+
+union Vec3a {
+  struct {
+    f32 x, y, z, _pad;
+  };
+
+  struct {
+    Vec3 xyz; f32 _unused0;
+  };
+
+  struct {
+    Vec2 xy; Vec2 _unused1;
+  };
+
+  __m128 m128;
+  f32    v[4] = {};
+};
+static_assert(sizeof(Vec4) == 16 && alignof(Vec4) == 16);
+static_assert(sizeof(Vec3a) == 16 && alignof(Vec3a) == 16);
+
+[[nodiscard]] Vec3a to_vec3a(Vec3 v);
+
+// Three parallel streams of `count` floats each.
+struct Vec3_Soa {
+  f32 *x;
+  f32 *y;
+  f32 *z;
 };
 
 /**
@@ -54,30 +88,45 @@ union Vec4 {
 [[nodiscard]] f32 dist_sq(Vec2 a, Vec2 b);
 [[nodiscard]] f32 dist_sq(Vec3 a, Vec3 b);
 [[nodiscard]] f32 dist_sq(Vec4 a, Vec4 b);
+[[nodiscard]] f32 dist_sq(Vec3a a, Vec3a b);
 
 [[nodiscard]] f32 dist(Vec2 a, Vec2 b);
 [[nodiscard]] f32 dist(Vec3 a, Vec3 b);
 [[nodiscard]] f32 dist(Vec4 a, Vec4 b);
+[[nodiscard]] f32 dist(Vec3a a, Vec3a b);
 
 [[nodiscard]] f32 len_sq(Vec2 v);
 [[nodiscard]] f32 len_sq(Vec3 const &v);
 [[nodiscard]] f32 len_sq(Vec4 const &v);
+[[nodiscard]] f32 len_sq(Vec3a v);
 
-[[nodiscard]] f32 Len(Vec2 v);
-[[nodiscard]] f32 Len(Vec3 const &v);
-[[nodiscard]] f32 Len(Vec4 const &v);
+[[nodiscard]] f32 len(Vec2 v);
+[[nodiscard]] f32 len(Vec3 const &v);
+[[nodiscard]] f32 len(Vec4 const &v);
+[[nodiscard]] f32 len(Vec3a v);
 
 Vec2& normalize(Vec2 &v);
 Vec3& normalize(Vec3 &v);
 Vec4& normalize(Vec4 &v);
+Vec3a& normalize(Vec3a &v);
 
 [[nodiscard]] Vec2 normalized(Vec2 v);
 [[nodiscard]] Vec3 normalized(Vec3 v);
 [[nodiscard]] Vec4 normalized(Vec4 v);
+[[nodiscard]] Vec3a normalized(Vec3a v);
 
 [[nodiscard]] f32 dot(Vec2 a, Vec2 b);
 [[nodiscard]] f32 dot(Vec3 a, Vec3 b);
 [[nodiscard]] f32 dot(Vec4 a, Vec4 b);
+[[nodiscard]] f32 dot(Vec3a a, Vec3a b);
+
+[[nodiscard]] Vec3  cross(Vec3 a, Vec3 b);
+[[nodiscard]] Vec3a cross(Vec3a a, Vec3a b);
+
+// Plain f32 versions of the SSE paths, for verification.
+[[nodiscard]] f32 dot_scalar(Vec4 a, Vec4 b);
+[[nodiscard]] f32 dot_scalar(Vec3a a, Vec3a b);
+[[nodiscard]] Vec4 normalized_scalar(Vec4 v);
 
 /**
  * Operators
@@ -120,4 +169,17 @@ Vec4& operator-=(Vec4 &a, Vec4 b);
 Vec4& operator*=(Vec4 &a, Vec4 b);
 Vec4& operator/=(Vec4 &a, Vec4 b);
 Vec4& operator*=(Vec4 &a, f32 x);
+
+
+[[nodiscard]] bool operator==(Vec3a a, Vec3a b);
+[[nodiscard]] Vec3a operator+(Vec3a a, Vec3a b);
+[[nodiscard]] Vec3a operator-(Vec3a a, Vec3a b);
+[[nodiscard]] Vec3a operator*(Vec3a a, Vec3a b);
+[[nodiscard]] Vec3a operator/(Vec3a a, Vec3a b);
+[[nodiscard]] Vec3a operator*(Vec3a v, f32 x);
+Vec3a& operator+=(Vec3a &a, Vec3a b);
+Vec3a& operator-=(Vec3a &a, Vec3a b);
+Vec3a& operator*=(Vec3a &a, Vec3a b);
+Vec3a& operator/=(Vec3a &a, Vec3a b);
+Vec3a& operator*=(Vec3a &a, f32 x);
 } // namespace rt
\ No newline at end of file
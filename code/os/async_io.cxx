@@ -0,0 +1,339 @@
+namespace rt {
+struct Async_Io_Slot {
+  ::OVERLAPPED      overlapped; // @Note: must be the first member, see os_poll_async_io.
+  ::HANDLE          file;
+  Async_Io_Request *request;
+
+  // Bytes of the request done so far. Requests over MAXDWORD bytes are transferred
+  // in chunks, one after the other.
+  s64 transferred;
+
+  // Error of a request that didn't go through the port: it failed at submission or
+  // ran synchronously.
+  ::DWORD sync_error;
+
+  // Fallback: the request runs on the job system, done once `job` drops to zero.
+  bool        on_jobs;
+  Job_Counter job;
+};
+
+struct Async_Io_State {
+  ::HANDLE port; // NULL if we run the fallback.
+
+  Async_Io_Slot slots[ASYNC_IO_MAX_IN_FLIGHT];
+
+  s32 free_slots[ASYNC_IO_MAX_IN_FLIGHT];
+  s32 free_count;
+
+  // Slots completed at submission, waiting for the next poll.
+  s32 ready_slots[ASYNC_IO_MAX_IN_FLIGHT];
+  s32 ready_count;
+
+  s32 on_port_count;
+  s32 on_jobs_count;
+} static gAsync_Io;
+
+namespace impl {
+void
+complete_async_io_slot(Async_Io_Slot &slot, bool success, ::DWORD error) {
+  Async_Io_Request &request = *slot.request;
+
+  request.bytes_transferred = slot.transferred;
+  request.error             = success ? 0 : (u32)error;
+  request.status            = success ? AsyncIoStatus_Done : AsyncIoStatus_Failed;
+
+  if (success && slot.transferred != request.buffer.count) {
+    logf("Async I/O: short %s of '%s' (%lld/%lld)\n",
+         request.op == AsyncIoOp_Read ? "read" : "write", request.path,
+         request.bytes_transferred, request.buffer.count);
+  }
+
+  if (slot.file != INVALID_HANDLE_VALUE) {
+    ::CloseHandle(slot.file);
+  }
+
+  // @Note: release the slot before the callback, so it can submit follow-up requests.
+  s64 const slot_index = &slot - gAsync_Io.slots;
+  slot = {};
+  gAsync_Io.free_slots[gAsync_Io.free_count++] = (s32)slot_index;
+
+  if (request.callback) {
+    request.callback(request);
+  }
+}
+
+void
+defer_async_io_completion(Async_Io_Slot &slot, ::DWORD error) {
+  slot.sync_error = error;
+
+  gAsync_Io.ready_slots[gAsync_Io.ready_count++] = (s32)(&slot - gAsync_Io.slots);
+}
+
+// Size of the next chunk of the request, ReadFile and WriteFile take a DWORD.
+[[nodiscard]] ::DWORD
+next_async_io_chunk(Async_Io_Slot const &slot) {
+  s64 const remaining = slot.request->buffer.count - slot.transferred;
+  return (::DWORD)((remaining < (s64)MAXDWORD) ? remaining : (s64)MAXDWORD);
+}
+
+// Starts the next chunk on the port. Returns false (with the error) if it failed right
+// away, no completion packet is queued then.
+[[nodiscard]] bool
+issue_async_io_chunk(Async_Io_Slot &slot, ::DWORD &error) {
+  Async_Io_Request &request = *slot.request;
+
+  u64 const offset = (u64)(request.offset + slot.transferred);
+  slot.overlapped            = {};
+  slot.overlapped.Offset     = (::DWORD)(offset & 0xffffffff);
+  slot.overlapped.OffsetHigh = (::DWORD)(offset >> 32);
+
+  u8 *const     bytes = request.buffer.bytes + slot.transferred;
+  ::DWORD const count = next_async_io_chunk(slot);
+  ::BOOL        success;
+
+  if (request.op == AsyncIoOp_Read) {
+    success = ::ReadFile(slot.file, bytes, count, NULL, &slot.overlapped);
+  } else {
+    success = ::WriteFile(slot.file, bytes, count, NULL, &slot.overlapped);
+  }
+
+  // @Note: even if the operation finished synchronously, the completion packet is
+  //        still queued on the port, so we handle both cases in os_poll_async_io.
+  error = success ? 0 : ::GetLastError();
+  return success || error == ERROR_IO_PENDING;
+}
+
+// Sets the slot's transferred and sync_error. Runs on any thread.
+void
+run_synchronous_io(Async_Io_Slot &slot) {
+  Async_Io_Request &request = *slot.request;
+
+  ::LARGE_INTEGER offset;
+  offset.QuadPart = request.offset;
+  if (!::SetFilePointerEx(slot.file, offset, NULL, FILE_BEGIN)) {
+    slot.sync_error = ::GetLastError();
+    return;
+  }
+
+  while (slot.transferred < request.buffer.count) {
+    u8 *const     bytes = request.buffer.bytes + slot.transferred;
+    ::DWORD const count = next_async_io_chunk(slot);
+    ::DWORD       done  = 0;
+    ::BOOL        success;
+
+    if (request.op == AsyncIoOp_Read) {
+      success = ::ReadFile(slot.file, bytes, count, &done, NULL);
+    } else {
+      success = ::WriteFile(slot.file, bytes, count, &done, NULL);
+    }
+
+    slot.transferred += done;
+    if (!success) {
+      slot.sync_error = ::GetLastError();
+      return;
+    }
+    if (done < count) {
+      return; // End of the file.
+    }
+  }
+  slot.sync_error = 0;
+}
+
+void
+async_io_job(void *data) {
+  run_synchronous_io(*(Async_Io_Slot*)data);
+}
+} // namespace impl
+
+void
+os_init_async_io() {
+  gAsync_Io = {};
+
+  gAsync_Io.port = ::CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+
+  if (gAsync_Io.port == NULL) {
+    logf("Async I/O: failed to create the completion port, using the job system.\n");
+  }
+
+  // @Note: hand out low indices first.
+  for (s32 i = 0; i < ASYNC_IO_MAX_IN_FLIGHT; i++) {
+    gAsync_Io.free_slots[i] = ASYNC_IO_MAX_IN_FLIGHT - 1 - i;
+  }
+  gAsync_Io.free_count = ASYNC_IO_MAX_IN_FLIGHT;
+
+  logf("Async I/O initialized (%s, %d slots).\n",
+       gAsync_Io.port ? "completion port" : "job system", ASYNC_IO_MAX_IN_FLIGHT);
+}
+
+void
+os_submit_async_io(Async_Io_Request &request) {
+  check_(request.path);
+  check_(request.offset >= 0);
+  check_(request.op == AsyncIoOp_Read || request.buffer.bytes != NULL);
+
+  request.status            = AsyncIoStatus_Pending;
+  request.bytes_transferred = 0;
+  request.error             = 0;
+
+  while (gAsync_Io.free_count == 0) {
+    os_poll_async_io(true);
+  }
+
+  s32 const      slot_index = gAsync_Io.free_slots[--gAsync_Io.free_count];
+  Async_Io_Slot &slot       = gAsync_Io.slots[slot_index];
+  slot         = {};
+  slot.request = &request;
+
+  bool const    is_read = (request.op == AsyncIoOp_Read);
+  ::DWORD const flags   = FILE_ATTRIBUTE_NORMAL | (gAsync_Io.port ? FILE_FLAG_OVERLAPPED : 0);
+
+  // @Unicode: handle UTF-8 paths
+  slot.file = ::CreateFileA(
+                  (LPCSTR)request.path,
+                  is_read ? GENERIC_READ : GENERIC_WRITE,
+                  FILE_SHARE_READ,
+                  0,
+                  is_read ? OPEN_EXISTING : OPEN_ALWAYS,
+                  flags,
+                  NULL
+                  );
+
+  if (slot.file == INVALID_HANDLE_VALUE) {
+    impl::defer_async_io_completion(slot, ::GetLastError());
+    return;
+  }
+
+  if (is_read && request.buffer.bytes == NULL) {
+    ::LARGE_INTEGER file_sz_raw;
+    if (!::GetFileSizeEx(slot.file, &file_sz_raw)) {
+      impl::defer_async_io_completion(slot, ::GetLastError());
+      return;
+    }
+
+    s64 const count = file_sz_raw.QuadPart - request.offset;
+    request.buffer.count = (count > 0) ? count : 0;
+    request.buffer.bytes = (count > 0) ? (u8*)alloc_perm(count) : NULL;
+  }
+
+  if (request.buffer.count == 0) {
+    impl::defer_async_io_completion(slot, 0);
+    return;
+  }
+
+  // @Note: the fallback blocks a worker per request. Without workers nothing would run
+  //        the job until someone waits, so the request is done right here instead.
+  if (gAsync_Io.port == NULL) {
+    if (jobs_thread_count() > 1) {
+      Job const job = {.fn = impl::async_io_job, .data = &slot};
+      slot.on_jobs = true;
+      gAsync_Io.on_jobs_count++;
+      submit_jobs(&job, 1, slot.job);
+    } else {
+      impl::run_synchronous_io(slot);
+      impl::defer_async_io_completion(slot, slot.sync_error);
+    }
+    return;
+  }
+
+  if (!::CreateIoCompletionPort(slot.file, gAsync_Io.port, 0, 0)) {
+    impl::defer_async_io_completion(slot, ::GetLastError());
+    return;
+  }
+
+  ::DWORD error;
+  if (impl::issue_async_io_chunk(slot, error)) {
+    gAsync_Io.on_port_count++;
+  } else {
+    impl::defer_async_io_completion(slot, error);
+  }
+}
+
+s32
+os_poll_async_io(bool wait) {
+  s32 completed = 0;
+
+  while (gAsync_Io.ready_count > 0) {
+    Async_Io_Slot &slot = gAsync_Io.slots[gAsync_Io.ready_slots[--gAsync_Io.ready_count]];
+    impl::complete_async_io_slot(slot, slot.sync_error == 0, slot.sync_error);
+    completed++;
+  }
+
+  if (gAsync_Io.on_jobs_count > 0) {
+    // @Note: help with the jobs until one of the requests is done.
+    for (s32 i = 0; wait && completed == 0 && i < ASYNC_IO_MAX_IN_FLIGHT; i++) {
+      if (gAsync_Io.slots[i].on_jobs) {
+        wait_for_jobs(gAsync_Io.slots[i].job);
+        break;
+      }
+    }
+
+    for (s32 i = 0; i < ASYNC_IO_MAX_IN_FLIGHT; i++) {
+      Async_Io_Slot &slot = gAsync_Io.slots[i];
+      if (slot.on_jobs && atomic_load(slot.job.pending) == 0) {
+        gAsync_Io.on_jobs_count--;
+        impl::complete_async_io_slot(slot, slot.sync_error == 0, slot.sync_error);
+        completed++;
+      }
+    }
+  }
+
+  if (gAsync_Io.on_port_count == 0) {
+    return completed;
+  }
+
+  ::OVERLAPPED_ENTRY entries[64];
+  ::ULONG            removed = 0;
+  ::DWORD const      timeout = (wait && completed == 0) ? INFINITE : 0;
+  ::BOOL  const      success = ::GetQueuedCompletionStatusEx(
+                                   gAsync_Io.port,
+                                   entries,
+                                   (::ULONG)(sizeof(entries)/sizeof(*entries)),
+                                   &removed,
+                                   timeout,
+                                   FALSE
+                                   );
+
+  // @Note: fails with WAIT_TIMEOUT if nothing completed.
+  if (!success) {
+    return completed;
+  }
+
+  for (::ULONG i = 0; i < removed; i++) {
+    Async_Io_Slot &slot = *(Async_Io_Slot*)entries[i].lpOverlapped;
+    gAsync_Io.on_port_count--;
+
+    ::DWORD       bytes  = 0;
+    ::BOOL  const result = ::GetOverlappedResult(slot.file, &slot.overlapped, &bytes, FALSE);
+    ::DWORD       error  = result ? 0 : ::GetLastError();
+    slot.transferred += bytes;
+
+    // @Note: a request over MAXDWORD bytes goes on with its next chunk until the file
+    //        ends. Hitting the end on a later chunk is a short read, not a failure.
+    if (!result && error == ERROR_HANDLE_EOF && slot.transferred > 0) {
+      error = 0;
+    } else if (result && bytes > 0 && slot.transferred < slot.request->buffer.count) {
+      if (impl::issue_async_io_chunk(slot, error)) {
+        gAsync_Io.on_port_count++;
+        continue;
+      }
+    }
+
+    impl::complete_async_io_slot(slot, error == 0, error);
+    completed++;
+  }
+
+  return completed;
+}
+
+void
+os_wait_for_all_async_io() {
+  while (os_get_async_io_in_flight_count() > 0) {
+    os_poll_async_io(true);
+  }
+}
+
+[[nodiscard]] s32
+os_get_async_io_in_flight_count() {
+  return ASYNC_IO_MAX_IN_FLIGHT - gAsync_Io.free_count;
+}
+} // namespace rt
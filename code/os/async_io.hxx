@@ -0,0 +1,70 @@
+/**
+ * Asynchronous, batched file I/O. Requests are submitted without blocking and their
+ * completions are collected with os_poll_async_io, which also runs the callbacks.
+ * Unlike the functions in filesystem.hxx, failures don't panic -- they are reported
+ * through the request status.
+ *
+ * Backed by an I/O completion port, so many reads can be in flight while the CPU
+ * decodes the ones that already arrived. If the port can't be created, every request
+ * runs as a blocking job on the job system's workers instead (synchronously at
+ * submission if there are none), and is completed by a later poll.
+ *
+ * @Note: single-threaded. Submit and poll from the same thread.
+*/
+
+namespace rt {
+enum Async_Io_Op {
+  AsyncIoOp_Read = 0,
+  AsyncIoOp_Write
+};
+
+enum Async_Io_Status {
+  AsyncIoStatus_Idle = 0,
+  AsyncIoStatus_Pending,
+  AsyncIoStatus_Done,
+  AsyncIoStatus_Failed
+};
+
+struct Async_Io_Request;
+using Async_Io_Callback = void(Async_Io_Request &request);
+
+// Owned by the caller, must stay alive (and not move) until the request completes.
+struct Async_Io_Request {
+  Async_Io_Op op;
+  char const *path;
+  s64         offset;
+
+  // Reads: destination. If `bytes` is NULL, the rest of the file (from `offset`) is
+  //        read into a new permanent allocation, which is stored here.
+  // Writes: source. The file is created if needed, but never truncated.
+  // @Note: requests over 4 GB are split into chunks, still one completion per request.
+  Buffer buffer;
+
+  Async_Io_Callback *callback;  // Optional.
+  void              *user_data;
+
+  // Filled by the OS layer.
+  Async_Io_Status status;
+  s64             bytes_transferred;
+  u32             error; // OS error code, valid when status == AsyncIoStatus_Failed.
+};
+
+void
+os_init_async_io();
+
+// May block (by polling) if ASYNC_IO_MAX_IN_FLIGHT requests are already in flight.
+void
+os_submit_async_io(Async_Io_Request &request);
+
+// Completes finished requests and runs their callbacks. If `wait` is set, blocks until
+// at least one request completes (unless nothing is in flight).
+// Returns the number of completed requests.
+s32
+os_poll_async_io(bool wait);
+
+void
+os_wait_for_all_async_io();
+
+[[nodiscard]] s32
+os_get_async_io_in_flight_count();
+} // namespace rt
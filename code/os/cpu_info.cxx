@@ -0,0 +1,243 @@
+namespace rt {
+struct Cpu_Info_State {
+  Cpu_Info  info;
+  Isa_Level detected_isa_level;
+} static gCpu_Info_State;
+
+namespace impl {
+struct Cpuid_Regs {
+  s32 eax, ebx, ecx, edx;
+};
+
+[[nodiscard]] Cpuid_Regs
+cpuid(s32 leaf, s32 subleaf = 0) {
+  s32 regs[4];
+  ::__cpuidex(regs, leaf, subleaf);
+  return {.eax = regs[0], .ebx = regs[1], .ecx = regs[2], .edx = regs[3]};
+}
+
+[[nodiscard]] bool
+bit(s32 reg, s32 index) {
+  return (((u32)reg >> index) & 1) != 0;
+}
+
+void
+query_cpuid_features(Cpu_Info &info) {
+  Cpuid_Regs const leaf0 = cpuid(0);
+  s32 const max_leaf = leaf0.eax;
+
+  // The vendor string is stored in EBX, EDX, ECX (in this order).
+  mem_copy_(info.vendor + 0, &leaf0.ebx, 4);
+  mem_copy_(info.vendor + 4, &leaf0.edx, 4);
+  mem_copy_(info.vendor + 8, &leaf0.ecx, 4);
+  info.vendor[12] = 0;
+
+  Cpuid_Regs const ext0 = cpuid((s32)0x80000000);
+  if ((u32)ext0.eax >= 0x80000004) {
+    for (s32 i = 0; i < 3; i++) {
+      Cpuid_Regs const regs = cpuid((s32)0x80000002 + i);
+      mem_copy_(info.brand + i*16, &regs, 16);
+    }
+  }
+  info.brand[48] = 0;
+
+  if (max_leaf < 1) {
+    return;
+  }
+
+  Cpuid_Regs const leaf1 = cpuid(1);
+  info.has_sse3   = bit(leaf1.ecx, 0);
+  info.has_ssse3  = bit(leaf1.ecx, 9);
+  info.has_fma    = bit(leaf1.ecx, 12);
+  info.has_sse41  = bit(leaf1.ecx, 19);
+  info.has_sse42  = bit(leaf1.ecx, 20);
+  info.has_popcnt = bit(leaf1.ecx, 23);
+  info.has_avx    = bit(leaf1.ecx, 28);
+  info.has_f16c   = bit(leaf1.ecx, 29);
+
+  // @Note: the CPU may support AVX while the OS doesn't save the YMM/ZMM registers
+  //        on context switch. XCR0 tells us what the OS enabled.
+  bool const has_osxsave = bit(leaf1.ecx, 27);
+  u64  const xcr0        = has_osxsave ? ::_xgetbv(0) : 0;
+  bool const os_ymm      = (xcr0 & 0x06) == 0x06;
+  bool const os_zmm      = (xcr0 & 0xe6) == 0xe6;
+
+  info.has_avx  = info.has_avx  && os_ymm;
+  info.has_fma  = info.has_fma  && os_ymm;
+  info.has_f16c = info.has_f16c && os_ymm;
+
+  if (max_leaf < 7) {
+    return;
+  }
+
+  Cpuid_Regs const leaf7 = cpuid(7, 0);
+  info.has_bmi1     = bit(leaf7.ebx, 3);
+  info.has_avx2     = bit(leaf7.ebx, 5)  && os_ymm;
+  info.has_bmi2     = bit(leaf7.ebx, 8);
+  info.has_avx512f  = bit(leaf7.ebx, 16) && os_zmm;
+  info.has_avx512dq = bit(leaf7.ebx, 17) && os_zmm;
+  info.has_avx512bw = bit(leaf7.ebx, 30) && os_zmm;
+  info.has_avx512vl = bit(leaf7.ebx, 31) && os_zmm;
+}
+
+void
+query_topology(Cpu_Info &info) {
+  ::DWORD buffer_size = 0;
+  ::GetLogicalProcessorInformationEx(::RelationAll, NULL, &buffer_size);
+
+  if (buffer_size == 0) {
+    logf("GetLogicalProcessorInformationEx failed, assuming a single core.\n");
+    info.logical_cores  = 1;
+    info.physical_cores = 1;
+    return;
+  }
+
+  u8 *buffer = (u8*)alloc_temp(buffer_size);
+  ::BOOL const success = ::GetLogicalProcessorInformationEx(
+                            ::RelationAll,
+                            (::PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX)buffer,
+                            &buffer_size
+                            );
+
+  if (!success) {
+    logf("GetLogicalProcessorInformationEx failed, assuming a single core.\n");
+    info.logical_cores  = 1;
+    info.physical_cores = 1;
+    return;
+  }
+
+  for (::DWORD offset = 0; offset < buffer_size;) {
+    auto const *entry = (::SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX const*)(buffer + offset);
+    offset += entry->Size;
+
+    switch (entry->Relationship) {
+      case ::RelationProcessorCore: {
+        info.physical_cores++;
+
+        if (entry->Processor.Flags == LTP_PC_SMT) {
+          info.hyperthreading = true;
+        }
+
+        // @Note: no __popcnt64 here - we don't know yet if the CPU has POPCNT.
+        for (::WORD i = 0; i < entry->Processor.GroupCount; i++) {
+          for (u64 mask = entry->Processor.GroupMask[i].Mask; mask; mask &= mask - 1) {
+            info.logical_cores++;
+          }
+        }
+      } break;
+
+      case ::RelationCache: {
+        ::CACHE_RELATIONSHIP const &cache = entry->Cache;
+        if (cache.Type != ::CacheData && cache.Type != ::CacheUnified) {
+          break;
+        }
+
+        info.cache_line_size = (s32)cache.LineSize;
+
+        // @Note: L1 and L2 are reported once per core; we only keep the size of one.
+        //        L3 may be split into slices (e.g. per CCX), so we sum it up.
+        switch (cache.Level) {
+          case 1: info.l1d_cache_size  = (s64)cache.CacheSize; break;
+          case 2: info.l2_cache_size   = (s64)cache.CacheSize; break;
+          case 3: info.l3_cache_size  += (s64)cache.CacheSize; break;
+        }
+      } break;
+
+      default: break;
+    }
+  }
+}
+
+[[nodiscard]] Isa_Level
+highest_supported_isa_level(Cpu_Info const &info) {
+  bool const avx512 = info.has_avx512f && info.has_avx512dq &&
+                      info.has_avx512bw && info.has_avx512vl;
+  bool const avx2   = info.has_avx && info.has_avx2 && info.has_fma &&
+                      info.has_bmi1 && info.has_bmi2 && info.has_f16c;
+  bool const sse42  = info.has_sse3 && info.has_ssse3 && info.has_sse41 &&
+                      info.has_sse42 && info.has_popcnt;
+
+  if (sse42 && avx2 && avx512) return IsaLevel_AVX512;
+  if (sse42 && avx2)           return IsaLevel_AVX2;
+  if (sse42)                   return IsaLevel_SSE42;
+  return IsaLevel_Scalar;
+}
+} // namespace impl
+
+void
+os_init_cpu_info() {
+  Cpu_Info &info = gCpu_Info_State.info;
+  info = {};
+
+  impl::query_cpuid_features(info);
+  impl::query_topology(info);
+
+  info.isa_level                     = impl::highest_supported_isa_level(info);
+  gCpu_Info_State.detected_isa_level = info.isa_level;
+
+  logf("CPU info:\n");
+  logf("\t   vendor='%s'\n", info.vendor);
+  logf("\t    brand='%s'\n", info.brand);
+  logf("\t    cores=%d physical, %d logical (hyperthreading: %s)\n",
+       info.physical_cores, info.logical_cores, info.hyperthreading ? "yes" : "no");
+  logf("\t   caches=L1d %lld KB, L2 %lld KB, L3 %lld KB, line %d B\n",
+       info.l1d_cache_size/1024, info.l2_cache_size/1024, info.l3_cache_size/1024,
+       info.cache_line_size);
+  logf("\t     simd=%s%s%s%s%s%s%s%s%s%s%s%s%s%s\n",
+       info.has_sse3     ? "SSE3 "     : "",
+       info.has_ssse3    ? "SSSE3 "    : "",
+       info.has_sse41    ? "SSE4.1 "   : "",
+       info.has_sse42    ? "SSE4.2 "   : "",
+       info.has_avx      ? "AVX "      : "",
+       info.has_avx2     ? "AVX2 "     : "",
+       info.has_fma      ? "FMA "      : "",
+       info.has_f16c     ? "F16C "     : "",
+       info.has_bmi1     ? "BMI1 "     : "",
+       info.has_bmi2     ? "BMI2 "     : "",
+       info.has_avx512f  ? "AVX512F "  : "",
+       info.has_avx512dq ? "AVX512DQ " : "",
+       info.has_avx512bw ? "AVX512BW " : "",
+       info.has_avx512vl ? "AVX512VL " : "");
+  logf("\tisa level=%s\n", os_isa_level_name(info.isa_level));
+}
+
+[[nodiscard]] Cpu_Info const&
+os_get_cpu_info() {
+  return gCpu_Info_State.info;
+}
+
+void
+os_limit_isa_level(Isa_Level max_level) {
+  dbg_check_(max_level >= IsaLevel_Scalar && max_level < IsaLevel_Count);
+
+  Isa_Level const detected = gCpu_Info_State.detected_isa_level;
+  gCpu_Info_State.info.isa_level = (max_level < detected) ? max_level : detected;
+
+  logf("ISA level limited to %s\n", os_isa_level_name(gCpu_Info_State.info.isa_level));
+}
+
+[[nodiscard]] char const*
+os_isa_level_name(Isa_Level level) {
+  switch (level) {
+    case IsaLevel_Scalar: return "Scalar";
+    case IsaLevel_SSE42:  return "SSE4.2";
+    case IsaLevel_AVX2:   return "AVX2";
+    case IsaLevel_AVX512: return "AVX-512";
+    default:              return "Unknown";
+  }
+}
+
+template <typename TFn>
+[[nodiscard]] TFn*
+os_pick_kernel(Kernel_Variants<TFn> const &kernel) {
+  check_(kernel.variants[IsaLevel_Scalar] != NULL);
+
+  for (s32 level = gCpu_Info_State.info.isa_level; level > IsaLevel_Scalar; level--) {
+    if (kernel.variants[level]) {
+      return kernel.variants[level];
+    }
+  }
+
+  return kernel.variants[IsaLevel_Scalar];
+}
+} // namespace rt
@@ -0,0 +1,85 @@
+/**
+ * Information about the CPU we run on (SIMD extensions, cores, caches) and a simple
+ * mechanism for picking the fastest variant of a hot kernel at startup.
+*/
+
+namespace rt {
+// Ordered from the weakest to the strongest. A kernel variant for a given level may
+// use every instruction set of the levels below it.
+enum Isa_Level {
+  IsaLevel_Scalar = 0, // SSE2 is always there on x64, so 'scalar' means plain SSE2.
+  IsaLevel_SSE42,      // SSE3, SSSE3, SSE4.1, SSE4.2, POPCNT
+  IsaLevel_AVX2,       // AVX, AVX2, FMA3, BMI1, BMI2, F16C
+  IsaLevel_AVX512,     // AVX-512 F, DQ, BW, VL
+
+  IsaLevel_Count
+};
+
+struct Cpu_Info {
+  char vendor[13];
+  char brand[49];
+
+  bool has_sse3;
+  bool has_ssse3;
+  bool has_sse41;
+  bool has_sse42;
+  bool has_popcnt;
+  bool has_avx;
+  bool has_avx2;
+  bool has_fma;
+  bool has_bmi1;
+  bool has_bmi2;
+  bool has_f16c;
+  bool has_avx512f;
+  bool has_avx512dq;
+  bool has_avx512bw;
+  bool has_avx512vl;
+
+  s32  logical_cores;
+  s32  physical_cores;
+  bool hyperthreading;
+
+  s32 cache_line_size;
+  s64 l1d_cache_size; // Per core.
+  s64 l2_cache_size;  // Per core.
+  s64 l3_cache_size;  // Total, summed over all L3 slices.
+
+  // Highest level supported by both the CPU and the OS (saved YMM/ZMM state).
+  Isa_Level isa_level;
+};
+
+// Queries cpuid and the OS for the processor topology and logs the results.
+void
+os_init_cpu_info();
+
+[[nodiscard]] Cpu_Info const&
+os_get_cpu_info();
+
+// Lowers the ISA level used by os_pick_kernel. Useful for verifying the fallback paths.
+void
+os_limit_isa_level(Isa_Level max_level);
+
+[[nodiscard]] char const*
+os_isa_level_name(Isa_Level level);
+
+/**
+ * Function-pointer dispatch. A kernel ships one variant per ISA level it cares about
+ * (leave the rest NULL) and picks the best one once, after os_init_cpu_info:
+ *
+ *    using Tonemap_Fn = void(Vec4 const *hdr, u32 *ldr, s64 count);
+ *    Tonemap_Fn *gTonemap = os_pick_kernel<Tonemap_Fn>({{
+ *      tonemap_scalar, NULL, tonemap_avx2, NULL
+ *    }});
+ *
+ * MSVC lets us use any intrinsic without /arch, so all variants live in the unity
+ * build side by side. The scalar variant is mandatory.
+*/
+template <typename TFn>
+struct Kernel_Variants {
+  TFn *variants[IsaLevel_Count];
+};
+
+template <typename TFn>
+[[nodiscard]] TFn*
+os_pick_kernel(Kernel_Variants<TFn> const &kernel);
+} // namespace rt
@@ -0,0 +1,320 @@
+namespace rt {
+struct File_Watch_Dir {
+  String       path;
+  ::HANDLE     dir;
+  ::OVERLAPPED overlapped;
+
+  // @Note: ReadDirectoryChangesW needs a DWORD-aligned buffer.
+  alignas(8) u8 notifications[RT_KILOBYTES(16)];
+};
+
+struct File_Subscription {
+  String                 path; // Normalized, see impl::normalize_watched_path.
+  File_Changed_Callback *callback;
+  void                  *user_data;
+
+  bool is_pending;
+  f32  changed_at;
+};
+
+struct File_Watcher_State {
+  File_Watch_Dir *dirs;
+  s32             dir_count;
+
+  File_Subscription subscriptions[FILE_WATCHER_MAX_SUBSCRIPTIONS];
+  s32               subscription_count;
+} static gFile_Watcher;
+
+namespace impl {
+// Paths are compared as lowercase with '\' separators, because that's what the file
+// system does.
+// @Unicode: only ASCII letters are folded.
+void
+normalize_watched_path(String path) {
+  for (s64 i = 0; i < path.count; i++) {
+    char &c = path.data[i];
+    if (c == '/') {
+      c = '\\';
+    } else if (c >= 'A' && c <= 'Z') {
+      c = c - 'A' + 'a';
+    }
+  }
+}
+
+[[nodiscard]] bool
+begin_watching_dir(File_Watch_Dir &watch) {
+  watch.overlapped = {};
+
+  ::DWORD constexpr static FILTER = FILE_NOTIFY_CHANGE_FILE_NAME  |
+                                    FILE_NOTIFY_CHANGE_DIR_NAME   |
+                                    FILE_NOTIFY_CHANGE_LAST_WRITE |
+                                    FILE_NOTIFY_CHANGE_SIZE;
+
+  ::BOOL const success = ::ReadDirectoryChangesW(
+                             watch.dir,
+                             watch.notifications,
+                             (::DWORD)sizeof(watch.notifications),
+                             TRUE, // Watch the subdirectories too.
+                             FILTER,
+                             NULL,
+                             &watch.overlapped,
+                             NULL
+                             );
+  return success != FALSE;
+}
+
+void
+mark_file_changed(String path) {
+  f32 const now = os_get_app_uptime();
+
+  for (s32 i = 0; i < gFile_Watcher.subscription_count; i++) {
+    File_Subscription &sub = gFile_Watcher.subscriptions[i];
+
+    if (sub.path.count == path.count && mem_comp_(sub.path.data, path.data, path.count) == 0) {
+      sub.is_pending = true;
+      sub.changed_at = now;
+    }
+  }
+}
+
+// Used when the notification buffer overflowed and we don't know what changed.
+void
+mark_dir_changed(String dir) {
+  f32 const now = os_get_app_uptime();
+
+  for (s32 i = 0; i < gFile_Watcher.subscription_count; i++) {
+    File_Subscription &sub = gFile_Watcher.subscriptions[i];
+
+    if (sub.path.count > dir.count && mem_comp_(sub.path.data, dir.data, dir.count) == 0) {
+      sub.is_pending = true;
+      sub.changed_at = now;
+    }
+  }
+}
+
+void
+process_notifications(File_Watch_Dir &watch, ::DWORD size) {
+  if (size == 0) {
+    logf("File watcher: too many changes in '%.*s', reloading everything in it.\n",
+         (int)watch.path.count, watch.path.data);
+    mark_dir_changed(watch.path);
+    return;
+  }
+
+  s64 const mark = get_temp_mem_mark();
+
+  for (u8 *it = watch.notifications;;) {
+    ::FILE_NOTIFY_INFORMATION const &info = *(::FILE_NOTIFY_INFORMATION*)it;
+
+    // @Unicode: we use ANSI paths everywhere else.
+    char name[MAX_PATH];
+    int const name_length = ::WideCharToMultiByte(
+                                CP_ACP,
+                                0,
+                                info.FileName,
+                                (int)(info.FileNameLength/sizeof(WCHAR)),
+                                name,
+                                (int)sizeof(name),
+                                NULL,
+                                NULL
+                                );
+
+    if (name_length > 0) {
+      String const path = tprint("%.*s\\%.*s", (int)watch.path.count, watch.path.data,
+                                 name_length, name);
+      normalize_watched_path(path);
+      mark_file_changed(path);
+    }
+
+    if (info.NextEntryOffset == 0) {
+      break;
+    }
+    it += info.NextEntryOffset;
+  }
+
+  pop_temp_mem_mark(get_temp_mem_mark() - mark);
+}
+} // namespace impl
+
+void
+os_init_file_watcher() {
+  gFile_Watcher = {};
+
+  // @Note: logs are left out on purpose -- the log file changes all the time.
+  //        Shaders, textures and models are subdirectories of these two.
+  String const roots[] = {gPath_Cache.data, gPath_Cache.assets};
+  s32 constexpr static ROOT_COUNT = sizeof(roots)/sizeof(*roots);
+
+  gFile_Watcher.dirs = (File_Watch_Dir*)alloc_perm(ROOT_COUNT*sizeof(File_Watch_Dir));
+
+  for (s32 i = 0; i < ROOT_COUNT; i++) {
+    File_Watch_Dir &watch = gFile_Watcher.dirs[gFile_Watcher.dir_count];
+    watch = {};
+
+    // @Note: copy, because we normalize it.
+    String_Builder sb;
+    append(sb, roots[i]);
+    watch.path = to_perm_string(sb);
+    impl::normalize_watched_path(watch.path);
+
+    // @Unicode
+    watch.dir = ::CreateFileA(
+                    as_cstr(watch.path),
+                    FILE_LIST_DIRECTORY,
+                    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                    NULL,
+                    OPEN_EXISTING,
+                    FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+                    NULL
+                    );
+
+    if (watch.dir == INVALID_HANDLE_VALUE) {
+      logf("File watcher: can't watch '%.*s', skipping it.\n",
+           (int)watch.path.count, watch.path.data);
+      continue;
+    }
+
+    if (!impl::begin_watching_dir(watch)) {
+      logf("File watcher: ReadDirectoryChangesW failed for '%.*s', skipping it.\n",
+           (int)watch.path.count, watch.path.data);
+      ::CloseHandle(watch.dir);
+      continue;
+    }
+
+    gFile_Watcher.dir_count++;
+  }
+
+  logf("File watcher initialized (%d directories).\n", gFile_Watcher.dir_count);
+}
+
+void
+os_shutdown_file_watcher() {
+  for (s32 i = 0; i < gFile_Watcher.dir_count; i++) {
+    File_Watch_Dir &watch = gFile_Watcher.dirs[i];
+    if (watch.dir == NULL) {
+      continue;
+    }
+
+    // @Note: the buffer must stay alive until the cancellation completes.
+    ::DWORD bytes;
+    ::CancelIoEx(watch.dir, &watch.overlapped);
+    ::GetOverlappedResult(watch.dir, &watch.overlapped, &bytes, TRUE);
+    ::CloseHandle(watch.dir);
+  }
+
+  for (s32 i = 0; i < gFile_Watcher.subscription_count; i++) {
+    free_perm(gFile_Watcher.subscriptions[i].path.data);
+  }
+
+  gFile_Watcher.dir_count          = 0;
+  gFile_Watcher.subscription_count = 0;
+}
+
+void
+os_watch_file(char const *path, File_Changed_Callback *callback, void *user_data) {
+  check_(path);
+  check_(callback);
+
+  if (gFile_Watcher.subscription_count == FILE_WATCHER_MAX_SUBSCRIPTIONS) {
+    errf("Too many watched files (max %d). Increase FILE_WATCHER_MAX_SUBSCRIPTIONS.",
+         FILE_WATCHER_MAX_SUBSCRIPTIONS);
+  }
+
+  s64 const length = (s64)::strlen(path);
+
+  File_Subscription &sub = gFile_Watcher.subscriptions[gFile_Watcher.subscription_count++];
+  sub = {
+    .path      = {.count = length, .data = (char*)alloc_perm(length + 1)},
+    .callback  = callback,
+    .user_data = user_data
+  };
+
+  mem_copy_(sub.path.data, path, length + 1);
+  impl::normalize_watched_path(sub.path);
+}
+
+void
+os_unwatch_file(char const *path, File_Changed_Callback *callback) {
+  check_(path);
+
+  s64 const mark = get_temp_mem_mark();
+
+  String const normalized = tprint("%s", path);
+  impl::normalize_watched_path(normalized);
+
+  for (s32 i = 0; i < gFile_Watcher.subscription_count;) {
+    File_Subscription &sub = gFile_Watcher.subscriptions[i];
+
+    bool const is_match = sub.callback == callback &&
+                          sub.path.count == normalized.count &&
+                          mem_comp_(sub.path.data, normalized.data, normalized.count) == 0;
+    if (!is_match) {
+      i++;
+      continue;
+    }
+
+    free_perm(sub.path.data);
+    sub = gFile_Watcher.subscriptions[--gFile_Watcher.subscription_count];
+  }
+
+  pop_temp_mem_mark(get_temp_mem_mark() - mark);
+}
+
+void
+os_poll_file_watcher() {
+  for (s32 i = 0; i < gFile_Watcher.dir_count; i++) {
+    File_Watch_Dir &watch = gFile_Watcher.dirs[i];
+    if (watch.dir == NULL) {
+      continue;
+    }
+
+    ::DWORD bytes = 0;
+    if (!::GetOverlappedResult(watch.dir, &watch.overlapped, &bytes, FALSE)) {
+      if (::GetLastError() == ERROR_IO_INCOMPLETE) {
+        continue;
+      }
+      // @Note: treat it as an overflow -- we may have missed something.
+      bytes = 0;
+    }
+
+    impl::process_notifications(watch, bytes);
+
+    // @Note: the other directories may have reads in flight, so we can't move them
+    //        around -- just mark this one as dead.
+    if (!impl::begin_watching_dir(watch)) {
+      logf("File watcher: stopped watching '%.*s'.\n",
+           (int)watch.path.count, watch.path.data);
+      ::CloseHandle(watch.dir);
+      watch.dir = NULL;
+    }
+  }
+
+  f32 const now = os_get_app_uptime();
+
+  // @Note: the paths of the snapshot and whatever the callbacks put in temp memory
+  //        are freed once they are done.
+  s64 const mark = get_temp_mem_mark();
+
+  // @Note: a callback may (un)watch files, so we run them from a snapshot.
+  File_Subscription ready[FILE_WATCHER_MAX_SUBSCRIPTIONS];
+  s32               ready_count = 0;
+
+  for (s32 i = 0; i < gFile_Watcher.subscription_count; i++) {
+    File_Subscription &sub = gFile_Watcher.subscriptions[i];
+
+    if (sub.is_pending && now - sub.changed_at >= FILE_WATCHER_DEBOUNCE) {
+      sub.is_pending = false;
+
+      ready[ready_count]      = sub;
+      ready[ready_count].path = tprint("%.*s", (int)sub.path.count, sub.path.data);
+      ready_count++;
+    }
+  }
+
+  for (s32 i = 0; i < ready_count; i++) {
+    ready[i].callback(ready[i].path, ready[i].user_data);
+  }
+
+  pop_temp_mem_mark(get_temp_mem_mark() - mark);
+}
+} // namespace rt
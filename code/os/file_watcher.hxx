@@ -0,0 +1,34 @@
+/**
+ * Hot reload. Subsystems subscribe to the files they were loaded from and get a
+ * callback when one of them changes on disk, so only the affected resources have to
+ * be reloaded instead of restarting the app.
+ *
+ * The data and assets directories of the path cache are watched recursively. Editors
+ * often save a file in several steps (truncate, write, rename), so a change is
+ * reported once the file has been quiet for FILE_WATCHER_DEBOUNCE seconds.
+ *
+ * @Note: single-threaded. Callbacks are run from os_poll_file_watcher.
+*/
+
+namespace rt {
+using File_Changed_Callback = void(String path, void *user_data);
+
+void
+os_init_file_watcher();
+
+void
+os_shutdown_file_watcher();
+
+// `path` must be inside one of the watched directories. The same file can have many
+// subscribers.
+void
+os_watch_file(char const *path, File_Changed_Callback *callback, void *user_data = NULL);
+
+void
+os_unwatch_file(char const *path, File_Changed_Callback *callback);
+
+// Call once per frame. Runs the callbacks of files that changed and settled down. The
+// `path` they get, and anything they allocate in temp memory, is freed after they return.
+void
+os_poll_file_watcher();
+} // namespace rt
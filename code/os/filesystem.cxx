@@ -1,27 +1,46 @@
 namespace rt {
-[[nodiscard]] Buffer
-os_read_entire_file_or_panic(char const *path) {
-  // @Note: we don't care about leaking resources on error, because system will
-  //        close all handles for us.
+[[nodiscard]] bool
+os_map_file(char const *path, Mapped_File &file, Mapped_File_Hint hint) {
   check_(path);
 
+  file = {};
+
+  ::DWORD const flags = (hint == MappedFileHint_Sequential) 
+                      ? FILE_FLAG_SEQUENTIAL_SCAN 
+                      : FILE_ATTRIBUTE_NORMAL;
+
   // @Unicode: handle UTF-8 paths
-  ::HANDLE file = ::CreateFileA(
+  ::HANDLE handle = ::CreateFileA(
                       (LPCSTR)path, 
                       GENERIC_READ, 
-                      NULL,
+                      FILE_SHARE_READ,
                       0,
                       OPEN_EXISTING,
-                      FILE_ATTRIBUTE_NORMAL,
+                      flags,
                       NULL
                       );
 
-  if (file == INVALID_HANDLE_VALUE) {
-    errf("Failed to open file for reading '%s'.", path);
+  if (handle == INVALID_HANDLE_VALUE) {
+    logf("Failed to open file for reading '%s'.\n", path);
+    return false;
+  }
+  file.file = handle;
+
+  ::LARGE_INTEGER file_sz_raw;
+  if (!::GetFileSizeEx(handle, &file_sz_raw)) {
+    logf("Failed to get the size of file '%s'.\n", path);
+    os_unmap_file(file);
+    return false;
+  }
+  file.content.count = file_sz_raw.QuadPart;
+
+  // @Note: empty files can't be mapped. We return an empty view instead.
+  if (file.content.count == 0) {
+    return true;
   }
 
   ::HANDLE mapping = ::CreateFileMappingA(
-                        file,
+                        handle,
                         NULL,
                         PAGE_READONLY,
                         0,
@@ -29,9 +48,12 @@ os_read_entire_file_or_panic(char const *path) {
                         NULL
                         );
 
-  if (mapping == INVALID_HANDLE_VALUE) {
-    errf("Failed to create mapping of file '%s'", path);
+  if (mapping == NULL) {
+    logf("Failed to create mapping of file '%s'.\n", path);
+    os_unmap_file(file);
+    return false;
   }
+  file.mapping = mapping;
 
   void *view = ::MapViewOfFile(
                   mapping, 
@@ -42,23 +64,113 @@ os_read_entire_file_or_panic(char const *path) {
                   );
                   
   if (view == NULL) {
-    errf("Failed to map file '%s'", path);
+    logf("Failed to map file '%s'.\n", path);
+    os_unmap_file(file);
+    return false;
+  }
+  file.content.bytes = (u8*)view;
+
+  if (hint == MappedFileHint_Will_Need) {
+    os_prefetch_mapped_range(file, 0, file.content.count);
   }
-	
-  ::LARGE_INTEGER file_sz_raw;
-	::GetFileSizeEx(file, &file_sz_raw);
-	s64 const file_sz = file_sz_raw.QuadPart;
 
-	void *file_mem = alloc_temp(file_sz);
-	::memcpy(file_mem, view, (u64)file_sz);
+  return true;
+}
 
-  ::UnmapViewOfFile(view);
-  ::CloseHandle(mapping);
-  ::CloseHandle(file);
+[[nodiscard]] Mapped_File
+os_map_file_or_panic(char const *path, Mapped_File_Hint hint) {
+  Mapped_File result;
+  if (!os_map_file(path, result, hint)) {
+    errf("Failed to map file '%s' (details in the log).", path);
+  }
+  return result;
+}
+
+void
+os_prefetch_mapped_range(Mapped_File const &file, s64 offset, s64 size) {
+  dbg_check_(offset >= 0 && size >= 0);
+  dbg_check_(offset + size <= file.content.count);
+
+  if (size == 0 || file.content.bytes == NULL) {
+    return;
+  }
+
+  ::WIN32_MEMORY_RANGE_ENTRY range = {
+    .VirtualAddress = file.content.bytes + offset,
+    .NumberOfBytes  = (::SIZE_T)size
+  };
 
-	return {.count = file_sz, .bytes = (u8*)file_mem};
+  // @Note: this is only a hint. If it fails, the pages will be faulted in on access.
+  if (!::PrefetchVirtualMemory(::GetCurrentProcess(), 1, &range, 0)) {
+    logf("PrefetchVirtualMemory failed for a %lld byte range.\n", size);
+  }
 }
 
+void
+os_unmap_file(Mapped_File &file) {
+  if (file.content.bytes) {
+    ::UnmapViewOfFile(file.content.bytes);
+  }
+
+  if (file.mapping) {
+    ::CloseHandle((::HANDLE)file.mapping);
+  }
+
+  if (file.file) {
+    ::CloseHandle((::HANDLE)file.file);
+  }
+
+  file = {};
+}
+
+[[nodiscard]] Buffer
+os_read_entire_file_or_panic(char const *path) {
+  Mapped_File file = os_map_file_or_panic(path, MappedFileHint_Sequential);
+
+  s64 const file_sz  = file.content.count;
+  void     *file_mem = NULL;
+
+  if (file_sz > 0) {
+    file_mem = alloc_temp(file_sz);
+    ::memcpy(file_mem, file.content.bytes, (u64)file_sz);
+  }
+
+  os_unmap_file(file);
+
+  return {.count = file_sz, .bytes = (u8*)file_mem};
+}
+
+namespace impl {
+// @Note: WriteFile takes a DWORD, so larger buffers are written in chunks.
+void
+write_all_or_panic(::HANDLE file, u8 const *bytes, s64 count, char const *path) {
+  s64 constexpr static MAX_CHUNK = RT_MEGABYTES(1024);
+
+  for (s64 offset = 0; offset < count;) {
+    s64 const     remaining      = count - offset;
+    ::DWORD const bytes_to_write = (::DWORD)(remaining < MAX_CHUNK ? remaining : MAX_CHUNK);
+    ::DWORD       bytes_written  = 0;
+    ::BOOL  const success        = ::WriteFile(
+                                      file, 
+                                      bytes + offset, 
+                                      bytes_to_write, 
+                                      &bytes_written, 
+                                      NULL
+                                      );
+
+    if (!success) {
+      errf("Failed to write to file '%s'", path);
+    }
+
+    if (bytes_written != bytes_to_write) {
+      errf("Partial write to '%s' (%lld/%lld)", path, offset + bytes_written, count);
+    }
+
+    offset += bytes_written;
+  }
+}
+} // namespace impl
+
 void
 os_write_entire_file_or_panic(Buffer content, char const *path) {
   check_(path);
@@ -80,23 +192,7 @@ os_write_entire_file_or_panic(Buffer content, char const *path) {
     errf("Failed to open file for writing: '%s'", path);
   }
   
-  ::DWORD const bytes_to_write = (::DWORD)content.count;
-  ::DWORD       bytes_written = 0;
-  ::BOOL  const success = ::WriteFile(
-                             file, 
-                             content.bytes, 
-                             bytes_to_write, 
-                             &bytes_written, 
-                             NULL
-                             );
-
-  if (!success) {
-    errf("Failed to write to file '%s'", path);
-  }
-
-  if (bytes_written != bytes_to_write) {
-    errf("Partial write to '%s' (%zu/%zu)", path, bytes_written, bytes_to_write);
-  }
+  impl::write_all_or_panic(file, content.bytes, content.count, path);
   
   ::CloseHandle(file);
 }
@@ -113,7 +209,7 @@ os_append_to_file_or_panic(Buffer content, char const *path) {
                       FILE_APPEND_DATA, // @Note: the only part that is different from write_entire_file 
                       FILE_SHARE_READ,
                       0,
-                      CREATE_ALWAYS,
+                      OPEN_ALWAYS,      // @Note: CREATE_ALWAYS would truncate the file.
                       FILE_ATTRIBUTE_NORMAL,
                       NULL
                       );
@@ -122,25 +218,228 @@ os_append_to_file_or_panic(Buffer content, char const *path) {
     errf("Failed to open file for appending: '%s'", path);
   }
   
-  ::DWORD const bytes_to_write = (::DWORD)content.count;
-  ::DWORD       bytes_written = 0;
-  ::BOOL  const success = ::WriteFile(
-                             file, 
-                             content.bytes, 
-                             bytes_to_write, 
-                             &bytes_written, 
-                             NULL
-                             );
+  impl::write_all_or_panic(file, content.bytes, content.count, path);
+  
+  ::CloseHandle(file);
+}
 
-  if (!success) {
-    errf("Failed to append to file '%s'", path);
+[[nodiscard]] File_Writer
+os_open_file_writer_or_panic(char const *path, File_Writer_Mode mode, s64 buffer_size) {
+  check_(path);
+  check_(buffer_size > 0);
+
+  bool const is_direct = (mode == FileWriterMode_Direct);
+
+  // @Note: unbuffered I/O needs sector-aligned sizes and addresses. VirtualAlloc gives
+  //        us page-aligned memory, so we only have to round the size.
+  if (is_direct) {
+    s64 constexpr static ALIGN = FILE_WRITER_DIRECT_ALIGNMENT;
+    buffer_size = (buffer_size + ALIGN - 1)/ALIGN*ALIGN;
   }
 
-  if (bytes_written != bytes_to_write) {
-    errf("Partial write (append) to '%s' (%zu/%zu)", path, bytes_written, bytes_to_write);
+  ::DWORD const flags = is_direct
+                      ? FILE_FLAG_NO_BUFFERING | FILE_FLAG_SEQUENTIAL_SCAN
+                      : FILE_ATTRIBUTE_NORMAL  | FILE_FLAG_SEQUENTIAL_SCAN;
+
+  // @Unicode: handle UTF-8 paths
+  ::HANDLE file = ::CreateFileA(
+                      (LPCSTR)path, 
+                      GENERIC_WRITE, 
+                      FILE_SHARE_READ,
+                      0,
+                      CREATE_ALWAYS,
+                      flags,
+                      NULL
+                      );
+
+  if (file == INVALID_HANDLE_VALUE) {
+    errf("Failed to open file for writing: '%s'", path);
   }
-  
-  ::CloseHandle(file);
+
+  void *buffer = ::VirtualAlloc(NULL, (::SIZE_T)buffer_size, MEM_RESERVE | MEM_COMMIT, 
+                                PAGE_READWRITE);
+  if (!buffer) {
+    errf("Failed to allocate a %lld byte buffer for writing '%s'", buffer_size, path);
+  }
+
+  return {
+    .path     = path,
+    .file     = file,
+    .buffer   = {.count = buffer_size, .bytes = (u8*)buffer},
+    .buffered = 0,
+    .written  = 0,
+    .mode     = mode
+  };
+}
+
+void
+os_file_writer_write_or_panic(File_Writer &writer, Buffer content) {
+  check_(writer.file);
+  check_(content.count >= 0);
+  check_(content.count == 0 || content.bytes != NULL);
+
+  u8 const *src       = content.bytes;
+  s64       remaining = content.count;
+
+  while (remaining > 0) {
+    // Large writes skip the copy if there's nothing buffered in front of them.
+    if (writer.buffered == 0 && remaining >= writer.buffer.count && 
+        writer.mode == FileWriterMode_Buffered) {
+      impl::write_all_or_panic((::HANDLE)writer.file, src, remaining, writer.path);
+      writer.written += remaining;
+      return;
+    }
+
+    s64 const space = writer.buffer.count - writer.buffered;
+    s64 const count = remaining < space ? remaining : space;
+
+    mem_copy_(writer.buffer.bytes + writer.buffered, src, (u64)count);
+    writer.buffered += count;
+    src             += count;
+    remaining       -= count;
+
+    if (writer.buffered == writer.buffer.count) {
+      os_file_writer_flush_or_panic(writer);
+    }
+  }
+}
+
+void
+os_file_writer_flush_or_panic(File_Writer &writer) {
+  check_(writer.file);
+
+  s64 flushed = writer.buffered;
+
+  // In the direct mode only whole sectors can be written. The tail waits for more data
+  // or for os_close_file_writer_or_panic.
+  if (writer.mode == FileWriterMode_Direct) {
+    flushed -= flushed % FILE_WRITER_DIRECT_ALIGNMENT;
+  }
+
+  if (flushed == 0) {
+    return;
+  }
+
+  impl::write_all_or_panic((::HANDLE)writer.file, writer.buffer.bytes, flushed, writer.path);
+
+  s64 const tail = writer.buffered - flushed;
+  if (tail > 0) {
+    ::memmove(writer.buffer.bytes, writer.buffer.bytes + flushed, (u64)tail);
+  }
+
+  writer.written  += flushed;
+  writer.buffered  = tail;
+}
+
+void
+os_close_file_writer_or_panic(File_Writer &writer) {
+  check_(writer.file);
+
+  os_file_writer_flush_or_panic(writer);
+
+  // Pad the last sector with zeros, write it and cut the file back to its real size.
+  if (writer.buffered > 0) {
+    s64 constexpr static ALIGN = FILE_WRITER_DIRECT_ALIGNMENT;
+    dbg_check_(writer.mode == FileWriterMode_Direct);
+
+    s64 const real_size   = writer.written + writer.buffered;
+    s64 const padded_tail = (writer.buffered + ALIGN - 1)/ALIGN*ALIGN;
+
+    ::memset(writer.buffer.bytes + writer.buffered, 0, (u64)(padded_tail - writer.buffered));
+    impl::write_all_or_panic((::HANDLE)writer.file, writer.buffer.bytes, padded_tail, 
+                             writer.path);
+
+    ::FILE_END_OF_FILE_INFO eof_info;
+    eof_info.EndOfFile.QuadPart = real_size;
+
+    if (!::SetFileInformationByHandle((::HANDLE)writer.file, ::FileEndOfFileInfo, 
+                                      &eof_info, sizeof(eof_info))) {
+      errf("Failed to set the size of '%s' to %lld", writer.path, real_size);
+    }
+
+    writer.written  = real_size;
+    writer.buffered = 0;
+  }
+
+  ::CloseHandle((::HANDLE)writer.file);
+  ::VirtualFree(writer.buffer.bytes, 0, MEM_RELEASE);
+
+  writer.file   = NULL;
+  writer.buffer = {};
+}
+
+void
+os_file_writer_sink(Buffer chunk, void *user_data) {
+  os_file_writer_write_or_panic(*(File_Writer*)user_data, chunk);
+}
+
+void
+os_write_compressed_file_or_panic(Buffer content, char const *path) {
+  check_(path);
+  check_(content.count >= 0);
+
+  File_Writer writer     = os_open_file_writer_or_panic(path);
+  Compressor  compressor = compressor_begin(os_file_writer_sink, &writer);
+
+  compressor_write(compressor, content);
+  compressor_end(compressor);
+
+  os_close_file_writer_or_panic(writer);
+}
+
+namespace impl {
+struct Decompress_Pass {
+  Compressed_Block const *blocks;
+  Buffer                  raw;
+  s64 volatile            corrupted;
+};
+
+void
+decompress_blocks_job(void *data, s64 begin, s64 end) {
+  Decompress_Pass &pass = *(Decompress_Pass*)data;
+
+  for (s64 i = begin; i < end; i++) {
+    if (!decompress_stream_block(pass.blocks[i], pass.raw)) {
+      atomic_store(pass.corrupted, 1);
+    }
+  }
+}
+} // namespace impl
+
+[[nodiscard]] Buffer
+os_read_compressed_file_or_panic(char const *path) {
+  Mapped_File file = os_map_file_or_panic(path, MappedFileHint_Sequential);
+
+  s64       raw_size    = 0;
+  s64 const block_count = compressed_stream_index(file.content, NULL, 0, raw_size);
+  if (block_count < 0) {
+    errf("File '%s' is not a valid compressed stream", path);
+  }
+
+  Buffer raw = {.count = raw_size, .bytes = NULL};
+  if (raw_size > 0) {
+    raw.bytes = (u8*)alloc_perm(raw_size);
+  }
+
+  // @Note: blocks don't reference each other, so each job decodes its own blocks
+  //        straight into their place in `raw`.
+  s64 const mark = get_temp_mem_mark();
+
+  s64 const               blocks_size = (block_count > 0 ? block_count : 1)*(s64)sizeof(Compressed_Block);
+  Compressed_Block *const blocks      = (Compressed_Block*)alloc_temp(blocks_size);
+  (void)compressed_stream_index(file.content, blocks, block_count, raw_size);
+
+  impl::Decompress_Pass pass = {.blocks = blocks, .raw = raw, .corrupted = 0};
+  parallel_for(block_count, 1, impl::decompress_blocks_job, &pass);
+
+  pop_temp_mem_mark(get_temp_mem_mark() - mark);
+
+  if (atomic_load(pass.corrupted)) {
+    errf("File '%s' is corrupted", path);
+  }
+
+  os_unmap_file(file);
+  return raw;
 }
 
 void
@@ -155,6 +454,71 @@ os_move_file_or_panic(char const *src, char const *dst) {
   }
 }
 
+void
+os_create_directory_or_panic(char const *path) {
+  check_(path);
+
+  // @Unicode: handle UTF-8 paths
+  if (!::CreateDirectoryA(path, NULL) && ::GetLastError() != ERROR_ALREADY_EXISTS) {
+    errf("Failed to create directory '%s'", path);
+  }
+}
+
+[[nodiscard]] bool
+os_file_exists(char const *path) {
+  check_(path);
+
+  // @Unicode: handle UTF-8 paths
+  ::DWORD const attributes = ::GetFileAttributesA(path);
+  return attributes != INVALID_FILE_ATTRIBUTES && !(attributes & FILE_ATTRIBUTE_DIRECTORY);
+}
+
+namespace impl {
+void
+visit_files_recursively_or_panic(String dir, String relative_dir, 
+                                 File_Visitor *visitor, void *user_data) {
+  String const pattern = tprint("%.*s\\*", (int)dir.count, dir.data);
+
+  // @Unicode
+  ::WIN32_FIND_DATAA find_data;
+  ::HANDLE find = ::FindFirstFileA(as_cstr(pattern), &find_data);
+
+  if (find == INVALID_HANDLE_VALUE) {
+    errf("Failed to list the directory '%.*s'", (int)dir.count, dir.data);
+  }
+
+  do {
+    char const *name = find_data.cFileName;
+    if (::strcmp(name, ".") == 0 || ::strcmp(name, "..") == 0) {
+      continue;
+    }
+
+    String const path     = tprint("%.*s\\%s", (int)dir.count, dir.data, name);
+    String const relative = (relative_dir.count > 0)
+                          ? tprint("%.*s/%s", (int)relative_dir.count, relative_dir.data, name)
+                          : tprint("%s", name);
+
+    if (find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+      visit_files_recursively_or_panic(path, relative, visitor, user_data);
+    } else {
+      s64 const size = (s64)(((u64)find_data.nFileSizeHigh << 32) | find_data.nFileSizeLow);
+      visitor(path, relative, size, user_data);
+    }
+  } while (::FindNextFileA(find, &find_data));
+
+  ::FindClose(find);
+}
+} // namespace impl
+
+void
+os_visit_files_or_panic(char const *dir, File_Visitor *visitor, void *user_data) {
+  check_(dir);
+  check_(visitor);
+
+  String const root = {.count = (s64)::strlen(dir), .data = (char*)dir};
+  impl::visit_files_recursively_or_panic(root, String{}, visitor, user_data);
+}
+
 // @Note: we assume/ensure that the paths are *not* ended with \ or /.
 struct Path_Cache {
   String cwd;
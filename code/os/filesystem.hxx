@@ -2,6 +2,38 @@
  * File I/O
 */
 namespace rt {
+enum Mapped_File_Hint {
+  MappedFileHint_None = 0,
+  MappedFileHint_Sequential, // The file will be read front to back.
+  MappedFileHint_Will_Need   // Prefetch the whole file into the page cache right away.
+};
+
+// Read-only view of a file. `content` points directly into the mapping (no copy!) and
+// stays valid until os_unmap_file is called.
+struct Mapped_File {
+  Buffer content;
+
+  void *file;    // ::HANDLE
+  void *mapping; // ::HANDLE, NULL for empty files.
+};
+
+// Returns false (and logs why) if the file can't be opened or mapped, for files that
+// may be missing or locked, like ones being saved while they are hot reloaded.
+[[nodiscard]] bool
+os_map_file(char const *path, Mapped_File &file, Mapped_File_Hint hint = MappedFileHint_None);
+
+[[nodiscard]] Mapped_File
+os_map_file_or_panic(char const *path, Mapped_File_Hint hint = MappedFileHint_None);
+
+// Asks the OS to bring the given range into memory in the background. Call it ahead of
+// parsing a large file in chunks.
+void
+os_prefetch_mapped_range(Mapped_File const &file, s64 offset, s64 size);
+
+void
+os_unmap_file(Mapped_File &file);
+
+// Copies the file into temp memory. Prefer os_map_file_or_panic for large files.
 [[nodiscard]] Buffer
 os_read_entire_file_or_panic(char const *path);
 
@@ -11,9 +43,72 @@ os_write_entire_file_or_panic(Buffer content, char const *path);
 void
 os_append_to_file_or_panic(Buffer content, char const *path);
 
+enum File_Writer_Mode {
+  FileWriterMode_Buffered = 0, // Goes through the OS file cache.
+  FileWriterMode_Direct        // Bypasses the OS file cache. Only whole sectors are 
+                               // written until the writer is closed.
+};
+
+// Streams data to a file through a large write-behind buffer, so big outputs (frame
+// sequences, traces, baked caches) don't have to be kept in memory as a whole.
+struct File_Writer {
+  char const *path;   // Only for error messages, must outlive the writer.
+  void       *file;   // ::HANDLE
+  Buffer      buffer;
+  s64         buffered; // Bytes waiting in the buffer.
+  s64         written;  // Bytes already handed to the OS.
+
+  File_Writer_Mode mode;
+};
+
+// Creates (or truncates) the file at `path`.
+[[nodiscard]] File_Writer
+os_open_file_writer_or_panic(char const      *path, 
+                             File_Writer_Mode mode        = FileWriterMode_Buffered,
+                             s64              buffer_size = FILE_WRITER_BUFFER_SIZE);
+
+void
+os_file_writer_write_or_panic(File_Writer &writer, Buffer content);
+
+// Hands the buffered data to the OS. In the direct mode a partial sector stays buffered.
+void
+os_file_writer_flush_or_panic(File_Writer &writer);
+
+void
+os_close_file_writer_or_panic(File_Writer &writer);
+
+// Compression_Sink that writes to a File_Writer (passed as `user_data`), so large
+// outputs can be compressed while they are streamed out.
+void
+os_file_writer_sink(Buffer chunk, void *user_data);
+
+// Writes `content` as a compressed stream (see base/compression.hxx).
+void
+os_write_compressed_file_or_panic(Buffer content, char const *path);
+
+// Reads and decompresses a file written by os_write_compressed_file_or_panic. The
+// result is in permanent memory (free it with free_perm).
+[[nodiscard]] Buffer
+os_read_compressed_file_or_panic(char const *path);
+
 void
 os_move_file_or_panic(char const *src, char const *dst);
 
+// Succeeds if the directory already exists. Its parent has to exist.
+void
+os_create_directory_or_panic(char const *path);
+
+[[nodiscard]] bool
+os_file_exists(char const *path);
+
+// `path` is the full path, `relative_path` is relative to the visited directory and
+// always uses '/' as the separator. Both are allocated in temp memory.
+using File_Visitor = void(String path, String relative_path, s64 size, void *user_data);
+
+// Calls `visitor` for every file in `dir` and its subdirectories.
+void
+os_visit_files_or_panic(char const *dir, File_Visitor *visitor, void *user_data);
+
 // Set up the path cache used by pathf
 void
 os_init_filesystem();
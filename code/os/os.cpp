@@ -6,4 +6,8 @@
 #include "filesystem.cxx"
 #include "debugger.cxx"
 #include "error_handling.cxx"
-#include "time.cxx"
\ No newline at end of file
+#include "time.cxx"
+#include "cpu_info.cxx"
+#include "async_io.cxx"
+#include "file_watcher.cxx"
+#include "thread.cxx"
\ No newline at end of file
@@ -2,4 +2,8 @@
 #include "error_handling.hxx"
 #include "time.hxx"
 #include "filesystem.hxx"
+#include "cpu_info.hxx"
+#include "async_io.hxx"
+#include "file_watcher.hxx"
+#include "thread.hxx"
 
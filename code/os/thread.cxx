@@ -0,0 +1,80 @@
+namespace rt {
+namespace impl {
+struct Thread_Start {
+  Thread_Proc *proc;
+  void        *data;
+};
+
+::DWORD WINAPI
+win32_thread_proc(void *param) {
+  Thread_Start const start = *(Thread_Start*)param;
+  free_perm(param);
+
+  start.proc(start.data);
+  return 0;
+}
+} // namespace impl
+
+[[nodiscard]] Thread
+os_create_thread_or_panic(Thread_Proc *proc, void *data, char const *name) {
+  dbg_check_(proc);
+
+  // @Note: the new thread frees this, so it may outlive the caller's stack frame.
+  impl::Thread_Start *start = (impl::Thread_Start*)alloc_perm(sizeof(impl::Thread_Start));
+  *start = {.proc = proc, .data = data};
+
+  ::HANDLE const handle = ::CreateThread(NULL, 0, impl::win32_thread_proc, start, 0, NULL);
+  if (!handle) {
+    errf("Failed to create thread '%s'", name);
+  }
+
+  wchar_t wide_name[64];
+  if (::MultiByteToWideChar(CP_UTF8, 0, name, -1, wide_name, 64) > 0) {
+    // @Note: only for debuggers and profilers, so a failure doesn't matter.
+    (void)::SetThreadDescription(handle, wide_name);
+  }
+
+  return {.handle = handle};
+}
+
+void
+os_join_thread(Thread &thread) {
+  ::WaitForSingleObject(thread.handle, INFINITE);
+  ::CloseHandle(thread.handle);
+  thread = {};
+}
+
+void
+os_yield_thread() {
+  ::SwitchToThread();
+}
+
+[[nodiscard]] Semaphore
+os_create_semaphore_or_panic(s32 initial_count) {
+  ::HANDLE const handle = ::CreateSemaphoreA(NULL, initial_count, LONG_MAX, NULL);
+  if (!handle) {
+    errf("Failed to create a semaphore");
+  }
+
+  return {.handle = handle};
+}
+
+void
+os_destroy_semaphore(Semaphore &semaphore) {
+  ::CloseHandle(semaphore.handle);
+  semaphore = {};
+}
+
+void
+os_signal_semaphore(Semaphore &semaphore, s32 count) {
+  dbg_check_(count > 0);
+
+  ::BOOL const success = ::ReleaseSemaphore(semaphore.handle, count, NULL);
+  check_(success);
+}
+
+void
+os_wait_semaphore(Semaphore &semaphore) {
+  ::WaitForSingleObject(semaphore.handle, INFINITE);
+}
+} // namespace rt
@@ -0,0 +1,41 @@
+/**
+ * Threads and the one synchronization primitive the job system needs to put idle
+ * workers to sleep. Everything else (atomics, spinning) lives in base/atomics.hxx.
+*/
+
+namespace rt {
+using Thread_Proc = void(void *data);
+
+struct Thread {
+  void *handle;
+};
+
+struct Semaphore {
+  void *handle;
+};
+
+// `name` shows up in the debugger.
+[[nodiscard]] Thread
+os_create_thread_or_panic(Thread_Proc *proc, void *data, char const *name);
+
+// Blocks until the thread returns from its proc.
+void
+os_join_thread(Thread &thread);
+
+// Gives the rest of the time slice to another thread, if one is ready to run.
+void
+os_yield_thread();
+
+[[nodiscard]] Semaphore
+os_create_semaphore_or_panic(s32 initial_count);
+
+void
+os_destroy_semaphore(Semaphore &semaphore);
+
+// Wakes up to `count` waiting threads.
+void
+os_signal_semaphore(Semaphore &semaphore, s32 count);
+
+void
+os_wait_semaphore(Semaphore &semaphore);
+} // namespace rt
@@ -32,6 +32,15 @@ os_get_app_uptime() {
 	return (f32)dt/gWin32_Timer.frequency;
 }
 
+[[nodiscard]] f64
+os_get_app_uptime_precise() {
+  ::LARGE_INTEGER alignas(8) now;
+  ::QueryPerformanceCounter(&now);
+
+  u64 const dt = (u64)(now.QuadPart - gWin32_Timer.start.QuadPart);
+  return (f64)dt/(f64)gWin32_Timer.frequency;
+}
+
 // hh:mm:ss, count=const=8.
 [[nodiscard]] String
 os_get_app_uptime_as_string() {
@@ -13,6 +13,10 @@ os_start_app_timer();
 [[nodiscard]] f32
 os_get_app_uptime();
 
+// Full timer resolution, for timing short intervals (benchmarks).
+[[nodiscard]] f64
+os_get_app_uptime_precise();
+
 // hh:mm:ss, count=const=8.
 [[nodiscard]] String
 os_get_app_uptime_as_string();
@@ -0,0 +1,598 @@
+namespace rt {
+namespace impl {
+struct Bvh_Builder {
+  AABB const *bounds;    // Per primitive.
+  Vec3       *centroids; // Per primitive.
+  u32        *indices;   // Partitioned in place, ends up as Bvh::primitives.
+
+  Bvh_Node *nodes;
+  s32       node_count;
+  s32       leaf_count;
+  s32       max_depth;
+};
+
+struct Bvh_Bin {
+  AABB bounds;
+  s32  count;
+};
+
+struct Bvh_Split {
+  s32 axis;
+  s32 bin;  // First bin of the right side.
+  f32 cost; // FLT_MAX if there is no split.
+};
+
+[[nodiscard]] s32
+bvh_bin_index(f32 centroid, f32 axis_min, f32 scale) {
+  s32 const bin = (s32)((centroid - axis_min)*scale);
+  return (bin < BVH_BIN_COUNT - 1) ? bin : BVH_BIN_COUNT - 1;
+}
+
+[[nodiscard]] Vec3
+bvh_bin_scale(AABB const &centroid_bounds) {
+  Vec3 const size = extent(centroid_bounds);
+  Vec3 scale;
+  for (s32 axis = 0; axis < 3; axis++) {
+    scale.v[axis] = (size.v[axis] > 0) ? BVH_BIN_COUNT/size.v[axis] : 0;
+  }
+  return scale;
+}
+
+void
+clear_bvh_bins(Bvh_Bin (&bins)[3][BVH_BIN_COUNT]) {
+  for (s32 axis = 0; axis < 3; axis++) {
+    for (s32 i = 0; i < BVH_BIN_COUNT; i++) {
+      bins[axis][i] = {.bounds = aabb_empty(), .count = 0};
+    }
+  }
+}
+
+// Adds the primitives in [begin, end) to the bins of all three axes, in one pass so
+// they are only read once.
+void
+fill_bvh_bins(Bvh_Builder const &builder, s32 begin, s32 end, AABB const &centroid_bounds,
+              Bvh_Bin (&bins)[3][BVH_BIN_COUNT]) {
+  Vec3 const scale = bvh_bin_scale(centroid_bounds);
+  for (s32 i = begin; i < end; i++) {
+    u32  const primitive = builder.indices[i];
+    Vec3 const centroid  = builder.centroids[primitive];
+    for (s32 axis = 0; axis < 3; axis++) {
+      Bvh_Bin &bin = bins[axis][bvh_bin_index(centroid.v[axis], centroid_bounds.min.v[axis],
+                                              scale.v[axis])];
+      bin.bounds = aabb_union(bin.bounds, builder.bounds[primitive]);
+      bin.count++;
+    }
+  }
+}
+
+// Cost of the best split between two bins, relative to intersecting a primitive and
+// without the traversal step, in units of the node's surface area.
+[[nodiscard]] Bvh_Split
+choose_bvh_split(Bvh_Bin const (&bins)[3][BVH_BIN_COUNT], AABB const &centroid_bounds,
+                 s32 count) {
+  Vec3 const size = extent(centroid_bounds);
+
+  Bvh_Split best = {.axis = 0, .bin = 0, .cost = FLT_MAX};
+  for (s32 axis = 0; axis < 3; axis++) {
+    if (size.v[axis] <= 0) {
+      continue;
+    }
+
+    // Sweep from the right, then from the left, to get both sides of every split.
+    f32 right_cost[BVH_BIN_COUNT];
+    AABB right_bounds = aabb_empty();
+    s32  right_count  = 0;
+    for (s32 i = BVH_BIN_COUNT - 1; i > 0; i--) {
+      right_bounds  = aabb_union(right_bounds, bins[axis][i].bounds);
+      right_count  += bins[axis][i].count;
+      right_cost[i] = surface_area(right_bounds)*right_count;
+    }
+
+    AABB left_bounds = aabb_empty();
+    s32  left_count  = 0;
+    for (s32 i = 1; i < BVH_BIN_COUNT; i++) {
+      left_bounds  = aabb_union(left_bounds, bins[axis][i - 1].bounds);
+      left_count  += bins[axis][i - 1].count;
+
+      f32 const cost = surface_area(left_bounds)*left_count + right_cost[i];
+      if (left_count > 0 && left_count < count && cost < best.cost) {
+        best = {.axis = axis, .bin = i, .cost = cost};
+      }
+    }
+  }
+
+  return best;
+}
+
+// Returns the first index of the right side.
+[[nodiscard]] s32
+partition_bvh_primitives(Bvh_Builder &builder, s32 begin, s32 end, Bvh_Split const &split,
+                         AABB const &centroid_bounds) {
+  // @Note: no split means every centroid is in the same spot (or the tree is too deep)
+  //        and any split is as good as another, so the primitives are cut in half.
+  if (split.cost == FLT_MAX) {
+    return begin + (end - begin)/2;
+  }
+
+  s32 const axis  = split.axis;
+  f32 const scale = bvh_bin_scale(centroid_bounds).v[axis];
+  f32 const min   = centroid_bounds.min.v[axis];
+
+  s32 left  = begin;
+  s32 right = end - 1;
+  while (left <= right) {
+    f32 const centroid = builder.centroids[builder.indices[left]].v[axis];
+    if (bvh_bin_index(centroid, min, scale) < split.bin) {
+      left++;
+    } else {
+      u32 const tmp          = builder.indices[left];
+      builder.indices[left]  = builder.indices[right];
+      builder.indices[right] = tmp;
+      right--;
+    }
+  }
+  return left;
+}
+
+[[nodiscard]] bool
+is_bvh_leaf_cheaper(s32 count, s32 depth, AABB const &bounds, Bvh_Split const &split) {
+  f32  const area       = surface_area(bounds);
+  f32  const split_cost = (area > 0) ? BVH_TRAVERSAL_COST + split.cost/area : FLT_MAX;
+  bool const can_leaf   = count <= BVH_MAX_LEAF_SIZE || depth >= BVH_MAX_DEPTH - 1;
+  return count == 1 || (can_leaf && (f32)count <= split_cost);
+}
+
+[[nodiscard]] s32
+build_bvh_node(Bvh_Builder &builder, s32 begin, s32 end, s32 depth) {
+  s32 const node_index = builder.node_count++;
+  s32 const count      = end - begin;
+
+  AABB bounds          = aabb_empty();
+  AABB centroid_bounds = aabb_empty();
+  for (s32 i = begin; i < end; i++) {
+    u32 const primitive = builder.indices[i];
+    bounds          = aabb_union(bounds, builder.bounds[primitive]);
+    centroid_bounds = aabb_grow(centroid_bounds, builder.centroids[primitive]);
+  }
+
+  builder.max_depth = (depth > builder.max_depth) ? depth : builder.max_depth;
+
+  Bvh_Split split = {.axis = 0, .bin = 0, .cost = FLT_MAX};
+  if (count > 1 && depth < BVH_MAX_DEPTH - 1) {
+    Bvh_Bin bins[3][BVH_BIN_COUNT];
+    clear_bvh_bins(bins);
+    fill_bvh_bins(builder, begin, end, centroid_bounds, bins);
+    split = choose_bvh_split(bins, centroid_bounds, count);
+  }
+
+  if (is_bvh_leaf_cheaper(count, depth, bounds, split)) {
+    if (count > 0xFFFF) {
+      errf("BVH leaf with %d primitives, the tree is too deep", count);
+    }
+
+    builder.nodes[node_index] = {
+      .bounds = bounds,
+      .offset = (u32)begin,
+      .count  = (u16)count
+    };
+    builder.leaf_count++;
+    return node_index;
+  }
+
+  s32 const mid = partition_bvh_primitives(builder, begin, end, split, centroid_bounds);
+
+  builder.nodes[node_index] = {
+    .bounds = bounds,
+    .offset = 0,
+    .count  = 0,
+    .axis   = (u16)split.axis
+  };
+
+  s32 const left_child = build_bvh_node(builder, begin, mid, depth + 1);
+  dbg_check_(left_child == node_index + 1);
+  (void)left_child;
+
+  builder.nodes[node_index].offset = (u32)build_bvh_node(builder, mid, end, depth + 1);
+  return node_index;
+}
+
+/**
+ * Parallel build
+ *
+ * Big nodes are split by tasks: the bounds and the bins are filled in parallel over
+ * batches of primitives, each batch into its own copy, then merged. The partition
+ * stays serial. One child goes to the job system and the task recurses into the
+ * other. Below BVH_PARALLEL_SUBTREE_SIZE primitives a task builds its whole subtree
+ * with the serial builder, into a range of the scratch nodes it reserves with an atomic
+ * add. The result is a tree of tasks whose subtrees are spread over the scratch array,
+ * a second pass moves them into one depth-first array.
+ *
+ * The splits are the same as the serial builder's (merging bounds is exact), so both
+ * build the same tree.
+*/
+
+struct Bvh_Task {
+  Bvh_Builder *builder; // Shared. Only `bounds`, `centroids` and `indices` are used.
+  s32          begin;
+  s32          end;
+  s32          depth;
+
+  // Split tasks.
+  Bvh_Node  node;     // `offset` is set when the tree is placed.
+  Bvh_Task *children; // [2], NULL for subtree tasks.
+
+  // Subtree tasks. Right children are indices into `subtree`.
+  Bvh_Node *subtree;
+
+  s32 node_count; // In the whole subtree of the task.
+  s32 leaf_count;
+  s32 max_depth;
+
+  s64 volatile *scratch_used; // Nodes reserved from `scratch_nodes`.
+  Bvh_Node     *scratch_nodes;
+  Bvh_Node     *nodes;        // Placement: the final array.
+  s32           first_node;   // Placement: where the task's first node goes.
+};
+
+struct Bvh_Partial {
+  AABB    bounds;
+  AABB    centroid_bounds;
+  Bvh_Bin bins[3][BVH_BIN_COUNT];
+};
+
+struct Bvh_Parallel_Pass {
+  Bvh_Builder const *builder;
+  s32                begin;
+  AABB               centroid_bounds; // Binning pass only.
+  Bvh_Partial       *partials;        // One per batch of BVH_PARALLEL_BATCH_SIZE.
+};
+
+void
+compute_bvh_centroids_job(void *data, s64 begin, s64 end) {
+  Bvh_Builder &builder = *(Bvh_Builder*)data;
+  for (s64 i = begin; i < end; i++) {
+    builder.centroids[i] = center(builder.bounds[i]);
+    builder.indices[i]   = (u32)i;
+  }
+}
+
+void
+bvh_bounds_job(void *data, s64 begin, s64 end) {
+  Bvh_Parallel_Pass const &pass    = *(Bvh_Parallel_Pass*)data;
+  Bvh_Builder       const &builder = *pass.builder;
+
+  AABB bounds          = aabb_empty();
+  AABB centroid_bounds = aabb_empty();
+  for (s64 i = pass.begin + begin; i < pass.begin + end; i++) {
+    u32 const primitive = builder.indices[i];
+    bounds          = aabb_union(bounds, builder.bounds[primitive]);
+    centroid_bounds = aabb_grow(centroid_bounds, builder.centroids[primitive]);
+  }
+
+  Bvh_Partial &partial = pass.partials[begin/BVH_PARALLEL_BATCH_SIZE];
+  partial.bounds          = bounds;
+  partial.centroid_bounds = centroid_bounds;
+}
+
+void
+bvh_bins_job(void *data, s64 begin, s64 end) {
+  Bvh_Parallel_Pass const &pass    = *(Bvh_Parallel_Pass*)data;
+  Bvh_Partial             &partial = pass.partials[begin/BVH_PARALLEL_BATCH_SIZE];
+  fill_bvh_bins(*pass.builder, pass.begin + (s32)begin, pass.begin + (s32)end,
+                pass.centroid_bounds, partial.bins);
+}
+
+void
+build_bvh_task(void *data);
+
+void
+build_bvh_subtree(Bvh_Task &task) {
+  s32 const max_nodes = 2*(task.end - task.begin) - 1;
+  s64 const first     = atomic_add(*task.scratch_used, max_nodes) - max_nodes;
+
+  Bvh_Builder subtree = *task.builder;
+  subtree.nodes      = task.scratch_nodes + first;
+  subtree.node_count = 0;
+  subtree.leaf_count = 0;
+  subtree.max_depth  = 0;
+  (void)build_bvh_node(subtree, task.begin, task.end, task.depth);
+
+  task.subtree    = subtree.nodes;
+  task.node_count = subtree.node_count;
+  task.leaf_count = subtree.leaf_count;
+  task.max_depth  = subtree.max_depth;
+}
+
+void
+build_bvh_task(void *data) {
+  Bvh_Task &task  = *(Bvh_Task*)data;
+  s32 const count = task.end - task.begin;
+
+  if (count <= BVH_PARALLEL_SUBTREE_SIZE || task.depth >= BVH_MAX_DEPTH - 1) {
+    build_bvh_subtree(task);
+    return;
+  }
+
+  s32 const batch_count = (count + BVH_PARALLEL_BATCH_SIZE - 1)/BVH_PARALLEL_BATCH_SIZE;
+  Bvh_Parallel_Pass pass = {
+    .builder  = task.builder,
+    .begin    = task.begin,
+    .partials = (Bvh_Partial*)alloc_perm(batch_count*sizeof(Bvh_Partial))
+  };
+
+  // @Note: with a single thread parallel_for runs everything as one batch, so the other
+  //        partials must merge as nothing.
+  for (s32 i = 0; i < batch_count; i++) {
+    pass.partials[i].bounds          = aabb_empty();
+    pass.partials[i].centroid_bounds = aabb_empty();
+    clear_bvh_bins(pass.partials[i].bins);
+  }
+
+  parallel_for(count, BVH_PARALLEL_BATCH_SIZE, bvh_bounds_job, &pass);
+
+  AABB bounds = aabb_empty();
+  pass.centroid_bounds = aabb_empty();
+  for (s32 i = 0; i < batch_count; i++) {
+    bounds               = aabb_union(bounds, pass.partials[i].bounds);
+    pass.centroid_bounds = aabb_union(pass.centroid_bounds, pass.partials[i].centroid_bounds);
+  }
+
+  parallel_for(count, BVH_PARALLEL_BATCH_SIZE, bvh_bins_job, &pass);
+
+  Bvh_Bin bins[3][BVH_BIN_COUNT];
+  clear_bvh_bins(bins);
+  for (s32 i = 0; i < batch_count; i++) {
+    for (s32 axis = 0; axis < 3; axis++) {
+      for (s32 j = 0; j < BVH_BIN_COUNT; j++) {
+        bins[axis][j].bounds = aabb_union(bins[axis][j].bounds, pass.partials[i].bins[axis][j].bounds);
+        bins[axis][j].count += pass.partials[i].bins[axis][j].count;
+      }
+    }
+  }
+  free_perm(pass.partials);
+
+  // @Note: too many primitives for a leaf, the task always splits.
+  Bvh_Split const split = choose_bvh_split(bins, pass.centroid_bounds, count);
+  s32 const mid = partition_bvh_primitives(*task.builder, task.begin, task.end, split,
+                                           pass.centroid_bounds);
+
+  task.node     = {.bounds = bounds, .axis = (u16)split.axis};
+  task.children = (Bvh_Task*)alloc_perm(2*sizeof(Bvh_Task));
+
+  Bvh_Task child = task;
+  child.children = NULL;
+  child.depth    = task.depth + 1;
+
+  task.children[0]       = child;
+  task.children[0].end   = mid;
+  task.children[1]       = child;
+  task.children[1].begin = mid;
+
+  Job const   right   = {.fn = build_bvh_task, .data = &task.children[1]};
+  Job_Counter counter = {};
+  submit_jobs(&right, 1, counter);
+  build_bvh_task(&task.children[0]);
+  wait_for_jobs(counter);
+
+  Bvh_Task const &left_task  = task.children[0];
+  Bvh_Task const &right_task = task.children[1];
+  task.node_count = 1 + left_task.node_count + right_task.node_count;
+  task.leaf_count = left_task.leaf_count + right_task.leaf_count;
+  task.max_depth  = (left_task.max_depth > right_task.max_depth) ? left_task.max_depth
+                                                                 : right_task.max_depth;
+}
+
+// Copies the nodes of the task's subtree to [first_node, first_node + node_count) of
+// the final array, and frees the task's children.
+void
+place_bvh_task(void *data) {
+  Bvh_Task &task = *(Bvh_Task*)data;
+
+  if (!task.children) {
+    for (s32 i = 0; i < task.node_count; i++) {
+      Bvh_Node node = task.subtree[i];
+      if (node.count == 0) {
+        node.offset += (u32)task.first_node;
+      }
+      task.nodes[task.first_node + i] = node;
+    }
+    return;
+  }
+
+  Bvh_Task &left_task  = task.children[0];
+  Bvh_Task &right_task = task.children[1];
+  left_task.nodes       = task.nodes;
+  left_task.first_node  = task.first_node + 1;
+  right_task.nodes      = task.nodes;
+  right_task.first_node = left_task.first_node + left_task.node_count;
+
+  task.node.offset            = (u32)right_task.first_node;
+  task.nodes[task.first_node] = task.node;
+
+  Job const   right   = {.fn = place_bvh_task, .data = &right_task};
+  Job_Counter counter = {};
+  submit_jobs(&right, 1, counter);
+  place_bvh_task(&left_task);
+  wait_for_jobs(counter);
+
+  free_perm(task.children);
+}
+} // namespace impl
+
+[[nodiscard]] Bvh
+bvh_build(AABB const *bounds, s32 count, Bvh_Build_Stats *stats) {
+  check_(count > 0);
+
+  f64 const start = os_get_app_uptime_precise();
+
+  // @Note: a binary tree with `count` leaves has 2*count - 1 nodes, at most.
+  s64 const max_nodes = 2*(s64)count - 1;
+
+  Bvh bvh = {};
+  bvh.arena           = arena_create(max_nodes*sizeof(Bvh_Node) + count*sizeof(u32) + 64);
+  bvh.nodes           = (Bvh_Node*)arena_alloc(bvh.arena, max_nodes*sizeof(Bvh_Node), 64);
+  bvh.primitives      = (u32*)arena_alloc(bvh.arena, count*sizeof(u32));
+  bvh.primitive_count = count;
+
+  Arena scratch = arena_create(count*sizeof(Vec3) + 16);
+
+  impl::Bvh_Builder builder = {
+    .bounds    = bounds,
+    .centroids = (Vec3*)arena_alloc(scratch, count*sizeof(Vec3)),
+    .indices   = bvh.primitives,
+    .nodes     = bvh.nodes
+  };
+
+  impl::compute_bvh_centroids_job(&builder, 0, count);
+  (void)impl::build_bvh_node(builder, 0, count, 0);
+  bvh.node_count = builder.node_count;
+
+  arena_destroy(scratch);
+
+  if (stats) {
+    *stats = {
+      .seconds    = os_get_app_uptime_precise() - start,
+      .node_count = builder.node_count,
+      .leaf_count = builder.leaf_count,
+      .max_depth  = builder.max_depth,
+      .sah_cost   = bvh_sah_cost(bvh)
+    };
+  }
+
+  return bvh;
+}
+
+[[nodiscard]] Bvh
+bvh_build_parallel(AABB const *bounds, s32 count, Bvh_Build_Stats *stats) {
+  check_(count > 0);
+
+  f64 const start = os_get_app_uptime_precise();
+
+  // @Note: the subtrees reserve 2*count - 1 nodes for count primitives, all of them
+  //        together no more than the whole tree would.
+  s64 const max_nodes = 2*(s64)count - 1;
+
+  Arena scratch = arena_create(max_nodes*sizeof(Bvh_Node) + count*(sizeof(Vec3) + sizeof(u32)) + 128);
+
+  impl::Bvh_Builder builder = {
+    .bounds    = bounds,
+    .centroids = (Vec3*)arena_alloc(scratch, count*sizeof(Vec3)),
+    .indices   = (u32*)arena_alloc(scratch, count*sizeof(u32))
+  };
+  parallel_for(count, BVH_PARALLEL_BATCH_SIZE, impl::compute_bvh_centroids_job, &builder);
+
+  s64 volatile scratch_used = 0;
+
+  impl::Bvh_Task root = {
+    .builder       = &builder,
+    .begin         = 0,
+    .end           = count,
+    .scratch_used  = &scratch_used,
+    .scratch_nodes = (Bvh_Node*)arena_alloc(scratch, max_nodes*sizeof(Bvh_Node), 64)
+  };
+  impl::build_bvh_task(&root);
+
+  // @Note: the final arena is sized after the build, the nodes don't have to fit the
+  //        worst case twice.
+  Bvh bvh = {};
+  bvh.arena           = arena_create(root.node_count*sizeof(Bvh_Node) + count*sizeof(u32) + 64);
+  bvh.nodes           = (Bvh_Node*)arena_alloc(bvh.arena, root.node_count*sizeof(Bvh_Node), 64);
+  bvh.node_count      = root.node_count;
+  bvh.primitives      = (u32*)arena_alloc(bvh.arena, count*sizeof(u32));
+  bvh.primitive_count = count;
+
+  root.nodes      = bvh.nodes;
+  root.first_node = 0;
+  impl::place_bvh_task(&root);
+  mem_copy_(bvh.primitives, builder.indices, count*sizeof(u32));
+
+  arena_destroy(scratch);
+
+  if (stats) {
+    *stats = {
+      .seconds    = os_get_app_uptime_precise() - start,
+      .node_count = root.node_count,
+      .leaf_count = root.leaf_count,
+      .max_depth  = root.max_depth,
+      .sah_cost   = bvh_sah_cost(bvh)
+    };
+  }
+
+  return bvh;
+}
+
+void
+bvh_destroy(Bvh &bvh) {
+  arena_destroy(bvh.arena);
+  bvh = {};
+}
+
+[[nodiscard]] f32
+bvh_sah_cost(Bvh const &bvh) {
+  if (bvh.node_count == 0) {
+    return 0;
+  }
+
+  f64 cost = 0;
+  for (s32 i = 0; i < bvh.node_count; i++) {
+    Bvh_Node const &node = bvh.nodes[i];
+    f64 const area = surface_area(node.bounds);
+    cost += (node.count > 0) ? area*node.count : area*BVH_TRAVERSAL_COST;
+  }
+
+  f64 const root_area = surface_area(bvh.nodes[0].bounds);
+  return (root_area > 0) ? (f32)(cost/root_area) : 0;
+}
+
+void
+bvh_log_stats(char const *label, Bvh_Build_Stats const &stats) {
+  logf("%s: built in %.3f ms -- %d nodes (%d leaves), depth %d, SAH cost %.2f\n",
+       label, stats.seconds*1000, stats.node_count, stats.leaf_count, stats.max_depth,
+       stats.sah_cost);
+}
+
+template <typename TIntersect>
+[[nodiscard]] bool
+bvh_intersect(Bvh const &bvh, Ray const &ray, f32 t_min, f32 &t_max,
+              TIntersect &&intersect_primitive) {
+  if (bvh.node_count == 0) {
+    return false;
+  }
+
+  u32  stack[BVH_MAX_DEPTH];
+  s32  stack_size = 0;
+  u32  node_index = 0;
+  bool hit        = false;
+
+  for (;;) {
+    Bvh_Node const &node = bvh.nodes[node_index];
+
+    f32 t_entry;
+    if (intersect(ray, node.bounds, t_min, t_max, t_entry)) {
+      if (node.count == 0) {
+        // @Note: a ray going down the split axis meets the right child (the higher
+        //        centroids) first.
+        if (ray.sign[node.axis]) {
+          stack[stack_size++] = node_index + 1;
+          node_index          = node.offset;
+        } else {
+          stack[stack_size++] = node.offset;
+          node_index          = node_index + 1;
+        }
+        continue;
+      }
+
+      for (u32 i = 0; i < node.count; i++) {
+        hit |= intersect_primitive(bvh.primitives[node.offset + i], t_min, t_max);
+      }
+    }
+
+    if (stack_size == 0) {
+      break;
+    }
+    node_index = stack[--stack_size];
+  }
+
+  return hit;
+}
+} // namespace rt
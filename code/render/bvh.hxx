@@ -0,0 +1,65 @@
+/**
+ * Bounding volume hierarchy over primitive bounds, built top-down with binned SAH
+ * splits: the centroids of a node are sorted into BVH_BIN_COUNT bins along every axis
+ * and the cheapest split between two bins wins, unless a leaf is cheaper.
+ *
+ * The nodes are stored depth-first. The left child of an interior node is the next
+ * node, only the right one is referenced. Traversal visits the child on the ray's
+ * side of the split first, so far subtrees are often culled by a closer hit.
+*/
+
+namespace rt {
+struct Bvh_Node {
+  AABB bounds;
+  u32  offset; // Leaves: first entry in Bvh::primitives. Interior: index of the right child.
+  u16  count;  // Primitives in the leaf. 0 for interior nodes.
+  u16  axis;   // Interior: split axis. The left child has the lower centroids.
+};
+static_assert(sizeof(Bvh_Node) == 32);
+
+struct Bvh {
+  Arena arena; // Holds the nodes and the primitive indices.
+
+  Bvh_Node *nodes;
+  s32       node_count;
+
+  u32 *primitives; // Indices of the input primitives, in leaf order.
+  s32  primitive_count;
+
+  f32 built_sah_cost; // Set by the first bvh_update, and by its (failed) rebuilds. 0 if unknown.
+};
+
+struct Bvh_Build_Stats {
+  f64 seconds;
+  s32 node_count;
+  s32 leaf_count;
+  s32 max_depth;
+  f32 sah_cost; // Expected cost of a ray, in primitive intersections.
+};
+
+// `bounds` has an entry per primitive. `stats` is optional.
+[[nodiscard]] Bvh
+bvh_build(AABB const *bounds, s32 count, Bvh_Build_Stats *stats = NULL);
+
+// Same tree as bvh_build, built on the job system. See bvh.cxx.
+[[nodiscard]] Bvh
+bvh_build_parallel(AABB const *bounds, s32 count, Bvh_Build_Stats *stats = NULL);
+
+void
+bvh_destroy(Bvh &bvh);
+
+// SAH cost of the tree, with the root's surface area as the reference.
+[[nodiscard]] f32
+bvh_sah_cost(Bvh const &bvh);
+
+void
+bvh_log_stats(char const *label, Bvh_Build_Stats const &stats);
+
+// Closest hit in (t_min, t_max). For every primitive in a leaf the ray reaches, calls
+// intersect_primitive(u32 primitive, f32 t_min, f32 &t_max), which returns true and
+// lowers `t_max` on a closer hit. Returns true if anything was hit.
+template <typename TIntersect>
+[[nodiscard]] bool
+bvh_intersect(Bvh const &bvh, Ray const &ray, f32 t_min, f32 &t_max,
+              TIntersect &&intersect_primitive);
+} // namespace rt
@@ -0,0 +1,282 @@
+namespace rt {
+namespace impl {
+// Morton codes that each split off one primitive, above a cluster of coincident
+// triangles that only the index tie breaker splits: deeper than BVH_MAX_DEPTH, so the
+// LBVH builder has to cap it. Returns the number of failed checks, `check_count` is
+// increased by the number of checks.
+[[nodiscard]] s32
+run_coincident_benchmark(s32 &check_count) {
+  s32 constexpr CHAIN_LEVELS = 18; // Per axis, 2^-1 to 2^-18 of the extent.
+  s32 constexpr CLUSTER      = BVH_LBVH_MORTON30_MAX; // Enough for 63-bit codes.
+
+  // @Note: the box of a triangle is centered on `p`, so its centroid is exactly `p`.
+  auto const triangle = [](Vec3 p, f32 size) {
+    return Triangle{
+      .v0 = p + Vec3{.x = -size, .y = -size},
+      .v1 = p + Vec3{.x =  size, .y = -size},
+      .v2 = p + Vec3{.y =  size}
+    };
+  };
+
+  Scene scene = scene_create(1, 0, CLUSTER + 3*CHAIN_LEVELS + 1);
+  (void)scene_add_material(scene, {
+    .type = MaterialType_Diffuse, .albedo = {.x = 0.5f, .y = 0.5f, .z = 0.5f}
+  });
+  for (s32 i = 0; i < CLUSTER; i++) {
+    scene_add_triangle(scene, triangle({}, 0.25f));
+  }
+  for (s32 level = 1; level <= CHAIN_LEVELS; level++) {
+    f32 const x = std::ldexp(1.0f, -level);
+    scene_add_triangle(scene, triangle({.x = x}, 1e-7f));
+    scene_add_triangle(scene, triangle({.y = x}, 1e-7f));
+    scene_add_triangle(scene, triangle({.z = x}, 1e-7f));
+  }
+  scene_add_triangle(scene, triangle({.x = 1, .y = 1, .z = 1}, 1e-7f));
+
+  s32   const primitive_count = scene.triangle_count;
+  AABB *const bounds          = (AABB*)alloc_perm(primitive_count*sizeof(AABB));
+  scene_primitive_bounds(scene, bounds);
+
+  // Rays from around the cluster through it.
+  Pcg32 rng  = pcg32_seed(2, 0);
+  Ray  *rays = (Ray*)alloc_perm(BVH_BENCHMARK_CHECK*sizeof(Ray));
+  Hit  *expected_hits   = (Hit*)alloc_perm(BVH_BENCHMARK_CHECK*sizeof(Hit));
+  bool *expected_is_hit = (bool*)alloc_perm(BVH_BENCHMARK_CHECK*sizeof(bool));
+  for (s32 i = 0; i < BVH_BENCHMARK_CHECK; i++) {
+    Vec3 const origin = sample_uniform_sphere({.x = next_f32(rng), .y = next_f32(rng)})*3;
+    Vec3 const target = {.x = 0.5f*next_f32(rng) - 0.25f, .y = 0.5f*next_f32(rng) - 0.25f};
+    rays[i] = make_ray(origin, target - origin);
+    expected_is_hit[i] = scene_intersect(scene, rays[i], 0, FLT_MAX, expected_hits[i]);
+  }
+
+  logf("BVH benchmark: %d coincident triangles under %d others\n", CLUSTER,
+       primitive_count - CLUSTER);
+
+  s32 failed = 0;
+  for (s32 optimize_treelets = 0; optimize_treelets < 2; optimize_treelets++) {
+    char const *const label = optimize_treelets ? "Coincident LBVH + treelets" : "Coincident LBVH";
+
+    Bvh_Build_Stats stats;
+    scene.bvh = bvh_build_lbvh(bounds, primitive_count, optimize_treelets != 0, &stats);
+    bvh_log_stats(label, stats);
+    if (scene.bvh.node_count == 0) {
+      logf("!!! %s: not built\n", label);
+      failed++;
+    }
+
+    for (s32 i = 0; i < BVH_BENCHMARK_CHECK; i++) {
+      Hit        hit    = {};
+      bool const is_hit = scene_intersect(scene, rays[i], 0, FLT_MAX, hit);
+      if (is_hit != expected_is_hit[i] || (is_hit && hit.t != expected_hits[i].t)) {
+        logf("!!! %s: ray %d: BVH %s at %f, brute force %s at %f\n", label, i,
+             is_hit ? "hit" : "missed", hit.t, expected_is_hit[i] ? "hit" : "missed",
+             expected_hits[i].t);
+        failed++;
+      }
+    }
+    check_count += BVH_BENCHMARK_CHECK + 1;
+    bvh_destroy(scene.bvh);
+  }
+
+  free_perm(expected_is_hit);
+  free_perm(expected_hits);
+  free_perm(rays);
+  free_perm(bounds);
+  scene_destroy(scene);
+  return failed;
+}
+} // namespace impl
+
+[[nodiscard]] s32
+bvh_run_benchmark(s32 triangle_count) {
+  s32 constexpr MAJOR_SEGMENTS  = 64;
+  s32 constexpr MINOR_SEGMENTS  = 32;
+  s32 constexpr TORUS_TRIANGLES = 2*MAJOR_SEGMENTS*MINOR_SEGMENTS;
+
+  check_(triangle_count > 0);
+
+  s32 const torus_count = (triangle_count + TORUS_TRIANGLES - 1)/TORUS_TRIANGLES;
+  f32 const half_size   = 2*std::cbrt((f32)torus_count); // Same density for any count.
+
+  Scene scene = scene_create(1, 0, torus_count*TORUS_TRIANGLES);
+  s32 const material = scene_add_material(scene, {
+    .type = MaterialType_Diffuse, .albedo = {.x = 0.5f, .y = 0.5f, .z = 0.5f}
+  });
+
+  Pcg32 rng = pcg32_seed(1, 0);
+  auto const random_point = [&]() {
+    return Vec3{
+      .x = half_size*(2*next_f32(rng) - 1),
+      .y = half_size*(2*next_f32(rng) - 1),
+      .z = half_size*(2*next_f32(rng) - 1)
+    };
+  };
+
+  for (s32 i = 0; i < torus_count; i++) {
+    f32 const major_radius = 0.5f + next_f32(rng);
+    scene_add_torus(scene, random_point(), major_radius, major_radius*(0.1f + 0.3f*next_f32(rng)),
+                    MAJOR_SEGMENTS, MINOR_SEGMENTS, material);
+  }
+
+  logf("BVH benchmark: %d triangles in %d tori\n", scene.triangle_count, torus_count);
+
+  s32   const primitive_count = scene.triangle_count;
+  AABB *const bounds          = (AABB*)alloc_perm(primitive_count*sizeof(AABB));
+  scene_primitive_bounds(scene, bounds);
+
+  Ray *rays = (Ray*)alloc_perm(BVH_BENCHMARK_RAYS*sizeof(Ray));
+  for (s32 i = 0; i < BVH_BENCHMARK_RAYS; i++) {
+    rays[i] = make_ray(random_point(), sample_uniform_sphere({.x = next_f32(rng), .y = next_f32(rng)}));
+  }
+
+  // @Note: brute force once, every tree is checked against it.
+  Hit  *expected_hits = (Hit*)alloc_perm(BVH_BENCHMARK_CHECK*sizeof(Hit));
+  bool *expected_is_hit = (bool*)alloc_perm(BVH_BENCHMARK_CHECK*sizeof(bool));
+  for (s32 i = 0; i < BVH_BENCHMARK_CHECK; i++) {
+    expected_is_hit[i] = scene_intersect(scene, rays[i], 0, FLT_MAX, expected_hits[i]);
+  }
+
+  s32 failed      = 0;
+  s32 check_count = 0;
+  auto const measure = [&](char const *label, Bvh_Build_Stats const *stats) {
+    if (stats) {
+      bvh_log_stats(label, *stats);
+    }
+
+    // @Note: single thread, the rate is per core.
+    s32       hit_count = 0;
+    f64 const start     = os_get_app_uptime_precise();
+    for (s32 i = 0; i < BVH_BENCHMARK_RAYS; i++) {
+      Hit hit;
+      hit_count += scene_intersect(scene, rays[i], 0, FLT_MAX, hit);
+    }
+    f64 const seconds = os_get_app_uptime_precise() - start;
+
+    logf("%s: %d rays in %.3f s, %.2f Mrays/s, %.1f%% hit\n", label, BVH_BENCHMARK_RAYS,
+         seconds, BVH_BENCHMARK_RAYS/seconds*1e-6, 100.0*hit_count/BVH_BENCHMARK_RAYS);
+
+    for (s32 i = 0; i < BVH_BENCHMARK_CHECK; i++) {
+      Hit        hit    = {};
+      bool const is_hit = scene_intersect(scene, rays[i], 0, FLT_MAX, hit);
+      if (is_hit != expected_is_hit[i] || (is_hit && hit.t != expected_hits[i].t)) {
+        logf("!!! %s: ray %d: BVH %s at %f, brute force %s at %f\n", label, i,
+             is_hit ? "hit" : "missed", hit.t, expected_is_hit[i] ? "hit" : "missed",
+             expected_hits[i].t);
+        failed++;
+      }
+    }
+    check_count += BVH_BENCHMARK_CHECK;
+    return seconds;
+  };
+
+  Bvh_Build_Stats serial_stats;
+  scene.bvh = bvh_build(bounds, primitive_count, &serial_stats);
+  f64 const binary_seconds = measure("SAH, 1 thread", &serial_stats);
+
+  // The same tree collapsed, scene_intersect prefers the wide ones.
+  auto const measure_wide = [&]<s32 N>(Wide_Bvh<N> &wide, Quantized_Bvh<N> &quantized) {
+    s64 const mark = get_temp_mem_mark(); // For the labels.
+
+    Bvh_Build_Stats wide_stats;
+    wide = wide_bvh_build<N>(scene.bvh, &wide_stats);
+    f64 const wide_size = wide.node_count*(f64)sizeof(*wide.nodes);
+    logf("SAH BVH%d: collapsed in %.3f ms -- %d nodes (%d leaves), depth %d, %.1f MB\n",
+         N, wide_stats.seconds*1000, wide_stats.node_count, wide_stats.leaf_count,
+         wide_stats.max_depth, wide_size/(1024*1024));
+    f64 const wide_seconds = measure(as_cstr(tprint("SAH BVH%d", N)), NULL);
+    logf("SAH BVH%d traversal speedup: %.2fx\n", N, binary_seconds/wide_seconds);
+    wide_bvh_destroy(wide);
+
+    Bvh_Build_Stats quantized_stats;
+    quantized = quantized_bvh_build<N>(scene.bvh, &quantized_stats);
+    f64 const quantized_size = quantized.node_count*(f64)sizeof(*quantized.nodes);
+    logf("SAH quantized BVH%d: collapsed in %.3f ms -- %d nodes, %.1f MB, %.2fx smaller\n",
+         N, quantized_stats.seconds*1000, quantized_stats.node_count,
+         quantized_size/(1024*1024), wide_size/quantized_size);
+    f64 const quantized_seconds = measure(as_cstr(tprint("SAH quantized BVH%d", N)), NULL);
+    logf("SAH quantized BVH%d traversal speedup: %.2fx (%.2fx over uncompressed)\n", N,
+         binary_seconds/quantized_seconds, wide_seconds/quantized_seconds);
+    quantized_bvh_destroy(quantized);
+
+    pop_temp_mem_mark(get_temp_mem_mark() - mark);
+  };
+  logf("SAH BVH2: %.1f MB\n", scene.bvh.node_count*(f64)sizeof(Bvh_Node)/(1024*1024));
+  measure_wide(scene.bvh4, scene.quantized_bvh4);
+  if (os_get_cpu_info().isa_level >= IsaLevel_AVX2) {
+    measure_wide(scene.bvh8, scene.quantized_bvh8);
+  }
+  Bvh serial = scene.bvh;
+
+  Bvh_Build_Stats parallel_stats;
+  scene.bvh = bvh_build_parallel(bounds, primitive_count, &parallel_stats);
+  s64 const mark = get_temp_mem_mark();
+  measure(as_cstr(tprint("SAH, %d threads", jobs_thread_count())), &parallel_stats);
+  pop_temp_mem_mark(get_temp_mem_mark() - mark);
+  logf("Parallel SAH build speedup: %.2fx\n", serial_stats.seconds/parallel_stats.seconds);
+
+  // @Note: both builders make the same splits.
+  if (serial.node_count != scene.bvh.node_count ||
+      mem_comp_(serial.nodes, scene.bvh.nodes, serial.node_count*sizeof(Bvh_Node)) != 0 ||
+      mem_comp_(serial.primitives, scene.bvh.primitives, primitive_count*sizeof(u32)) != 0) {
+    logf("!!! The parallel SAH build differs from the serial one\n");
+    failed++;
+  }
+  bvh_destroy(serial);
+  bvh_destroy(scene.bvh);
+
+  Bvh_Build_Stats lbvh_stats;
+  scene.bvh = bvh_build_lbvh(bounds, primitive_count, false, &lbvh_stats);
+  measure("LBVH", &lbvh_stats);
+  bvh_destroy(scene.bvh);
+
+  Bvh_Build_Stats treelet_stats;
+  scene.bvh = bvh_build_lbvh(bounds, primitive_count, true, &treelet_stats);
+  measure("LBVH + treelets", &treelet_stats);
+
+  // Dynamic geometry: every torus drifts away with its own velocity, the tree is refit
+  // every frame until it has degraded enough to be rebuilt.
+  Vec3 *velocities = (Vec3*)alloc_perm(torus_count*sizeof(Vec3));
+  for (s32 i = 0; i < torus_count; i++) {
+    velocities[i] = sample_uniform_sphere({.x = next_f32(rng), .y = next_f32(rng)})*(0.02f*half_size);
+  }
+
+  for (s32 frame = 0; frame < BVH_BENCHMARK_FRAMES; frame++) {
+    for (s32 i = 0; i < scene.triangle_count; i++) {
+      Vec3 const velocity = velocities[i/TORUS_TRIANGLES];
+      scene.triangles[i].v0 = scene.triangles[i].v0 + velocity;
+      scene.triangles[i].v1 = scene.triangles[i].v1 + velocity;
+      scene.triangles[i].v2 = scene.triangles[i].v2 + velocity;
+    }
+
+    Bvh_Update_Stats update;
+    scene_update_bvh(scene, &update);
+    logf("Frame %d: %s in %.3f ms, SAH cost %.2f (%.2f when built)\n", frame,
+         update.rebuilt ? "rebuilt" : "refit", update.seconds*1000, update.sah_cost,
+         update.built_sah_cost);
+  }
+  free_perm(velocities);
+
+  Scene moved = scene;
+  moved.bvh            = {};
+  moved.bvh4           = {};
+  moved.bvh8           = {};
+  moved.quantized_bvh4 = {};
+  moved.quantized_bvh8 = {};
+  for (s32 i = 0; i < BVH_BENCHMARK_CHECK; i++) {
+    expected_is_hit[i] = scene_intersect(moved, rays[i], 0, FLT_MAX, expected_hits[i]);
+  }
+  measure("Updated LBVH, collapsed", NULL);
+
+  check_count++; // The parallel SAH build.
+
+  failed += impl::run_coincident_benchmark(check_count);
+  logf("BVH benchmark: %d of %d checks failed\n", failed, check_count);
+
+  free_perm(expected_is_hit);
+  free_perm(expected_hits);
+  free_perm(rays);
+  free_perm(bounds);
+  scene_destroy(scene);
+  return failed;
+}
+} // namespace rt
@@ -0,0 +1,20 @@
+/**
+ * BVH build and traversal benchmark:
+ *
+ *    rt_internal.exe --bvh-bench [triangle_count]
+ *
+ * Builds BVHs over a soup of randomly placed tori -- SAH on one thread and on the job
+ * system, LBVH without and with treelet optimization -- and traces random rays through
+ * each of them on one thread. Logs the build stats and the trace rate, so build time
+ * can be weighed against tree quality. Then the tori drift apart for a few frames and
+ * the tree is refit (or rebuilt, when it has degraded) every frame. Checks that both
+ * SAH builds are the same tree and a few of the rays against brute force. Last, the
+ * LBVH of a cluster of coincident triangles, which is deeper than BVH_MAX_DEPTH
+ * before it's capped, is checked the same way.
+*/
+
+namespace rt {
+// Returns the number of failed checks.
+[[nodiscard]] s32
+bvh_run_benchmark(s32 triangle_count);
+} // namespace rt
@@ -0,0 +1,119 @@
+namespace rt {
+namespace impl {
+struct Bvh_Refit {
+  Bvh        *bvh;
+  AABB const *bounds;
+  u32         node;
+  s32         depth;
+  f64         cost; // Output: SAH cost of the subtree times the root's surface area.
+};
+
+[[nodiscard]] AABB
+refit_bvh_node(Bvh &bvh, AABB const *bounds, u32 node_index, f64 &cost) {
+  Bvh_Node &node = bvh.nodes[node_index];
+
+  if (node.count > 0) {
+    AABB leaf_bounds = aabb_empty();
+    for (u32 i = 0; i < node.count; i++) {
+      leaf_bounds = aabb_union(leaf_bounds, bounds[bvh.primitives[node.offset + i]]);
+    }
+    node.bounds  = leaf_bounds;
+    cost        += (f64)surface_area(leaf_bounds)*node.count;
+    return leaf_bounds;
+  }
+
+  AABB const left  = refit_bvh_node(bvh, bounds, node_index + 1, cost);
+  AABB const right = refit_bvh_node(bvh, bounds, node.offset, cost);
+  node.bounds  = aabb_union(left, right);
+  cost        += (f64)surface_area(node.bounds)*BVH_TRAVERSAL_COST;
+  return node.bounds;
+}
+
+void
+refit_bvh_task(void *data) {
+  Bvh_Refit &task = *(Bvh_Refit*)data;
+  Bvh_Node  &node = task.bvh->nodes[task.node];
+
+  // @Note: the top levels split into 2^BVH_REFIT_TASK_DEPTH tasks, enough to keep
+  //        every thread busy even when the tree is lopsided.
+  if (node.count > 0 || task.depth >= BVH_REFIT_TASK_DEPTH) {
+    task.cost = 0;
+    (void)refit_bvh_node(*task.bvh, task.bounds, task.node, task.cost);
+    return;
+  }
+
+  Bvh_Refit left  = {.bvh = task.bvh, .bounds = task.bounds, .node = task.node + 1, .depth = task.depth + 1};
+  Bvh_Refit right = {.bvh = task.bvh, .bounds = task.bounds, .node = node.offset,   .depth = task.depth + 1};
+
+  Job const   job     = {.fn = refit_bvh_task, .data = &right};
+  Job_Counter counter = {};
+  submit_jobs(&job, 1, counter);
+  refit_bvh_task(&left);
+  wait_for_jobs(counter);
+
+  node.bounds = aabb_union(task.bvh->nodes[left.node].bounds, task.bvh->nodes[right.node].bounds);
+  task.cost   = left.cost + right.cost + (f64)surface_area(node.bounds)*BVH_TRAVERSAL_COST;
+}
+} // namespace impl
+
+f32
+bvh_refit(Bvh &bvh, AABB const *bounds) {
+  if (bvh.node_count == 0) {
+    return 0;
+  }
+
+  impl::Bvh_Refit root = {.bvh = &bvh, .bounds = bounds, .node = 0, .depth = 0};
+  impl::refit_bvh_task(&root);
+
+  f64 const root_area = surface_area(bvh.nodes[0].bounds);
+  return (root_area > 0) ? (f32)(root.cost/root_area) : 0;
+}
+
+void
+bvh_update(Bvh &bvh, AABB const *bounds, s32 count, Bvh_Update_Stats *stats) {
+  f64 const start = os_get_app_uptime_precise();
+
+  // @Note: the cost after the build is only needed once the tree is refit, so the
+  //        builders don't pay for it.
+  if (bvh.node_count > 0 && bvh.built_sah_cost == 0) {
+    bvh.built_sah_cost = bvh_sah_cost(bvh);
+  }
+
+  f32  cost    = 0;
+  bool rebuild = bvh.node_count == 0 || bvh.primitive_count != count;
+  if (!rebuild) {
+    cost    = bvh_refit(bvh, bounds);
+    rebuild = cost > bvh.built_sah_cost*BVH_REFIT_MAX_DEGRADATION;
+  }
+
+  if (rebuild) {
+    Bvh_Build_Stats build_stats;
+    Bvh rebuilt = bvh_build_lbvh(bounds, count, true, &build_stats);
+
+    // @Note: the LBVH builder gives up on trees it can't cap at BVH_MAX_DEPTH. The
+    //        refit tree is still correct, just slower, so it stays, and its cost
+    //        becomes the reference: the same rebuild would fail again next frame.
+    if (rebuilt.node_count == 0 && bvh.node_count > 0 && bvh.primitive_count == count) {
+      logf("BVH rebuild over %d primitives failed, keeping the refit tree\n", count);
+      bvh.built_sah_cost = cost;
+      rebuild            = false;
+    } else {
+      if (bvh.node_count > 0) {
+        bvh_destroy(bvh);
+      }
+      bvh                = rebuilt;
+      bvh.built_sah_cost = build_stats.sah_cost;
+      cost               = build_stats.sah_cost;
+    }
+  }
+
+  if (stats) {
+    *stats = {
+      .seconds        = os_get_app_uptime_precise() - start,
+      .sah_cost       = cost,
+      .built_sah_cost = bvh.built_sah_cost,
+      .rebuilt        = rebuild
+    };
+  }
+}
+} // namespace rt
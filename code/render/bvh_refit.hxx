@@ -0,0 +1,28 @@
+/**
+ * Updates of a BVH whose primitives move but stay the same primitives. A refit keeps
+ * the topology and recomputes the bounds bottom-up, which is linear and cheap. The
+ * tree gets worse as the primitives drift away from where it was built, so every
+ * update measures the SAH cost and rebuilds (with the LBVH builder, it's meant for
+ * moving geometry) once it's BVH_REFIT_MAX_DEGRADATION times the cost after the last
+ * build.
+*/
+
+namespace rt {
+struct Bvh_Update_Stats {
+  f64  seconds;
+  f32  sah_cost;
+  f32  built_sah_cost; // Right after the last rebuild, or when a failed one kept the tree.
+  bool rebuilt;
+};
+
+// Recomputes the bounds of every node from `bounds`, one entry per primitive as in
+// the build. Big subtrees are refit in parallel. Returns the new SAH cost.
+f32
+bvh_refit(Bvh &bvh, AABB const *bounds);
+
+// Refits, or rebuilds if the tree has degraded too much or the primitive count has
+// changed. If the rebuild fails (see bvh_build_lbvh) a refit tree is kept. `stats` is
+// optional.
+void
+bvh_update(Bvh &bvh, AABB const *bounds, s32 count, Bvh_Update_Stats *stats = NULL);
+} // namespace rt
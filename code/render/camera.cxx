@@ -0,0 +1,56 @@
+namespace rt {
+[[nodiscard]] Camera
+camera_look_at(Vec3 eye, Vec3 target, Vec3 up, f32 fov_y, f32 aspect,
+               f32 aperture, f32 focus_distance) {
+  // @Note: rows of the camera-to-world matrix are the camera's axes.
+  Mat4x4 const camera_to_world = rigid_inverse(look_at(eye, target, up));
+  Vec3   const axis_x = {.x = camera_to_world.v[0][0], .y = camera_to_world.v[0][1], .z = camera_to_world.v[0][2]};
+  Vec3   const axis_y = {.x = camera_to_world.v[1][0], .y = camera_to_world.v[1][1], .z = camera_to_world.v[1][2]};
+  Vec3   const axis_z = {.x = camera_to_world.v[2][0], .y = camera_to_world.v[2][1], .z = camera_to_world.v[2][2]};
+
+  f32 const half_height = std::tan(fov_y*0.5f);
+
+  return {
+    .eye            = eye,
+    .right          = axis_x*(half_height*aspect),
+    .up             = axis_y*half_height,
+    .forward        = axis_z*-1,
+    .lens_radius    = aperture*0.5f,
+    .focus_distance = focus_distance
+  };
+}
+
+[[nodiscard]] Camera
+camera_from_orbit(Orbit_Camera const &orbit, f32 aspect) {
+  f32 const cos_pitch = std::cos(orbit.pitch);
+  Vec3 const offset = {
+    .x = cos_pitch*std::cos(orbit.yaw),
+    .y = std::sin(orbit.pitch),
+    .z = cos_pitch*std::sin(orbit.yaw)
+  };
+
+  return camera_look_at(orbit.target + offset*orbit.distance, orbit.target,
+                        {.x = 0, .y = 1, .z = 0}, orbit.fov_y, aspect, orbit.aperture,
+                        orbit.distance);
+}
+
+[[nodiscard]] Ray
+camera_ray(Camera const &camera, Vec2 film, Vec2 lens) {
+  f32 const x = 2*film.x - 1;
+  f32 const y = 1 - 2*film.y;
+  Vec3 const dir = camera.forward + camera.right*x + camera.up*y;
+
+  if (camera.lens_radius <= 0) {
+    return make_ray(camera.eye, dir);
+  }
+
+  // Everything on the focus plane stays sharp, wherever on the lens the ray starts.
+  Vec2 const disk   = sample_unit_disk(lens);
+  Vec3 const focus  = camera.eye + dir*camera.focus_distance;
+  Vec3 const offset = normalized(camera.right)*(disk.x*camera.lens_radius) +
+                      normalized(camera.up)*(disk.y*camera.lens_radius);
+  Vec3 const origin = camera.eye + offset;
+
+  return make_ray(origin, focus - origin);
+}
+} // namespace rt
@@ -0,0 +1,40 @@
+/**
+ * Camera for the ray tracer. Same conventions as look_at: right-handed, looking down
+ * -Z of the camera space. A lens radius above 0 gives depth of field (thin lens model).
+*/
+
+namespace rt {
+struct Camera {
+  Vec3 eye;
+  Vec3 right;   // Scaled by the half-width of the image plane at distance 1.
+  Vec3 up;      // Scaled by the half-height of the image plane at distance 1.
+  Vec3 forward;
+
+  f32 lens_radius;
+  f32 focus_distance;
+};
+
+// Looks at `target` from a point on a sphere around it, for interactive viewing. Focused
+// on the target.
+struct Orbit_Camera {
+  Vec3 target;
+  f32  yaw;      // Around +Y, 0 puts the eye on the +X side.
+  f32  pitch;    // In (-PI/2, PI/2), above 0 the eye is higher than the target.
+  f32  distance;
+  f32  fov_y;
+  f32  aperture;
+};
+
+// `fov_y` is in radians. `aperture` is the lens diameter.
+[[nodiscard]] Camera
+camera_look_at(Vec3 eye, Vec3 target, Vec3 up, f32 fov_y, f32 aspect,
+               f32 aperture = 0, f32 focus_distance = 1);
+
+[[nodiscard]] Camera
+camera_from_orbit(Orbit_Camera const &orbit, f32 aspect);
+
+// `film` is the position on the image in [0, 1)^2, (0, 0) being the top-left corner.
+// `lens` is a [0, 1)^2 sample, unused by pinhole cameras.
+[[nodiscard]] Ray
+camera_ray(Camera const &camera, Vec2 film, Vec2 lens);
+} // namespace rt
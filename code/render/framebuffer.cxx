@@ -0,0 +1,153 @@
+namespace rt {
+namespace impl {
+[[nodiscard]] u8
+linear_to_srgb8(f32 x) {
+  x = (x > 0) ? x : 0;
+  x = (x < 1) ? x : 1;
+
+  f32 const srgb = (x <= 0.0031308f) ? 12.92f*x : 1.055f*std::pow(x, 1/2.4f) - 0.055f;
+  return (u8)(srgb*255 + 0.5f);
+}
+
+struct Resolve_Rgba8 {
+  Framebuffer const *fb;
+  u32               *rgba;
+  f32                exposure;
+};
+
+void
+resolve_rgba8_rows(void *data, s64 begin, s64 end) {
+  Resolve_Rgba8 const &resolve = *(Resolve_Rgba8*)data;
+  Framebuffer   const &fb      = *resolve.fb;
+
+  for (s32 y = (s32)begin; y < (s32)end; y++) {
+    u32 *row = resolve.rgba + (s64)y*fb.width;
+    for (s32 x = 0; x < fb.width; x++) {
+      Vec3 const c = framebuffer_resolve(fb, x, y)*resolve.exposure;
+      row[x] = (u32)linear_to_srgb8(c.x)         | ((u32)linear_to_srgb8(c.y) << 8) |
+               ((u32)linear_to_srgb8(c.z) << 16) | 0xff000000u;
+    }
+  }
+}
+
+void
+put_u16_le(u8 *dst, u32 x) {
+  dst[0] = (u8)x;
+  dst[1] = (u8)(x >> 8);
+}
+
+void
+put_u32_le(u8 *dst, u32 x) {
+  put_u16_le(dst, x);
+  put_u16_le(dst + 2, x >> 16);
+}
+} // namespace impl
+
+[[nodiscard]] Framebuffer
+framebuffer_create(s32 width, s32 height) {
+  check_(width > 0 && height > 0);
+
+  return {
+    .width  = width,
+    .height = height,
+    .pixels = (Vec4*)alloc_perm((s64)width*height*sizeof(Vec4))
+  };
+}
+
+void
+framebuffer_destroy(Framebuffer &fb) {
+  free_perm(fb.pixels);
+  fb = {};
+}
+
+void
+framebuffer_clear(Framebuffer &fb) {
+  ::memset(fb.pixels, 0, (s64)fb.width*fb.height*sizeof(Vec4));
+}
+
+void
+framebuffer_add_samples(Framebuffer &fb, s32 x, s32 y, Vec3 radiance_sum, s32 sample_count) {
+  dbg_check_(x >= 0 && x < fb.width && y >= 0 && y < fb.height);
+
+  Vec4 const samples = {
+    .x = radiance_sum.x, .y = radiance_sum.y, .z = radiance_sum.z, .w = (f32)sample_count
+  };
+  fb.pixels[(s64)y*fb.width + x] += samples;
+}
+
+[[nodiscard]] Vec3
+framebuffer_resolve(Framebuffer const &fb, s32 x, s32 y) {
+  dbg_check_(x >= 0 && x < fb.width && y >= 0 && y < fb.height);
+
+  Vec4 const sum = fb.pixels[(s64)y*fb.width + x];
+  if (sum.w <= 0) {
+    return {};
+  }
+  return sum.xyz*(1/sum.w);
+}
+
+void
+framebuffer_resolve_rgba8(Framebuffer const &fb, u32 *rgba, f32 exposure) {
+  impl::Resolve_Rgba8 resolve = {.fb = &fb, .rgba = rgba, .exposure = exposure};
+  parallel_for(fb.height, 8, impl::resolve_rgba8_rows, &resolve);
+}
+
+void
+framebuffer_write_pfm_or_panic(Framebuffer const &fb, char const *path) {
+  File_Writer writer = os_open_file_writer_or_panic(path);
+  s64 const   mark   = get_temp_mem_mark();
+
+  // @Note: a negative scale means little-endian. Rows go bottom to top.
+  String const header = tprint("PF\n%d %d\n-1.0\n", fb.width, fb.height);
+  os_file_writer_write_or_panic(writer, {.count = header.count, .bytes = (u8*)header.data});
+
+  s64 const row_size = (s64)fb.width*3*sizeof(f32);
+  f32      *row      = (f32*)alloc_temp(row_size);
+
+  for (s32 y = fb.height - 1; y >= 0; y--) {
+    for (s32 x = 0; x < fb.width; x++) {
+      Vec3 const c = framebuffer_resolve(fb, x, y);
+      row[3*x + 0] = c.x;
+      row[3*x + 1] = c.y;
+      row[3*x + 2] = c.z;
+    }
+    os_file_writer_write_or_panic(writer, {.count = row_size, .bytes = (u8*)row});
+  }
+
+  os_close_file_writer_or_panic(writer);
+  pop_temp_mem_mark(get_temp_mem_mark() - mark);
+}
+
+void
+framebuffer_write_bmp_or_panic(Framebuffer const &fb, char const *path, f32 exposure) {
+  s64 const row_size   = ((s64)fb.width*3 + 3) & ~3ll; // Rows are padded to 4 bytes.
+  s64 const image_size = row_size*fb.height;
+
+  u8 header[54] = {'B', 'M'};
+  impl::put_u32_le(header + 2,  (u32)(sizeof(header) + image_size));
+  impl::put_u32_le(header + 10, sizeof(header)); // Pixel data offset.
+  impl::put_u32_le(header + 14, 40);             // BITMAPINFOHEADER
+  impl::put_u32_le(header + 18, (u32)fb.width);
+  impl::put_u32_le(header + 22, (u32)fb.height); // Positive: bottom-up rows.
+  impl::put_u16_le(header + 26, 1);              // Planes.
+  impl::put_u16_le(header + 28, 24);             // Bits per pixel.
+  impl::put_u32_le(header + 34, (u32)image_size);
+
+  File_Writer writer = os_open_file_writer_or_panic(path);
+  os_file_writer_write_or_panic(writer, {.count = sizeof(header), .bytes = header});
+
+  u8 *row = (u8*)alloc_temp(row_size);
+  for (s32 y = fb.height - 1; y >= 0; y--) {
+    for (s32 x = 0; x < fb.width; x++) {
+      Vec3 const c = framebuffer_resolve(fb, x, y)*exposure;
+      row[3*x + 0] = impl::linear_to_srgb8(c.z);
+      row[3*x + 1] = impl::linear_to_srgb8(c.y);
+      row[3*x + 2] = impl::linear_to_srgb8(c.x);
+    }
+    os_file_writer_write_or_panic(writer, {.count = row_size, .bytes = row});
+  }
+
+  os_close_file_writer_or_panic(writer);
+  pop_temp_mem_mark(row_size);
+}
+} // namespace rt
@@ -0,0 +1,43 @@
+/**
+ * HDR accumulation buffer. Every pixel keeps the sum of its radiance samples (rgb) and
+ * their count (w), so samples can be added in any number of passes and the image is
+ * resolved as their mean at any point.
+*/
+
+namespace rt {
+struct Framebuffer {
+  s32   width;
+  s32   height;
+  Vec4 *pixels; // Row-major, top row first.
+};
+
+[[nodiscard]] Framebuffer
+framebuffer_create(s32 width, s32 height);
+
+void
+framebuffer_destroy(Framebuffer &fb);
+
+void
+framebuffer_clear(Framebuffer &fb);
+
+// `radiance_sum` is the sum of `sample_count` samples.
+void
+framebuffer_add_samples(Framebuffer &fb, s32 x, s32 y, Vec3 radiance_sum, s32 sample_count);
+
+// Mean of the samples, black for pixels without any.
+[[nodiscard]] Vec3
+framebuffer_resolve(Framebuffer const &fb, s32 x, s32 y);
+
+// Resolves, exposes and converts to sRGB for display, as R8G8B8A8 (R in the low byte).
+// `rgba` holds width*height pixels, top row first. Runs on every thread.
+void
+framebuffer_resolve_rgba8(Framebuffer const &fb, u32 *rgba, f32 exposure = 1);
+
+// Portable float map: the linear HDR values, exactly.
+void
+framebuffer_write_pfm_or_panic(Framebuffer const &fb, char const *path);
+
+// 24-bit BMP, exposed and converted to sRGB (values above 1 are clipped).
+void
+framebuffer_write_bmp_or_panic(Framebuffer const &fb, char const *path, f32 exposure = 1);
+} // namespace rt
@@ -0,0 +1,773 @@
+namespace rt {
+namespace impl {
+// Interior node of the radix tree. Children >= 0 are interior nodes, the others are
+// ~i for the primitive at position i of the sorted order.
+struct Lbvh_Node {
+  AABB bounds;
+  s32  children[2];
+  s32  parent;
+  s32  primitive_count;
+  s32  node_count; // In the flattened subtree. 1 if the subtree is collapsed into a leaf.
+  s32  height;     // Levels of the flattened subtree. 1 if it's collapsed.
+  f32  cost;       // SAH cost of the subtree times its surface area.
+
+  s64 volatile visits; // Threads that reached the node on the way up.
+};
+
+struct Lbvh_Builder {
+  AABB const *bounds;
+  s32         count;
+  bool        optimize_treelets;
+
+  Vec3 *centroids;
+  AABB  centroid_bounds;
+  s32   morton_bits;
+
+  u64 *keys; // Sorted Morton codes.
+  u32 *primitives;
+
+  Lbvh_Node *nodes;        // count - 1 of them, nodes[0] is the root.
+  s32       *leaf_parents; // Per sorted position.
+
+  Bvh *bvh; // Output.
+
+  s64 volatile leaf_count;
+  s64 volatile max_depth;
+};
+
+[[nodiscard]] s32
+leading_zeros(u64 x) {
+  unsigned long index;
+  return _BitScanReverse64(&index, x) ? 63 - (s32)index : 64;
+}
+
+[[nodiscard]] s32
+bit_count(u32 x) {
+  s32 count = 0;
+  for (; x; x &= x - 1) {
+    count++;
+  }
+  return count;
+}
+
+/**
+ * Morton codes
+*/
+
+// Spreads the low 10 bits out to every third bit.
+[[nodiscard]] u64
+expand_bits_10(u64 x) {
+  x &= 0x3FF;
+  x = (x | (x << 16)) & 0x030000FF;
+  x = (x | (x <<  8)) & 0x0300F00F;
+  x = (x | (x <<  4)) & 0x030C30C3;
+  x = (x | (x <<  2)) & 0x09249249;
+  return x;
+}
+
+// Spreads the low 21 bits out to every third bit.
+[[nodiscard]] u64
+expand_bits_21(u64 x) {
+  x &= 0x1FFFFF;
+  x = (x | (x << 32)) & 0x001F00000000FFFF;
+  x = (x | (x << 16)) & 0x001F0000FF0000FF;
+  x = (x | (x <<  8)) & 0x100F00F00F00F00F;
+  x = (x | (x <<  4)) & 0x10C30C30C30C30C3;
+  x = (x | (x <<  2)) & 0x1249249249249249;
+  return x;
+}
+
+// `p` in [0, 1]^3.
+[[nodiscard]] u64
+morton_code(Vec3 p, s32 bits) {
+  f32 const cells = (bits == 30) ? 1024.0f : 2097152.0f;
+  u64 q[3];
+  for (s32 axis = 0; axis < 3; axis++) {
+    f32 const x = p.v[axis]*cells;
+    q[axis] = (u64)((x < 0) ? 0 : (x > cells - 1) ? cells - 1 : x);
+  }
+
+  if (bits == 30) {
+    return (expand_bits_10(q[0]) << 2) | (expand_bits_10(q[1]) << 1) | expand_bits_10(q[2]);
+  }
+  return (expand_bits_21(q[0]) << 2) | (expand_bits_21(q[1]) << 1) | expand_bits_21(q[2]);
+}
+
+struct Lbvh_Bounds_Pass {
+  Lbvh_Builder *builder;
+  AABB         *partials; // Centroid bounds per batch.
+};
+
+void
+lbvh_centroids_job(void *data, s64 begin, s64 end) {
+  Lbvh_Bounds_Pass const &pass    = *(Lbvh_Bounds_Pass*)data;
+  Lbvh_Builder           &builder = *pass.builder;
+
+  AABB centroid_bounds = aabb_empty();
+  for (s64 i = begin; i < end; i++) {
+    builder.centroids[i] = center(builder.bounds[i]);
+    centroid_bounds      = aabb_grow(centroid_bounds, builder.centroids[i]);
+  }
+  pass.partials[begin/BVH_PARALLEL_BATCH_SIZE] = centroid_bounds;
+}
+
+void
+lbvh_morton_job(void *data, s64 begin, s64 end) {
+  Lbvh_Builder &builder = *(Lbvh_Builder*)data;
+
+  Vec3 const size = extent(builder.centroid_bounds);
+  Vec3 scale;
+  for (s32 axis = 0; axis < 3; axis++) {
+    scale.v[axis] = (size.v[axis] > 0) ? 1/size.v[axis] : 0;
+  }
+
+  for (s64 i = begin; i < end; i++) {
+    Vec3 const offset = builder.centroids[i] - builder.centroid_bounds.min;
+    Vec3 const p      = {.x = offset.x*scale.x, .y = offset.y*scale.y, .z = offset.z*scale.z};
+    builder.keys[i]       = morton_code(p, builder.morton_bits);
+    builder.primitives[i] = (u32)i;
+  }
+}
+
+/**
+ * Radix sort
+ *
+ * Least significant digit first, 8 bits per pass. Every batch of keys counts its
+ * digits, the offsets of each batch follow from the counts, and every batch scatters
+ * its keys in order -- so the sort is stable and the same on any thread count.
+*/
+
+s32 constexpr RADIX_BITS    = 8;
+s32 constexpr RADIX_BUCKETS = 1 << RADIX_BITS;
+
+struct Radix_Sort {
+  u64 *keys;
+  u32 *values;
+  u64 *out_keys;
+  u32 *out_values;
+  s32  shift;
+  s64 *offsets; // [batch][bucket]
+};
+
+// @Note: parallel_for may hand a job several batches (all of them on a single thread).
+
+void
+radix_count_job(void *data, s64 begin, s64 end) {
+  Radix_Sort const &sort = *(Radix_Sort*)data;
+
+  for (s64 batch = begin; batch < end; batch += BVH_PARALLEL_BATCH_SIZE) {
+    s64 const batch_end = (batch + BVH_PARALLEL_BATCH_SIZE < end) ? batch + BVH_PARALLEL_BATCH_SIZE : end;
+    s64      *counts    = sort.offsets + (batch/BVH_PARALLEL_BATCH_SIZE)*RADIX_BUCKETS;
+
+    for (s32 i = 0; i < RADIX_BUCKETS; i++) {
+      counts[i] = 0;
+    }
+    for (s64 i = batch; i < batch_end; i++) {
+      counts[(sort.keys[i] >> sort.shift) & (RADIX_BUCKETS - 1)]++;
+    }
+  }
+}
+
+void
+radix_scatter_job(void *data, s64 begin, s64 end) {
+  Radix_Sort const &sort = *(Radix_Sort*)data;
+
+  for (s64 batch = begin; batch < end; batch += BVH_PARALLEL_BATCH_SIZE) {
+    s64 const batch_end = (batch + BVH_PARALLEL_BATCH_SIZE < end) ? batch + BVH_PARALLEL_BATCH_SIZE : end;
+    s64      *offsets   = sort.offsets + (batch/BVH_PARALLEL_BATCH_SIZE)*RADIX_BUCKETS;
+
+    for (s64 i = batch; i < batch_end; i++) {
+      s64 const to = offsets[(sort.keys[i] >> sort.shift) & (RADIX_BUCKETS - 1)]++;
+      sort.out_keys[to]   = sort.keys[i];
+      sort.out_values[to] = sort.values[i];
+    }
+  }
+}
+
+// Sorts the low `bits` of the keys. Returns true if the result is in the temp arrays.
+[[nodiscard]] bool
+radix_sort(u64 *keys, u32 *values, u64 *temp_keys, u32 *temp_values, s64 count, s32 bits) {
+  s64 const batch_count = (count + BVH_PARALLEL_BATCH_SIZE - 1)/BVH_PARALLEL_BATCH_SIZE;
+
+  Radix_Sort sort = {
+    .keys       = keys,
+    .values     = values,
+    .out_keys   = temp_keys,
+    .out_values = temp_values,
+    .offsets    = (s64*)alloc_perm(batch_count*RADIX_BUCKETS*sizeof(s64))
+  };
+
+  bool swapped = false;
+  for (s32 shift = 0; shift < bits; shift += RADIX_BITS) {
+    sort.shift = shift;
+    parallel_for(count, BVH_PARALLEL_BATCH_SIZE, radix_count_job, &sort);
+
+    // Exclusive prefix sum, bucket-major so a bucket's batches stay in order.
+    s64  offset      = 0;
+    bool is_constant = false;
+    for (s32 bucket = 0; bucket < RADIX_BUCKETS; bucket++) {
+      s64 bucket_count = 0;
+      for (s64 batch = 0; batch < batch_count; batch++) {
+        s64      &slot = sort.offsets[batch*RADIX_BUCKETS + bucket];
+        s64 const n    = slot;
+        slot          = offset;
+        offset       += n;
+        bucket_count += n;
+      }
+      is_constant |= (bucket_count == count);
+    }
+
+    // @Note: every key has the same digit, the pass wouldn't move anything.
+    if (is_constant) {
+      continue;
+    }
+
+    parallel_for(count, BVH_PARALLEL_BATCH_SIZE, radix_scatter_job, &sort);
+
+    rt_swap(sort.keys, sort.out_keys);
+    rt_swap(sort.values, sort.out_values);
+    swapped = !swapped;
+  }
+
+  free_perm(sort.offsets);
+  return swapped;
+}
+
+/**
+ * Radix tree
+*/
+
+// Length of the common prefix of the keys at i and j, -1 if j is out of range. Equal
+// keys continue with the bits of the positions, so every key is unique.
+[[nodiscard]] s32
+common_prefix(Lbvh_Builder const &builder, s64 i, s64 j) {
+  if (j < 0 || j >= builder.count) {
+    return -1;
+  }
+
+  u64 const x = builder.keys[i] ^ builder.keys[j];
+  if (x == 0) {
+    return 32 + leading_zeros((u64)(i ^ j));
+  }
+  return leading_zeros(x);
+}
+
+void
+lbvh_radix_tree_job(void *data, s64 begin, s64 end) {
+  Lbvh_Builder &builder = *(Lbvh_Builder*)data;
+
+  for (s64 i = begin; i < end; i++) {
+    // Direction of the node's range: towards the neighbor with the longer prefix.
+    s32 const d          = (common_prefix(builder, i, i + 1) > common_prefix(builder, i, i - 1)) ? 1 : -1;
+    s32 const prefix_min = common_prefix(builder, i, i - d);
+
+    // Other end of the range: an upper bound by doubling, then a binary search.
+    s64 length_max = 2;
+    while (common_prefix(builder, i, i + length_max*d) > prefix_min) {
+      length_max *= 2;
+    }
+    s64 length = 0;
+    for (s64 t = length_max/2; t >= 1; t /= 2) {
+      if (common_prefix(builder, i, i + (length + t)*d) > prefix_min) {
+        length += t;
+      }
+    }
+    s64 const j = i + length*d;
+
+    // Split: the last position that shares more than the range's prefix with i.
+    s32 const prefix = common_prefix(builder, i, j);
+    s64 split = 0;
+    for (s64 t = length; t > 1;) {
+      t = (t + 1)/2;
+      if (common_prefix(builder, i, i + (split + t)*d) > prefix) {
+        split += t;
+      }
+    }
+    s64 const gamma = i + split*d + ((d < 0) ? -1 : 0);
+
+    s64 const first = (i < j) ? i : j;
+    s64 const last  = (i < j) ? j : i;
+
+    Lbvh_Node &node = builder.nodes[i];
+    node.children[0] = (first == gamma)     ? ~(s32)gamma       : (s32)gamma;
+    node.children[1] = (last == gamma + 1)  ? ~(s32)(gamma + 1) : (s32)(gamma + 1);
+    node.visits      = 0;
+
+    for (s32 c = 0; c < 2; c++) {
+      s32 const child = node.children[c];
+      if (child >= 0) {
+        builder.nodes[child].parent = (s32)i;
+      } else {
+        builder.leaf_parents[~child] = (s32)i;
+      }
+    }
+  }
+}
+
+/**
+ * Bottom-up pass
+*/
+
+[[nodiscard]] AABB
+child_bounds(Lbvh_Builder const &builder, s32 child) {
+  return (child >= 0) ? builder.nodes[child].bounds : builder.bounds[builder.primitives[~child]];
+}
+
+[[nodiscard]] f32
+child_cost(Lbvh_Builder const &builder, s32 child) {
+  return (child >= 0) ? builder.nodes[child].cost : surface_area(child_bounds(builder, child));
+}
+
+[[nodiscard]] s32
+child_primitive_count(Lbvh_Builder const &builder, s32 child) {
+  return (child >= 0) ? builder.nodes[child].primitive_count : 1;
+}
+
+[[nodiscard]] s32
+child_node_count(Lbvh_Builder const &builder, s32 child) {
+  return (child >= 0) ? builder.nodes[child].node_count : 1;
+}
+
+[[nodiscard]] s32
+child_height(Lbvh_Builder const &builder, s32 child) {
+  return (child >= 0) ? builder.nodes[child].height : 1;
+}
+
+// Sets everything but the topology from the children, collapsing the subtree into a
+// leaf when that is cheaper.
+void
+finish_lbvh_node(Lbvh_Builder &builder, s32 index) {
+  Lbvh_Node &node = builder.nodes[index];
+  s32 const left  = node.children[0];
+  s32 const right = node.children[1];
+
+  node.bounds          = aabb_union(child_bounds(builder, left), child_bounds(builder, right));
+  node.primitive_count = child_primitive_count(builder, left) + child_primitive_count(builder, right);
+
+  f32 const area       = surface_area(node.bounds);
+  f32 const split_cost = BVH_TRAVERSAL_COST*area + child_cost(builder, left) + child_cost(builder, right);
+  f32 const leaf_cost  = area*node.primitive_count;
+
+  if (node.primitive_count <= BVH_MAX_LEAF_SIZE && leaf_cost <= split_cost) {
+    node.cost       = leaf_cost;
+    node.node_count = 1;
+    node.height     = 1;
+  } else {
+    s32 const left_height  = child_height(builder, left);
+    s32 const right_height = child_height(builder, right);
+
+    node.cost       = split_cost;
+    node.node_count = 1 + child_node_count(builder, left) + child_node_count(builder, right);
+    node.height     = 1 + ((left_height > right_height) ? left_height : right_height);
+  }
+}
+
+s32 constexpr TREELET_SUBSETS = 1 << BVH_TREELET_LEAVES;
+
+struct Treelet {
+  s32 leaves[BVH_TREELET_LEAVES];
+  s32 interiors[BVH_TREELET_LEAVES - 1]; // interiors[0] is the root.
+  s32 leaf_count;
+  s32 interior_count;
+
+  f32 area[TREELET_SUBSETS];
+  f32 cost[TREELET_SUBSETS]; // Best topology of the subset, without collapsing.
+  u32 split[TREELET_SUBSETS];
+};
+
+// Cost of the current topology of the treelet, measured like Treelet::cost.
+[[nodiscard]] f32
+treelet_cost(Lbvh_Builder const &builder, Treelet const &treelet, s32 node) {
+  for (s32 i = 0; i < treelet.leaf_count; i++) {
+    if (treelet.leaves[i] == node) {
+      return child_cost(builder, node);
+    }
+  }
+
+  Lbvh_Node const &interior = builder.nodes[node];
+  return BVH_TRAVERSAL_COST*surface_area(interior.bounds) +
+         treelet_cost(builder, treelet, interior.children[0]) +
+         treelet_cost(builder, treelet, interior.children[1]);
+}
+
+// Rebuilds the interior nodes of subset `set` from the best splits, bottom-up.
+void
+restructure_treelet(Lbvh_Builder &builder, Treelet const &treelet, u32 set, s32 node,
+                    s32 &next_interior) {
+  u32 const sides[2] = {treelet.split[set], set & ~treelet.split[set]};
+  for (s32 side = 0; side < 2; side++) {
+    s32 child;
+    if (bit_count(sides[side]) == 1) {
+      s32 bit = 0;
+      while (!(sides[side] & (1u << bit))) {
+        bit++;
+      }
+      child = treelet.leaves[bit];
+    } else {
+      child = treelet.interiors[next_interior++];
+      restructure_treelet(builder, treelet, sides[side], child, next_interior);
+    }
+
+    builder.nodes[node].children[side] = child;
+    if (child >= 0) {
+      builder.nodes[child].parent = node;
+    } else {
+      builder.leaf_parents[~child] = node;
+    }
+  }
+
+  finish_lbvh_node(builder, node);
+}
+
+void
+optimize_treelet(Lbvh_Builder &builder, s32 root) {
+  Treelet treelet;
+  treelet.leaves[0]      = builder.nodes[root].children[0];
+  treelet.leaves[1]      = builder.nodes[root].children[1];
+  treelet.leaf_count     = 2;
+  treelet.interiors[0]   = root;
+  treelet.interior_count = 1;
+
+  // Grow the treelet by opening its biggest interior leaf, as long as there is one.
+  while (treelet.leaf_count < BVH_TREELET_LEAVES) {
+    s32 largest      = -1;
+    f32 largest_area = -1;
+    for (s32 i = 0; i < treelet.leaf_count; i++) {
+      s32 const leaf = treelet.leaves[i];
+      if (leaf >= 0 && surface_area(builder.nodes[leaf].bounds) > largest_area) {
+        largest      = i;
+        largest_area = surface_area(builder.nodes[leaf].bounds);
+      }
+    }
+    if (largest < 0) {
+      break;
+    }
+
+    Lbvh_Node const &opened = builder.nodes[treelet.leaves[largest]];
+    treelet.interiors[treelet.interior_count++] = treelet.leaves[largest];
+    treelet.leaves[largest]                     = opened.children[0];
+    treelet.leaves[treelet.leaf_count++]        = opened.children[1];
+  }
+
+  if (treelet.leaf_count < 3) {
+    return;
+  }
+
+  // @Note: a subset's proper subsets are smaller numbers, so increasing order solves
+  //        them first.
+  u32 const full = (1u << treelet.leaf_count) - 1;
+  for (u32 set = 1; set <= full; set++) {
+    AABB bounds = aabb_empty();
+    for (s32 i = 0; i < treelet.leaf_count; i++) {
+      if (set & (1u << i)) {
+        bounds = aabb_union(bounds, child_bounds(builder, treelet.leaves[i]));
+      }
+    }
+    treelet.area[set] = surface_area(bounds);
+
+    if (bit_count(set) == 1) {
+      s32 bit = 0;
+      while (!(set & (1u << bit))) {
+        bit++;
+      }
+      treelet.cost[set] = child_cost(builder, treelet.leaves[bit]);
+      continue;
+    }
+
+    // Every split once: the side with the lowest bit of the set.
+    u32 const lowest = set & (0u - set);
+    f32 best_cost  = FLT_MAX;
+    u32 best_split = 0;
+    for (u32 part = (set - 1) & set; part; part = (part - 1) & set) {
+      if (!(part & lowest)) {
+        continue;
+      }
+      f32 const cost = treelet.cost[part] + treelet.cost[set & ~part];
+      if (cost < best_cost) {
+        best_cost  = cost;
+        best_split = part;
+      }
+    }
+    treelet.cost[set]  = BVH_TRAVERSAL_COST*treelet.area[set] + best_cost;
+    treelet.split[set] = best_split;
+  }
+
+  if (treelet.cost[full] >= treelet_cost(builder, treelet, root)) {
+    return;
+  }
+
+  s32 next_interior = 1;
+  restructure_treelet(builder, treelet, full, root, next_interior);
+}
+
+void
+lbvh_bottom_up_job(void *data, s64 begin, s64 end) {
+  Lbvh_Builder &builder = *(Lbvh_Builder*)data;
+
+  for (s64 i = begin; i < end; i++) {
+    s32 node = builder.leaf_parents[i];
+    for (;;) {
+      // @Note: the first thread to get here stops, the other child isn't done yet.
+      //        The second one sees everything the first wrote (the add is a barrier).
+      if (atomic_add(builder.nodes[node].visits, 1) == 1) {
+        break;
+      }
+
+      finish_lbvh_node(builder, node);
+      if (builder.optimize_treelets &&
+          builder.nodes[node].primitive_count >= BVH_TREELET_MIN_SIZE) {
+        optimize_treelet(builder, node);
+      }
+
+      if (node == 0) {
+        break;
+      }
+      node = builder.nodes[node].parent;
+    }
+  }
+}
+
+/**
+ * Flattening
+*/
+
+// The radix tree of 63-bit codes (with the index as a tie breaker for equal codes) and
+// the treelet rotations aren't bounded to BVH_MAX_DEPTH levels. Like the SAH builder,
+// collapse whatever reaches the last level into a leaf. Only the paths that are too
+// deep are walked. Returns false if a leaf would get more than 0xFFFF primitives.
+[[nodiscard]] bool
+cap_lbvh_depth(Lbvh_Builder &builder, s32 child, s32 depth) {
+  if (child < 0) {
+    return true;
+  }
+
+  Lbvh_Node &node = builder.nodes[child];
+  if (depth + node.height <= BVH_MAX_DEPTH) {
+    return true;
+  }
+
+  if (depth >= BVH_MAX_DEPTH - 1) {
+    node.node_count = 1;
+    node.height     = 1;
+    return node.primitive_count <= 0xFFFF;
+  }
+
+  s32 const left  = node.children[0];
+  s32 const right = node.children[1];
+  if (!cap_lbvh_depth(builder, left, depth + 1) || !cap_lbvh_depth(builder, right, depth + 1)) {
+    return false;
+  }
+
+  s32 const left_height  = child_height(builder, left);
+  s32 const right_height = child_height(builder, right);
+  node.node_count = 1 + child_node_count(builder, left) + child_node_count(builder, right);
+  node.height     = 1 + ((left_height > right_height) ? left_height : right_height);
+  return true;
+}
+
+struct Lbvh_Place {
+  Lbvh_Builder *builder;
+  s32           child;
+  s32           first_node;
+  s32           first_primitive;
+  s32           depth;
+};
+
+// Writes the primitives of a collapsed subtree.
+[[nodiscard]] s32
+gather_lbvh_primitives(Lbvh_Builder &builder, s32 child, u32 *out) {
+  if (child < 0) {
+    *out = builder.primitives[~child];
+    return 1;
+  }
+
+  Lbvh_Node const &node = builder.nodes[child];
+  s32 const left_count = gather_lbvh_primitives(builder, node.children[0], out);
+  return left_count + gather_lbvh_primitives(builder, node.children[1], out + left_count);
+}
+
+void
+place_lbvh_node(void *data) {
+  Lbvh_Place const &place   = *(Lbvh_Place*)data;
+  Lbvh_Builder     &builder = *place.builder;
+  Bvh              &bvh     = *builder.bvh;
+
+  s64 leaf_count = 0;
+  s64 max_depth  = 0;
+
+  // @Note: iterates down the left children and recurses (or spawns a job) for the
+  //        right ones.
+  s32 child           = place.child;
+  s32 first_node      = place.first_node;
+  s32 first_primitive = place.first_primitive;
+  s32 depth           = place.depth;
+
+  Lbvh_Place  right_places[BVH_MAX_DEPTH];
+  s32         right_count = 0;
+  Job_Counter counter     = {};
+
+  for (;;) {
+    dbg_check_(depth < BVH_MAX_DEPTH); // See cap_lbvh_depth.
+    max_depth = (depth > max_depth) ? depth : max_depth;
+
+    if (child < 0 || builder.nodes[child].node_count == 1) {
+      s32 const count = gather_lbvh_primitives(builder, child, bvh.primitives + first_primitive);
+      bvh.nodes[first_node] = {
+        .bounds = child_bounds(builder, child),
+        .offset = (u32)first_primitive,
+        .count  = (u16)count
+      };
+      leaf_count++;
+      break;
+    }
+
+    Lbvh_Node const &node = builder.nodes[child];
+    s32 left  = node.children[0];
+    s32 right = node.children[1];
+
+    // The traversal expects the lower centroids on the left of the split axis, so the
+    // axis is the one that separates the children the most.
+    Vec3 const offset = center(child_bounds(builder, right)) - center(child_bounds(builder, left));
+    s32  axis         = 0;
+    for (s32 i = 1; i < 3; i++) {
+      axis = (std::abs(offset.v[i]) > std::abs(offset.v[axis])) ? i : axis;
+    }
+    if (offset.v[axis] < 0) {
+      rt_swap(left, right);
+    }
+
+    s32 const right_first = first_node + 1 + child_node_count(builder, left);
+    bvh.nodes[first_node] = {
+      .bounds = node.bounds,
+      .offset = (u32)right_first,
+      .count  = 0,
+      .axis   = (u16)axis
+    };
+
+    Lbvh_Place const right_place = {
+      .builder         = &builder,
+      .child           = right,
+      .first_node      = right_first,
+      .first_primitive = first_primitive + child_primitive_count(builder, left),
+      .depth           = depth + 1
+    };
+    if (child_primitive_count(builder, right) > BVH_PARALLEL_SUBTREE_SIZE) {
+      right_places[right_count] = right_place;
+      Job const job = {.fn = place_lbvh_node, .data = &right_places[right_count]};
+      right_count++;
+      submit_jobs(&job, 1, counter);
+    } else {
+      Lbvh_Place serial = right_place;
+      place_lbvh_node(&serial);
+    }
+
+    child       = left;
+    first_node += 1;
+    depth      += 1;
+  }
+
+  wait_for_jobs(counter);
+
+  atomic_add(builder.leaf_count, leaf_count);
+  for (;;) {
+    s64 const current = atomic_load(builder.max_depth);
+    if (current >= max_depth || atomic_compare_exchange(builder.max_depth, current, max_depth)) {
+      break;
+    }
+  }
+}
+} // namespace impl
+
+[[nodiscard]] Bvh
+bvh_build_lbvh(AABB const *bounds, s32 count, bool optimize_treelets, Bvh_Build_Stats *stats) {
+  check_(count > 0);
+
+  f64 const start = os_get_app_uptime_precise();
+
+  s64 const batch_count = (count + BVH_PARALLEL_BATCH_SIZE - 1)/BVH_PARALLEL_BATCH_SIZE;
+  s64 const interiors   = (count > 1) ? count - 1 : 1;
+
+  Arena scratch = arena_create(count*(sizeof(Vec3) + 2*sizeof(u64) + 2*sizeof(u32) + sizeof(s32)) +
+                               interiors*sizeof(impl::Lbvh_Node) + batch_count*sizeof(AABB) + 256);
+
+  impl::Lbvh_Builder builder = {
+    .bounds            = bounds,
+    .count             = count,
+    .optimize_treelets = optimize_treelets,
+    .centroids         = (Vec3*)arena_alloc(scratch, count*sizeof(Vec3)),
+    .morton_bits       = (count <= BVH_LBVH_MORTON30_MAX) ? 30 : 63,
+    .keys              = (u64*)arena_alloc(scratch, count*sizeof(u64)),
+    .primitives        = (u32*)arena_alloc(scratch, count*sizeof(u32)),
+    .nodes             = (impl::Lbvh_Node*)arena_alloc(scratch, interiors*sizeof(impl::Lbvh_Node)),
+    .leaf_parents      = (s32*)arena_alloc(scratch, count*sizeof(s32))
+  };
+
+  impl::Lbvh_Bounds_Pass bounds_pass = {
+    .builder  = &builder,
+    .partials = (AABB*)arena_alloc(scratch, batch_count*sizeof(AABB))
+  };
+  for (s64 i = 0; i < batch_count; i++) {
+    bounds_pass.partials[i] = aabb_empty();
+  }
+  parallel_for(count, BVH_PARALLEL_BATCH_SIZE, impl::lbvh_centroids_job, &bounds_pass);
+
+  builder.centroid_bounds = aabb_empty();
+  for (s64 i = 0; i < batch_count; i++) {
+    builder.centroid_bounds = aabb_union(builder.centroid_bounds, bounds_pass.partials[i]);
+  }
+
+  parallel_for(count, BVH_PARALLEL_BATCH_SIZE, impl::lbvh_morton_job, &builder);
+
+  u64 *temp_keys   = (u64*)arena_alloc(scratch, count*sizeof(u64));
+  u32 *temp_values = (u32*)arena_alloc(scratch, count*sizeof(u32));
+  if (impl::radix_sort(builder.keys, builder.primitives, temp_keys, temp_values, count,
+                       builder.morton_bits)) {
+    builder.keys       = temp_keys;
+    builder.primitives = temp_values;
+  }
+
+  // @Note: the worst case size. Collapsed leaves make the tree smaller.
+  s64 const max_nodes = 2*(s64)count - 1;
+
+  Bvh bvh = {};
+  bvh.arena           = arena_create(max_nodes*sizeof(Bvh_Node) + count*sizeof(u32) + 64);
+  bvh.nodes           = (Bvh_Node*)arena_alloc(bvh.arena, max_nodes*sizeof(Bvh_Node), 64);
+  bvh.primitives      = (u32*)arena_alloc(bvh.arena, count*sizeof(u32));
+  bvh.primitive_count = count;
+  builder.bvh         = &bvh;
+
+  impl::Lbvh_Place root = {.builder = &builder, .child = ~0};
+  if (count > 1) {
+    parallel_for(count - 1, BVH_PARALLEL_BATCH_SIZE, impl::lbvh_radix_tree_job, &builder);
+    parallel_for(count, BVH_PARALLEL_BATCH_SIZE, impl::lbvh_bottom_up_job, &builder);
+    root.child = 0;
+
+    if (!impl::cap_lbvh_depth(builder, root.child, 0)) {
+      logf("LBVH over %d primitives: a leaf at depth %d would be too big, not built\n",
+           count, BVH_MAX_DEPTH - 1);
+      arena_destroy(scratch);
+      bvh_destroy(bvh);
+      if (stats) {
+        *stats = {.seconds = os_get_app_uptime_precise() - start};
+      }
+      return bvh;
+    }
+  }
+  impl::place_lbvh_node(&root);
+  bvh.node_count = impl::child_node_count(builder, root.child);
+
+  arena_destroy(scratch);
+
+  if (stats) {
+    *stats = {
+      .seconds    = os_get_app_uptime_precise() - start,
+      .node_count = bvh.node_count,
+      .leaf_count = (s32)builder.leaf_count,
+      .max_depth  = (s32)builder.max_depth,
+      .sah_cost   = bvh_sah_cost(bvh)
+    };
+  }
+
+  return bvh;
+}
+} // namespace rt
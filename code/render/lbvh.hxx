@@ -0,0 +1,23 @@
+/**
+ * Linear BVH builder, for geometry that moves every frame: a tree that is a bit worse
+ * than a SAH one is cheaper than a slow rebuild.
+ *
+ * The centroids are sorted along a Morton curve (30-bit codes for up to
+ * BVH_LBVH_MORTON30_MAX primitives, 63-bit above, a radix sort on the job system)
+ * and the tree is the binary radix tree of the codes (Karras 2012): every interior
+ * node splits at the highest bit that differs in its range, and all of them are found
+ * in parallel. The bounds go bottom-up, the second thread to reach a node finishes it.
+ * On the way up subtrees that are cheaper as a leaf are collapsed, and optionally the
+ * treelets of BVH_TREELET_LEAVES nodes under big nodes are rebuilt in their optimal
+ * SAH topology (Karras and Aila 2013).
+ *
+ * The result is the same depth-first Bvh as bvh_build's, traversed the same way.
+*/
+
+namespace rt {
+// Like bvh_build, but returns an empty Bvh (node_count 0) if the tree is so deep that
+// capping it at BVH_MAX_DEPTH would need a leaf of more than 0xFFFF primitives.
+[[nodiscard]] Bvh
+bvh_build_lbvh(AABB const *bounds, s32 count, bool optimize_treelets,
+               Bvh_Build_Stats *stats = NULL);
+} // namespace rt
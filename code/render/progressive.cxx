@@ -0,0 +1,126 @@
+namespace rt {
+[[nodiscard]] Progressive_Render
+progressive_create(s32 width, s32 height, Render_Settings const &settings, f32 budget) {
+  check_(budget > 0);
+
+  Progressive_Render render = {
+    .fb          = framebuffer_create(width, height),
+    .settings    = settings,
+    .budget      = budget,
+    .parallelism = (f64)jobs_thread_count()
+  };
+  render.tile_seconds = (f32*)alloc_perm(render_tile_count(render.fb)*sizeof(f32));
+  return render;
+}
+
+void
+progressive_destroy(Progressive_Render &render) {
+  free_perm(render.tile_seconds);
+  framebuffer_destroy(render.fb);
+  render = {};
+}
+
+void
+progressive_reset(Progressive_Render &render) {
+  framebuffer_clear(render.fb);
+  render.pass        = 0;
+  render.tile_cursor = 0;
+
+  // @Note: the tile costs are kept. A moved camera renders about as fast as before,
+  //        and the first steps after a reset are the ones that must not stall.
+}
+
+Render_Stats
+progressive_step(Progressive_Render &render, Scene const &scene, Camera const &camera) {
+  if (mem_comp_(&camera, &render.camera, sizeof(Camera)) != 0) {
+    render.camera = camera;
+    progressive_reset(render);
+  }
+
+  if (render.pass >= (u32)RENDER_PROGRESSIVE_MAX_SPP) {
+    render.tile_samples_per_step = 0;
+    return {};
+  }
+
+  s32 const tile_count   = render_tile_count(render.fb);
+  s32 const thread_count = jobs_thread_count();
+
+  // @Note: tiles that were never rendered are assumed to cost as much as the last run.
+  //        Runs go row by row and neighboring tiles cost about the same, the average
+  //        over the image is a worse guess (the first rows are often just sky).
+  f64 pass_seconds = 0;
+  s32 known_count  = 0;
+  for (s32 i = 0; i < tile_count; i++) {
+    pass_seconds += render.tile_seconds[i];
+    known_count  += (render.tile_seconds[i] > 0);
+  }
+  f64 const unknown_seconds = render.last_run_seconds;
+  pass_seconds += (tile_count - known_count)*unknown_seconds;
+  f64 const budget = render.budget*render.parallelism;
+
+  s32 const first_tile = render.tile_cursor;
+  s32 run_length       = 0;
+  s32 sample_count     = 1;
+
+  if (unknown_seconds == 0) {
+    // @Note: nothing measured yet. A tile per thread costs as much as a single one.
+    s32 const tiles_left = tile_count - first_tile;
+    run_length = (thread_count < tiles_left) ? thread_count : tiles_left;
+  } else if (first_tile == 0 && pass_seconds <= budget) {
+    // Whole passes.
+    s64       passes      = (s64)(budget/pass_seconds);
+    s64 const passes_left = (s64)RENDER_PROGRESSIVE_MAX_SPP - render.pass;
+    passes = (passes < passes_left) ? passes : passes_left;
+
+    run_length   = tile_count;
+    sample_count = (s32)passes;
+  } else {
+    // A run of tiles of the pass in progress. At least one tile per thread, see above.
+    f64 seconds = 0;
+    for (s32 i = first_tile; i < tile_count; i++) {
+      seconds += (render.tile_seconds[i] > 0) ? render.tile_seconds[i] : unknown_seconds;
+      if (seconds > budget && run_length >= thread_count) {
+        break;
+      }
+      run_length++;
+    }
+  }
+
+  f32 *tile_seconds = render.tile_seconds + first_tile;
+  Render_Stats const stats = render_tiles(render.fb, scene, render.camera, render.settings,
+                                          first_tile, run_length, render.pass, sample_count,
+                                          tile_seconds);
+
+  f64 thread_seconds = 0;
+  for (s32 i = 0; i < run_length; i++) {
+    thread_seconds  += tile_seconds[i];
+    tile_seconds[i] /= sample_count;
+  }
+  render.last_run_seconds = thread_seconds/((f64)run_length*sample_count);
+
+  // @Note: how many threads actually worked in parallel. It's below the thread count
+  //        if the tiles ran out before the threads did, or if something else runs.
+  if (stats.seconds > 0) {
+    f64 const parallelism = thread_seconds/stats.seconds;
+    render.parallelism = 0.8*render.parallelism + 0.2*parallelism;
+  }
+
+  if (run_length == tile_count) {
+    render.pass += (u32)sample_count;
+  } else {
+    render.tile_cursor += run_length;
+    if (render.tile_cursor == tile_count) {
+      render.tile_cursor = 0;
+      render.pass++;
+    }
+  }
+  render.tile_samples_per_step = (s64)run_length*sample_count;
+
+  return stats;
+}
+
+[[nodiscard]] f32
+progressive_samples_per_pixel(Progressive_Render const &render) {
+  return render.pass + (f32)render.tile_cursor/render_tile_count(render.fb);
+}
+} // namespace rt
@@ -0,0 +1,48 @@
+/**
+ * Progressive rendering for the interactive view. Every step adds samples to a
+ * persistent framebuffer, so the image converges over the frames, and starts over when
+ * the camera changes.
+ *
+ * A step does as much work as fits in the time budget. Tiles differ a lot in cost, so
+ * the time of one sample is remembered for every tile, and a step adds up the tiles it
+ * is going to render. When a whole pass over the image doesn't fit, a step renders a
+ * run of tiles and the next one continues where it stopped -- pixels may have different
+ * sample counts for a while, which the framebuffer handles.
+*/
+
+namespace rt {
+struct Progressive_Render {
+  Framebuffer     fb;
+  Render_Settings settings; // samples_per_pixel is ignored, the budget decides.
+  Camera          camera;   // Of the image in `fb`.
+  f32             budget;   // Seconds per step.
+
+  u32 pass;        // Sample index of the pass in progress.
+  s32 tile_cursor; // First tile of the pass in progress that has no sample yet.
+
+  f32 *tile_seconds;     // One sample over the tile, last time it was rendered. 0 if never.
+  f64  last_run_seconds; // One sample over a tile, on average, in the last step.
+  f64  parallelism;      // Tile seconds per second of a step, smoothed over the last steps.
+
+  s64 tile_samples_per_step; // Work done by the last step.
+};
+
+[[nodiscard]] Progressive_Render
+progressive_create(s32 width, s32 height, Render_Settings const &settings, f32 budget);
+
+void
+progressive_destroy(Progressive_Render &render);
+
+// Throws the samples away. Call it when the scene changes.
+void
+progressive_reset(Progressive_Render &render);
+
+// Adds the samples that fit in the budget. Resets first if `camera` isn't the camera
+// of the image. Does nothing once RENDER_PROGRESSIVE_MAX_SPP passes are done.
+Render_Stats
+progressive_step(Progressive_Render &render, Scene const &scene, Camera const &camera);
+
+// Samples per pixel, counting the pass in progress as a fraction.
+[[nodiscard]] f32
+progressive_samples_per_pixel(Progressive_Render const &render);
+} // namespace rt
@@ -0,0 +1,350 @@
+namespace rt {
+namespace impl {
+template <s32 N>
+struct Quantized_Bvh_Builder {
+  Bvh const *bvh; // Input.
+
+  Quantized_Bvh_Node<N> *nodes;
+  u32                   *sources;
+  u32                   *primitives;
+  s32                    node_count;
+  s32                    primitive_count;
+  s32                    leaf_count;
+  s32                    max_depth;
+};
+
+// 2^e as a float, for normal results.
+[[nodiscard]] f32
+exp2_int(s32 e) {
+  dbg_check_(e >= -126 && e <= 127);
+
+  u32 const bits = (u32)(e + 127) << 23;
+  f32 x;
+  mem_copy_(&x, &bits, sizeof(x));
+  return x;
+}
+
+// Smallest exponent for which 255 steps from `min` reach `max`, in float arithmetic,
+// which is what the traversal does.
+[[nodiscard]] s32
+quantization_exponent(f32 min, f32 max) {
+  s32 e = -126;
+  if (max > min) {
+    (void)std::frexp(max - min, &e); // max - min = m*2^e, 0.5 <= m < 1. 255 ~ 2^8.
+    e -= 8;
+    e  = (e > -126) ? e : -126;
+    e  = (e < 127) ? e : 127;
+  }
+
+  while (e < 127 && min + 255*exp2_int(e) < max) {
+    e++;
+  }
+  while (e > -126 && min + 255*exp2_int(e - 1) >= max) {
+    e--;
+  }
+  return e;
+}
+
+// Sets the origin, the exponents and the quantized child bounds. Empty boxes are
+// empty slots.
+template <s32 N>
+void
+quantize_bvh_node(Quantized_Bvh_Node<N> &node, AABB const (&bounds)[N]) {
+  AABB box = aabb_empty();
+  for (s32 i = 0; i < N; i++) {
+    box = aabb_union(box, bounds[i]);
+  }
+  node.origin = box.min;
+
+  u8 *q_min[3] = {node.q_min_x, node.q_min_y, node.q_min_z};
+  u8 *q_max[3] = {node.q_max_x, node.q_max_y, node.q_max_z};
+  for (s32 axis = 0; axis < 3; axis++) {
+    f32 const origin   = box.min.v[axis];
+    s32 const exponent = quantization_exponent(origin, box.max.v[axis]);
+    f32 const scale    = exp2_int(exponent);
+    node.exponents[axis] = (s8)exponent;
+
+    // @Note: origin + q*scale is rounded once (q*scale is exact), the loops make sure
+    //        it's on the outside of the child's box after that.
+    for (s32 i = 0; i < N; i++) {
+      if (is_empty(bounds[i])) {
+        q_min[axis][i] = 255;
+        q_max[axis][i] = 0;
+        continue;
+      }
+
+      f32 const min = bounds[i].min.v[axis];
+      f32 const max = bounds[i].max.v[axis];
+
+      s32 lo = (s32)std::floor((min - origin)/scale);
+      s32 hi = (s32)std::ceil((max - origin)/scale);
+      lo = (lo > 0) ? lo : 0;
+      lo = (lo < 255) ? lo : 255;
+      hi = (hi > 0) ? hi : 0;
+      hi = (hi < 255) ? hi : 255;
+      while (lo > 0 && origin + (f32)lo*scale > min) {
+        lo--;
+      }
+      while (hi < 255 && origin + (f32)hi*scale < max) {
+        hi++;
+      }
+
+      q_min[axis][i] = (u8)lo;
+      q_max[axis][i] = (u8)hi;
+    }
+  }
+}
+
+// `binary_index` is the binary node the quantized node at `node_index` replaces.
+template <s32 N>
+void
+build_quantized_bvh_node(Quantized_Bvh_Builder<N> &builder, u32 binary_index,
+                         s32 node_index, s32 depth) {
+  Bvh_Node const *binary = builder.bvh->nodes;
+  builder.max_depth = (depth > builder.max_depth) ? depth : builder.max_depth;
+
+  u32       children[N];
+  s32 const child_count = collapse_bvh_node(*builder.bvh, binary_index, children);
+
+  Quantized_Bvh_Node<N> &node    = builder.nodes[node_index];
+  u32                   *sources = builder.sources + (s64)node_index*N;
+
+  AABB bounds[N];
+  for (s32 i = 0; i < N; i++) {
+    bool const used = i < child_count;
+    bounds[i]  = used ? binary[children[i]].bounds : aabb_empty();
+    sources[i] = used ? children[i] : ~0u;
+  }
+  quantize_bvh_node(node, bounds);
+
+  node.inner_mask     = 0;
+  node.child_base     = (u32)builder.node_count;
+  node.primitive_base = (u32)builder.primitive_count;
+  for (s32 i = 0; i < N; i++) {
+    node.counts[i] = 0;
+  }
+
+  // @Note: the child nodes are reserved before any of them is built, so they end up
+  //        next to each other.
+  for (s32 i = 0; i < child_count; i++) {
+    Bvh_Node const &child = binary[children[i]];
+    if (child.count > 0) {
+      dbg_check_(child.count <= 255);
+      mem_copy_(builder.primitives + builder.primitive_count,
+                builder.bvh->primitives + child.offset, child.count*sizeof(u32));
+      builder.primitive_count += child.count;
+      builder.leaf_count++;
+      node.counts[i] = (u8)child.count;
+    } else {
+      node.inner_mask |= (u8)(1u << i);
+      builder.node_count++;
+    }
+  }
+
+  s32 child_index = (s32)node.child_base;
+  for (s32 i = 0; i < child_count; i++) {
+    if (node.inner_mask & (1u << i)) {
+      build_quantized_bvh_node(builder, children[i], child_index++, depth + 1);
+    }
+  }
+}
+} // namespace impl
+
+template <s32 N>
+[[nodiscard]] Quantized_Bvh<N>
+quantized_bvh_build(Bvh const &bvh, Bvh_Build_Stats *stats) {
+  f64 const start = os_get_app_uptime_precise();
+
+  // @Note: a leaf count is a byte. Bigger leaves only come from capping the depth.
+  bool fits = bvh.node_count > 0;
+  for (s32 i = 0; fits && i < bvh.node_count; i++) {
+    fits = bvh.nodes[i].count <= 255;
+  }
+
+  Quantized_Bvh<N> result = {};
+  if (!fits) {
+    if (stats) {
+      *stats = {};
+    }
+    return result;
+  }
+
+  // @Note: as many nodes as in a Wide_Bvh at most, see wide_bvh_build.
+  s64 const node_capacity = bvh.node_count;
+  result.arena = arena_create(node_capacity*sizeof(Quantized_Bvh_Node<N>) + 64 +
+                              node_capacity*N*sizeof(u32) + 16 +
+                              bvh.primitive_count*sizeof(u32) + 16);
+
+  impl::Quantized_Bvh_Builder<N> builder = {
+    .bvh        = &bvh,
+    .nodes      = (Quantized_Bvh_Node<N>*)arena_alloc(result.arena,
+                                                      node_capacity*sizeof(Quantized_Bvh_Node<N>), 64),
+    .sources    = (u32*)arena_alloc(result.arena, node_capacity*N*sizeof(u32)),
+    .primitives = (u32*)arena_alloc(result.arena, bvh.primitive_count*sizeof(u32)),
+    .node_count = 1
+  };
+  impl::build_quantized_bvh_node(builder, 0, 0, 1);
+  dbg_check_(builder.primitive_count == bvh.primitive_count);
+
+  result.nodes           = builder.nodes;
+  result.node_count      = builder.node_count;
+  result.primitives      = builder.primitives;
+  result.primitive_count = builder.primitive_count;
+  result.sources         = builder.sources;
+
+  if (stats) {
+    *stats = {
+      .seconds    = os_get_app_uptime_precise() - start,
+      .node_count = builder.node_count,
+      .leaf_count = builder.leaf_count,
+      .max_depth  = builder.max_depth,
+      .sah_cost   = 0
+    };
+  }
+  return result;
+}
+
+template <s32 N>
+void
+quantized_bvh_refit(Quantized_Bvh<N> &bvh, Bvh const &binary) {
+  for (s32 i = 0; i < bvh.node_count; i++) {
+    u32 const *sources = bvh.sources + (s64)i*N;
+
+    AABB bounds[N];
+    for (s32 j = 0; j < N; j++) {
+      bounds[j] = (sources[j] != ~0u) ? binary.nodes[sources[j]].bounds : aabb_empty();
+    }
+    impl::quantize_bvh_node(bvh.nodes[i], bounds);
+  }
+}
+
+template <s32 N>
+void
+quantized_bvh_destroy(Quantized_Bvh<N> &bvh) {
+  arena_destroy(bvh.arena);
+  bvh = {};
+}
+
+template <s32 N, typename TIntersect>
+[[nodiscard]] bool
+quantized_bvh_intersect(Quantized_Bvh<N> const &bvh, Ray const &ray, f32 t_min, f32 &t_max,
+                        TIntersect &&intersect_primitive) {
+  static_assert(N == 4 || N == 8);
+
+  if (bvh.node_count == 0) {
+    return false;
+  }
+
+  // A node or a leaf to visit, and where the ray enters it.
+  struct Entry {
+    f32 t;
+    u32 child;
+    u32 count; // 0 for nodes.
+  };
+
+  // @Note: a node pushes all but the nearest of its children.
+  Entry stack[BVH_MAX_DEPTH*(N - 1)];
+  s32   stack_size = 0;
+  Entry current    = {.t = t_min, .child = 0, .count = 0};
+  bool  hit        = false;
+
+  for (;;) {
+    if (current.count == 0) {
+      Quantized_Bvh_Node<N> const &node = bvh.nodes[current.child];
+
+      Vec3 const scale = {
+        .x = impl::exp2_int(node.exponents[0]),
+        .y = impl::exp2_int(node.exponents[1]),
+        .z = impl::exp2_int(node.exponents[2])
+      };
+
+      alignas(32) f32 entries[N];
+      u32 mask;
+      if constexpr (N == 4) {
+        Vec3x4 const origin = vec3x4(node.origin);
+        Vec3x4 const step   = vec3x4(scale);
+        AABBx4 const boxes  = {
+          .min = {
+            fmadd(load_u8_f32x4(node.q_min_x), step.x, origin.x),
+            fmadd(load_u8_f32x4(node.q_min_y), step.y, origin.y),
+            fmadd(load_u8_f32x4(node.q_min_z), step.z, origin.z)
+          },
+          .max = {
+            fmadd(load_u8_f32x4(node.q_max_x), step.x, origin.x),
+            fmadd(load_u8_f32x4(node.q_max_y), step.y, origin.y),
+            fmadd(load_u8_f32x4(node.q_max_z), step.z, origin.z)
+          }
+        };
+        F32x4 t_entry;
+        mask = to_bits(intersect(ray, boxes, t_min, t_max, t_entry));
+        store(entries, t_entry);
+      } else {
+        Vec3x8 const origin = vec3x8(node.origin);
+        Vec3x8 const step   = vec3x8(scale);
+        AABBx8 const boxes  = {
+          .min = {
+            fmadd(load_u8_f32x8(node.q_min_x), step.x, origin.x),
+            fmadd(load_u8_f32x8(node.q_min_y), step.y, origin.y),
+            fmadd(load_u8_f32x8(node.q_min_z), step.z, origin.z)
+          },
+          .max = {
+            fmadd(load_u8_f32x8(node.q_max_x), step.x, origin.x),
+            fmadd(load_u8_f32x8(node.q_max_y), step.y, origin.y),
+            fmadd(load_u8_f32x8(node.q_max_z), step.z, origin.z)
+          }
+        };
+        F32x8 t_entry;
+        mask = to_bits(intersect(ray, boxes, t_min, t_max, t_entry));
+        store(entries, t_entry);
+      }
+
+      // Insertion sort of the hit children, nearest first.
+      Entry hits[N];
+      s32   hit_count = 0;
+      for (unsigned long i = 0; _BitScanForward(&i, mask); mask &= mask - 1) {
+        Entry entry = {.t = entries[i]};
+        if (node.inner_mask & (1u << i)) {
+          entry.child = node.child_base + (u32)impl::bit_count(node.inner_mask & ((1u << i) - 1));
+          entry.count = 0;
+        } else if (node.counts[i] > 0) {
+          entry.child = node.primitive_base;
+          for (u32 j = 0; j < i; j++) {
+            entry.child += node.counts[j];
+          }
+          entry.count = node.counts[i];
+        } else {
+          // @Note: an inverted box is only hit in corner cases (a ray on its plane
+          //        with t_max = inf), but an empty slot must never be visited.
+          continue;
+        }
+
+        s32 j = hit_count++;
+        for (; j > 0 && hits[j - 1].t > entry.t; j--) {
+          hits[j] = hits[j - 1];
+        }
+        hits[j] = entry;
+      }
+
+      if (hit_count > 0) {
+        for (s32 i = hit_count - 1; i > 0; i--) {
+          stack[stack_size++] = hits[i];
+        }
+        current = hits[0];
+        continue;
+      }
+    } else {
+      for (u32 i = 0; i < current.count; i++) {
+        hit |= intersect_primitive(bvh.primitives[current.child + i], t_min, t_max);
+      }
+    }
+
+    // The next entry that isn't behind the closest hit.
+    do {
+      if (stack_size == 0) {
+        return hit;
+      }
+      current = stack[--stack_size];
+    } while (current.t > t_max);
+  }
+}
+} // namespace rt
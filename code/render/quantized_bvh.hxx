@@ -0,0 +1,78 @@
+/**
+ * Wide BVHs with quantized child bounds: traversal of a tree that doesn't fit in the
+ * caches is bound by memory, and smaller nodes mean fewer cache misses.
+ *
+ * A node stores its own box as an origin and a power-of-two scale per axis (the
+ * smallest one for which 255 steps cover the box), and the bounds of its children as
+ * bytes on that grid, rounded outwards so no ray misses a child it should hit.
+ * Traversal converts them back to floats right before the wide slab test, exactly: a
+ * byte times a power of two needs no rounding. The child nodes of a node are stored
+ * next to each other, as are the primitives of its leaf children, so one index of
+ * each replaces the per-child ones.
+ *
+ * A BVH4 node is 64 bytes and a BVH8 one 80, against 128 and 256 in wide_bvh.hxx: the
+ * BVH4 nodes only take half the memory, the BVH8 ones 3.2 times less. The node array
+ * starts on a cache line, so a BVH4 node is exactly one line. A BVH8 node always spans
+ * two, and padding it to 128 bytes wouldn't change that: it would only spread the tree
+ * over 1.6 times more lines, which is what we are trying to avoid. So it's packed on 16
+ * bytes instead, and siblings, which are visited together, share their lines.
+ * The tree is collapsed from a binary Bvh like a Wide_Bvh, straight into the quantized
+ * nodes. The BVH8 traversal needs AVX2.
+*/
+
+namespace rt {
+template <s32 N>
+struct alignas(N == 4 ? 64 : 16) Quantized_Bvh_Node {
+  Vec3 origin;       // Min corner of the node's box.
+  s8   exponents[3]; // A child's bounds are origin + q*2^exponent, per axis.
+  u8   inner_mask;   // Bit i is set if child i is a node.
+
+  u32 child_base;     // Index of the first child node, the others follow in slot order.
+  u32 primitive_base; // First entry in Quantized_Bvh::primitives of the leaf children, in slot order.
+  u8  counts[N];      // Primitives in a leaf child. 0 for child nodes and empty slots.
+
+  // Rounded down and up. Empty slots have min 255 and max 0.
+  u8 q_min_x[N], q_min_y[N], q_min_z[N];
+  u8 q_max_x[N], q_max_y[N], q_max_z[N];
+};
+static_assert(sizeof(Quantized_Bvh_Node<4>) == 64);
+static_assert(sizeof(Quantized_Bvh_Node<8>) == 80);
+
+template <s32 N>
+struct Quantized_Bvh {
+  Arena arena; // Holds the nodes, the primitive indices and the sources.
+
+  Quantized_Bvh_Node<N> *nodes;
+  s32                    node_count;
+
+  u32 *primitives; // In the order of the leaves, which isn't the binary tree's.
+  s32  primitive_count;
+
+  u32 *sources; // N per node: the binary node of every child, ~0u for empty slots.
+};
+
+using Quantized_Bvh4 = Quantized_Bvh<4>;
+using Quantized_Bvh8 = Quantized_Bvh<8>;
+
+// `stats` is optional, its SAH cost is left at 0. Returns an empty tree (node_count 0)
+// if a leaf of `bvh` has more than 255 primitives.
+template <s32 N>
+[[nodiscard]] Quantized_Bvh<N>
+quantized_bvh_build(Bvh const &bvh, Bvh_Build_Stats *stats = NULL);
+
+// Quantizes the bounds of the binary tree `bvh` was collapsed from again, after it was
+// refit.
+template <s32 N>
+void
+quantized_bvh_refit(Quantized_Bvh<N> &bvh, Bvh const &binary);
+
+template <s32 N>
+void
+quantized_bvh_destroy(Quantized_Bvh<N> &bvh);
+
+// Same contract as bvh_intersect.
+template <s32 N, typename TIntersect>
+[[nodiscard]] bool
+quantized_bvh_intersect(Quantized_Bvh<N> const &bvh, Ray const &ray, f32 t_min, f32 &t_max,
+                        TIntersect &&intersect_primitive);
+} // namespace rt
@@ -0,0 +1,11 @@
+#include "camera.cxx"
+#include "bvh.cxx"
+#include "lbvh.cxx"
+#include "bvh_refit.cxx"
+#include "wide_bvh.cxx"
+#include "quantized_bvh.cxx"
+#include "scene.cxx"
+#include "framebuffer.cxx"
+#include "tracer.cxx"
+#include "progressive.cxx"
+#include "bvh_bench.cxx"
\ No newline at end of file
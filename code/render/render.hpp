@@ -0,0 +1,11 @@
+#include "camera.hxx"
+#include "bvh.hxx"
+#include "lbvh.hxx"
+#include "bvh_refit.hxx"
+#include "wide_bvh.hxx"
+#include "quantized_bvh.hxx"
+#include "scene.hxx"
+#include "framebuffer.hxx"
+#include "tracer.hxx"
+#include "progressive.hxx"
+#include "bvh_bench.hxx"
\ No newline at end of file
@@ -0,0 +1,484 @@
+namespace rt {
+namespace impl {
+[[nodiscard]] bool
+intersect_sphere(Sphere const &sphere, Ray const &ray, f32 t_min, f32 t_max, f32 &t) {
+  // @Note: half-b form of the quadratic.
+  Vec3 const oc     = ray.origin - sphere.center;
+  f32  const a      = len_sq(ray.dir);
+  f32  const half_b = dot(oc, ray.dir);
+  f32  const c      = len_sq(oc) - sphere.radius*sphere.radius;
+  f32  const disc   = half_b*half_b - a*c;
+  if (disc < 0) {
+    return false;
+  }
+
+  f32 const sqrt_disc = std::sqrt(disc);
+  f32 root = (-half_b - sqrt_disc)/a;
+  if (root <= t_min || root >= t_max) {
+    root = (-half_b + sqrt_disc)/a;
+    if (root <= t_min || root >= t_max) {
+      return false;
+    }
+  }
+
+  t = root;
+  return true;
+}
+
+// Moller-Trumbore.
+[[nodiscard]] bool
+intersect_triangle(Triangle const &tri, Ray const &ray, f32 t_min, f32 t_max, f32 &t) {
+  Vec3 const e1  = tri.v1 - tri.v0;
+  Vec3 const e2  = tri.v2 - tri.v0;
+  Vec3 const p   = cross(ray.dir, e2);
+  f32  const det = dot(e1, p);
+  if (std::abs(det) < 1e-12f) {
+    return false;
+  }
+
+  f32  const inv_det = 1/det;
+  Vec3 const s       = ray.origin - tri.v0;
+  f32  const u       = dot(s, p)*inv_det;
+  if (u < 0 || u > 1) {
+    return false;
+  }
+
+  Vec3 const q = cross(s, e1);
+  f32  const v = dot(ray.dir, q)*inv_det;
+  if (v < 0 || u + v > 1) {
+    return false;
+  }
+
+  f32 const root = dot(e2, q)*inv_det;
+  if (root <= t_min || root >= t_max) {
+    return false;
+  }
+
+  t = root;
+  return true;
+}
+
+void
+set_hit_normal(Hit &hit, Ray const &ray, Vec3 outward_normal) {
+  hit.front_face = dot(ray.dir, outward_normal) < 0;
+  hit.normal     = hit.front_face ? outward_normal : outward_normal*-1;
+}
+
+void
+destroy_wide_bvh(Scene &scene) {
+  if (scene.bvh4.node_count > 0) {
+    wide_bvh_destroy(scene.bvh4);
+  }
+  if (scene.bvh8.node_count > 0) {
+    wide_bvh_destroy(scene.bvh8);
+  }
+  if (scene.quantized_bvh4.node_count > 0) {
+    quantized_bvh_destroy(scene.quantized_bvh4);
+  }
+  if (scene.quantized_bvh8.node_count > 0) {
+    quantized_bvh_destroy(scene.quantized_bvh8);
+  }
+}
+
+// Collapses scene.bvh into the widest quantized BVH the CPU can traverse. Returns its
+// name. `stats` is optional.
+char const*
+build_wide_bvh(Scene &scene, Bvh_Build_Stats *stats = NULL) {
+  destroy_wide_bvh(scene);
+
+  // @Note: quantizing fails on leaves too big for it, the tree stays uncompressed then.
+  bool const avx2 = os_get_cpu_info().isa_level >= IsaLevel_AVX2;
+  if (avx2) {
+    scene.quantized_bvh8 = quantized_bvh_build<8>(scene.bvh, stats);
+    if (scene.quantized_bvh8.node_count > 0) {
+      return "quantized BVH8";
+    }
+  } else {
+    scene.quantized_bvh4 = quantized_bvh_build<4>(scene.bvh, stats);
+    if (scene.quantized_bvh4.node_count > 0) {
+      return "quantized BVH4";
+    }
+  }
+
+  if (avx2) {
+    scene.bvh8 = wide_bvh_build<8>(scene.bvh, stats);
+    return "BVH8";
+  } else {
+    scene.bvh4 = wide_bvh_build<4>(scene.bvh, stats);
+    return "BVH4";
+  }
+}
+
+// Brings the wide BVH up to date after scene.bvh was refit. Returns false if there is none.
+[[nodiscard]] bool
+refit_wide_bvh(Scene &scene) {
+  if (scene.quantized_bvh8.node_count > 0) {
+    quantized_bvh_refit(scene.quantized_bvh8, scene.bvh);
+  } else if (scene.quantized_bvh4.node_count > 0) {
+    quantized_bvh_refit(scene.quantized_bvh4, scene.bvh);
+  } else if (scene.bvh8.node_count > 0) {
+    wide_bvh_refit(scene.bvh8, scene.bvh);
+  } else if (scene.bvh4.node_count > 0) {
+    wide_bvh_refit(scene.bvh4, scene.bvh);
+  } else {
+    return false;
+  }
+  return true;
+}
+} // namespace impl
+
+[[nodiscard]] Scene
+scene_create(s32 material_capacity, s32 sphere_capacity, s32 triangle_capacity) {
+  check_(material_capacity > 0);
+
+  Scene scene = {
+    .material_capacity = material_capacity,
+    .sphere_capacity   = sphere_capacity,
+    .triangle_capacity = triangle_capacity,
+    .sky_zenith        = {.x = 0.5f, .y = 0.7f, .z = 1.0f},
+    .sky_horizon       = {.x = 1.0f, .y = 1.0f, .z = 1.0f}
+  };
+
+  scene.materials = (Material*)alloc_perm(material_capacity*sizeof(Material));
+  if (sphere_capacity > 0) {
+    scene.spheres = (Sphere*)alloc_perm(sphere_capacity*sizeof(Sphere));
+  }
+  if (triangle_capacity > 0) {
+    scene.triangles = (Triangle*)alloc_perm(triangle_capacity*sizeof(Triangle));
+  }
+  return scene;
+}
+
+void
+scene_destroy(Scene &scene) {
+  free_perm(scene.materials);
+  free_perm(scene.spheres);
+  free_perm(scene.triangles);
+  if (scene.bvh.node_count > 0) {
+    bvh_destroy(scene.bvh);
+  }
+  impl::destroy_wide_bvh(scene);
+  scene = {};
+}
+
+[[nodiscard]] s32
+scene_add_material(Scene &scene, Material const &material) {
+  if (scene.material_count == scene.material_capacity) {
+    errf("Too many materials in the scene (capacity: %d)", scene.material_capacity);
+  }
+
+  scene.materials[scene.material_count] = material;
+  return scene.material_count++;
+}
+
+void
+scene_add_sphere(Scene &scene, Sphere const &sphere) {
+  dbg_check_(sphere.material >= 0 && sphere.material < scene.material_count);
+  if (scene.sphere_count == scene.sphere_capacity) {
+    errf("Too many spheres in the scene (capacity: %d)", scene.sphere_capacity);
+  }
+
+  scene.spheres[scene.sphere_count++] = sphere;
+}
+
+void
+scene_add_triangle(Scene &scene, Triangle const &triangle) {
+  dbg_check_(triangle.material >= 0 && triangle.material < scene.material_count);
+  if (scene.triangle_count == scene.triangle_capacity) {
+    errf("Too many triangles in the scene (capacity: %d)", scene.triangle_capacity);
+  }
+
+  scene.triangles[scene.triangle_count++] = triangle;
+}
+
+void
+scene_add_quad(Scene &scene, Vec3 corner, Vec3 edge_u, Vec3 edge_v, s32 material) {
+  Vec3 const opposite = corner + edge_u + edge_v;
+  scene_add_triangle(scene, {.v0 = corner, .v1 = corner + edge_u, .v2 = opposite, .material = material});
+  scene_add_triangle(scene, {.v0 = corner, .v1 = opposite, .v2 = corner + edge_v, .material = material});
+}
+
+void
+scene_add_torus(Scene &scene, Vec3 center, f32 major_radius, f32 minor_radius,
+                s32 major_segments, s32 minor_segments, s32 material) {
+  check_(major_segments >= 3 && minor_segments >= 3);
+
+  auto const point = [&](s32 i, s32 j) {
+    f32 const u    = 2*PI*i/major_segments;
+    f32 const v    = 2*PI*j/minor_segments;
+    f32 const ring = major_radius + minor_radius*std::cos(v);
+    return center + Vec3{.x = ring*std::cos(u), .y = minor_radius*std::sin(v), .z = ring*std::sin(u)};
+  };
+
+  // @Note: stepping around the tube and then around the axis turns counter-clockwise
+  //        when seen from the outside.
+  for (s32 i = 0; i < major_segments; i++) {
+    for (s32 j = 0; j < minor_segments; j++) {
+      Vec3 const p00 = point(i,     j);
+      Vec3 const p01 = point(i,     j + 1);
+      Vec3 const p11 = point(i + 1, j + 1);
+      Vec3 const p10 = point(i + 1, j);
+      scene_add_triangle(scene, {.v0 = p00, .v1 = p01, .v2 = p11, .material = material});
+      scene_add_triangle(scene, {.v0 = p00, .v1 = p11, .v2 = p10, .material = material});
+    }
+  }
+}
+
+void
+scene_primitive_bounds(Scene const &scene, AABB *bounds) {
+  for (s32 i = 0; i < scene.sphere_count; i++) {
+    Sphere const &sphere = scene.spheres[i];
+    Vec3   const  r      = {.x = sphere.radius, .y = sphere.radius, .z = sphere.radius};
+    bounds[i] = {.min = sphere.center - r, .max = sphere.center + r};
+  }
+  for (s32 i = 0; i < scene.triangle_count; i++) {
+    Triangle const &tri = scene.triangles[i];
+    bounds[scene.sphere_count + i] = aabb_grow(aabb_grow(aabb_grow(aabb_empty(), tri.v0), tri.v1), tri.v2);
+  }
+}
+
+void
+scene_build_bvh(Scene &scene) {
+  if (scene.bvh.node_count > 0) {
+    bvh_destroy(scene.bvh);
+  }
+  impl::destroy_wide_bvh(scene);
+
+  s32 const count = scene.sphere_count + scene.triangle_count;
+  if (count == 0) {
+    return;
+  }
+
+  AABB *bounds = (AABB*)alloc_perm(count*sizeof(AABB));
+  scene_primitive_bounds(scene, bounds);
+
+  Bvh_Build_Stats stats;
+  scene.bvh = bvh_build_parallel(bounds, count, &stats);
+  free_perm(bounds);
+
+  s64 const mark = get_temp_mem_mark();
+  bvh_log_stats(as_cstr(tprint("Scene BVH (%d primitives)", count)), stats);
+  pop_temp_mem_mark(get_temp_mem_mark() - mark);
+
+  Bvh_Build_Stats   wide_stats;
+  char const *const wide_name = impl::build_wide_bvh(scene, &wide_stats);
+  logf("Scene %s: collapsed in %.3f ms -- %d nodes (%d leaves), depth %d\n", wide_name,
+       wide_stats.seconds*1000, wide_stats.node_count, wide_stats.leaf_count,
+       wide_stats.max_depth);
+}
+
+void
+scene_update_bvh(Scene &scene, Bvh_Update_Stats *stats) {
+  s32 const count = scene.sphere_count + scene.triangle_count;
+  if (count == 0) {
+    return;
+  }
+
+  AABB *bounds = (AABB*)alloc_perm(count*sizeof(AABB));
+  scene_primitive_bounds(scene, bounds);
+  Bvh_Update_Stats update;
+  bvh_update(scene.bvh, bounds, count, &update);
+  free_perm(bounds);
+
+  // @Note: a refit keeps the topology, the wide tree only needs the new bounds.
+  f64 const start = os_get_app_uptime_precise();
+  if (update.rebuilt || !impl::refit_wide_bvh(scene)) {
+    (void)impl::build_wide_bvh(scene);
+  }
+  update.seconds += os_get_app_uptime_precise() - start;
+
+  if (stats) {
+    *stats = update;
+  }
+}
+
+[[nodiscard]] bool
+scene_intersect(Scene const &scene, Ray const &ray, f32 t_min, f32 t_max, Hit &hit) {
+  s32 hit_primitive = -1;
+  f32 closest       = t_max;
+
+  // Primitive indices count the spheres first, then the triangles.
+  auto const intersect_primitive = [&](u32 primitive, f32 t0, f32 &t1) {
+    f32  t;
+    bool is_hit;
+    if ((s32)primitive < scene.sphere_count) {
+      is_hit = impl::intersect_sphere(scene.spheres[primitive], ray, t0, t1, t);
+    } else {
+      is_hit = impl::intersect_triangle(scene.triangles[primitive - scene.sphere_count], ray,
+                                        t0, t1, t);
+    }
+    if (is_hit) {
+      t1            = t;
+      hit_primitive = (s32)primitive;
+    }
+    return is_hit;
+  };
+
+  if (scene.quantized_bvh8.node_count > 0) {
+    (void)quantized_bvh_intersect(scene.quantized_bvh8, ray, t_min, closest, intersect_primitive);
+  } else if (scene.quantized_bvh4.node_count > 0) {
+    (void)quantized_bvh_intersect(scene.quantized_bvh4, ray, t_min, closest, intersect_primitive);
+  } else if (scene.bvh8.node_count > 0) {
+    (void)wide_bvh_intersect(scene.bvh8, ray, t_min, closest, intersect_primitive);
+  } else if (scene.bvh4.node_count > 0) {
+    (void)wide_bvh_intersect(scene.bvh4, ray, t_min, closest, intersect_primitive);
+  } else if (scene.bvh.node_count > 0) {
+    (void)bvh_intersect(scene.bvh, ray, t_min, closest, intersect_primitive);
+  } else {
+    s32 const primitive_count = scene.sphere_count + scene.triangle_count;
+    for (s32 i = 0; i < primitive_count; i++) {
+      (void)intersect_primitive((u32)i, t_min, closest);
+    }
+  }
+
+  if (hit_primitive < 0) {
+    return false;
+  }
+
+  // @Note: the surface data is only computed for the closest hit.
+  hit.t = closest;
+  hit.p = ray_at(ray, closest);
+  if (hit_primitive < scene.sphere_count) {
+    Sphere const &sphere = scene.spheres[hit_primitive];
+
+    hit.material = sphere.material;
+    impl::set_hit_normal(hit, ray, (hit.p - sphere.center)*(1/sphere.radius));
+  } else {
+    Triangle const &tri = scene.triangles[hit_primitive - scene.sphere_count];
+
+    hit.material = tri.material;
+    impl::set_hit_normal(hit, ray, normalized(cross(tri.v1 - tri.v0, tri.v2 - tri.v0)));
+  }
+  return true;
+}
+
+[[nodiscard]] Vec3
+scene_sky(Scene const &scene, Vec3 dir) {
+  f32 const t = 0.5f*(dir.y/len(dir) + 1);
+  return scene.sky_horizon*(1 - t) + scene.sky_zenith*t;
+}
+
+[[nodiscard]] Scene
+scene_create_demo(u32 seed) {
+  s32 constexpr GRID        = 11; // Small spheres on a (2*GRID)^2 grid.
+  s32 constexpr TORUS_MAJOR = 96; // Segments around the axis and around the tube.
+  s32 constexpr TORUS_MINOR = 32;
+
+  Vec3 const torus_center = {.x = 2.5f, .y = 0.3f, .z = 2.5f};
+
+  Scene scene = scene_create(8 + 4*GRID*GRID, 3 + 4*GRID*GRID, 4 + 2*TORUS_MAJOR*TORUS_MINOR);
+
+  s32 const ground = scene_add_material(scene, {
+    .type = MaterialType_Diffuse, .albedo = {.x = 0.5f, .y = 0.5f, .z = 0.5f}
+  });
+  s32 const glass = scene_add_material(scene, {
+    .type = MaterialType_Dielectric, .albedo = {.x = 1, .y = 1, .z = 1}, .ior = 1.5f
+  });
+  s32 const matte = scene_add_material(scene, {
+    .type = MaterialType_Diffuse, .albedo = {.x = 0.4f, .y = 0.2f, .z = 0.1f}
+  });
+  s32 const gold = scene_add_material(scene, {
+    .type = MaterialType_Metal, .albedo = {.x = 0.7f, .y = 0.6f, .z = 0.5f}
+  });
+  s32 const mirror = scene_add_material(scene, {
+    .type = MaterialType_Metal, .albedo = {.x = 0.9f, .y = 0.9f, .z = 0.9f}, .roughness = 0.02f
+  });
+
+  scene_add_quad(scene, {.x = -50, .y = 0, .z = 50}, {.x = 100, .y = 0, .z = 0},
+                 {.x = 0, .y = 0, .z = -100}, ground);
+  scene_add_quad(scene, {.x = -6, .y = 0, .z = -6}, {.x = 12, .y = 0, .z = 0},
+                 {.x = 0, .y = 4, .z = 0}, mirror);
+
+  scene_add_sphere(scene, {.center = {.x =  0, .y = 1, .z = 0}, .radius = 1, .material = glass});
+  scene_add_sphere(scene, {.center = {.x = -4, .y = 1, .z = 0}, .radius = 1, .material = matte});
+  scene_add_sphere(scene, {.center = {.x =  4, .y = 1, .z = 0}, .radius = 1, .material = gold});
+  scene_add_torus(scene, torus_center, 0.8f, 0.3f, TORUS_MAJOR, TORUS_MINOR, gold);
+
+  Pcg32 rng = pcg32_seed(seed, 0);
+  for (s32 a = -GRID; a < GRID; a++) {
+    for (s32 b = -GRID; b < GRID; b++) {
+      Vec3 const center = {
+        .x = a + 0.9f*next_f32(rng),
+        .y = 0.2f,
+        .z = b + 0.9f*next_f32(rng)
+      };
+
+      f32  const choice = next_f32(rng);
+      Vec3 const color  = {.x = next_f32(rng), .y = next_f32(rng), .z = next_f32(rng)};
+
+      // @Note: keep clear of the big spheres.
+      bool is_clear = true;
+      for (s32 i = 0; i < 3; i++) {
+        is_clear &= dist(center, scene.spheres[i].center) > 1.3f;
+      }
+      is_clear &= dist(center, torus_center) > 1.4f;
+      if (!is_clear) {
+        continue;
+      }
+
+      s32 material = glass;
+      if (choice < 0.7f) {
+        material = scene_add_material(scene, {.type = MaterialType_Diffuse, .albedo = color*color});
+      } else if (choice < 0.85f) {
+        material = scene_add_material(scene, {
+          .type      = MaterialType_Metal,
+          .albedo    = color*0.5f + Vec3{.x = 0.5f, .y = 0.5f, .z = 0.5f},
+          .roughness = 0.5f*color.x
+        });
+      } else if (choice >= 0.95f) {
+        material = scene_add_material(scene, {
+          .type     = MaterialType_Diffuse,
+          .albedo   = color,
+          .emission = color*4
+        });
+      }
+
+      scene_add_sphere(scene, {.center = center, .radius = 0.2f, .material = material});
+    }
+  }
+
+  scene_build_bvh(scene);
+  return scene;
+}
+
+void
+scene_animate_demo(Scene &scene, f32 time, f32 dt, Bvh_Update_Stats *stats) {
+  // @Note: the first 3 spheres are the big ones, the rest are the small ones.
+  for (s32 i = 3; i < scene.sphere_count; i++) {
+    Sphere &sphere = scene.spheres[i];
+
+    f32 const radius = std::sqrt(sphere.center.x*sphere.center.x + sphere.center.z*sphere.center.z);
+    f32 const angle  = dt*2/(1 + radius);
+    f32 const c      = std::cos(angle);
+    f32 const s      = std::sin(angle);
+    f32 const x      = sphere.center.x;
+
+    sphere.center.x = c*x - s*sphere.center.z;
+    sphere.center.z = s*x + c*sphere.center.z;
+    sphere.center.y = sphere.radius + 0.5f*std::abs(std::sin(3*time + 0.37f*i));
+  }
+
+  scene_update_bvh(scene, stats);
+}
+
+[[nodiscard]] Orbit_Camera
+scene_demo_orbit() {
+  Vec3 const eye    = {.x = 13, .y = 2,    .z = 3};
+  Vec3 const target = {.x = 0,  .y = 0.5f, .z = 0};
+  Vec3 const offset = eye - target;
+
+  return {
+    .target   = target,
+    .yaw      = std::atan2(offset.z, offset.x),
+    .pitch    = std::atan2(offset.y, std::sqrt(offset.x*offset.x + offset.z*offset.z)),
+    .distance = len(offset),
+    .fov_y    = 20*PI/180,
+    .aperture = 0.05f
+  };
+}
+
+[[nodiscard]] Camera
+scene_demo_camera(f32 aspect) {
+  return camera_from_orbit(scene_demo_orbit(), aspect);
+}
+} // namespace rt
@@ -0,0 +1,134 @@
+/**
+ * Scene description for the ray tracer: materials, spheres and triangles. The arrays
+ * have a fixed capacity, given when the scene is created. Lighting comes from the sky
+ * (a vertical gradient) and from emissive materials.
+*/
+
+namespace rt {
+enum Material_Type {
+  MaterialType_Diffuse = 0,
+  MaterialType_Metal,
+  MaterialType_Dielectric
+};
+
+struct Material {
+  Material_Type type;
+  Vec3          albedo;
+  Vec3          emission;
+  f32           roughness; // Metal only. 0 is a perfect mirror.
+  f32           ior;       // Dielectric only.
+};
+
+struct Sphere {
+  Vec3 center;
+  f32  radius;
+  s32  material;
+};
+
+struct Triangle {
+  Vec3 v0, v1, v2; // Counter-clockwise when looking at the front.
+  s32  material;
+};
+
+struct Scene {
+  Material *materials;
+  s32       material_count;
+  s32       material_capacity;
+
+  Sphere *spheres;
+  s32     sphere_count;
+  s32     sphere_capacity;
+
+  Triangle *triangles;
+  s32       triangle_count;
+  s32       triangle_capacity;
+
+  Bvh bvh; // Over the spheres, then the triangles. Empty until scene_build_bvh.
+
+  // Collapsed from `bvh` and traced instead of it. At most one of them is built: 8-wide
+  // if the ISA level is AVX2 or higher, else 4-wide. Quantized unless a leaf is too
+  // big for it.
+  Bvh4           bvh4;
+  Bvh8           bvh8;
+  Quantized_Bvh4 quantized_bvh4;
+  Quantized_Bvh8 quantized_bvh8;
+
+  Vec3 sky_zenith;
+  Vec3 sky_horizon;
+};
+
+struct Hit {
+  f32  t;
+  Vec3 p;
+  Vec3 normal;     // Unit length, facing against the ray.
+  bool front_face; // The ray hit the outside of the surface.
+  s32  material;
+};
+
+[[nodiscard]] Scene
+scene_create(s32 material_capacity, s32 sphere_capacity, s32 triangle_capacity);
+
+void
+scene_destroy(Scene &scene);
+
+// Returns the index to use in the primitives.
+[[nodiscard]] s32
+scene_add_material(Scene &scene, Material const &material);
+
+void
+scene_add_sphere(Scene &scene, Sphere const &sphere);
+
+void
+scene_add_triangle(Scene &scene, Triangle const &triangle);
+
+// Parallelogram spanned by `edge_u` and `edge_v`, as two triangles. The front is on the
+// side of cross(edge_u, edge_v).
+void
+scene_add_quad(Scene &scene, Vec3 corner, Vec3 edge_u, Vec3 edge_v, s32 material);
+
+// Torus around the Y axis, `major_segments*minor_segments*2` triangles facing out.
+void
+scene_add_torus(Scene &scene, Vec3 center, f32 major_radius, f32 minor_radius,
+                s32 major_segments, s32 minor_segments, s32 material);
+
+// Bounds of every primitive, spheres first, then triangles (the order of the primitive
+// indices in the BVH). `bounds` has room for sphere_count + triangle_count entries.
+void
+scene_primitive_bounds(Scene const &scene, AABB *bounds);
+
+// (Re)builds the BVH over every primitive, and the wide BVH traced instead of it. Call it
+// after the last primitive is added, primitives added later aren't hit until the next
+// build.
+void
+scene_build_bvh(Scene &scene);
+
+// Brings the BVH up to date after primitives have moved, see bvh_update, and collapses
+// the wide BVH again. `stats` is optional.
+void
+scene_update_bvh(Scene &scene, Bvh_Update_Stats *stats = NULL);
+
+// Closest hit in (t_min, t_max). Walks the wide BVH or the BVH if there is one, else tests
+// every primitive.
+[[nodiscard]] bool
+scene_intersect(Scene const &scene, Ray const &ray, f32 t_min, f32 t_max, Hit &hit);
+
+[[nodiscard]] Vec3
+scene_sky(Scene const &scene, Vec3 dir);
+
+// Spheres of every material on a ground plane, a few hundred small ones scattered
+// around (placed from `seed`), a mirror and a torus made of triangles.
+[[nodiscard]] Scene
+scene_create_demo(u32 seed);
+
+// Moves the small spheres of the demo scene: they bounce, and swirl around the middle
+// (the inner ones faster), so the BVH has to follow. Updates the BVH.
+void
+scene_animate_demo(Scene &scene, f32 time, f32 dt, Bvh_Update_Stats *stats = NULL);
+
+// Camera that frames the demo scene.
+[[nodiscard]] Orbit_Camera
+scene_demo_orbit();
+
+[[nodiscard]] Camera
+scene_demo_camera(f32 aspect);
+} // namespace rt
@@ -0,0 +1,291 @@
+namespace rt {
+namespace impl {
+// Orthonormal basis around a unit vector, without branches (Duff et al. 2017).
+void
+tangent_frame(Vec3 n, Vec3 &t, Vec3 &b) {
+  f32 const sign = (n.z >= 0) ? 1.f : -1.f;
+  f32 const a    = -1/(sign + n.z);
+  f32 const c    = n.x*n.y*a;
+
+  t = {.x = 1 + sign*n.x*n.x*a, .y = sign*c, .z = -sign*n.x};
+  b = {.x = c, .y = sign + n.y*n.y*a, .z = -n.y};
+}
+
+[[nodiscard]] Vec3
+reflect(Vec3 v, Vec3 n) {
+  return v - n*(2*dot(v, n));
+}
+
+// `v` must be normalized. `eta` is the ratio of the indices of refraction.
+[[nodiscard]] Vec3
+refract(Vec3 v, Vec3 n, f32 cos_theta, f32 eta) {
+  Vec3 const perpendicular = (v + n*cos_theta)*eta;
+  f32  const parallel_sq   = 1 - len_sq(perpendicular);
+  return perpendicular - n*std::sqrt((parallel_sq > 0) ? parallel_sq : 0);
+}
+
+// Schlick's approximation of the Fresnel reflectance.
+[[nodiscard]] f32
+reflectance(f32 cos_theta, f32 eta) {
+  f32 r0 = (1 - eta)/(1 + eta);
+  r0 = r0*r0;
+
+  f32 const m = 1 - cos_theta;
+  return r0 + (1 - r0)*m*m*m*m*m;
+}
+
+// Samples the next direction. Returns false if the path is absorbed.
+[[nodiscard]] bool
+scatter(Material const &material, Vec3 dir, Hit const &hit, Vec2 u, f32 u_choice,
+        Vec3 &attenuation, Vec3 &next_dir) {
+  switch (material.type) {
+    case MaterialType_Diffuse: {
+      // @Note: the cosine and the 1/PI of the BRDF cancel out with the pdf.
+      Vec3 t, b;
+      tangent_frame(hit.normal, t, b);
+
+      Vec3 const local = sample_cosine_hemisphere(u);
+      next_dir    = t*local.x + b*local.y + hit.normal*local.z;
+      attenuation = material.albedo;
+      return true;
+    }
+
+    case MaterialType_Metal: {
+      Vec3 const reflected = reflect(normalized(dir), hit.normal);
+      next_dir    = reflected + sample_uniform_sphere(u)*material.roughness;
+      attenuation = material.albedo;
+      return dot(next_dir, hit.normal) > 0;
+    }
+
+    case MaterialType_Dielectric: {
+      f32  const eta       = hit.front_face ? 1/material.ior : material.ior;
+      Vec3 const unit_dir  = normalized(dir);
+      f32  const cos_in    = -dot(unit_dir, hit.normal);
+      f32  const cos_theta = (cos_in < 1) ? cos_in : 1;
+      f32  const sin_theta = std::sqrt(1 - cos_theta*cos_theta);
+
+      bool const must_reflect = eta*sin_theta > 1;
+      if (must_reflect || u_choice < reflectance(cos_theta, eta)) {
+        next_dir = reflect(unit_dir, hit.normal);
+      } else {
+        next_dir = refract(unit_dir, hit.normal, cos_theta, eta);
+      }
+      attenuation = material.albedo;
+      return true;
+    }
+
+    default: {
+      dbg_check_(false);
+      return false;
+    }
+  }
+}
+
+struct Render_Tiles {
+  Framebuffer           *fb;
+  Scene const           *scene;
+  Camera const          *camera;
+  Render_Settings const *settings;
+  s32                    first_tile;
+  s32                    tiles_x;
+  u32                    first_sample;
+  s32                    sample_count;
+  f32                   *tile_seconds;
+
+  s64 volatile samples;
+  s64 volatile rays;
+};
+
+void
+render_tiles_job(void *data, s64 begin, s64 end) {
+  Render_Tiles &tiles = *(Render_Tiles*)data;
+  Framebuffer  &fb    = *tiles.fb;
+
+  // @Note: counted locally and merged once, so the threads don't fight over a cache
+  //        line for every pixel.
+  Render_Stats stats = {};
+  for (s64 i = tiles.first_tile + begin; i < tiles.first_tile + end; i++) {
+    s32 const x0 = (s32)(i % tiles.tiles_x)*RENDER_TILE_SIZE;
+    s32 const y0 = (s32)(i / tiles.tiles_x)*RENDER_TILE_SIZE;
+    s32 const x1 = (x0 + RENDER_TILE_SIZE < fb.width)  ? x0 + RENDER_TILE_SIZE : fb.width;
+    s32 const y1 = (y0 + RENDER_TILE_SIZE < fb.height) ? y0 + RENDER_TILE_SIZE : fb.height;
+
+    f64 const start = tiles.tile_seconds ? os_get_app_uptime_precise() : 0;
+    render_rect(fb, *tiles.scene, *tiles.camera, *tiles.settings, x0, y0, x1, y1,
+                tiles.first_sample, tiles.sample_count, stats);
+    if (tiles.tile_seconds) {
+      tiles.tile_seconds[i - tiles.first_tile] = (f32)(os_get_app_uptime_precise() - start);
+    }
+  }
+
+  atomic_add(tiles.samples, stats.samples);
+  atomic_add(tiles.rays, stats.rays);
+}
+} // namespace impl
+
+[[nodiscard]] Vec3
+trace_path(Scene const &scene, Ray const &ray, Sampler &sampler, s32 max_depth,
+           s64 &ray_count) {
+  Vec3 radiance   = {};
+  Vec3 throughput = {.x = 1, .y = 1, .z = 1};
+  Ray  current    = ray;
+
+  for (s32 depth = 0;; depth++) {
+    ray_count++;
+
+    Hit hit;
+    if (!scene_intersect(scene, current, RENDER_RAY_EPSILON, FLT_MAX, hit)) {
+      radiance += throughput*scene_sky(scene, current.dir);
+      break;
+    }
+
+    Material const &material = scene.materials[hit.material];
+    radiance += throughput*material.emission;
+
+    if (depth == max_depth) {
+      break;
+    }
+
+    // @Note: every bounce takes the same sample dimensions, whatever the material, so
+    //        the dimensions of a low-discrepancy sequence line up across paths.
+    Vec2 const u        = sampler_next_2d(sampler);
+    f32  const u_choice = sampler_next_1d(sampler);
+    f32  const u_rr     = sampler_next_1d(sampler);
+
+    Vec3 attenuation, next_dir;
+    if (!impl::scatter(material, current.dir, hit, u, u_choice, attenuation, next_dir)) {
+      break;
+    }
+    throughput *= attenuation;
+
+    if (depth >= RENDER_ROULETTE_DEPTH) {
+      f32 survival = (throughput.x > throughput.y) ? throughput.x : throughput.y;
+      survival = (throughput.z > survival) ? throughput.z : survival;
+      survival = (survival < 0.05f) ? 0.05f : (survival > 0.95f) ? 0.95f : survival;
+      if (u_rr >= survival) {
+        break;
+      }
+      throughput *= 1/survival;
+    }
+
+    current = make_ray(hit.p, next_dir);
+  }
+
+  return radiance;
+}
+
+void
+render_rect(Framebuffer &fb, Scene const &scene, Camera const &camera,
+            Render_Settings const &settings, s32 x0, s32 y0, s32 x1, s32 y1,
+            u32 first_sample, s32 sample_count, Render_Stats &stats) {
+  dbg_check_(x0 >= 0 && x1 <= fb.width && y0 >= 0 && y1 <= fb.height);
+
+  Sampler sampler = sampler_init(settings.sampler, settings.seed);
+  f32 const inv_width  = 1.f/fb.width;
+  f32 const inv_height = 1.f/fb.height;
+
+  s64 rays = 0;
+  for (s32 y = y0; y < y1; y++) {
+    for (s32 x = x0; x < x1; x++) {
+      Vec3 sum = {};
+      for (s32 s = 0; s < sample_count; s++) {
+        sampler_start(sampler, x, y, first_sample + s);
+
+        Vec2 const jitter = sampler_next_2d(sampler);
+        Vec2 const lens   = sampler_next_2d(sampler);
+        Vec2 const film   = {.x = (x + jitter.x)*inv_width, .y = (y + jitter.y)*inv_height};
+
+        sum += trace_path(scene, camera_ray(camera, film, lens), sampler, settings.max_depth, rays);
+      }
+      framebuffer_add_samples(fb, x, y, sum, sample_count);
+    }
+  }
+
+  stats.samples += (s64)(x1 - x0)*(y1 - y0)*sample_count;
+  stats.rays    += rays;
+}
+
+[[nodiscard]] s32
+render_tile_count(Framebuffer const &fb) {
+  s32 const tiles_x = (fb.width  + RENDER_TILE_SIZE - 1)/RENDER_TILE_SIZE;
+  s32 const tiles_y = (fb.height + RENDER_TILE_SIZE - 1)/RENDER_TILE_SIZE;
+  return tiles_x*tiles_y;
+}
+
+[[nodiscard]] Render_Stats
+render_tiles(Framebuffer &fb, Scene const &scene, Camera const &camera,
+             Render_Settings const &settings, s32 first_tile, s32 tile_count,
+             u32 first_sample, s32 sample_count, f32 *tile_seconds) {
+  dbg_check_(first_tile >= 0 && tile_count >= 0);
+  dbg_check_(first_tile + tile_count <= render_tile_count(fb));
+
+  f64 const start = os_get_app_uptime_precise();
+
+  impl::Render_Tiles tiles = {
+    .fb           = &fb,
+    .scene        = &scene,
+    .camera       = &camera,
+    .settings     = &settings,
+    .first_tile   = first_tile,
+    .tiles_x      = (fb.width + RENDER_TILE_SIZE - 1)/RENDER_TILE_SIZE,
+    .first_sample = first_sample,
+    .sample_count = sample_count,
+    .tile_seconds = tile_seconds
+  };
+
+  // @Note: one job per tile. Tiles differ a lot in cost (sky vs. glass), and small
+  //        jobs let the idle threads steal whatever is left.
+  parallel_for(tile_count, 1, impl::render_tiles_job, &tiles);
+
+  return {
+    .samples = tiles.samples,
+    .rays    = tiles.rays,
+    .seconds = os_get_app_uptime_precise() - start
+  };
+}
+
+[[nodiscard]] Render_Stats
+render_frame(Framebuffer &fb, Scene const &scene, Camera const &camera,
+             Render_Settings const &settings, u32 first_sample) {
+  return render_tiles(fb, scene, camera, settings, 0, render_tile_count(fb),
+                      first_sample, settings.samples_per_pixel);
+}
+
+void
+render_log_stats(char const *label, Render_Stats const &stats) {
+  f64 const seconds = (stats.seconds > 0) ? stats.seconds : 1e-9;
+
+  logf("%s: %lld samples, %lld rays in %.3fs -- %.3f Msamples/s, %.3f Mrays/s\n",
+       label, stats.samples, stats.rays, stats.seconds,
+       stats.samples/seconds*1e-6, stats.rays/seconds*1e-6);
+}
+
+void
+render_headless_or_panic(char const *output_path, s32 width, s32 height,
+                         Render_Settings const &settings) {
+  check_(output_path);
+
+  Framebuffer  fb     = framebuffer_create(width, height);
+  Scene        scene  = scene_create_demo(settings.seed);
+  Camera const camera = scene_demo_camera((f32)width/height);
+
+  logf("Rendering %dx%d, %d spp (%s sampler, %d spheres, %d triangles) on %d threads\n",
+       width, height, settings.samples_per_pixel, sampler_type_name(settings.sampler),
+       scene.sphere_count, scene.triangle_count, jobs_thread_count());
+
+  Render_Stats const stats = render_frame(fb, scene, camera, settings);
+  render_log_stats("Render", stats);
+
+  s64 const path_length = (s64)::strlen(output_path);
+  bool const is_pfm = path_length >= 4 && ::strcmp(output_path + path_length - 4, ".pfm") == 0;
+  if (is_pfm) {
+    framebuffer_write_pfm_or_panic(fb, output_path);
+  } else {
+    framebuffer_write_bmp_or_panic(fb, output_path);
+  }
+  logf("Image written to '%s'\n", output_path);
+
+  scene_destroy(scene);
+  framebuffer_destroy(fb);
+}
+} // namespace rt
@@ -0,0 +1,60 @@
+/**
+ * CPU path tracer. Unidirectional, with Russian roulette after a few bounces. The
+ * samples come from a Sampler, so the image of a (seed, sample count) pair doesn't
+ * depend on the order in which pixels are rendered.
+*/
+
+namespace rt {
+struct Render_Settings {
+  s32          samples_per_pixel;
+  s32          max_depth; // Bounces after the camera ray.
+  Sampler_Type sampler;
+  u32          seed;
+};
+
+struct Render_Stats {
+  s64 samples; // Camera paths.
+  s64 rays;    // Every ray cast, camera rays included.
+  f64 seconds;
+};
+
+// Radiance along `ray`. Adds the number of rays cast to `ray_count`.
+[[nodiscard]] Vec3
+trace_path(Scene const &scene, Ray const &ray, Sampler &sampler, s32 max_depth,
+           s64 &ray_count);
+
+// Adds `sample_count` samples to every pixel of the [x0, x1) x [y0, y1) rectangle,
+// starting at sample index `first_sample`. Single-threaded; rectangles that don't
+// overlap may be rendered in parallel.
+void
+render_rect(Framebuffer &fb, Scene const &scene, Camera const &camera,
+            Render_Settings const &settings, s32 x0, s32 y0, s32 x1, s32 y1,
+            u32 first_sample, s32 sample_count, Render_Stats &stats);
+
+// Number of RENDER_TILE_SIZE tiles covering the framebuffer, numbered row by row.
+[[nodiscard]] s32
+render_tile_count(Framebuffer const &fb);
+
+// Adds `sample_count` samples to every pixel of the tiles [first_tile, first_tile +
+// tile_count), starting at sample index `first_sample`. Every tile is a job, so the
+// work is spread over all threads. If `tile_seconds` isn't NULL, it gets the time
+// spent on each tile.
+[[nodiscard]] Render_Stats
+render_tiles(Framebuffer &fb, Scene const &scene, Camera const &camera,
+             Render_Settings const &settings, s32 first_tile, s32 tile_count,
+             u32 first_sample, s32 sample_count, f32 *tile_seconds = NULL);
+
+// Adds settings.samples_per_pixel samples to the whole framebuffer.
+[[nodiscard]] Render_Stats
+render_frame(Framebuffer &fb, Scene const &scene, Camera const &camera,
+             Render_Settings const &settings, u32 first_sample = 0);
+
+void
+render_log_stats(char const *label, Render_Stats const &stats);
+
+// Renders the demo scene without a window and writes it to `output_path` (.pfm for the
+// HDR image, BMP otherwise).
+void
+render_headless_or_panic(char const *output_path, s32 width, s32 height,
+                         Render_Settings const &settings);
+} // namespace rt
@@ -0,0 +1,239 @@
+namespace rt {
+namespace impl {
+template <s32 N>
+struct Wide_Bvh_Builder {
+  Bvh const *bvh; // Input.
+
+  Wide_Bvh_Node<N> *nodes;
+  u32              *sources;
+  s32               node_count;
+  s32               leaf_count;
+  s32               max_depth;
+};
+
+template <s32 N>
+void
+set_wide_bvh_child_bounds(Wide_Bvh_Node<N> &node, s32 i, AABB const &bounds) {
+  node.min_x[i] = bounds.min.x; node.min_y[i] = bounds.min.y; node.min_z[i] = bounds.min.z;
+  node.max_x[i] = bounds.max.x; node.max_y[i] = bounds.max.y; node.max_z[i] = bounds.max.z;
+}
+
+// Children of the binary node `binary_index` in a wide node: the interior child with
+// the largest surface area is opened until there are N or only leaves are left.
+// Returns the child count, which is 1 only for a leaf.
+template <s32 N>
+[[nodiscard]] s32
+collapse_bvh_node(Bvh const &bvh, u32 binary_index, u32 (&children)[N]) {
+  // @Note: the biggest child is the one most rays reach, opening it saves them the
+  //        most node visits.
+  children[0] = binary_index;
+  s32 child_count = 1;
+  while (child_count < N) {
+    s32 best      = -1;
+    f32 best_area = -1;
+    for (s32 i = 0; i < child_count; i++) {
+      Bvh_Node const &child = bvh.nodes[children[i]];
+      f32 const area = surface_area(child.bounds);
+      if (child.count == 0 && area > best_area) {
+        best      = i;
+        best_area = area;
+      }
+    }
+    if (best < 0) {
+      break;
+    }
+
+    u32 const opened = children[best];
+    children[best]          = opened + 1;
+    children[child_count++] = bvh.nodes[opened].offset;
+  }
+  return child_count;
+}
+
+// `binary_index` is the binary node the wide node at `node_index` replaces.
+template <s32 N>
+void
+build_wide_bvh_node(Wide_Bvh_Builder<N> &builder, u32 binary_index, s32 node_index,
+                    s32 depth) {
+  Bvh_Node const *binary = builder.bvh->nodes;
+  builder.max_depth = (depth > builder.max_depth) ? depth : builder.max_depth;
+
+  u32       children[N];
+  s32 const child_count = collapse_bvh_node(*builder.bvh, binary_index, children);
+
+  Wide_Bvh_Node<N> &node    = builder.nodes[node_index];
+  u32              *sources = builder.sources + (s64)node_index*N;
+  for (s32 i = 0; i < N; i++) {
+    bool const used = i < child_count;
+    set_wide_bvh_child_bounds(node, i, used ? binary[children[i]].bounds : aabb_empty());
+    node.children[i] = 0;
+    node.counts[i]   = 0;
+    sources[i]       = used ? children[i] : ~0u;
+  }
+
+  for (s32 i = 0; i < child_count; i++) {
+    Bvh_Node const &child = binary[children[i]];
+    if (child.count > 0) {
+      node.children[i] = child.offset;
+      node.counts[i]   = child.count;
+      builder.leaf_count++;
+    } else {
+      s32 const child_index = builder.node_count++;
+      node.children[i] = (u32)child_index;
+      build_wide_bvh_node(builder, children[i], child_index, depth + 1);
+    }
+  }
+}
+} // namespace impl
+
+template <s32 N>
+[[nodiscard]] Wide_Bvh<N>
+wide_bvh_build(Bvh const &bvh, Bvh_Build_Stats *stats) {
+  f64 const start = os_get_app_uptime_precise();
+
+  Wide_Bvh<N> result = {};
+  if (bvh.node_count == 0) {
+    if (stats) {
+      *stats = {};
+    }
+    return result;
+  }
+
+  // @Note: every wide node replaces a different binary one, the binary node count is
+  //        an upper bound. A leaf root still gets a node, with one slot.
+  s64 const node_capacity = bvh.node_count;
+  result.arena = arena_create(node_capacity*sizeof(Wide_Bvh_Node<N>) + 64 +
+                              node_capacity*N*sizeof(u32) + 16 +
+                              bvh.primitive_count*sizeof(u32));
+
+  result.primitive_count = bvh.primitive_count;
+  result.primitives      = (u32*)arena_alloc(result.arena, bvh.primitive_count*sizeof(u32));
+  mem_copy_(result.primitives, bvh.primitives, bvh.primitive_count*sizeof(u32));
+
+  impl::Wide_Bvh_Builder<N> builder = {
+    .bvh   = &bvh,
+    .nodes = (Wide_Bvh_Node<N>*)arena_alloc(result.arena,
+                                            node_capacity*sizeof(Wide_Bvh_Node<N>), 64),
+    .sources    = (u32*)arena_alloc(result.arena, node_capacity*N*sizeof(u32)),
+    .node_count = 1
+  };
+  impl::build_wide_bvh_node(builder, 0, 0, 1);
+
+  result.nodes      = builder.nodes;
+  result.node_count = builder.node_count;
+  result.sources    = builder.sources;
+
+  if (stats) {
+    *stats = {
+      .seconds    = os_get_app_uptime_precise() - start,
+      .node_count = builder.node_count,
+      .leaf_count = builder.leaf_count,
+      .max_depth  = builder.max_depth,
+      .sah_cost   = 0
+    };
+  }
+  return result;
+}
+
+template <s32 N>
+void
+wide_bvh_refit(Wide_Bvh<N> &bvh, Bvh const &binary) {
+  for (s32 i = 0; i < bvh.node_count; i++) {
+    u32 const *sources = bvh.sources + (s64)i*N;
+    for (s32 j = 0; j < N; j++) {
+      if (sources[j] != ~0u) {
+        impl::set_wide_bvh_child_bounds(bvh.nodes[i], j, binary.nodes[sources[j]].bounds);
+      }
+    }
+  }
+}
+
+template <s32 N>
+void
+wide_bvh_destroy(Wide_Bvh<N> &bvh) {
+  arena_destroy(bvh.arena);
+  bvh = {};
+}
+
+template <s32 N, typename TIntersect>
+[[nodiscard]] bool
+wide_bvh_intersect(Wide_Bvh<N> const &bvh, Ray const &ray, f32 t_min, f32 &t_max,
+                   TIntersect &&intersect_primitive) {
+  static_assert(N == 4 || N == 8);
+
+  if (bvh.node_count == 0) {
+    return false;
+  }
+
+  // A node or a leaf to visit, and where the ray enters it.
+  struct Entry {
+    f32 t;
+    u32 child;
+    u32 count; // 0 for nodes.
+  };
+
+  // @Note: a node pushes all but the nearest of its children.
+  Entry stack[BVH_MAX_DEPTH*(N - 1)];
+  s32   stack_size = 0;
+  Entry current    = {.t = t_min, .child = 0, .count = 0};
+  bool  hit        = false;
+
+  for (;;) {
+    if (current.count == 0) {
+      Wide_Bvh_Node<N> const &node = bvh.nodes[current.child];
+
+      alignas(32) f32 entries[N];
+      u32 mask;
+      if constexpr (N == 4) {
+        AABBx4 const boxes = {
+          .min = {load_f32x4(node.min_x), load_f32x4(node.min_y), load_f32x4(node.min_z)},
+          .max = {load_f32x4(node.max_x), load_f32x4(node.max_y), load_f32x4(node.max_z)}
+        };
+        F32x4 t_entry;
+        mask = to_bits(intersect(ray, boxes, t_min, t_max, t_entry));
+        store(entries, t_entry);
+      } else {
+        AABBx8 const boxes = {
+          .min = {load_f32x8(node.min_x), load_f32x8(node.min_y), load_f32x8(node.min_z)},
+          .max = {load_f32x8(node.max_x), load_f32x8(node.max_y), load_f32x8(node.max_z)}
+        };
+        F32x8 t_entry;
+        mask = to_bits(intersect(ray, boxes, t_min, t_max, t_entry));
+        store(entries, t_entry);
+      }
+
+      // Insertion sort of the hit children, nearest first.
+      Entry hits[N];
+      s32   hit_count = 0;
+      for (unsigned long i = 0; _BitScanForward(&i, mask); mask &= mask - 1) {
+        Entry const entry = {.t = entries[i], .child = node.children[i], .count = node.counts[i]};
+        s32 j = hit_count++;
+        for (; j > 0 && hits[j - 1].t > entry.t; j--) {
+          hits[j] = hits[j - 1];
+        }
+        hits[j] = entry;
+      }
+
+      if (hit_count > 0) {
+        for (s32 i = hit_count - 1; i > 0; i--) {
+          stack[stack_size++] = hits[i];
+        }
+        current = hits[0];
+        continue;
+      }
+    } else {
+      for (u32 i = 0; i < current.count; i++) {
+        hit |= intersect_primitive(bvh.primitives[current.child + i], t_min, t_max);
+      }
+    }
+
+    // The next entry that isn't behind the closest hit.
+    do {
+      if (stack_size == 0) {
+        return hit;
+      }
+      current = stack[--stack_size];
+    } while (current.t > t_max);
+  }
+}
+} // namespace rt
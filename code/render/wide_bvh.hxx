@@ -0,0 +1,64 @@
+/**
+ * Wide BVHs (BVH4 and BVH8), collapsed from a binary Bvh. A node holds the bounds of
+ * its up to 4 or 8 children as SoA, the layout of AABBx4/AABBx8, so a ray tests all of
+ * them with one wide slab test. The children it hits are sorted by entry distance and
+ * visited front to back, and the ones behind the closest hit so far are skipped when
+ * they come off the stack.
+ *
+ * Collapsing keeps the leaves of the binary tree and, starting from a node, opens its
+ * interior child with the largest surface area until the wide node is full. Any binary
+ * builder works. The binary node behind every child is kept, so after the binary tree
+ * is refit the wide one only copies the new bounds.
+ *
+ * Traversing a BVH8 uses the 8-wide slab test: do it only with an ISA level of at least
+ * AVX2 (scene_build_bvh picks the width).
+*/
+
+namespace rt {
+template <s32 N>
+struct alignas(64) Wide_Bvh_Node {
+  // Empty slots have aabb_empty() bounds, which no ray hits.
+  f32 min_x[N], min_y[N], min_z[N];
+  f32 max_x[N], max_y[N], max_z[N];
+  u32 children[N]; // Leaves: first entry in Wide_Bvh::primitives. Interior: node index.
+  u16 counts[N];   // Primitives in a leaf child. 0 for interior children and empty slots.
+};
+static_assert(sizeof(Wide_Bvh_Node<4>) == 128);
+static_assert(sizeof(Wide_Bvh_Node<8>) == 256);
+
+template <s32 N>
+struct Wide_Bvh {
+  Arena arena; // Holds the nodes, the primitive indices and the sources.
+
+  Wide_Bvh_Node<N> *nodes;
+  s32               node_count;
+
+  u32 *primitives; // Same as the binary tree's.
+  s32  primitive_count;
+
+  u32 *sources; // N per node: the binary node of every child, ~0u for empty slots.
+};
+
+using Bvh4 = Wide_Bvh<4>;
+using Bvh8 = Wide_Bvh<8>;
+
+// `stats` is optional, its SAH cost is left at 0.
+template <s32 N>
+[[nodiscard]] Wide_Bvh<N>
+wide_bvh_build(Bvh const &bvh, Bvh_Build_Stats *stats = NULL);
+
+// Copies the bounds of the binary tree `bvh` was collapsed from, after it was refit.
+template <s32 N>
+void
+wide_bvh_refit(Wide_Bvh<N> &bvh, Bvh const &binary);
+
+template <s32 N>
+void
+wide_bvh_destroy(Wide_Bvh<N> &bvh);
+
+// Same contract as bvh_intersect.
+template <s32 N, typename TIntersect>
+[[nodiscard]] bool
+wide_bvh_intersect(Wide_Bvh<N> const &bvh, Ray const &ray, f32 t_min, f32 &t_max,
+                   TIntersect &&intersect_primitive);
+} // namespace rt